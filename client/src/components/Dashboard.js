@@ -1,6 +1,6 @@
 import React, { useState, useEffect } from 'react';
 import { onValue, ref, set } from 'firebase/database';
-import { database } from '../firebase/config';
+import { database, roverPath } from '../firebase/config';
 import SensorDisplay from './SensorDisplay';
 import MotionControls from './MotionControls';
 import ServoControl from './ServoControl';
@@ -32,8 +32,8 @@ const Dashboard = () => {
     }
 
     // Listen for real-time sensor data
-    const sensorDataRef = ref(database, 'sensor_data');
-    const alertsRef = ref(database, 'alerts');
+    const sensorDataRef = ref(database, roverPath('sensor_data'));
+    const alertsRef = ref(database, roverPath('alerts'));
 
     const unsubscribeSensor = onValue(sensorDataRef, (snapshot) => {
       const data = snapshot.val();
@@ -81,7 +81,7 @@ const Dashboard = () => {
       return;
     }
     try {
-      await set(ref(database, 'motion_command/request'), command);
+      await set(ref(database, roverPath('commands/motion')), { command, issued_at: Date.now() });
       toast.success(`Motion command sent: ${command}`);
     } catch (error) {
       console.error('Error sending motion command:', error);
@@ -95,7 +95,7 @@ const Dashboard = () => {
       return;
     }
     try {
-      await set(ref(database, 'servo/request'), angle);
+      await set(ref(database, roverPath('commands/servo')), { angle, issued_at: Date.now() });
       toast.success(`Servo command sent: ${angle}°`);
     } catch (error) {
       console.error('Error sending servo command:', error);
@@ -109,8 +109,8 @@ const Dashboard = () => {
       return;
     }
     try {
-      await set(ref(database, 'emergency_stop'), true);
-      await set(ref(database, 'motion_command/request'), 'STOP');
+      await set(ref(database, roverPath('emergency_stop')), true);
+      await set(ref(database, roverPath('commands/motion')), { command: 'STOP', issued_at: Date.now() });
       toast.error('Emergency stop activated!');
     } catch (error) {
       console.error('Error sending emergency stop:', error);
@@ -1,6 +1,6 @@
 import React, { useState } from 'react';
 import { set, ref } from 'firebase/database';
-import { database } from '../firebase/config';
+import { database, roverPath } from '../firebase/config';
 import { Settings, AlertTriangle, Shield, Activity } from 'lucide-react';
 import toast from 'react-hot-toast';
 
@@ -45,7 +45,7 @@ const UltrasonicServoControl = ({
 
   const sendUltrasonicServoCommand = async (command, value) => {
     try {
-      await set(ref(database, `ultrasonic_servo/${command}`), value);
+      await set(ref(database, roverPath(`ultrasonic_servo/${command}`)), value);
       toast.success(`UltrasonicServo ${command} updated`);
     } catch (error) {
       console.error(`Error updating UltrasonicServo ${command}:`, error);
@@ -55,8 +55,8 @@ const UltrasonicServoControl = ({
 
   const handleEmergencyStop = async () => {
     try {
-      await set(ref(database, 'emergency_stop'), true);
-      await set(ref(database, 'motion_command/request'), 'STOP');
+      await set(ref(database, roverPath('emergency_stop')), true);
+      await set(ref(database, roverPath('commands/motion')), { command: 'STOP', issued_at: Date.now() });
       toast.error('Emergency stop activated!');
       if (onEmergencyStop) onEmergencyStop();
     } catch (error) {
@@ -67,7 +67,7 @@ const UltrasonicServoControl = ({
 
   const resetUltrasonicServo = async () => {
     try {
-      await set(ref(database, 'ultrasonic_servo/reset'), true);
+      await set(ref(database, roverPath('ultrasonic_servo/reset')), true);
       toast.success('UltrasonicServo reset');
     } catch (error) {
       console.error('Error resetting UltrasonicServo:', error);
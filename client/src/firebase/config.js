@@ -33,14 +33,19 @@ try {
   database = null;
 }
 
+// Each rover writes under rovers/<chip id>; leave REACT_APP_ROVER_ID unset for
+// firmware built with FLEET_NAMESPACE=0
+export const ROVER_ID = process.env.REACT_APP_ROVER_ID || '';
+export const roverPath = (path) => (ROVER_ID ? `rovers/${ROVER_ID}/${path}` : path);
+
 // Database references (with null checks)
-export const gasDataRef = database ? ref(database, 'gas_data') : null;
-export const distanceDataRef = database ? ref(database, 'ultrasonic_distance') : null;
-export const motionCommandRef = database ? ref(database, 'motion_command') : null;
-export const servoDataRef = database ? ref(database, 'servo') : null;
-export const alertsRef = database ? ref(database, 'alerts') : null;
-export const sensorDataRef = database ? ref(database, 'sensor_data') : null;
-export const statusRef = database ? ref(database, 'status') : null;
+export const gasDataRef = database ? ref(database, roverPath('gas_data')) : null;
+export const distanceDataRef = database ? ref(database, roverPath('ultrasonic_distance')) : null;
+export const motionCommandRef = database ? ref(database, roverPath('motion_command')) : null;
+export const servoDataRef = database ? ref(database, roverPath('servo')) : null;
+export const alertsRef = database ? ref(database, roverPath('alerts')) : null;
+export const sensorDataRef = database ? ref(database, roverPath('sensor_data')) : null;
+export const statusRef = database ? ref(database, roverPath('status')) : null;
 
 // Export database for components that need direct access
 export { database };
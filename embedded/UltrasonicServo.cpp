@@ -1,5 +1,11 @@
 
 #include "UltrasonicServo.h"
+#include "config_store.h"
+
+#if FEATURE_ULTRASONIC_SERVO
+
+#include "loop_profiler.h"
+#include "trace_recorder.h"
 
 UltrasonicServo::UltrasonicServo(int trig, int echo, int servo, int motorIn1, int motorIn2) {
   // Validate pin assignments
@@ -21,8 +27,8 @@ UltrasonicServo::UltrasonicServo(int trig, int echo, int servo, int motorIn1, in
   trigPin = trig;
   echoPin = echo;
   servoPin = servo;
-  motorIn1 = motorIn1;
-  motorIn2 = motorIn2;
+  this->motorIn1 = motorIn1;
+  this->motorIn2 = motorIn2;
   obstacleDetected = false;
   lastDistance = 0;
   lastActionTime = 0;
@@ -47,7 +53,7 @@ void UltrasonicServo::begin() {
   
   Serial.println("🔍 UltrasonicServo initialized");
   Serial.print("📏 Obstacle threshold: ");
-  Serial.print(OBSTACLE_THRESHOLD);
+  Serial.print(roverConfig.obstacleThreshold);
   Serial.println(" cm");
 }
 
@@ -58,18 +64,27 @@ float UltrasonicServo::getDistance() {
   delayMicroseconds(10);
   digitalWrite(trigPin, LOW);
 
-  long duration = pulseIn(echoPin, HIGH, 30000);
+  long duration;
+  {
+    PROFILE_SCOPE("pulseIn");
+    duration = TRACE_INPUT(TRACE_SERVO_ECHO_US, pulseIn(echoPin, HIGH, 30000));
+  }
   if (duration == 0) {
     Serial.println("❌ No echo received. Check sensor or wiring.");
     return -1.0;
   }
 
-  float distance = (duration * 0.034) / 2;
+  float distance = echoToCentimeters(duration);
   lastDistance = distance;
   
   return distance;
 }
 
+// Round-trip echo time (us) to one-way distance at ~340 m/s
+float UltrasonicServo::echoToCentimeters(long duration) {
+  return (duration * 0.034) / 2;
+}
+
 void UltrasonicServo::checkAndAct() {
   float distance = getDistance();
   
@@ -78,9 +93,11 @@ void UltrasonicServo::checkAndAct() {
     return;
   }
   
-  if (distance > 0 && distance < OBSTACLE_THRESHOLD) {
+  if (distance > 0 && distance < roverConfig.obstacleThreshold) {
     if (!obstacleDetected) {
-      Serial.println("⚠️ Object detected within 20cm. Taking action...");
+      Serial.print("⚠️ Object detected within ");
+      Serial.print(roverConfig.obstacleThreshold);
+      Serial.println("cm. Taking action...");
       obstacleDetected = true;
       lastActionTime = millis();
       
@@ -98,7 +115,7 @@ void UltrasonicServo::checkAndAct() {
       digitalWrite(motorIn2, LOW);
       myServo.write(90);
     }
-  } else if (distance >= OBSTACLE_THRESHOLD) {
+  } else if (distance >= roverConfig.obstacleThreshold) {
     obstacleDetected = false;
     
     // Ensure motor is stopped
@@ -124,15 +141,15 @@ bool UltrasonicServo::isSafeDistance() {
   return lastDistance >= SAFE_DISTANCE;
 }
 
-String UltrasonicServo::getDistanceStatus() {
+DistanceStatus UltrasonicServo::getDistanceStatus() {
   if (lastDistance < 0) {
-    return "ERROR";
-  } else if (lastDistance < OBSTACLE_THRESHOLD) {
-    return "DANGER";
+    return DISTANCE_ERROR;
+  } else if (lastDistance < roverConfig.obstacleThreshold) {
+    return DISTANCE_DANGER;
   } else if (lastDistance < WARNING_THRESHOLD) {
-    return "WARNING";
+    return DISTANCE_WARNING;
   } else {
-    return "SAFE";
+    return DISTANCE_SAFE;
   }
 }
 
@@ -188,3 +205,20 @@ void UltrasonicServo::reset() {
   obstacleDetected = false;
   lastActionTime = 0;
 }
+
+// Detached while parked so the servo stops drawing holding current
+void UltrasonicServo::setServoAttached(bool attached) {
+  if (attached && !myServo.attached()) {
+    myServo.attach(servoPin);
+    myServo.write(90);
+  } else if (!attached && myServo.attached()) {
+    myServo.detach();
+  }
+}
+
+// Points the sensor for the next reading; the planner sweeps it one sector per tick
+void UltrasonicServo::aimServo(int angle) {
+  if (myServo.attached()) myServo.write(constrain(angle, 0, 180));
+}
+
+#endif
@@ -5,6 +5,8 @@
 #include <Arduino.h>
 #include <Servo.h>
 #include "pin_config.h"
+#include "rover_status.h"
+#include "features.h"
 
 class UltrasonicServo {
   private:
@@ -14,8 +16,7 @@ class UltrasonicServo {
     int motorIn1, motorIn2;
     Servo myServo;
     
-    // Obstacle detection parameters
-    const int OBSTACLE_THRESHOLD = 20;  // cm
+    // Obstacle detection parameters; the obstacle threshold is roverConfig.obstacleThreshold
     const int WARNING_THRESHOLD = 50;   // cm
     const int SAFE_DISTANCE = 100;      // cm
     
@@ -33,17 +34,20 @@ class UltrasonicServo {
     UltrasonicServo(int trig, int echo, int servo, int motorIn1, int motorIn2);
     void begin();
     float getDistance();
+    static float echoToCentimeters(long duration);
     void checkAndAct();
     bool isObstacleDetected();
     bool isWarningDistance();
     bool isSafeDistance();
-    String getDistanceStatus();
+    DistanceStatus getDistanceStatus();
     float getLastDistance();
     void emergencyStop();
     void setObstacleThreshold(int threshold);
     void setMotorSpeed(int speed);
     void setRotationDuration(int duration);
     void reset();
+    void setServoAttached(bool attached);
+    void aimServo(int angle);
 };
 
 #endif
@@ -0,0 +1,35 @@
+/*
+ * WAN Connection Module for ToxiRover
+ * MQTT motor control via Adafruit IO with a Wi-Fi provisioning portal
+ *
+ * Features:
+ * - Adafruit IO feed subscriptions for drive commands
+ * - Credential portal (/setting) when no network is reachable, run as its own task
+ * - Non-blocking polling for use as a scheduler task
+ * - Status feed for the dashboard
+ * - Gas map feed, one changed tile per message
+ * - Binary telemetry frame feed
+ * - Feeds in a per-rover group, plus a shared fleet view feed
+ * - Compiles out with FEATURE_MQTT_WAN; portal alone with FEATURE_PROVISIONING
+ */
+
+#ifndef WAN_CONNECTION_H
+#define WAN_CONNECTION_H
+
+#include <Arduino.h>
+#include "features.h"
+
+// Function declarations
+void setupWAN();
+void loopWAN();
+bool publishWanStatus(const char* status);
+bool publishWanGasTile(const char* tile);
+bool publishWanTelemetry(const uint8_t* frame, size_t length);
+bool publishWanFleetView(const char* view);
+#if FEATURE_PROVISIONING
+void serviceWanPortal();
+void requestWanPortal();
+bool isWanPortalOpen();
+#endif
+
+#endif
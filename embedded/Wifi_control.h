@@ -0,0 +1,47 @@
+/*
+ * WiFi Motor Control Module for ToxiRover
+ * L298N drive over the local web remote (HTTP "State" commands)
+ *
+ * Features:
+ * - STA connection with AP fallback
+ * - Single-character drive, horn, light and speed commands
+ * - OTA firmware updates
+ * - Latest sample bus values as JSON on /samples
+ * - Web server and OTA compile out with FEATURE_HTTP_CONTROL / FEATURE_OTA
+ */
+
+#ifndef WIFI_CONTROL_H
+#define WIFI_CONTROL_H
+
+#include <Arduino.h>
+#include "features.h"
+
+// Drive speed state (restored from the config store)
+extern int SPEED;
+extern int speed_Coeff;
+
+// Function declarations
+void setupWiFi();
+void handleClient();
+void dispatchCommand(char command);
+#if FEATURE_HTTP_CONTROL
+void HTTP_handleRoot(void);
+void handleNotFound();
+#endif
+
+// Motor, horn and light actions
+void Forward();
+void Backward();
+void TurnRight();
+void TurnLeft();
+void ForwardLeft();
+void BackwardLeft();
+void ForwardRight();
+void BackwardRight();
+void Stop();
+void setDrive(int left, int right);
+void BeepHorn();
+void TurnLightOn();
+void TurnLightOff();
+
+#endif
@@ -0,0 +1,128 @@
+/*
+ * Alert Manager Implementation for ToxiRover
+ */
+
+#include "alert_manager.h"
+
+// Names match the alert types shown by the dashboard
+static const char* const ALERT_TYPE_NAMES[ALERT_TYPE_COUNT] = {
+  "HIGH_GAS_LEVEL",
+  "OBSTACLE_DETECTED",
+  "SYSTEM"
+};
+
+static const char* const ALERT_SEVERITY_NAMES[] = {
+  "INFO",
+  "WARNING",
+  "DANGER"
+};
+
+// Minimum time between coalesced updates of the same alert type
+static const unsigned long ALERT_MIN_INTERVAL[ALERT_TYPE_COUNT] = {
+  30000,  // gas
+  60000,  // obstacle
+  10000   // system
+};
+
+static AlertRecord alerts[ALERT_TYPE_COUNT];
+static AlertSink alertSink = NULL;
+
+AlertStats alertStats = {0, 0, 0};
+
+void setAlertSink(AlertSink sink) {
+  alertSink = sink;
+}
+
+static void deliverAlert(AlertRecord& alert, unsigned long now) {
+  alert.lastSent = now;
+  alert.pending = 0;
+  alertStats.sent++;
+
+  if (alertSink) alertSink(alert);
+}
+
+static void copyMessage(AlertRecord& alert, const char* message) {
+  strncpy(alert.message, message, ALERT_MESSAGE_SIZE - 1);
+  alert.message[ALERT_MESSAGE_SIZE - 1] = '\0';
+}
+
+AlertAction raiseAlert(AlertType type, AlertSeverity severity, float value, const char* message) {
+  AlertRecord& alert = alerts[type];
+  unsigned long now = millis();
+  alertStats.raised++;
+
+  if (!alert.active) {
+    alert.type = type;
+    alert.severity = severity;
+    alert.active = true;
+    alert.count = 1;
+    alert.firstSeen = now;
+    alert.lastSeen = now;
+    alert.peak = value;
+    copyMessage(alert, message);
+    deliverAlert(alert, now);
+    return ALERT_SENT_NEW;
+  }
+
+  alert.count++;
+  alert.pending++;
+  alert.lastSeen = now;
+  if (value > alert.peak) alert.peak = value;
+
+  // Escalations bypass the rate limit
+  if (severity > alert.severity) {
+    alert.severity = severity;
+    copyMessage(alert, message);
+    deliverAlert(alert, now);
+    return ALERT_SENT_ESCALATED;
+  }
+
+  if (now - alert.lastSent >= ALERT_MIN_INTERVAL[type]) {
+    deliverAlert(alert, now);
+    return ALERT_SENT_COALESCED;
+  }
+
+  alertStats.suppressed++;
+  return ALERT_SUPPRESSED;
+}
+
+void serviceAlerts() {
+  unsigned long now = millis();
+
+  for (int i = 0; i < ALERT_TYPE_COUNT; i++) {
+    AlertRecord& alert = alerts[i];
+    if (!alert.active || now - alert.lastSeen < ALERT_RESOLVE_TIMEOUT) continue;
+
+    // Final update so the record carries the full count and peak
+    if (alert.pending > 0) {
+      deliverAlert(alert, now);
+    }
+    alert.active = false;
+  }
+}
+
+const AlertRecord& getAlert(AlertType type) {
+  return alerts[type];
+}
+
+const char* getAlertTypeName(AlertType type) {
+  return ALERT_TYPE_NAMES[type];
+}
+
+const char* getAlertSeverityName(AlertSeverity severity) {
+  return ALERT_SEVERITY_NAMES[severity];
+}
+
+AlertType getAlertTypeByName(const char* name) {
+  for (int i = 0; i < ALERT_TYPE_COUNT; i++) {
+    if (strcmp(name, ALERT_TYPE_NAMES[i]) == 0) return (AlertType)i;
+  }
+  return ALERT_SYSTEM;
+}
+
+void printAlertStats() {
+  Serial.println("🚨 Alert manager:");
+  Serial.print("  Raised: "); Serial.println(alertStats.raised);
+  Serial.print("  Sent: "); Serial.println(alertStats.sent);
+  Serial.print("  Suppressed: "); Serial.println(alertStats.suppressed);
+}
@@ -0,0 +1,77 @@
+/*
+ * Alert Manager for ToxiRover
+ * Deduplication, coalescing and rate limiting of alerts
+ *
+ * Features:
+ * - One active alert per type; repeats fold into count/first/last/peak
+ * - Per-type minimum interval between coalesced updates
+ * - Severity escalations are always sent immediately
+ * - Alerts resolve after a quiet period, flushing pending repeats
+ */
+
+#ifndef ALERT_MANAGER_H
+#define ALERT_MANAGER_H
+
+#include <Arduino.h>
+
+// Alert becomes resolved after this long without a repeat
+#define ALERT_RESOLVE_TIMEOUT 10000  // 10 seconds
+
+#define ALERT_MESSAGE_SIZE 48
+
+enum AlertType {
+  ALERT_HIGH_GAS,
+  ALERT_OBSTACLE,
+  ALERT_SYSTEM,
+  ALERT_TYPE_COUNT
+};
+
+enum AlertSeverity {
+  SEVERITY_INFO,
+  SEVERITY_WARNING,
+  SEVERITY_DANGER
+};
+
+// Outcome of raiseAlert()
+enum AlertAction {
+  ALERT_SENT_NEW,        // first occurrence, sent
+  ALERT_SENT_ESCALATED,  // severity increased, sent immediately
+  ALERT_SENT_COALESCED,  // repeats flushed as one update
+  ALERT_SUPPRESSED       // folded into the active alert, not sent yet
+};
+
+struct AlertRecord {
+  AlertType type;
+  AlertSeverity severity;
+  bool active;
+  unsigned long count;
+  unsigned long firstSeen;
+  unsigned long lastSeen;
+  unsigned long lastSent;
+  unsigned long pending;  // repeats since lastSent
+  float peak;
+  char message[ALERT_MESSAGE_SIZE];
+};
+
+struct AlertStats {
+  unsigned long raised;
+  unsigned long sent;
+  unsigned long suppressed;
+};
+
+// Delivers an alert record (new or updated); same record id for one episode
+typedef void (*AlertSink)(const AlertRecord& alert);
+
+extern AlertStats alertStats;
+
+// Function declarations
+void setAlertSink(AlertSink sink);
+AlertAction raiseAlert(AlertType type, AlertSeverity severity, float value, const char* message);
+void serviceAlerts();
+const AlertRecord& getAlert(AlertType type);
+const char* getAlertTypeName(AlertType type);
+const char* getAlertSeverityName(AlertSeverity severity);
+AlertType getAlertTypeByName(const char* name);
+void printAlertStats();
+
+#endif
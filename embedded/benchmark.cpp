@@ -0,0 +1,48 @@
+/*
+ * Microbenchmark Harness Implementation for ToxiRover
+ */
+
+#include "benchmark.h"
+
+#if BENCHMARK_ENABLED
+
+BenchmarkResult runBenchmark(const char* name, BenchmarkOp op, unsigned long iterations) {
+  for (int i = 0; i < BENCHMARK_WARMUP; i++) op();
+
+  uint32_t heapBefore = ESP.getFreeHeap();
+  uint64_t cycles = 0;
+  unsigned long done = 0;
+
+  while (done < iterations) {
+    unsigned long batch = min((unsigned long)BENCHMARK_BATCH, iterations - done);
+
+    uint32_t start = ESP.getCycleCount();
+    for (unsigned long i = 0; i < batch; i++) op();
+    cycles += ESP.getCycleCount() - start;
+
+    done += batch;
+    yield();  // outside the timed region
+  }
+
+  BenchmarkResult result;
+  result.name = name;
+  result.iterations = iterations;
+  result.nsPerOp = (unsigned long)(cycles * 1000 / (F_CPU / 1000000) / iterations);
+  result.heapBytesPerOp = ((long)heapBefore - (long)ESP.getFreeHeap()) / (long)iterations;
+  result.heapFragmentation = ESP.getHeapFragmentation();
+  return result;
+}
+
+void printBenchmarkHeader() {
+  Serial.println("BENCH,name,iterations,ns_per_op,heap_bytes_per_op,heap_frag_pct");
+}
+
+void printBenchmarkResult(const BenchmarkResult& result) {
+  Serial.print("BENCH,"); Serial.print(result.name);
+  Serial.print(","); Serial.print(result.iterations);
+  Serial.print(","); Serial.print(result.nsPerOp);
+  Serial.print(","); Serial.print(result.heapBytesPerOp);
+  Serial.print(","); Serial.println(result.heapFragmentation);
+}
+
+#endif
@@ -0,0 +1,43 @@
+/*
+ * Microbenchmark Harness for ToxiRover
+ * Times firmware hot paths on the device and reports machine-readable results
+ *
+ * Features:
+ * - Warm-up, then timed batches with watchdog yields between them
+ * - ns/op from the CPU clock, heap bytes/op from free-heap deltas
+ * - CSV lines over Serial ("BENCH,...") for diffing between releases
+ * - Compiles out to nothing unless BENCHMARK_ENABLED is 1
+ */
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <Arduino.h>
+
+#ifndef BENCHMARK_ENABLED
+#define BENCHMARK_ENABLED 0  // build with -DBENCHMARK_ENABLED=1 to run at boot
+#endif
+
+#define BENCHMARK_WARMUP 16
+#define BENCHMARK_BATCH 256   // ops between watchdog yields
+
+#if BENCHMARK_ENABLED
+
+typedef void (*BenchmarkOp)();
+
+struct BenchmarkResult {
+  const char* name;
+  unsigned long iterations;
+  unsigned long nsPerOp;
+  long heapBytesPerOp;      // free-heap drop per op; nonzero means the path allocates and keeps memory
+  uint32_t heapFragmentation;
+};
+
+// Function declarations
+BenchmarkResult runBenchmark(const char* name, BenchmarkOp op, unsigned long iterations);
+void printBenchmarkHeader();
+void printBenchmarkResult(const BenchmarkResult& result);
+
+#endif
+
+#endif
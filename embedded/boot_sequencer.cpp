@@ -0,0 +1,179 @@
+/*
+ * Boot Sequencer Implementation for ToxiRover
+ */
+
+#include <ESP8266WiFi.h>
+#include "boot_sequencer.h"
+#include "config_store.h"
+#include "task_scheduler.h"
+
+WarmState warmState;
+
+static bool warmBoot = false;
+static unsigned long milestones[BOOT_MILESTONE_COUNT];
+
+static const char* const MILESTONE_NAMES[BOOT_MILESTONE_COUNT] = {
+  "sensors_ready", "first_sample", "network_up", "first_upload"
+};
+
+// Network bring-up
+static char staSsid[CONFIG_SSID_SIZE];
+static char staPassword[CONFIG_PASS_SIZE];
+static bool networkStarted = false;
+static bool networkUp = false;
+static bool usingCachedChannel = false;
+static unsigned long networkStartedAt = 0;
+
+static NetworkUpHandler networkHandlers[NETWORK_MAX_HANDLERS];
+static int networkHandlerCount = 0;
+
+static uint32_t warmStateCrc(const WarmState& state) {
+  return configCrc32((const uint8_t*)&state, offsetof(WarmState, crc));
+}
+
+void initBootSequencer() {
+  // RTC memory holds garbage after power-on; any other reset keeps it
+  bool retained = ESP.getResetInfoPtr()->reason != REASON_DEFAULT_RST;
+
+  if (retained &&
+      ESP.rtcUserMemoryRead(WARM_STATE_RTC_OFFSET, (uint32_t*)&warmState, sizeof(warmState)) &&
+      warmState.magic == WARM_STATE_MAGIC && warmState.crc == warmStateCrc(warmState)) {
+    warmBoot = true;
+    warmState.bootCount++;
+  } else {
+    memset(&warmState, 0, sizeof(warmState));
+    warmState.magic = WARM_STATE_MAGIC;
+    warmState.servoAngle = 90;
+  }
+  saveWarmState();
+
+  if (warmBoot) {
+    Serial.print("♨️ Warm restart #"); Serial.print(warmState.bootCount);
+    Serial.print(" ("); Serial.print(ESP.getResetReason()); Serial.println(")");
+  } else {
+    Serial.println("❄️ Cold boot");
+  }
+}
+
+bool isWarmBoot() {
+  return warmBoot;
+}
+
+// RTC writes don't wear flash, so callers save on every change
+void saveWarmState() {
+  warmState.crc = warmStateCrc(warmState);
+  ESP.rtcUserMemoryWrite(WARM_STATE_RTC_OFFSET, (uint32_t*)&warmState, sizeof(warmState));
+}
+
+void markBootMilestone(BootMilestone milestone) {
+  if (milestones[milestone] != 0) return;
+  milestones[milestone] = max(millis(), 1UL);
+
+  Serial.print("⏱️ Boot "); Serial.print(MILESTONE_NAMES[milestone]);
+  Serial.print(" at "); Serial.print(milestones[milestone]); Serial.println(" ms");
+
+  // One machine-readable line once the whole path has been timed
+  if (milestone == BOOT_FIRST_UPLOAD) {
+    Serial.print("BOOT,warm="); Serial.print(warmBoot ? 1 : 0);
+    for (int i = 0; i < BOOT_MILESTONE_COUNT; i++) {
+      Serial.print(","); Serial.print(MILESTONE_NAMES[i]);
+      Serial.print("="); Serial.print(milestones[i]);
+    }
+    Serial.println();
+  }
+}
+
+unsigned long getBootMilestone(BootMilestone milestone) {
+  return milestones[milestone];
+}
+
+// Starts association and returns; serviceNetwork() finishes it from the scheduler
+void beginNetwork(const char* ssid, const char* password) {
+  strlcpy(staSsid, ssid, sizeof(staSsid));
+  strlcpy(staPassword, password, sizeof(staPassword));
+
+  WiFi.persistent(false);  // credentials come from the config store; skip the SDK flash write
+  WiFi.mode(WIFI_STA);
+
+  // A warm restart already knows the channel and AP, which skips the full scan
+  usingCachedChannel = warmBoot && warmState.wifiChannel != 0;
+  if (usingCachedChannel) {
+    WiFi.begin(staSsid, staPassword, warmState.wifiChannel, warmState.bssid);
+  } else {
+    WiFi.begin(staSsid, staPassword);
+  }
+
+  networkStartedAt = millis();
+  networkUp = false;
+
+  if (!networkStarted) {
+    addPeriodicTask("network", serviceNetwork, NETWORK_POLL_INTERVAL, PRIORITY_NORMAL);
+    networkStarted = true;
+  }
+
+  Serial.print("📡 Connecting to: "); Serial.print(staSsid);
+  Serial.println(usingCachedChannel ? " (cached channel)" : "");
+}
+
+void serviceNetwork() {
+  if (WiFi.status() == WL_CONNECTED) {
+    if (networkUp) return;
+    networkUp = true;
+
+    warmState.wifiChannel = WiFi.channel();
+    memcpy(warmState.bssid, WiFi.BSSID(), sizeof(warmState.bssid));
+    saveWarmState();
+
+    markBootMilestone(BOOT_NETWORK_UP);
+    Serial.print("📶 IP Address: ");
+    Serial.println(WiFi.localIP());
+
+    for (int i = 0; i < networkHandlerCount; i++) networkHandlers[i]();
+    return;
+  }
+
+  if (networkUp) {
+    networkUp = false;
+    Serial.println("⚠️ Wi-Fi link lost");
+  }
+
+  // The AP moved or changed channel: forget the hint and scan
+  if (usingCachedChannel && millis() - networkStartedAt > NETWORK_FAST_CONNECT_TIMEOUT) {
+    usingCachedChannel = false;
+    warmState.wifiChannel = 0;
+    saveWarmState();
+    WiFi.begin(staSsid, staPassword);
+    Serial.println("📡 Cached channel failed, scanning");
+  }
+}
+
+bool isNetworkUp() {
+  return networkUp;
+}
+
+// Association still inside its window; fallbacks should wait until this is false
+bool isNetworkPending() {
+  return networkStarted && !networkUp && millis() - networkStartedAt < NETWORK_CONNECT_TIMEOUT;
+}
+
+// Handlers run every time the link comes (back) up
+void addNetworkUpHandler(NetworkUpHandler handler) {
+  if (networkHandlerCount >= NETWORK_MAX_HANDLERS) return;
+  networkHandlers[networkHandlerCount++] = handler;
+}
+
+void printBootStats() {
+  Serial.println("🥾 Boot:");
+  Serial.print("  Type: "); Serial.print(warmBoot ? "warm #" : "cold");
+  if (warmBoot) Serial.print(warmState.bootCount);
+  Serial.print("  Reset: "); Serial.println(ESP.getResetReason());
+
+  for (int i = 0; i < BOOT_MILESTONE_COUNT; i++) {
+    Serial.print("  "); Serial.print(MILESTONE_NAMES[i]); Serial.print(": ");
+    if (milestones[i] == 0) Serial.println("pending");
+    else { Serial.print(milestones[i]); Serial.println(" ms"); }
+  }
+
+  Serial.print("  Wi-Fi: "); Serial.print(networkUp ? "up" : "down");
+  Serial.print("  Channel: "); Serial.println(warmState.wifiChannel);
+}
@@ -0,0 +1,69 @@
+/*
+ * Boot Sequencer for ToxiRover
+ * Sensors first, network in the background, warm restarts from RTC memory
+ *
+ * Features:
+ * - Non-blocking STA bring-up polled as a scheduler task
+ * - Warm-restart record in RTC memory (last commands, Wi-Fi channel/BSSID)
+ * - Fast reconnect by reusing the cached channel and BSSID
+ * - Boot milestone timing (first sample, network up, first upload)
+ */
+
+#ifndef BOOT_SEQUENCER_H
+#define BOOT_SEQUENCER_H
+
+#include <Arduino.h>
+
+#define SERIAL_BAUD 115200
+
+// RTC user memory: the first 128 bytes are left to the OTA bootloader command
+#define WARM_STATE_RTC_OFFSET 32        // in 4-byte blocks
+#define WARM_STATE_MAGIC 0x4D524157UL   // "WARM"
+
+#define NETWORK_POLL_INTERVAL 100       // ms between association checks
+#define NETWORK_FAST_CONNECT_TIMEOUT 3000 // cached channel/BSSID attempt before a full scan
+#define NETWORK_CONNECT_TIMEOUT 10000   // association window before fallbacks (AP, portal) kick in
+#define NETWORK_MAX_HANDLERS 4
+
+// Survives resets but not power loss; calibration and thresholds live in the config store
+struct WarmState {
+  uint32_t magic;
+  uint32_t bootCount;     // consecutive warm restarts
+  uint8_t wifiChannel;    // 0 = unknown
+  uint8_t bssid[6];
+  uint8_t lastMotion;     // MotionCommand
+  int16_t servoAngle;
+  int16_t motorSpeed;
+  uint8_t speedCoeff;
+  char lastDriveCommand;  // last WiFi remote command character
+  uint16_t reserved;
+  uint32_t crc;
+};
+
+enum BootMilestone {
+  BOOT_SENSORS_READY,
+  BOOT_FIRST_SAMPLE,
+  BOOT_NETWORK_UP,
+  BOOT_FIRST_UPLOAD,
+  BOOT_MILESTONE_COUNT
+};
+
+typedef void (*NetworkUpHandler)();
+
+// Warm state (valid after initBootSequencer())
+extern WarmState warmState;
+
+// Function declarations
+void initBootSequencer();
+bool isWarmBoot();
+void saveWarmState();
+void markBootMilestone(BootMilestone milestone);
+unsigned long getBootMilestone(BootMilestone milestone);
+void beginNetwork(const char* ssid, const char* password);
+void serviceNetwork();
+bool isNetworkUp();
+bool isNetworkPending();
+void addNetworkUpHandler(NetworkUpHandler handler);
+void printBootStats();
+
+#endif
@@ -0,0 +1,164 @@
+/*
+ * Persistent Configuration Store Implementation for ToxiRover
+ */
+
+#include <EEPROM.h>
+#include "config_store.h"
+#include "gas_sensor.h"
+#include "ultrasonic.h"
+
+// Global configuration
+RoverConfig roverConfig;
+
+// Copy of what is currently in EEPROM, used to skip no-op commits
+static RoverConfig storedConfig;
+static bool configInitialized = false;
+static ConfigLoadResult lastLoadResult = CONFIG_DEFAULTS;
+
+uint32_t configCrc32(const uint8_t* data, size_t length) {
+  uint32_t crc = 0xFFFFFFFFUL;
+  for (size_t i = 0; i < length; i++) {
+    crc ^= data[i];
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc >> 1) ^ (0xEDB88320UL & (0UL - (crc & 1)));
+    }
+  }
+  return ~crc;
+}
+
+static uint32_t recordCrc(const RoverConfig& config) {
+  return configCrc32((const uint8_t*)&config, offsetof(RoverConfig, crc));
+}
+
+void resetConfigToDefaults() {
+  memset(&roverConfig, 0, sizeof(roverConfig));
+  roverConfig.magic = CONFIG_MAGIC;
+  roverConfig.version = CONFIG_VERSION;
+  roverConfig.length = sizeof(RoverConfig);
+
+  roverConfig.gasDangerThreshold = GAS_DANGER_THRESHOLD;
+  roverConfig.gasWarningThreshold = GAS_WARNING_THRESHOLD;
+  roverConfig.gasSafeThreshold = GAS_SAFE_THRESHOLD;
+  roverConfig.gasPpmPerCount = 2.0;
+  roverConfig.gasBaseline = 0;
+  roverConfig.obstacleThreshold = OBSTACLE_THRESHOLD;
+  roverConfig.motorSpeed = CONFIG_DEFAULT_SPEED;
+  roverConfig.speedCoeff = CONFIG_DEFAULT_SPEED_COEFF;
+}
+
+static bool isValidRecord(const RoverConfig& config) {
+  return config.magic == CONFIG_MAGIC &&
+         config.version == CONFIG_VERSION &&
+         config.length == sizeof(RoverConfig) &&
+         config.crc == recordCrc(config);
+}
+
+// Copy a legacy NUL-padded field, rejecting erased (0xFF) or non-printable data
+static bool readLegacyString(int address, int length, char* out) {
+  int n = 0;
+  for (; n < length; n++) {
+    uint8_t c = EEPROM.read(address + n);
+    if (c == 0) break;
+    if (c < 0x20 || c > 0x7E) return false;
+    out[n] = (char)c;
+  }
+  out[n] = '\0';
+  return true;
+}
+
+static bool migrateLegacyCredentials() {
+  char ssid[CONFIG_SSID_SIZE];
+  char password[CONFIG_PASS_SIZE];
+
+  if (!readLegacyString(LEGACY_SSID_ADDR, LEGACY_SSID_LEN, ssid) || ssid[0] == '\0') {
+    return false;
+  }
+  if (!readLegacyString(LEGACY_PASS_ADDR, LEGACY_PASS_LEN, password)) {
+    return false;
+  }
+
+  resetConfigToDefaults();
+  strcpy(roverConfig.ssid, ssid);
+  strcpy(roverConfig.password, password);
+  return true;
+}
+
+static ConfigLoadResult loadConfig() {
+  // Single block read of the whole record
+  EEPROM.get(CONFIG_EEPROM_ADDR, roverConfig);
+
+  if (isValidRecord(roverConfig)) {
+    // Guard against unterminated strings even in a CRC-valid record
+    roverConfig.ssid[CONFIG_SSID_SIZE - 1] = '\0';
+    roverConfig.password[CONFIG_PASS_SIZE - 1] = '\0';
+    storedConfig = roverConfig;
+    Serial.println("💾 Configuration loaded from EEPROM");
+    return CONFIG_LOADED;
+  }
+
+  // Invalid record: mark stored copy as unknown so the next save commits
+  memset(&storedConfig, 0xFF, sizeof(storedConfig));
+
+  if (migrateLegacyCredentials()) {
+    Serial.println("💾 Migrated legacy Wi-Fi credentials to config record");
+    saveConfig();
+    return CONFIG_MIGRATED;
+  }
+
+  Serial.println("⚠️ No valid configuration found, using defaults");
+  resetConfigToDefaults();
+  return CONFIG_DEFAULTS;
+}
+
+ConfigLoadResult initConfigStore() {
+  // Several modules depend on the config; only the first caller loads it
+  if (configInitialized) {
+    return lastLoadResult;
+  }
+
+  EEPROM.begin(CONFIG_EEPROM_SIZE);
+  lastLoadResult = loadConfig();
+  configInitialized = true;
+  return lastLoadResult;
+}
+
+bool saveConfig() {
+  roverConfig.magic = CONFIG_MAGIC;
+  roverConfig.version = CONFIG_VERSION;
+  roverConfig.length = sizeof(RoverConfig);
+  roverConfig.crc = recordCrc(roverConfig);
+
+  // Skip the flash erase/write cycle if nothing changed
+  if (memcmp(&roverConfig, &storedConfig, sizeof(RoverConfig)) == 0) {
+    return true;
+  }
+
+  EEPROM.put(CONFIG_EEPROM_ADDR, roverConfig);
+  if (!EEPROM.commit()) {
+    Serial.println("❌ Failed to commit configuration to EEPROM");
+    return false;
+  }
+
+  storedConfig = roverConfig;
+  Serial.println("💾 Configuration saved");
+  return true;
+}
+
+bool hasWiFiCredentials() {
+  return roverConfig.ssid[0] != '\0';
+}
+
+bool setWiFiCredentials(const char* ssid, const char* password) {
+  size_t ssidLength = strlen(ssid);
+  size_t passLength = strlen(password);
+
+  if (ssidLength == 0 || ssidLength >= CONFIG_SSID_SIZE || passLength >= CONFIG_PASS_SIZE) {
+    return false;
+  }
+
+  memset(roverConfig.ssid, 0, sizeof(roverConfig.ssid));
+  memset(roverConfig.password, 0, sizeof(roverConfig.password));
+  memcpy(roverConfig.ssid, ssid, ssidLength);
+  memcpy(roverConfig.password, password, passLength);
+  return true;
+}
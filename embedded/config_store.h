@@ -0,0 +1,85 @@
+/*
+ * Persistent Configuration Store for ToxiRover
+ * Versioned, CRC-protected EEPROM record
+ *
+ * Features:
+ * - Single block read/write of the whole configuration
+ * - Magic, version, length and CRC32 validated in one pass
+ * - Commit-on-change to limit flash sector wear
+ * - One-time import of the legacy raw SSID/password layout
+ */
+
+#ifndef CONFIG_STORE_H
+#define CONFIG_STORE_H
+
+#include <Arduino.h>
+
+// EEPROM layout
+#define CONFIG_EEPROM_SIZE 512
+#define CONFIG_EEPROM_ADDR 0
+#define CONFIG_MAGIC 0x564F5254UL  // "TROV"
+#define CONFIG_VERSION 1
+
+// Legacy layout used by the provisioning portal before the config record
+#define LEGACY_SSID_ADDR 0
+#define LEGACY_SSID_LEN 32
+#define LEGACY_PASS_ADDR 32
+#define LEGACY_PASS_LEN 64
+
+// Credential buffer sizes (802.11 limits plus NUL)
+#define CONFIG_SSID_SIZE 33
+#define CONFIG_PASS_SIZE 65
+
+// Drive defaults; thresholds default to the sensor headers' constants
+#define CONFIG_DEFAULT_SPEED 122       // web remote '5'
+#define CONFIG_DEFAULT_SPEED_COEFF 3   // arc turns run the inner wheel at SPEED / coeff
+
+// Result of the last load
+enum ConfigLoadResult {
+  CONFIG_LOADED,
+  CONFIG_MIGRATED,
+  CONFIG_DEFAULTS
+};
+
+// Stored configuration record. Only append fields and bump CONFIG_VERSION.
+struct RoverConfig {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t length;
+
+  // Wi-Fi credentials
+  char ssid[CONFIG_SSID_SIZE];
+  char password[CONFIG_PASS_SIZE];
+
+  // Gas thresholds (ppm)
+  float gasDangerThreshold;
+  float gasWarningThreshold;
+  float gasSafeThreshold;
+
+  // Gas calibration
+  float gasPpmPerCount;
+  int16_t gasBaseline;
+
+  // Obstacle avoidance (cm)
+  int16_t obstacleThreshold;
+
+  // Motor speeds
+  int16_t motorSpeed;
+  uint8_t speedCoeff;
+  uint8_t reserved;
+
+  uint32_t crc;
+};
+
+// Global configuration (valid after initConfigStore())
+extern RoverConfig roverConfig;
+
+// Function declarations
+ConfigLoadResult initConfigStore();
+bool saveConfig();
+void resetConfigToDefaults();
+bool hasWiFiCredentials();
+bool setWiFiCredentials(const char* ssid, const char* password);
+uint32_t configCrc32(const uint8_t* data, size_t length);
+
+#endif
@@ -0,0 +1,87 @@
+/*
+ * Dead Reckoning Implementation for ToxiRover
+ */
+
+#include "dead_reckoning.h"
+
+static Pose livePose = {0, 0, 0};
+static int wheelLeft = 0;
+static int wheelRight = 0;
+static unsigned long lastUpdate = 0;
+static float odometerCm = 0;
+static unsigned long wheelCommands = 0;
+
+// Midpoint heading per step keeps arcs accurate without trig per sub-step
+void poseIntegrate(Pose& pose, int left, int right, unsigned long ms) {
+  if (left == 0 && right == 0) return;
+  float vl = left * DR_CM_PER_PWM, vr = right * DR_CM_PER_PWM;
+  float v = (vl + vr) / 2;
+  float w = (vr - vl) / DR_WHEELBASE;
+
+  while (ms > 0) {
+    unsigned long step = min(ms, (unsigned long)DR_STEP_MS);
+    float dt = step / 1000.0f;
+    float mid = pose.heading + w * dt / 2;
+    pose.x += v * cosf(mid) * dt;
+    pose.y += v * sinf(mid) * dt;
+    pose.heading += w * dt;
+    ms -= step;
+  }
+
+  // Keep heading in (-pi, pi] so it stays precise over long runs
+  while (pose.heading > PI) pose.heading -= TWO_PI;
+  while (pose.heading <= -PI) pose.heading += TWO_PI;
+}
+
+static void advancePose() {
+  unsigned long now = millis();
+  unsigned long elapsed = now - lastUpdate;
+  lastUpdate = now;
+  if (elapsed == 0) return;
+
+  poseIntegrate(livePose, wheelLeft, wheelRight, elapsed);
+  odometerCm += (abs(wheelLeft) + abs(wheelRight)) / 2.0f * DR_CM_PER_PWM * elapsed / 1000.0f;
+}
+
+// Called with the values just written to the motor driver; positive is forward
+void noteWheelCommand(int left, int right) {
+  advancePose();
+  wheelLeft = constrain(left, -1023, 1023);
+  wheelRight = constrain(right, -1023, 1023);
+  wheelCommands++;
+}
+
+Pose getPose() {
+  advancePose();
+  return livePose;
+}
+
+// Coarse motion for status; arcs count as the way the rover mostly goes
+MotionCommand getWheelMotion() {
+  if (wheelLeft == 0 && wheelRight == 0) return MOTION_STOP;
+  if (wheelLeft > 0 && wheelRight > 0) return MOTION_FORWARD;
+  if (wheelLeft < 0 && wheelRight < 0) return MOTION_BACKWARD;
+  return wheelRight > wheelLeft ? MOTION_LEFT : MOTION_RIGHT;
+}
+
+float getOdometerCm() {
+  advancePose();
+  return odometerCm;
+}
+
+void resetPose() {
+  advancePose();
+  livePose.x = 0;
+  livePose.y = 0;
+  livePose.heading = 0;
+}
+
+void printPoseStats() {
+  Pose pose = getPose();
+  Serial.println("🧭 Dead reckoning:");
+  Serial.print("  Pose: ("); Serial.print(pose.x, 0); Serial.print(", ");
+  Serial.print(pose.y, 0); Serial.print(") cm, ");
+  Serial.print(pose.heading * RAD_TO_DEG, 0); Serial.println("°");
+  Serial.print("  Odometer: "); Serial.print(odometerCm / 100.0f, 1); Serial.print(" m");
+  Serial.print("  Wheel commands: "); Serial.println(wheelCommands);
+}
@@ -0,0 +1,38 @@
+/*
+ * Dead Reckoning for ToxiRover
+ * Estimates the rover's pose from commanded wheel speeds and time
+ *
+ * Features:
+ * - Integrates signed per-wheel PWM as a differential drive
+ * - Every drive path (web remote, MQTT, planner) reports what it commands
+ * - Pose and odometer on demand, no periodic task needed
+ * - Open loop: no encoders, so error grows with distance and wheel slip
+ */
+
+#ifndef DEAD_RECKONING_H
+#define DEAD_RECKONING_H
+
+#include <Arduino.h>
+#include "rover_status.h"
+
+#define DR_CM_PER_PWM 0.06f       // cm/s per PWM count (1023 = ~60 cm/s); calibrate per rover
+#define DR_WHEELBASE 14           // cm between the wheel contact lines
+#define DR_STEP_MS 50             // integration step; long commands are split into these
+
+// Origin is where the rover booted (or was last reset), facing +x
+struct Pose {
+  float x;                        // cm
+  float y;                        // cm, positive to the rover's starting left
+  float heading;                  // radians, counter-clockwise
+};
+
+// Function declarations
+void poseIntegrate(Pose& pose, int left, int right, unsigned long ms);
+void noteWheelCommand(int left, int right);
+Pose getPose();
+MotionCommand getWheelMotion();
+float getOdometerCm();
+void resetPose();
+void printPoseStats();
+
+#endif
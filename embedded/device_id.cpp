@@ -0,0 +1,45 @@
+/*
+ * Device Identity Implementation for ToxiRover
+ */
+
+#include "device_id.h"
+
+uint32_t getDeviceChipId() {
+  return ESP.getChipId();
+}
+
+// Lowercase hex, zero-padded to 6 digits; Adafruit IO feed keys must be lowercase
+const char* getDeviceId() {
+  static char id[DEVICE_ID_SIZE] = "";
+  if (id[0] == '\0') snprintf(id, sizeof(id), "%06lx", (unsigned long)getDeviceChipId());
+  return id;
+}
+
+const char* getDeviceHostname() {
+  static char name[DEVICE_NAME_SIZE] = "";
+  if (name[0] == '\0') snprintf(name, sizeof(name), DEVICE_HOSTNAME_PREFIX "%s", getDeviceId());
+  return name;
+}
+
+// RTDB path under this rover's subtree. The result lives in a shared buffer
+// that is only valid until the next call, so pass it straight to the request.
+const char* roverPath(const char* path) {
+#if FLEET_NAMESPACE
+  static char buffer[DEVICE_PATH_SIZE];
+  if (strcmp(path, "/") == 0) path = "";
+  snprintf(buffer, sizeof(buffer), DEVICE_ROOT "%s%s", getDeviceId(), path);
+  return buffer;
+#else
+  return path;
+#endif
+}
+
+// "<user>/f/rover-<id>.<feed>": one Adafruit IO group per rover
+const char* formatDeviceFeed(char* topic, size_t size, const char* user, const char* feed) {
+#if FLEET_NAMESPACE
+  snprintf(topic, size, "%s/f/" DEVICE_FEED_GROUP_PREFIX "%s.%s", user, getDeviceId(), feed);
+#else
+  snprintf(topic, size, "%s/f/%s", user, feed);
+#endif
+  return topic;
+}
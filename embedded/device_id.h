@@ -0,0 +1,35 @@
+/*
+ * Device Identity for ToxiRover
+ * Per-rover names so several rovers can share one backend
+ *
+ * Features:
+ * - Stable device id from the ESP8266 chip ID
+ * - Hostname / AP name and MQTT client id derived from it
+ * - Firebase paths under /rovers/<id>, MQTT feeds in a rover-<id> group
+ * - FLEET_NAMESPACE=0 keeps the single-rover root layout
+ */
+
+#ifndef DEVICE_ID_H
+#define DEVICE_ID_H
+
+#include <Arduino.h>
+
+#ifndef FLEET_NAMESPACE
+#define FLEET_NAMESPACE 1  // build with -DFLEET_NAMESPACE=0 for the old global paths
+#endif
+
+#define DEVICE_ID_SIZE 9              // chip ID as hex, up to 8 digits
+#define DEVICE_NAME_SIZE 24
+#define DEVICE_PATH_SIZE 96
+#define DEVICE_ROOT "/rovers/"
+#define DEVICE_HOSTNAME_PREFIX "ToxiRover-"
+#define DEVICE_FEED_GROUP_PREFIX "rover-"
+
+// Function declarations
+uint32_t getDeviceChipId();
+const char* getDeviceId();
+const char* getDeviceHostname();
+const char* roverPath(const char* path);
+const char* formatDeviceFeed(char* topic, size_t size, const char* user, const char* feed);
+
+#endif
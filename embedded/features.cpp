@@ -0,0 +1,34 @@
+/*
+ * Feature Selection Implementation for ToxiRover
+ */
+
+#include <Arduino.h>
+#include "features.h"
+
+static void printFeature(const char* name, bool enabled) {
+  Serial.print("  ");
+  Serial.print(enabled ? "✅ " : "➖ ");
+  Serial.println(name);
+}
+
+// One line per configuration so boot logs from different builds can be compared
+void printFeatureReport() {
+  Serial.println("🧩 Features:");
+  printFeature("HTTP control", FEATURE_HTTP_CONTROL);
+  printFeature("MQTT/WAN", FEATURE_MQTT_WAN);
+  printFeature("Firebase", FEATURE_FIREBASE);
+  printFeature("OTA", FEATURE_OTA);
+  printFeature("UltrasonicServo", FEATURE_ULTRASONIC_SERVO);
+  printFeature("Provisioning portal", FEATURE_PROVISIONING);
+  printFeature("Fleet gateway", FEATURE_FLEET_GATEWAY);
+
+  Serial.print("FEATURES,preset="); Serial.print(FEATURE_PRESET);
+  Serial.print(",mask=0x");
+  Serial.print((FEATURE_HTTP_CONTROL << 0) | (FEATURE_MQTT_WAN << 1) | (FEATURE_FIREBASE << 2) |
+               (FEATURE_OTA << 3) | (FEATURE_ULTRASONIC_SERVO << 4) | (FEATURE_PROVISIONING << 5) |
+               (FEATURE_FLEET_GATEWAY << 6), HEX);
+  Serial.print(",sketch="); Serial.print(ESP.getSketchSize());
+  Serial.print(",free_sketch="); Serial.print(ESP.getFreeSketchSpace());
+  Serial.print(",free_heap="); Serial.print(ESP.getFreeHeap());
+  Serial.print(",init_ms="); Serial.println(millis());
+}
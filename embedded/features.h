@@ -0,0 +1,135 @@
+/*
+ * Feature Selection for ToxiRover
+ * Compile-time switches that strip unused subsystems from the image
+ *
+ * Features:
+ * - One switch per subsystem; a disabled subsystem is not compiled or initialized
+ * - Role presets pick a sensible set for each deployment
+ * - Invalid combinations fail at compile time
+ * - Boot report of enabled features, image size and free heap
+ */
+
+#ifndef FEATURES_H
+#define FEATURES_H
+
+// ========================================
+// ROLE PRESETS
+// ========================================
+// Build with -DFEATURE_PRESET=<n>; individual -DFEATURE_X=0/1 flags still override
+
+#define FEATURE_PRESET_FULL 0    // everything (default)
+#define FEATURE_PRESET_LOCAL 1   // HTTP remote + OTA + obstacle servo, no cloud
+#define FEATURE_PRESET_WAN 2     // MQTT drive + provisioning portal
+#define FEATURE_PRESET_CLOUD 3   // Firebase telemetry and commands only
+
+#ifndef FEATURE_PRESET
+#define FEATURE_PRESET FEATURE_PRESET_FULL
+#endif
+
+#if FEATURE_PRESET == FEATURE_PRESET_FULL
+#define FEATURE_DEFAULT_HTTP 1
+#define FEATURE_DEFAULT_MQTT 1
+#define FEATURE_DEFAULT_FIREBASE 1
+#define FEATURE_DEFAULT_OTA 1
+#define FEATURE_DEFAULT_SERVO 1
+#define FEATURE_DEFAULT_PORTAL 1
+#elif FEATURE_PRESET == FEATURE_PRESET_LOCAL
+#define FEATURE_DEFAULT_HTTP 1
+#define FEATURE_DEFAULT_MQTT 0
+#define FEATURE_DEFAULT_FIREBASE 0
+#define FEATURE_DEFAULT_OTA 1
+#define FEATURE_DEFAULT_SERVO 1
+#define FEATURE_DEFAULT_PORTAL 0
+#elif FEATURE_PRESET == FEATURE_PRESET_WAN
+#define FEATURE_DEFAULT_HTTP 0
+#define FEATURE_DEFAULT_MQTT 1
+#define FEATURE_DEFAULT_FIREBASE 0
+#define FEATURE_DEFAULT_OTA 0
+#define FEATURE_DEFAULT_SERVO 0
+#define FEATURE_DEFAULT_PORTAL 1
+#elif FEATURE_PRESET == FEATURE_PRESET_CLOUD
+#define FEATURE_DEFAULT_HTTP 0
+#define FEATURE_DEFAULT_MQTT 0
+#define FEATURE_DEFAULT_FIREBASE 1
+#define FEATURE_DEFAULT_OTA 0
+#define FEATURE_DEFAULT_SERVO 0
+#define FEATURE_DEFAULT_PORTAL 0
+#else
+#error "Unknown FEATURE_PRESET!"
+#endif
+
+// ========================================
+// SUBSYSTEM SWITCHES
+// ========================================
+
+#ifndef FEATURE_HTTP_CONTROL
+#define FEATURE_HTTP_CONTROL FEATURE_DEFAULT_HTTP          // web remote on port 80 (wifi_Control.cpp)
+#endif
+
+#ifndef FEATURE_MQTT_WAN
+#define FEATURE_MQTT_WAN FEATURE_DEFAULT_MQTT              // Adafruit IO drive feeds (WANconnection.cpp)
+#endif
+
+#ifndef FEATURE_FIREBASE
+#define FEATURE_FIREBASE FEATURE_DEFAULT_FIREBASE          // RTDB telemetry, alerts and command stream
+#endif
+
+#ifndef FEATURE_OTA
+#define FEATURE_OTA FEATURE_DEFAULT_OTA                    // ArduinoOTA firmware updates
+#endif
+
+#ifndef FEATURE_ULTRASONIC_SERVO
+#define FEATURE_ULTRASONIC_SERVO FEATURE_DEFAULT_SERVO     // UltrasonicServo obstacle avoidance
+#endif
+
+#ifndef FEATURE_PROVISIONING
+#define FEATURE_PROVISIONING FEATURE_DEFAULT_PORTAL        // Wi-Fi credential portal (/setting)
+#endif
+
+#ifndef FEATURE_FLEET_GATEWAY
+#define FEATURE_FLEET_GATEWAY 0                            // fleet view from LAN rover frames (fleet_gateway.cpp); one unit per site
+#endif
+
+// Feature Validation
+#if FEATURE_PROVISIONING && !FEATURE_MQTT_WAN
+#error "FEATURE_PROVISIONING is part of the WAN connection and needs FEATURE_MQTT_WAN!"
+#endif
+
+#if FEATURE_FLEET_GATEWAY && !FEATURE_MQTT_WAN
+#error "FEATURE_FLEET_GATEWAY publishes the fleet view over MQTT and needs FEATURE_MQTT_WAN!"
+#endif
+
+#if !FEATURE_HTTP_CONTROL && !FEATURE_MQTT_WAN && !FEATURE_FIREBASE
+#error "At least one control plane (HTTP, MQTT or Firebase) must be enabled!"
+#endif
+
+// ========================================
+// TASK BUDGET
+// ========================================
+// Tasks the largest sketch (main.cpp) registers at boot, modules' own included.
+// The scheduler and power manager tables are sized from these; a new task needs its count here.
+
+#if defined(PROFILER_ENABLED) && PROFILER_ENABLED
+#define FEATURE_PROFILER_TASKS 1                           // profiler console
+#else
+#define FEATURE_PROFILER_TASKS 0
+#endif
+
+// Power-managed tasks (addPowerManagedTask)
+#define FEATURE_MANAGED_TASKS (1 +                         /* gas */ \
+  (FEATURE_HTTP_CONTROL || FEATURE_OTA ? 1 : 0) +          /* wifi */ \
+  (FEATURE_ULTRASONIC_SERVO ? 1 : 0) +                     /* obstacle */ \
+  (FEATURE_MQTT_WAN ? 3 : 0) +                             /* mqtt, gasmap, telemetry */ \
+  (FEATURE_FIREBASE ? 3 : 0))                              /* commands, firebase, logger */
+
+// Every scheduler task, managed or not
+#define FEATURE_BOOT_TASKS (FEATURE_MANAGED_TASKS + 5 +    /* network, wifiFallback, power, stats, bootStats */ \
+  (FEATURE_ULTRASONIC_SERVO ? 1 : 0) +                     /* seek */ \
+  (FEATURE_PROVISIONING ? 1 : 0) +                         /* portal */ \
+  (FEATURE_FLEET_GATEWAY ? 2 : 0) +                        /* fleetRx, fleetView */ \
+  FEATURE_PROFILER_TASKS)
+
+// Function declarations
+void printFeatureReport();
+
+#endif
@@ -5,15 +5,30 @@
 
 #include "firebase.h"
 
+#if FEATURE_FIREBASE
+
+#include "outbound_queue.h"
+#include "alert_manager.h"
+#include "json_writer.h"
+#include "rtdb_client.h"
+#include "loop_profiler.h"
+#include "trace_recorder.h"
+#include "sample_bus.h"
+#include "boot_sequencer.h"
+#include "dead_reckoning.h"
+#include "gas_map.h"
+#include "log_summary.h"
+#include "device_id.h"
+
 // Global Firebase objects
 FirebaseData firebaseDataObj;
-FirebaseJson json;
+FirebaseData firebaseStreamObj;  // dedicated connection for the command stream
 
 // Global Firebase data
-FirebaseData firebaseData = {
+FirebaseState firebaseState = {
   .gasConcentration = 0,
   .distance = 0,
-  .motionCommand = "",
+  .motionCommand = MOTION_STOP,
   .servoAngle = 90,
   .lastAlert = "",
   .lastUpdate = 0,
@@ -21,6 +36,129 @@ FirebaseData firebaseData = {
   .isConnected = false
 };
 
+FirebaseTickStats firebaseTickStats = {0, 0, 0, 0, 0, 0, 0};
+TelemetrySavings firebaseSavings = {0, 0, 0, 0, 0, 0, 0};
+
+// Tracked telemetry fields, keyed relative to the root for multi-location updates
+static TelemetryField gasField = {
+  "sensor_data/gas_concentration", "gas_data/ppm", DEADBAND_RELATIVE, GAS_DEADBAND_RELATIVE, 0, false
+};
+static TelemetryField distanceField = {
+  "sensor_data/distance", "ultrasonic_distance", DEADBAND_ABSOLUTE, DISTANCE_DEADBAND_CM, 0, false
+};
+static TelemetryField motionField = {
+  "sensor_data/motion", "motion_command/current", DEADBAND_ABSOLUTE, 0, 0, false
+};
+static TelemetryField servoField = {
+  "sensor_data/servo_angle", "servo/angle", DEADBAND_ABSOLUTE, SERVO_DEADBAND_DEG, 0, false
+};
+
+static unsigned long lastHeartbeat = 0;
+
+CommandStreamStats commandStreamStats = {0, 0, 0, 0, 0, 0, 0};
+
+// Outbound payloads are serialized here instead of on the heap
+static char payloadBuffer[FIREBASE_PAYLOAD_SIZE];
+static char batchBuffer[SAMPLE_BATCH_PAYLOAD_SIZE];
+static JsonWriter payloadWriter(payloadBuffer, sizeof(payloadBuffer));
+static JsonWriter batchWriter(batchBuffer, sizeof(batchBuffer));
+
+// Alerts must survive an outage, so they never serialize larger than a queue slot
+static char alertBuffer[QUEUE_PAYLOAD_SIZE];
+static JsonWriter alertWriter(alertBuffer, sizeof(alertBuffer));
+
+// Writes pre-serialized JSON; the text goes out as-is with no re-parse
+static bool writePayload(char op, const char* path, const char* payload, size_t length) {
+  PROFILE_SCOPE("rtdb_write");
+  bool ok = rtdbWrite(op == QUEUE_OP_PUSH ? RTDB_POST : RTDB_PATCH, roverPath(path), payload, length);
+  noteFirebaseResult(ok);
+  if (ok) markBootMilestone(BOOT_FIRST_UPLOAD);
+  return ok;
+}
+
+// Replays one queued message over the write connection
+static bool sendQueuedMessage(const QueuedMessage& message) {
+  if (!isFirebaseConnected()) return false;
+  
+  return writePayload(message.op, message.path, message.payload, strlen(message.payload));
+}
+
+// Send now if possible, otherwise keep for replay. Anything already queued
+// goes first so replay order matches the order events happened.
+static void sendOrQueue(QueuePriority priority, char op, const char* path, const JsonWriter& payload) {
+  if (!payload.ok()) {
+    Serial.print("❌ Payload too large, dropped: ");
+    Serial.println(path);
+    return;
+  }
+  
+  if (isFirebaseConnected() && isOutboundQueueEmpty()) {
+    if (writePayload(op, path, payload.c_str(), payload.length())) return;
+  }
+  
+  enqueueOutbound(priority, op, path, payload.c_str());
+}
+
+FirebaseHealthStats firebaseHealthStats = {0, 0, 0, FIREBASE_BACKOFF_MIN, 0, 0, 0, 0};
+
+static unsigned long nextProbeAt = 0;
+static bool dataInitialized = false;
+static int consecutiveFailures = 0;
+static bool probeInFlight = false;
+static unsigned long probeStartedAt = 0;
+
+static void recordStall(unsigned long duration) {
+  if (duration < FIREBASE_STALL_THRESHOLD) return;
+  
+  firebaseHealthStats.stalls++;
+  firebaseHealthStats.totalStallMs += duration;
+  if (duration > firebaseHealthStats.maxStallMs) {
+    firebaseHealthStats.maxStallMs = duration;
+  }
+}
+
+// Schedule the next probe with exponential backoff and +/-25% jitter
+static void scheduleProbe() {
+  unsigned long backoff = firebaseHealthStats.backoffMs;
+  long jitter = random(-(long)backoff / 4, (long)backoff / 4 + 1);
+  nextProbeAt = millis() + backoff + jitter;
+  
+  firebaseHealthStats.backoffMs = min(backoff * 2, (unsigned long)FIREBASE_BACKOFF_MAX);
+}
+
+static void markDisconnected() {
+  if (firebaseState.isConnected) {
+    Serial.println("⚠️ Firebase link down, sending will queue until it recovers");
+    firebaseHealthStats.disconnects++;
+  }
+  firebaseState.status = FIREBASE_ERROR;
+  firebaseState.isConnected = false;
+  firebaseHealthStats.backoffMs = FIREBASE_BACKOFF_MIN;
+  scheduleProbe();
+}
+
+// Current record timestamp as text, for the string-typed */timestamp nodes
+static const char* nowTimestamp() {
+  static char text[21];
+  formatTimestamp(text, getRecordTimestamp(millis()), 1);
+  return text;
+}
+
+// The logger drains its own bus channel, independent of the telemetry tick
+static SampleSnapshot loggerSamples;
+static LoggedSample sampleBatch[SAMPLE_BATCH_SIZE];
+static int sampleBatchCount = 0;
+static unsigned long samplesLogged = 0;
+static unsigned long sampleRequests = 0;
+
+// Every gas sample on the logger channel, condensed for /log_summary
+static LogSummary logSummary;
+static char summaryBuffer[LOG_SUMMARY_PAYLOAD_SIZE];
+
+static bool commandStreamActive = false;
+static MotionCommandHandler onMotionCommand = NULL;
+static ServoCommandHandler onServoCommand = NULL;
+
 void initFirebase() {
   Serial.println("🔥 Initializing Firebase connection...");
   
@@ -28,249 +166,752 @@ void initFirebase() {
   Firebase.begin(FIREBASE_HOST, FIREBASE_AUTH);
   Firebase.reconnectWiFi(true);
   
-  // Set database read timeout to 1 minute
-  Firebase.setReadTimeout(firebaseDataObj, 1000 * 60);
+  // Keep read timeout short so an unreachable backend can't stall the loop for a minute
+  Firebase.setReadTimeout(firebaseDataObj, FIREBASE_READ_TIMEOUT);
   
   // Set database write timeout to 1 minute
   Firebase.setwriteSizeLimit(firebaseDataObj, "tiny");
   
-  // Test connection
-  if (connectToFirebase()) {
-    Serial.println("✅ Firebase connected successfully!");
-    firebaseData.status = FIREBASE_CONNECTED;
-    firebaseData.isConnected = true;
-    
-    // Initialize Firebase data structure
-    initializeFirebaseData();
-  } else {
-    Serial.println("❌ Firebase connection failed!");
-    firebaseData.status = FIREBASE_ERROR;
-    firebaseData.isConnected = false;
-  }
-}
-
-bool connectToFirebase() {
-  Serial.print("🔗 Connecting to Firebase: ");
-  Serial.println(FIREBASE_HOST);
+  // Telemetry, alerts and logs go through the keep-alive writer
+  rtdbBegin(FIREBASE_HOST, FIREBASE_AUTH, FIREBASE_READ_TIMEOUT);
   
-  firebaseData.status = FIREBASE_CONNECTING;
+  // Wall clock for record timestamps
+  initTimeSync();
   
-  // Test connection by reading a simple value
-  if (Firebase.getString(firebaseDataObj, "/test")) {
-    firebaseData.status = FIREBASE_CONNECTED;
-    firebaseData.isConnected = true;
-    return true;
-  } else {
-    firebaseData.status = FIREBASE_ERROR;
-    firebaseData.isConnected = false;
-    return false;
-  }
+  // Messages queued before a reboot are replayed once connected
+  initOutboundQueue();
+  setAlertSink(sendAlertRecord);
+  
+  // Don't hold up boot on a TLS handshake: probe as soon as Wi-Fi is up
+  firebaseState.status = FIREBASE_CONNECTING;
+  firebaseState.isConnected = false;
+  addNetworkUpHandler(reconnectFirebase);
 }
 
 void initializeFirebaseData() {
   // Initialize sensor data structure
-  json.clear();
-  json.add("gas_concentration", 0);
-  json.add("distance", 0);
-  json.add("motion", "STOP");
-  json.add("servo_angle", 90);
-  json.add("timestamp", millis());
+  JsonWriter& writer = payloadWriter;
+  writer.reset();
+  writer.beginObject();
+  writer.add("sensor_data/gas_concentration", 0);
+  writer.add("sensor_data/distance", 0);
+  writer.add("sensor_data/motion", "STOP");
+  writer.add("sensor_data/servo_angle", 90);
+  writer.add("sensor_data/timestamp", getRecordTimestamp(millis()));
   
-  Firebase.updateNode(firebaseDataObj, FIREBASE_SENSOR_DATA, json);
+  // Initialize status in the same update
+  writer.add("status", "ONLINE");
+  writer.endObject();
   
-  // Initialize status
-  Firebase.setString(firebaseDataObj, FIREBASE_STATUS, "ONLINE");
+  writePayload(QUEUE_OP_UPDATE, "/", writer.c_str(), writer.length());
   
   Serial.println("📊 Firebase data structure initialized");
 }
 
-void updateFirebaseData() {
-  if (!isFirebaseConnected()) {
-    Serial.println("⚠️ Firebase not connected, attempting reconnect...");
-    reconnectFirebase();
+static void writeTelemetry(JsonWriter& writer, bool sendGas, bool sendDistance,
+                           bool sendMotion, bool sendServo, unsigned long stamp) {
+  writer.reset();
+  writer.beginObject();
+  if (sendGas) {
+    writer.add(gasField.key, firebaseState.gasConcentration);
+    writer.add(gasField.mirrorKey, firebaseState.gasConcentration);
+  }
+  if (sendDistance) {
+    writer.add(distanceField.key, firebaseState.distance);
+    writer.add(distanceField.mirrorKey, firebaseState.distance);
+  }
+  if (sendMotion) {
+    writer.add(motionField.key, getMotionName(firebaseState.motionCommand));
+    writer.add(motionField.mirrorKey, getMotionName(firebaseState.motionCommand));
+  }
+  if (sendServo) {
+    writer.add(servoField.key, firebaseState.servoAngle);
+    writer.add(servoField.mirrorKey, firebaseState.servoAngle);
+  }
+  writer.add("sensor_data/timestamp", getRecordTimestamp(stamp));
+  writer.endObject();
+}
+
+static uint8_t activeAlertMask() {
+  uint8_t mask = 0;
+  for (int type = 0; type < ALERT_TYPE_COUNT; type++) {
+    if (getAlert((AlertType)type).active) mask |= 1 << type;
+  }
+  return mask;
+}
+
+// Latest value per source wins; sampling never waits on this consumer
+static void consumeBusSamples() {
+  BusSample sample;
+  while (consumeSample(BUS_CONSUMER_FIREBASE, sample)) {
+    switch (sample.source) {
+      case SAMPLE_GAS_PPM: firebaseState.gasConcentration = sample.value; break;
+      case SAMPLE_DISTANCE_CM: firebaseState.distance = (int)sample.value; break;
+      case SAMPLE_MOTION: firebaseState.motionCommand = (MotionCommand)(int)sample.value; break;
+      case SAMPLE_SERVO_ANGLE: firebaseState.servoAngle = (int)sample.value; break;
+    }
+  }
+}
+
+// Full heartbeat payload into a caller buffer; 0 if it didn't fit
+size_t formatTelemetryPayload(char* buffer, size_t size) {
+  JsonWriter writer(buffer, size);
+  writeTelemetry(writer, true, true, true, true, millis());
+  return writer.ok() ? writer.length() : 0;
+}
+
+// Changed cells of one gas map tile per tick, merged into /gas_map/<tx_ty>.
+// Not queued: a tile that fails stays dirty and is retried on a later tick.
+static void uploadGasMapTile() {
+  if (!isOutboundQueueEmpty()) return;
+  GasMapTile* tile = gasMapNextDirty(gasMap);
+  if (tile == NULL) return;
+  
+  char path[10 + GAS_MAP_KEY_SIZE] = "/gas_map/";
+  gasMapTileKey(*tile, path + strlen(path));
+  
+  JsonWriter& writer = payloadWriter;
+  writer.reset();
+  writer.beginObject();
+  gasMapWriteCells(*tile, writer, true);
+  writer.endObject();
+  
+  if (writer.ok() && writePayload(QUEUE_OP_UPDATE, path, writer.c_str(), writer.length())) {
+    gasMapMarkSent(gasMap, *tile);
+  }
+}
+
+// Ten closed windows at a time under /log_summary/<boot id>_<first window ms>
+static void uploadLogSummary() {
+  if (!logSummaryReady(logSummary) || !isOutboundQueueEmpty()) return;
+  
+  char key[24];
+  snprintf(key, sizeof(key), "%08lx_%lu", (unsigned long)getBootId(), logSummary.windows[0].start);
+  
+  JsonWriter writer(summaryBuffer, sizeof(summaryBuffer));
+  writer.beginObject();
+  writer.beginObject(key);
+  writer.add("start", getRecordTimestamp(logSummary.windows[0].start));
+  writeLogSummary(logSummary, writer);
+  writer.endObject();
+  writer.endObject();
+  
+  if (writer.ok() && writePayload(QUEUE_OP_UPDATE, "/log_summary", writer.c_str(), writer.length())) {
+    logSummaryMarkSent(logSummary);
+  }
+}
+
+// Changed fields (or all of them on the heartbeat) in one multi-location update
+static void uploadTelemetry() {
+  unsigned long now = millis();
+  bool heartbeat = now - lastHeartbeat >= FIREBASE_HEARTBEAT_INTERVAL;
+  bool sendGas = heartbeat || isFieldDirty(gasField, firebaseState.gasConcentration);
+  bool sendDistance = heartbeat || isFieldDirty(distanceField, firebaseState.distance);
+  bool sendMotion = heartbeat || isFieldDirty(motionField, firebaseState.motionCommand);
+  bool sendServo = heartbeat || isFieldDirty(servoField, firebaseState.servoAngle);
+  
+  recordTelemetryField(firebaseSavings, gasField, sendGas);
+  recordTelemetryField(firebaseSavings, distanceField, sendDistance);
+  recordTelemetryField(firebaseSavings, motionField, sendMotion);
+  recordTelemetryField(firebaseSavings, servoField, sendServo);
+  
+  // Nothing changed beyond its deadband: skip the round trip entirely
+  if (!sendGas && !sendDistance && !sendMotion && !sendServo) {
+    recordTelemetryRequest(firebaseSavings, false);
     return;
   }
   
-  // Update sensor data
-  json.clear();
-  json.add("gas_concentration", firebaseData.gasConcentration);
-  json.add("distance", firebaseData.distance);
-  json.add("motion", firebaseData.motionCommand);
-  json.add("servo_angle", firebaseData.servoAngle);
-  json.add("timestamp", millis());
+  // One atomic multi-location update with only the changed fields and their mirrors
+  JsonWriter& writer = payloadWriter;
+  writeTelemetry(writer, sendGas, sendDistance, sendMotion, sendServo, now);
+  
+  bool ok = writer.ok() && writePayload(QUEUE_OP_UPDATE, "/", writer.c_str(), writer.length());
+  if (ok) {
+    if (sendGas) markFieldSent(gasField, firebaseState.gasConcentration);
+    if (sendDistance) markFieldSent(distanceField, firebaseState.distance);
+    if (sendMotion) markFieldSent(motionField, firebaseState.motionCommand);
+    if (sendServo) markFieldSent(servoField, firebaseState.servoAngle);
+    if (heartbeat) lastHeartbeat = now;
+    firebaseState.lastUpdate = millis();
+  } else {
+    firebaseTickStats.failures++;
+  }
+  recordTelemetryRequest(firebaseSavings, true);
+}
+
+void updateFirebaseData() {
+  // Timed and counted as a whole: replay, tiles and summaries share the tick's budget
+  unsigned long startTime = millis();
+  unsigned long requestsBefore = rtdbStats.requests;
   
-  Firebase.updateNode(firebaseDataObj, FIREBASE_SENSOR_DATA, json);
+  consumeBusSamples();
   
-  // Update individual values for easier access
-  Firebase.setFloat(firebaseDataObj, FIREBASE_GAS_DATA "/ppm", firebaseData.gasConcentration);
-  Firebase.setInt(firebaseDataObj, FIREBASE_DISTANCE_DATA, firebaseData.distance);
-  Firebase.setString(firebaseDataObj, FIREBASE_MOTION_DATA "/current", firebaseData.motionCommand);
-  Firebase.setInt(firebaseDataObj, FIREBASE_SERVO_DATA "/angle", firebaseData.servoAngle);
+  if (!isFirebaseConnected()) {
+    // Probes run on their own backoff schedule and keep their own stall stats
+    serviceFirebaseConnection();
+    return;
+  }
   
-  firebaseData.lastUpdate = millis();
+  // Replay anything stored during an outage, a rate-limited batch per tick
+  drainOutboundQueue(sendQueuedMessage);
+  uploadGasMapTile();
+  uploadLogSummary();
+  uploadTelemetry();
+  
+  unsigned long duration = millis() - startTime;
+  unsigned long requests = rtdbStats.requests - requestsBefore;
+  recordStall(duration);
+  firebaseTickStats.ticks++;
+  firebaseTickStats.requests += requests;
+  firebaseTickStats.lastRequests = requests;
+  firebaseTickStats.lastDurationMs = duration;
+  firebaseTickStats.totalDurationMs += duration;
+  if (duration > firebaseTickStats.maxDurationMs) {
+    firebaseTickStats.maxDurationMs = duration;
+  }
+}
+
+void printFirebaseTickStats() {
+  Serial.println("📊 Firebase telemetry ticks:");
+  Serial.print("  Ticks: "); Serial.println(firebaseTickStats.ticks);
+  Serial.print("  Round trips last/total: ");
+  Serial.print(firebaseTickStats.lastRequests); Serial.print("/");
+  Serial.println(firebaseTickStats.requests);
+  Serial.print("  Last: "); Serial.print(firebaseTickStats.lastDurationMs); Serial.println(" ms");
+  Serial.print("  Max: "); Serial.print(firebaseTickStats.maxDurationMs); Serial.println(" ms");
+  if (firebaseTickStats.ticks > 0) {
+    Serial.print("  Avg: ");
+    Serial.print(firebaseTickStats.totalDurationMs / firebaseTickStats.ticks);
+    Serial.println(" ms");
+  }
+  Serial.print("  Failures: "); Serial.println(firebaseTickStats.failures);
+  Serial.print("  Samples logged/requests: ");
+  Serial.print(samplesLogged); Serial.print("/");
+  Serial.println(sampleRequests);
+  Serial.print("  Clock: "); Serial.println(isTimeSynced() ? "SNTP" : "boot-relative");
+  Serial.print("  REST writes/failed/connects: ");
+  Serial.print(rtdbStats.requests); Serial.print("/");
+  Serial.print(rtdbStats.failures); Serial.print("/");
+  Serial.println(rtdbStats.connects);
+  Serial.print("  Last HTTP status: "); Serial.println(rtdbStats.lastStatus);
+  
+  printTelemetrySavings(firebaseSavings);
+  printSampleBusStats();
+  printOutboundQueueStats();
+  printAlertStats();
+  printFirebaseHealthStats();
 }
 
 void sendGasData(float ppm) {
   if (!isFirebaseConnected()) return;
   
-  firebaseData.gasConcentration = ppm;
-  Firebase.setFloat(firebaseDataObj, FIREBASE_GAS_DATA "/ppm", ppm);
-  Firebase.setString(firebaseDataObj, FIREBASE_GAS_DATA "/timestamp", String(millis()));
+  firebaseState.gasConcentration = ppm;
+  Firebase.setFloat(firebaseDataObj, roverPath(FIREBASE_GAS_DATA "/ppm"), ppm);
+  Firebase.setString(firebaseDataObj, roverPath(FIREBASE_GAS_DATA "/timestamp"), nowTimestamp());
 }
 
 void sendDistanceData(int distance) {
   if (!isFirebaseConnected()) return;
   
-  firebaseData.distance = distance;
-  Firebase.setInt(firebaseDataObj, FIREBASE_DISTANCE_DATA, distance);
-  Firebase.setString(firebaseDataObj, FIREBASE_DISTANCE_DATA "/timestamp", String(millis()));
+  firebaseState.distance = distance;
+  Firebase.setInt(firebaseDataObj, roverPath(FIREBASE_DISTANCE_DATA), distance);
+  Firebase.setString(firebaseDataObj, roverPath(FIREBASE_DISTANCE_DATA "/timestamp"), nowTimestamp());
 }
 
-void sendMotionCommand(String command) {
+void sendMotionCommand(MotionCommand command) {
   if (!isFirebaseConnected()) return;
   
-  firebaseData.motionCommand = command;
-  Firebase.setString(firebaseDataObj, FIREBASE_MOTION_DATA "/current", command);
-  Firebase.setString(firebaseDataObj, FIREBASE_MOTION_DATA "/timestamp", String(millis()));
+  firebaseState.motionCommand = command;
+  Firebase.setString(firebaseDataObj, roverPath(FIREBASE_MOTION_DATA "/current"), getMotionName(command));
+  Firebase.setString(firebaseDataObj, roverPath(FIREBASE_MOTION_DATA "/timestamp"), nowTimestamp());
 }
 
 void sendServoData(int angle) {
   if (!isFirebaseConnected()) return;
   
-  firebaseData.servoAngle = angle;
-  Firebase.setInt(firebaseDataObj, FIREBASE_SERVO_DATA "/angle", angle);
-  Firebase.setString(firebaseDataObj, FIREBASE_SERVO_DATA "/timestamp", String(millis()));
+  firebaseState.servoAngle = angle;
+  Firebase.setInt(firebaseDataObj, roverPath(FIREBASE_SERVO_DATA "/angle"), angle);
+  Firebase.setString(firebaseDataObj, roverPath(FIREBASE_SERVO_DATA "/timestamp"), nowTimestamp());
 }
 
-void sendAlert(String alertType, String message) {
-  if (!isFirebaseConnected()) return;
+void sendAlert(const char* alertType, const char* message) {
+  raiseAlert(getAlertTypeByName(alertType), SEVERITY_WARNING, 0, message);
+}
+
+// Alert manager sink: the episode record and the latest-alert fields go as two
+// updates, each built in a queue-slot-sized buffer so an offline alert always fits
+void sendAlertRecord(const AlertRecord& alert) {
+  const char* typeName = getAlertTypeName(alert.type);
+  firebaseState.lastAlert = typeName;
+  
+  // Stable key per episode so coalesced updates overwrite the same record
+  char id[48];
+  snprintf(id, sizeof(id), "%s_%lx_%lu", typeName, (unsigned long)getBootId(), alert.firstSeen);
+  char lastTimestamp[21];
+  formatTimestamp(lastTimestamp, getRecordTimestamp(alert.lastSeen), 1);
+  
+  JsonWriter& writer = alertWriter;
+  writer.reset();
+  writer.beginObject();
+  writer.beginObject(id);
+  writer.add("type", typeName);
+  writer.add("severity", getAlertSeverityName(alert.severity));
+  writer.add("message", alert.message);
+  writer.add("count", (int)alert.count);
+  writer.add("first", getRecordTimestamp(alert.firstSeen));
+  writer.add("last", getRecordTimestamp(alert.lastSeen));
+  writer.add("peak", alert.peak);
+  writer.add("timestamp", getRecordTimestamp(alert.lastSeen));
+  writer.endObject();
+  writer.endObject();
+  sendOrQueue(QUEUE_ALERT, QUEUE_OP_UPDATE, FIREBASE_ALERTS, writer);
+  
+  writer.reset();
+  writer.beginObject();
+  writer.add("last_alert", typeName);
+  writer.add("last_message", alert.message);
+  writer.add("last_timestamp", lastTimestamp);
+  if (alert.type == ALERT_HIGH_GAS) {
+    writer.add("gas_level", alert.peak);  // read by the dashboard alert panel
+  }
+  writer.endObject();
+  sendOrQueue(QUEUE_ALERT, QUEUE_OP_UPDATE, FIREBASE_ALERTS, writer);
+  
+  Serial.print("🚨 Alert sent to Firebase: ");
+  Serial.print(typeName);
+  Serial.print(" x");
+  Serial.println(alert.count);
+}
+
+// UltrasonicServo state under /ultrasonic_servo; written when the status or the
+// obstacle flag changes, not on every 100 ms check
+void sendObstacleStatus(float distance, DistanceStatus status, bool obstacleDetected) {
+  static DistanceStatus lastStatus = DISTANCE_STATUS_COUNT;
+  static bool lastObstacle = false;
+  if (status == lastStatus && obstacleDetected == lastObstacle) return;
+  if (!isFirebaseConnected() || !isOutboundQueueEmpty()) return;  // retried on the next change
+  
+  JsonWriter& writer = payloadWriter;
+  writer.reset();
+  writer.beginObject();
+  writer.add("distance", distance);
+  writer.add("status", getDistanceStatusName(status));
+  writer.add("obstacle_detected", obstacleDetected);
+  writer.add("timestamp", getRecordTimestamp(millis()));
+  writer.endObject();
+  
+  if (writer.ok() && writePayload(QUEUE_OP_UPDATE, "/ultrasonic_servo", writer.c_str(), writer.length())) {
+    lastStatus = status;
+    lastObstacle = obstacleDetected;
+  }
+}
+
+// Motion and the stop flag in one update; queued like an alert if offline
+void sendEmergencyStop() {
+  firebaseState.motionCommand = MOTION_STOP;
+  
+  JsonWriter& writer = payloadWriter;
+  writer.reset();
+  writer.beginObject();
+  writer.add("motion_command/current", getMotionName(MOTION_STOP));
+  writer.add("emergency_stop", true);
+  writer.add("timestamp", getRecordTimestamp(millis()));
+  writer.endObject();
+  
+  sendOrQueue(QUEUE_ALERT, QUEUE_OP_UPDATE, "/", writer);
+}
+
+void setFirebaseCommandHandlers(MotionCommandHandler motionHandler, ServoCommandHandler servoHandler) {
+  onMotionCommand = motionHandler;
+  onServoCommand = servoHandler;
+}
+
+bool beginCommandStream() {
+  commandStreamStats.restRequests++;
+  commandStreamActive = Firebase.beginStream(firebaseStreamObj, roverPath(FIREBASE_COMMANDS));
   
-  firebaseData.lastAlert = alertType;
+  if (commandStreamActive) {
+    Serial.println("📡 Command stream started: " FIREBASE_COMMANDS);
+  } else {
+    Serial.print("❌ Command stream failed: ");
+    Serial.println(firebaseStreamObj.errorReason());
+  }
+  return commandStreamActive;
+}
+
+// issued_at of the last command seen, so snapshots after a reconnect don't replay it
+static double lastMotionIssuedAt = 0;
+static double lastServoIssuedAt = 0;
+static bool commandBaselineTaken = false;
+
+static void applyMotionCommand(const char* name, double issuedAt) {
+  MotionCommand command = parseMotionCommand(name);
+  if (command == MOTION_UNKNOWN) return;
+  if (issuedAt != 0) {
+    if (issuedAt == lastMotionIssuedAt) return;
+    lastMotionIssuedAt = issuedAt;
+  }
+  // Commands already pending at boot are stale; only record them
+  if (!commandBaselineTaken) return;
   
-  json.clear();
-  json.add("type", alertType);
-  json.add("message", message);
-  json.add("timestamp", millis());
+  firebaseState.motionCommand = command;
+  commandStreamStats.commands++;
+  TRACE_EVENT(TRACE_MOTION_CMD, command);
+  Serial.print("📡 Motion command received: ");
+  Serial.println(getMotionName(command));
   
-  Firebase.pushJSON(firebaseDataObj, FIREBASE_ALERTS, json);
+  if (onMotionCommand) onMotionCommand(command);
+}
+
+static void applyServoCommand(int angle, double issuedAt) {
+  if (angle < 0 || angle > 180) return;
+  if (issuedAt != 0) {
+    if (issuedAt == lastServoIssuedAt) return;
+    lastServoIssuedAt = issuedAt;
+  }
+  if (!commandBaselineTaken) return;
   
-  // Also update the latest alert
-  Firebase.setString(firebaseDataObj, FIREBASE_ALERTS "/last_alert", alertType);
-  Firebase.setString(firebaseDataObj, FIREBASE_ALERTS "/last_message", message);
-  Firebase.setString(firebaseDataObj, FIREBASE_ALERTS "/last_timestamp", String(millis()));
+  firebaseState.servoAngle = angle;
+  commandStreamStats.commands++;
+  TRACE_EVENT(TRACE_SERVO_CMD, angle);
+  Serial.print("📡 Servo command received: ");
+  Serial.println(angle);
   
-  Serial.print("🚨 Alert sent to Firebase: ");
-  Serial.println(alertType);
+  if (onServoCommand) onServoCommand(angle);
+}
+
+static void handleCommandEvent(FirebaseData& stream) {
+  String path = stream.dataPath();
+  String type = stream.dataType();
+  
+  if (type == "json") {
+    // "/" carries both command objects, "/motion" or "/servo" just one
+    FirebaseJson& data = stream.jsonObject();
+    FirebaseJsonData command;
+    FirebaseJsonData issuedAt;
+    
+    bool root = path == "/";
+    if (root || path == "/motion") {
+      data.get(command, root ? "motion/command" : "command");
+      data.get(issuedAt, root ? "motion/issued_at" : "issued_at");
+      if (command.success) {
+        applyMotionCommand(command.stringValue.c_str(), issuedAt.success ? issuedAt.doubleValue : 0);
+      }
+    }
+    if (root || path == "/servo") {
+      data.get(command, root ? "servo/angle" : "angle");
+      data.get(issuedAt, root ? "servo/issued_at" : "issued_at");
+      if (command.success) {
+        applyServoCommand(command.intValue, issuedAt.success ? issuedAt.doubleValue : 0);
+      }
+    }
+  } else if (path == "/motion/command") {
+    applyMotionCommand(stream.stringData().c_str(), 0);
+  } else if (path == "/servo/angle") {
+    applyServoCommand(stream.intData(), 0);
+  }
+  
+  // The first event of the first stream is the snapshot of pending commands
+  commandBaselineTaken = true;
 }
 
 void checkFirebaseCommands() {
+  // Reconnects belong to the low-priority telemetry task; this one only streams
   if (!isFirebaseConnected()) return;
   
-  // Check for motion commands
-  String motionCommand;
-  if (Firebase.getString(firebaseDataObj, FIREBASE_MOTION_DATA "/request", motionCommand)) {
-    if (motionCommand != firebaseData.motionCommand && motionCommand != "") {
-      firebaseData.motionCommand = motionCommand;
-      Serial.print("📡 Motion command received: ");
-      Serial.println(motionCommand);
-      
-      // Clear the request after processing
-      Firebase.deleteNode(firebaseDataObj, FIREBASE_MOTION_DATA "/request");
-    }
+  if (!commandStreamActive) {
+    if (commandStreamStats.startTime == 0) commandStreamStats.startTime = millis();
+    else commandStreamStats.reconnects++;
+    if (!beginCommandStream()) return;
   }
   
-  // Check for servo commands
-  int servoAngle;
-  if (Firebase.getInt(firebaseDataObj, FIREBASE_SERVO_DATA "/request", servoAngle)) {
-    if (servoAngle >= 0 && servoAngle <= 180) {
-      firebaseData.servoAngle = servoAngle;
-      Serial.print("📡 Servo command received: ");
-      Serial.println(servoAngle);
-      
-      // Clear the request after processing
-      Firebase.deleteNode(firebaseDataObj, FIREBASE_SERVO_DATA "/request");
-    }
+  // Reads pushed events from the open stream; no request is sent
+  bool streamOk;
+  {
+    PROFILE_SCOPE("stream_read");
+    streamOk = Firebase.readStream(firebaseStreamObj);
+  }
+  if (!streamOk) {
+    Serial.print("⚠️ Command stream lost: ");
+    Serial.println(firebaseStreamObj.errorReason());
+    commandStreamActive = false;
+    return;
+  }
+  
+  if (firebaseStreamObj.streamTimeout()) {
+    Serial.println("⚠️ Command stream timed out, resuming...");
+    return;
   }
+  
+  if (!firebaseStreamObj.streamAvailable()) return;
+  
+  unsigned long startMicros = micros();
+  commandStreamStats.events++;
+  handleCommandEvent(firebaseStreamObj);
+  
+  commandStreamStats.lastApplyMicros = micros() - startMicros;
+  if (commandStreamStats.lastApplyMicros > commandStreamStats.maxApplyMicros) {
+    commandStreamStats.maxApplyMicros = commandStreamStats.lastApplyMicros;
+  }
+}
+
+void printCommandStreamStats() {
+  unsigned long elapsed = millis() - commandStreamStats.startTime;
+  if (elapsed == 0) elapsed = 1;
+  
+  Serial.println("📡 Command stream:");
+  Serial.print("  Events: "); Serial.println(commandStreamStats.events);
+  Serial.print("  Commands applied: "); Serial.println(commandStreamStats.commands);
+  Serial.print("  Reconnects: "); Serial.println(commandStreamStats.reconnects);
+  Serial.print("  Command path requests/s: ");
+  Serial.println((float)commandStreamStats.restRequests * 1000.0 / elapsed, 4);
+  Serial.print("  Apply latency last/max: ");
+  Serial.print(commandStreamStats.lastApplyMicros); Serial.print("/");
+  Serial.print(commandStreamStats.maxApplyMicros); Serial.println(" us");
 }
 
 bool isFirebaseConnected() {
-  return firebaseData.isConnected && firebaseData.status == FIREBASE_CONNECTED;
+  return firebaseState.isConnected && firebaseState.status == FIREBASE_CONNECTED;
 }
 
 FirebaseStatus getFirebaseStatus() {
-  return firebaseData.status;
+  return firebaseState.status;
 }
 
 void reconnectFirebase() {
-  Serial.println("🔄 Attempting Firebase reconnection...");
-  
-  firebaseData.status = FIREBASE_CONNECTING;
-  firebaseData.isConnected = false;
-  
-  // Wait a bit before reconnecting
-  delay(1000);
+  // Probe on the next service call instead of waiting out the backoff
+  nextProbeAt = millis();
+  serviceFirebaseConnection();
+}
+
+static void finishProbe(bool ok) {
+  unsigned long duration = millis() - probeStartedAt;
+  if (duration > firebaseHealthStats.maxProbeMs) {
+    firebaseHealthStats.maxProbeMs = duration;
+  }
   
-  if (connectToFirebase()) {
+  if (ok) {
     Serial.println("✅ Firebase reconnected successfully!");
-    firebaseData.status = FIREBASE_CONNECTED;
-    firebaseData.isConnected = true;
+    firebaseState.status = FIREBASE_CONNECTED;
+    firebaseState.isConnected = true;
+    consecutiveFailures = 0;
+    firebaseHealthStats.backoffMs = FIREBASE_BACKOFF_MIN;
+    
+    // Initialize Firebase data structure on the first connection after boot
+    if (!dataInitialized) {
+      initializeFirebaseData();
+      dataInitialized = true;
+    }
   } else {
-    Serial.println("❌ Firebase reconnection failed!");
-    firebaseData.status = FIREBASE_ERROR;
-    firebaseData.isConnected = false;
+    Serial.print("❌ Firebase probe failed, retry in ~");
+    firebaseState.status = FIREBASE_ERROR;
+    firebaseHealthStats.probeFailures++;
+    scheduleProbe();
+    Serial.print((long)(nextProbeAt - millis()));
+    Serial.println(" ms");
   }
 }
 
-void logDataToFirebase() {
-  if (!isFirebaseConnected()) return;
+// Health state machine: idle until the backoff expires, then one probe in
+// flight whose reply is picked up by later calls; no call waits on the backend
+void serviceFirebaseConnection() {
+  if (isFirebaseConnected()) return;
+  
+  if (probeInFlight) {
+    RtdbProbeResult result = rtdbProbePoll();
+    if (result == RTDB_PROBE_PENDING) return;
+    probeInFlight = false;
+    finishProbe(result == RTDB_PROBE_OK);
+    return;
+  }
+  
+  if ((long)(millis() - nextProbeAt) < 0) return;
+  
+  // No network: don't spend a TLS handshake finding that out
+  if (WiFi.status() != WL_CONNECTED) {
+    scheduleProbe();
+    return;
+  }
   
-  // Create a log entry
-  json.clear();
-  json.add("gas_ppm", firebaseData.gasConcentration);
-  json.add("distance_cm", firebaseData.distance);
-  json.add("motion", firebaseData.motionCommand);
-  json.add("servo_angle", firebaseData.servoAngle);
-  json.add("timestamp", millis());
+  Serial.println("🔄 Probing Firebase...");
+  firebaseHealthStats.probes++;
+  firebaseState.status = FIREBASE_CONNECTING;
   
-  Firebase.pushJSON(firebaseDataObj, "/logs", json);
+  PROFILE_SCOPE("fb_probe");
+  probeStartedAt = millis();
+  probeInFlight = rtdbProbeStart(roverPath(FIREBASE_STATUS));
+  recordStall(millis() - probeStartedAt);  // the connect is the only blocking part
+  if (!probeInFlight) finishProbe(false);
 }
 
-void createFirebaseLog(String event, String data) {
-  if (!isFirebaseConnected()) return;
+void noteFirebaseResult(bool success) {
+  if (success) {
+    consecutiveFailures = 0;
+    return;
+  }
   
-  json.clear();
-  json.add("event", event);
-  json.add("data", data);
-  json.add("timestamp", millis());
+  if (++consecutiveFailures >= FIREBASE_FAILURES_TO_DISCONNECT) {
+    consecutiveFailures = 0;
+    markDisconnected();
+  }
+}
+
+void printFirebaseLogSummary() {
+  printLogSummary(logSummary);
+}
+
+void printFirebaseHealthStats() {
+  Serial.println("🩺 Firebase health:");
+  Serial.print("  Connected: "); Serial.println(isFirebaseConnected() ? "yes" : "no");
+  Serial.print("  Disconnects: "); Serial.println(firebaseHealthStats.disconnects);
+  Serial.print("  Probes/failed: ");
+  Serial.print(firebaseHealthStats.probes); Serial.print("/");
+  Serial.println(firebaseHealthStats.probeFailures);
+  Serial.print("  Backoff: "); Serial.print(firebaseHealthStats.backoffMs); Serial.println(" ms");
+  Serial.print("  Max probe: "); Serial.print(firebaseHealthStats.maxProbeMs); Serial.println(" ms");
+  Serial.print("  Loop stalls: "); Serial.print(firebaseHealthStats.stalls);
+  Serial.print(" (max "); Serial.print(firebaseHealthStats.maxStallMs);
+  Serial.print(" ms, total "); Serial.print(firebaseHealthStats.totalStallMs); Serial.println(" ms)");
+}
+
+// Chronologically sortable key: epoch ms once synced, boot id + millis before
+static void sampleKey(const LoggedSample& sample, char* key) {
+  uint64_t epochMillis = millisToEpochMillis(sample.stamp);
+  if (epochMillis != 0) {
+    formatTimestamp(key, epochMillis, 13);
+  } else {
+    snprintf(key, SAMPLE_KEY_SIZE, "b%08lx_%010lu", (unsigned long)getBootId(), sample.stamp);
+  }
+}
+
+static void writeSampleEntry(JsonWriter& writer, const LoggedSample& sample) {
+  char key[SAMPLE_KEY_SIZE];
+  sampleKey(sample, key);
+  
+  writer.beginObject(key);
+  writer.add("gas_ppm", sample.gasConcentration);
+  writer.add("distance_cm", sample.distance);
+  writer.add("motion", getMotionName(sample.motion));
+  writer.add("servo_angle", sample.servoAngle);
+  writer.add("x_cm", sample.xCm);
+  writer.add("y_cm", sample.yCm);
+  writer.add("timestamp", getRecordTimestamp(sample.stamp));
+  if (!isTimeSynced()) {
+    char bootId[9];
+    snprintf(bootId, sizeof(bootId), "%08lx", (unsigned long)getBootId());
+    writer.add("boot_id", bootId);  // timestamp is boot-relative
+  }
+  writer.endObject();
+}
+
+static float loggedValue(SampleSource source, float fallback) {
+  return hasSnapshotValue(loggerSamples, source) ? loggerSamples.value[source] : fallback;
+}
+
+// Every queued sample, not just the newest, so the summary sees the full gas stream
+static void drainLoggerSamples() {
+  BusSample sample;
+  while (consumeSample(BUS_CONSUMER_LOGGER, sample)) {
+    updateSampleSnapshot(loggerSamples, sample);
+    if (sample.source == SAMPLE_GAS_PPM) logSummaryAdd(logSummary, sample.stamp, sample.value, activeAlertMask());
+  }
+}
+
+void logDataToFirebase() {
+  // Buffer the sample; the batch goes up as one multi-location update
+  drainLoggerSamples();
+  LoggedSample& sample = sampleBatch[sampleBatchCount++];
+  sample.stamp = millis();
+  sample.gasConcentration = loggedValue(SAMPLE_GAS_PPM, 0);
+  sample.distance = (int)loggedValue(SAMPLE_DISTANCE_CM, 0);
+  sample.servoAngle = (int)loggedValue(SAMPLE_SERVO_ANGLE, 90);
+  sample.motion = (MotionCommand)(int)loggedValue(SAMPLE_MOTION, MOTION_STOP);
+  Pose pose = getPose();
+  sample.xCm = (int16_t)constrain(pose.x, -32768.0f, 32767.0f);
+  sample.yCm = (int16_t)constrain(pose.y, -32768.0f, 32767.0f);
+  samplesLogged++;
+  
+  if (sampleBatchCount == SAMPLE_BATCH_SIZE ||
+      millis() - sampleBatch[0].stamp >= SAMPLE_BATCH_MAX_AGE) {
+    flushSampleBatch();
+  }
+}
+
+void flushSampleBatch() {
+  if (sampleBatchCount == 0) return;
+  
+  if (isFirebaseConnected() && isOutboundQueueEmpty()) {
+    JsonWriter& writer = batchWriter;
+    writer.reset();
+    writer.beginObject();
+    for (int i = 0; i < sampleBatchCount; i++) {
+      writeSampleEntry(writer, sampleBatch[i]);
+    }
+    writer.endObject();
+    
+    if (writer.ok()) {
+      bool ok = writePayload(QUEUE_OP_UPDATE, "/logs", writer.c_str(), writer.length());
+      sampleRequests++;
+      if (ok) {
+        sampleBatchCount = 0;
+        return;
+      }
+    }
+  }
   
-  Firebase.pushJSON(firebaseDataObj, "/event_logs", json);
+  // Offline: queue samples one by one so each fits a queue slot
+  JsonWriter& writer = payloadWriter;
+  for (int i = 0; i < sampleBatchCount; i++) {
+    writer.reset();
+    writer.beginObject();
+    writeSampleEntry(writer, sampleBatch[i]);
+    writer.endObject();
+    sendOrQueue(QUEUE_SAMPLE, QUEUE_OP_UPDATE, "/logs", writer);
+  }
+  sampleBatchCount = 0;
 }
 
-void updateFirebaseStatus(String status) {
+void createFirebaseLog(const char* event, const char* data) {
+  JsonWriter& writer = payloadWriter;
+  writer.reset();
+  writer.beginObject();
+  writer.add("event", event);
+  writer.add("data", data);
+  writer.add("timestamp", getRecordTimestamp(millis()));
+  writer.endObject();
+  
+  sendOrQueue(QUEUE_EVENT, QUEUE_OP_PUSH, "/event_logs", writer);
+}
+
+void updateFirebaseStatus(const char* status) {
   if (!isFirebaseConnected()) return;
   
-  Firebase.setString(firebaseDataObj, FIREBASE_STATUS, status);
+  Firebase.setString(firebaseDataObj, roverPath(FIREBASE_STATUS), status);
 }
 
 void clearFirebaseCommands() {
   if (!isFirebaseConnected()) return;
   
-  Firebase.deleteNode(firebaseDataObj, FIREBASE_MOTION_DATA "/request");
-  Firebase.deleteNode(firebaseDataObj, FIREBASE_SERVO_DATA "/request");
+  Firebase.deleteNode(firebaseDataObj, roverPath(FIREBASE_COMMANDS));
 }
 
-String getFirebaseData(String path) {
-  if (!isFirebaseConnected()) return "";
+// Copies the value into a caller buffer; false if offline or the read failed
+bool getFirebaseData(const char* path, char* value, size_t size) {
+  if (size == 0) return false;
+  value[0] = '\0';
+  if (!isFirebaseConnected()) return false;
   
-  String data;
-  if (Firebase.getString(firebaseDataObj, path, data)) {
-    return data;
-  }
-  return "";
+  if (!Firebase.getString(firebaseDataObj, roverPath(path))) return false;
+  
+  strncpy(value, firebaseDataObj.stringData().c_str(), size - 1);
+  value[size - 1] = '\0';
+  return true;
 }
 
-bool setFirebaseData(String path, String value) {
+bool setFirebaseData(const char* path, const char* value) {
   if (!isFirebaseConnected()) return false;
   
-  return Firebase.setString(firebaseDataObj, path, value);
+  return Firebase.setString(firebaseDataObj, roverPath(path), value);
 }
+
+#endif
@@ -8,18 +8,25 @@
  * - Command reception from web interface
  * - Alert system integration
  * - Data logging and history
+ * - Gas map upload, changed cells only
+ * - Condensed log summary (stats, gaps, downsampled series)
  */
 
 #ifndef FIREBASE_H
 #define FIREBASE_H
 
 #include <FirebaseESP8266.h>
+#include "features.h"
+#include "telemetry_filter.h"
+#include "alert_manager.h"
+#include "time_sync.h"
+#include "rover_status.h"
 
 // Firebase configuration
 #define FIREBASE_HOST "your-project.firebaseio.com"
 #define FIREBASE_AUTH "your-firebase-secret"
 
-// Firebase data paths
+// Firebase data paths, relative to the rover root (see roverPath())
 #define FIREBASE_GAS_DATA "/gas_data"
 #define FIREBASE_DISTANCE_DATA "/ultrasonic_distance"
 #define FIREBASE_MOTION_DATA "/motion_command"
@@ -27,10 +34,34 @@
 #define FIREBASE_ALERTS "/alerts"
 #define FIREBASE_SENSOR_DATA "/sensor_data"
 #define FIREBASE_STATUS "/status"
+#define FIREBASE_COMMANDS "/commands"  // streamed: motion/{command,issued_at}, servo/{angle,issued_at}
 
 // Data update intervals
 #define FIREBASE_UPDATE_INTERVAL 2000  // 2 seconds
 #define FIREBASE_COMMAND_CHECK_INTERVAL 500  // 500ms
+#define FIREBASE_HEARTBEAT_INTERVAL 60000  // resend all fields at least every minute
+
+// Sample log batching (one request per batch instead of per sample)
+#define SAMPLE_LOG_INTERVAL 3000    // one /logs record per logger task run
+#define SAMPLE_BATCH_SIZE 10
+#define SAMPLE_BATCH_MAX_AGE 30000  // flush a partial batch after 30 seconds
+#define SAMPLE_KEY_SIZE 24
+
+// Fixed serialization buffers (no heap JSON on the write path)
+#define FIREBASE_PAYLOAD_SIZE 512
+#define SAMPLE_BATCH_PAYLOAD_SIZE 2048  // ~160 bytes per sample
+
+// Connection health
+#define FIREBASE_READ_TIMEOUT 5000        // caps how long one request can stall the loop
+#define FIREBASE_BACKOFF_MIN 1000         // first retry delay after a failure
+#define FIREBASE_BACKOFF_MAX 60000        // retry delay ceiling
+#define FIREBASE_FAILURES_TO_DISCONNECT 2 // consecutive write failures before marking the link down
+#define FIREBASE_STALL_THRESHOLD 100      // ms; longer Firebase calls count as loop stalls
+
+// Upload deadbands (changes within these are not sent)
+#define GAS_DEADBAND_RELATIVE 0.05  // 5% of last sent value
+#define DISTANCE_DEADBAND_CM 2
+#define SERVO_DEADBAND_DEG 1
 
 // Firebase connection status
 enum FirebaseStatus {
@@ -40,44 +71,108 @@ enum FirebaseStatus {
   FIREBASE_ERROR
 };
 
-// Firebase data structure
-struct FirebaseData {
+// Last known rover state as mirrored to Firebase (FirebaseData is the library's connection class)
+struct FirebaseState {
   float gasConcentration;
   int distance;
-  String motionCommand;
+  MotionCommand motionCommand;
   int servoAngle;
-  String lastAlert;
+  const char* lastAlert;  // points into the alert name table
   unsigned long lastUpdate;
   FirebaseStatus status;
   bool isConnected;
 };
 
+// Telemetry tick statistics
+struct FirebaseTickStats {
+  unsigned long ticks;
+  unsigned long requests;        // total REST round trips made by ticks
+  unsigned long lastRequests;    // round trips in the last tick
+  unsigned long lastDurationMs;  // wall time of the last tick
+  unsigned long maxDurationMs;
+  unsigned long totalDurationMs;
+  unsigned long failures;
+};
+
+// One buffered /logs entry
+struct LoggedSample {
+  unsigned long stamp;  // millis() when taken, converted to epoch at upload
+  float gasConcentration;
+  int distance;
+  int servoAngle;
+  MotionCommand motion;
+  int16_t xCm, yCm;     // dead-reckoned position
+};
+
+// Connection health statistics
+struct FirebaseHealthStats {
+  unsigned long probes;
+  unsigned long probeFailures;
+  unsigned long disconnects;
+  unsigned long backoffMs;        // current retry delay
+  unsigned long maxProbeMs;
+  unsigned long stalls;           // Firebase calls longer than FIREBASE_STALL_THRESHOLD
+  unsigned long maxStallMs;
+  unsigned long totalStallMs;
+};
+
+// Command stream statistics
+struct CommandStreamStats {
+  unsigned long startTime;
+  unsigned long events;          // stream events received (excluding keep-alives)
+  unsigned long commands;        // commands applied
+  unsigned long restRequests;    // REST round trips made on the command path
+  unsigned long reconnects;
+  unsigned long lastApplyMicros; // event read to command applied
+  unsigned long maxApplyMicros;
+};
+
+// Handlers invoked when a streamed command arrives
+typedef void (*MotionCommandHandler)(MotionCommand command);
+typedef void (*ServoCommandHandler)(int angle);
+
 // Global Firebase data
-extern FirebaseData firebaseData;
+extern FirebaseState firebaseState;
+extern FirebaseData firebaseStreamObj;
+extern CommandStreamStats commandStreamStats;
+extern FirebaseTickStats firebaseTickStats;
+extern TelemetrySavings firebaseSavings;
+extern FirebaseHealthStats firebaseHealthStats;
 extern FirebaseData firebaseDataObj;
-extern FirebaseJson json;
 
 // Function declarations
 void initFirebase();
-bool connectToFirebase();
 void updateFirebaseData();
 void sendGasData(float ppm);
 void sendDistanceData(int distance);
-void sendMotionCommand(String command);
+void sendMotionCommand(MotionCommand command);
 void sendServoData(int angle);
-void sendAlert(String alertType, String message);
+void sendAlert(const char* alertType, const char* message);
+void sendAlertRecord(const AlertRecord& alert);
+void sendObstacleStatus(float distance, DistanceStatus status, bool obstacleDetected);
+void sendEmergencyStop();
 void checkFirebaseCommands();
+bool beginCommandStream();
+void setFirebaseCommandHandlers(MotionCommandHandler motionHandler, ServoCommandHandler servoHandler);
+void printCommandStreamStats();
 bool isFirebaseConnected();
 FirebaseStatus getFirebaseStatus();
 void reconnectFirebase();
+void serviceFirebaseConnection();
+void noteFirebaseResult(bool success);
+void printFirebaseHealthStats();
 void logDataToFirebase();
+void flushSampleBatch();
+void printFirebaseTickStats();
+void printFirebaseLogSummary();
+size_t formatTelemetryPayload(char* buffer, size_t size);
 
 // Advanced Firebase functions
-void createFirebaseLog(String event, String data);
-void updateFirebaseStatus(String status);
+void createFirebaseLog(const char* event, const char* data);
+void updateFirebaseStatus(const char* status);
 void clearFirebaseCommands();
 void setFirebaseUpdateInterval(int interval);
-String getFirebaseData(String path);
-bool setFirebaseData(String path, String value);
+bool getFirebaseData(const char* path, char* value, size_t size);
+bool setFirebaseData(const char* path, const char* value);
 
 #endif
@@ -0,0 +1,292 @@
+/*
+ * Fleet Gateway Implementation for ToxiRover
+ */
+
+#include "fleet_gateway.h"
+#include <WiFiUdp.h>
+#include "boot_sequencer.h"
+#include "device_id.h"
+#if FEATURE_FLEET_GATEWAY
+#include "WANconnection.h"
+#endif
+
+static uint32_t roverHash(uint32_t device) {
+  return (device * 2654435761UL >> 16) & (FLEET_HASH_SLOTS - 1);
+}
+
+void fleetTableReset(FleetTable& table) {
+  memset(&table, 0, sizeof(table));
+  memset(table.slots, -1, sizeof(table.slots));
+}
+
+// Linear probe; returns the slot holding the rover, or the empty slot ending the run
+static int findSlot(const FleetTable& table, uint32_t device) {
+  uint32_t slot = roverHash(device);
+  while (table.slots[slot] >= 0 && table.rovers[table.slots[slot]].latest.device != device) {
+    slot = (slot + 1) & (FLEET_HASH_SLOTS - 1);
+  }
+  return slot;
+}
+
+// Backward-shift delete, as in the gas map
+static void removeSlot(FleetTable& table, int slot) {
+  int hole = slot;
+  int next = (hole + 1) & (FLEET_HASH_SLOTS - 1);
+  while (table.slots[next] >= 0) {
+    int home = roverHash(table.rovers[table.slots[next]].latest.device);
+    bool between = hole <= next ? (home > hole && home <= next) : (home > hole || home <= next);
+    if (!between) {
+      table.slots[hole] = table.slots[next];
+      hole = next;
+    }
+    next = (next + 1) & (FLEET_HASH_SLOTS - 1);
+  }
+  table.slots[hole] = -1;
+}
+
+// A full table gives the longest-silent rover's entry to the newcomer
+static int claimRover(FleetTable& table, uint32_t device) {
+  int index;
+  if (table.count < FLEET_MAX_ROVERS) {
+    index = table.count++;
+  } else {
+    index = 0;
+    for (int i = 1; i < FLEET_MAX_ROVERS; i++) {
+      if (table.rovers[i].lastSeen < table.rovers[index].lastSeen) index = i;
+    }
+    removeSlot(table, findSlot(table, table.rovers[index].latest.device));
+    table.evictions++;
+  }
+
+  memset(&table.rovers[index], 0, sizeof(FleetRover));
+  table.rovers[index].latest.device = device;
+  table.slots[findSlot(table, device)] = index;
+  return index;
+}
+
+// Constant work per frame: one decode, one probe, one copy
+FleetResult fleetTableAdd(FleetTable& table, const uint8_t* bytes, size_t length, unsigned long now) {
+  TelemetryFrame frame;
+  if (!decodeTelemetryFrame(bytes, length, frame) || frame.device == 0) {
+    table.rejected++;
+    return FLEET_REJECTED;
+  }
+
+  FleetResult result = FLEET_ACCEPTED;
+  int slot = findSlot(table, frame.device);
+  int index = table.slots[slot];
+  if (index < 0) {
+    index = claimRover(table, frame.device);
+    result = FLEET_NEW_ROVER;
+  }
+
+  FleetRover& rover = table.rovers[index];
+  if (result == FLEET_ACCEPTED) {
+    // A sender clock that went back is a restart and starts a new sequence. Otherwise only
+    // a step forward inside the window is a gap; behind it is a duplicate or reordered datagram.
+    uint8_t ahead = frame.seq - rover.latest.seq;
+    bool restarted = frame.stamp + FLEET_STALE_MS < rover.latest.stamp;
+    if (!restarted) {
+      if (ahead == 0 || ahead >= FLEET_SEQ_WINDOW) {
+        table.outOfOrder++;
+        return FLEET_OUT_OF_ORDER;
+      }
+      rover.lost += ahead - 1;
+    }
+    if (now - rover.lastSeen < FLEET_MIN_FRAME_MS) {
+      rover.latest.seq = frame.seq;  // seen, so not counted as lost later
+      table.rateLimited++;
+      return FLEET_RATE_LIMITED;
+    }
+  }
+
+  rover.latest = frame;
+  rover.lastSeen = now;
+  rover.frames++;
+  table.frames++;
+  return result;
+}
+
+// Alarms outrank any gas level
+static bool ranksAbove(const FleetRover& a, const FleetRover& b) {
+  bool alarmA = a.latest.flags & FRAME_FLAG_GAS_ALARM;
+  bool alarmB = b.latest.flags & FRAME_FLAG_GAS_ALARM;
+  if (alarmA != alarmB) return alarmA;
+  return a.latest.gasDeciPpm > b.latest.gasDeciPpm;
+}
+
+// Totals over online rovers plus the top few; size is fixed whatever the fleet size
+void writeFleetView(const FleetTable& table, JsonWriter& writer, unsigned long now) {
+  int online = 0;
+  int alarms = 0;
+  uint16_t gasMax = 0;
+  float gasSum = 0;
+  unsigned long lost = 0;
+  int top[FLEET_VIEW_TOP];
+  int topCount = 0;
+
+  for (int i = 0; i < table.count; i++) {
+    const FleetRover& rover = table.rovers[i];
+    lost += rover.lost;
+    if (now - rover.lastSeen > FLEET_STALE_MS) continue;
+
+    online++;
+    if (rover.latest.flags & FRAME_FLAG_GAS_ALARM) alarms++;
+    gasMax = max(gasMax, rover.latest.gasDeciPpm);
+    gasSum += rover.latest.gasDeciPpm;
+
+    // Insertion into a short sorted list
+    int pos = topCount;
+    while (pos > 0 && ranksAbove(rover, table.rovers[top[pos - 1]])) pos--;
+    if (pos >= FLEET_VIEW_TOP) continue;
+    if (topCount < FLEET_VIEW_TOP) topCount++;
+    for (int j = topCount - 1; j > pos; j--) top[j] = top[j - 1];
+    top[pos] = i;
+  }
+
+  writer.add("rovers", table.count);
+  writer.add("online", online);
+  writer.add("alarms", alarms);
+  writer.add("gas_max_ppm", gasMax / 10.0, 1);
+  writer.add("gas_mean_ppm", online > 0 ? gasSum / online / 10.0 : 0, 1);
+  writer.add("frames", table.frames);
+  writer.add("rate_limited", table.rateLimited);
+  writer.add("lost", lost);
+  writer.add("evictions", table.evictions);
+
+  // "<device>": "ppm,x_cm,y_cm,alarm"
+  writer.beginObject("top");
+  for (int i = 0; i < topCount; i++) {
+    const TelemetryFrame& frame = table.rovers[top[i]].latest;
+    char device[DEVICE_ID_SIZE];
+    char value[32];
+    snprintf(device, sizeof(device), "%06lx", (unsigned long)frame.device);
+    snprintf(value, sizeof(value), "%u.%u,%d,%d,%d", frame.gasDeciPpm / 10, frame.gasDeciPpm % 10,
+             frame.xCm, frame.yCm, (frame.flags & FRAME_FLAG_GAS_ALARM) ? 1 : 0);
+    writer.add(device, value);
+  }
+  writer.endObject();
+}
+
+#if FEATURE_FLEET_GATEWAY
+static FleetTable fleetTable;
+static WiFiUDP gatewayUdp;
+static bool listening = false;
+#endif
+
+static WiFiUDP broadcastUdp;
+
+// Every rover sends its frames to the LAN; a gateway build also keeps its own
+void broadcastTelemetryFrame(const uint8_t* bytes, size_t length) {
+  if (length == 0) return;
+#if FEATURE_FLEET_GATEWAY
+  fleetTableAdd(fleetTable, bytes, length, millis());
+#endif
+  if (!isNetworkUp()) return;
+  broadcastUdp.beginPacket(IPAddress(255, 255, 255, 255), FLEET_UDP_PORT);
+  broadcastUdp.write(bytes, length);
+  broadcastUdp.endPacket();
+}
+
+#if FEATURE_FLEET_GATEWAY
+static void startListening() {
+  listening = gatewayUdp.begin(FLEET_UDP_PORT);
+  Serial.print("🛰️ Fleet gateway listening on UDP ");
+  Serial.println(FLEET_UDP_PORT);
+}
+
+void initFleetGateway() {
+  fleetTableReset(fleetTable);
+  addNetworkUpHandler(startListening);
+}
+
+void serviceFleetGateway() {
+  if (!listening) return;
+
+  uint8_t bytes[TELEMETRY_FRAME_MAX_SIZE + 8];  // room for fields appended by newer rovers
+  for (int i = 0; i < FLEET_MAX_PACKETS; i++) {
+    int size = gatewayUdp.parsePacket();
+    if (size <= 0) break;
+    int length = gatewayUdp.read(bytes, sizeof(bytes));
+    if (length > 0) fleetTableAdd(fleetTable, bytes, length, millis());
+  }
+}
+
+void publishFleetView() {
+  static char buffer[FLEET_VIEW_SIZE];
+  JsonWriter writer(buffer, sizeof(buffer));
+  writer.beginObject();
+  writer.add("gateway", getDeviceId());
+  writeFleetView(fleetTable, writer, millis());
+  writer.endObject();
+  if (writer.ok()) publishWanFleetView(writer.c_str());
+}
+
+void printFleetStats() {
+  Serial.println("🛰️ Fleet gateway:");
+  Serial.print("  Rovers: "); Serial.print(fleetTable.count);
+  Serial.print("/"); Serial.print(FLEET_MAX_ROVERS);
+  Serial.print("  Frames: "); Serial.print(fleetTable.frames);
+  Serial.print("  Rate limited: "); Serial.print(fleetTable.rateLimited);
+  Serial.print("  Out of order: "); Serial.print(fleetTable.outOfOrder);
+  Serial.print("  Rejected: "); Serial.print(fleetTable.rejected);
+  Serial.print("  Evictions: "); Serial.println(fleetTable.evictions);
+}
+
+#if BENCHMARK_ENABLED
+static uint8_t benchFrames[FLEET_BENCH_ROVERS][TELEMETRY_FRAME_MAX_SIZE];
+static unsigned long benchNow = 0;
+static int benchNext = 0;
+
+// Each rover sends every 2 s, interleaved, as a real fleet would arrive
+static void benchFleetAdd() {
+  uint8_t* bytes = benchFrames[benchNext];
+  bytes[3]++;  // sequence
+  fleetTableAdd(fleetTable, bytes, TELEMETRY_FRAME_MAX_SIZE, benchNow);
+  benchNow += 2000 / FLEET_BENCH_ROVERS + 1;
+  benchNext = (benchNext + 1) % FLEET_BENCH_ROVERS;
+}
+
+static void benchFleetView() {
+  static char buffer[FLEET_VIEW_SIZE];
+  JsonWriter writer(buffer, sizeof(buffer));
+  writer.beginObject();
+  writeFleetView(fleetTable, writer, benchNow);
+  writer.endObject();
+}
+
+// Load test on the live table before the listener starts; leaves it empty
+void runFleetGatewayBenchmarks() {
+  fleetTableReset(fleetTable);
+  for (int i = 0; i < FLEET_BENCH_ROVERS; i++) {
+    TelemetryFrame frame;
+    memset(&frame, 0, sizeof(frame));
+    frame.device = 0x100000 + i * 7919;
+    setTelemetryFrameGas(frame, 20 + (i * 37) % 400);
+    setTelemetryFramePose(frame, i * 50, -i * 30, 0);
+    if (i % 17 == 0) frame.flags = FRAME_FLAG_GAS_ALARM;
+    encodeTelemetryFrame(frame, benchFrames[i], TELEMETRY_FRAME_MAX_SIZE);
+  }
+
+  BenchmarkResult add = runBenchmark("fleetFrame", benchFleetAdd, 12000);
+  printBenchmarkResult(add);
+  printBenchmarkResult(runBenchmark("fleetView", benchFleetView, 200));
+
+  static char buffer[FLEET_VIEW_SIZE];
+  JsonWriter writer(buffer, sizeof(buffer));
+  writer.beginObject();
+  writeFleetView(fleetTable, writer, benchNow);
+  writer.endObject();
+
+  Serial.print("FLEETSIM,rovers="); Serial.print(FLEET_BENCH_ROVERS);
+  Serial.print(",tracked="); Serial.print(fleetTable.count);
+  Serial.print(",table_bytes="); Serial.print(sizeof(FleetTable));
+  Serial.print(",frames_per_s="); Serial.print(add.nsPerOp > 0 ? 1000000000UL / add.nsPerOp : 0);
+  Serial.print(",accepted="); Serial.print(fleetTable.frames);
+  Serial.print(",rate_limited="); Serial.print(fleetTable.rateLimited);
+  Serial.print(",evictions="); Serial.print(fleetTable.evictions);
+  Serial.print(",view_bytes="); Serial.println(writer.ok() ? writer.length() : 0);
+  fleetTableReset(fleetTable);
+}
+#endif
+#endif
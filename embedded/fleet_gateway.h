@@ -0,0 +1,78 @@
+/*
+ * Fleet Gateway for ToxiRover
+ * Merges telemetry frames from many rovers on the local network into one view
+ *
+ * Features:
+ * - Rovers broadcast their binary telemetry frames over UDP
+ * - Gateway keeps the latest frame per rover in a fixed, hashed table
+ * - Bounded fan-in: packets per tick, frames per rover and table size are capped
+ * - One merged fleet view per interval on the shared MQTT fleet feed
+ * - Load test with 100+ simulated rovers with BENCHMARK_ENABLED
+ */
+
+#ifndef FLEET_GATEWAY_H
+#define FLEET_GATEWAY_H
+
+#include <Arduino.h>
+#include "features.h"
+#include "telemetry_frame.h"
+#include "json_writer.h"
+#include "benchmark.h"
+
+#define FLEET_UDP_PORT 4210
+#define FLEET_MAX_ROVERS 128
+#define FLEET_HASH_SLOTS 256           // power of two, twice the table
+#define FLEET_MIN_FRAME_MS 500         // frames closer together from one rover are dropped
+#define FLEET_STALE_MS 10000           // no frame for this long counts as offline
+#define FLEET_SEQ_WINDOW 128           // sequence steps ahead that count as a gap; behind is a repeat
+#define FLEET_MAX_PACKETS 16           // per receive tick, so a burst can't starve the loop
+#define FLEET_RECEIVE_INTERVAL 20      // ms
+#define FLEET_VIEW_INTERVAL 5000       // ms between merged views, whatever the fleet size
+#define FLEET_VIEW_TOP 5               // rovers listed in the view, alarms first then highest gas
+#define FLEET_VIEW_SIZE 512
+#define FLEET_BENCH_ROVERS 120
+
+enum FleetResult {
+  FLEET_ACCEPTED,
+  FLEET_NEW_ROVER,
+  FLEET_RATE_LIMITED,
+  FLEET_OUT_OF_ORDER,                  // a duplicate or late datagram; the newer frame is kept
+  FLEET_REJECTED                       // not a telemetry frame, or no device id
+};
+
+struct FleetRover {
+  unsigned long lastSeen;
+  unsigned long frames;
+  unsigned long lost;                  // forward sequence gaps
+  TelemetryFrame latest;
+};
+
+struct FleetTable {
+  FleetRover rovers[FLEET_MAX_ROVERS];
+  int16_t slots[FLEET_HASH_SLOTS];     // rover index, or -1 for empty
+  int count;
+  unsigned long frames;
+  unsigned long rateLimited;
+  unsigned long outOfOrder;
+  unsigned long rejected;
+  unsigned long evictions;
+};
+
+// Function declarations
+void fleetTableReset(FleetTable& table);
+FleetResult fleetTableAdd(FleetTable& table, const uint8_t* bytes, size_t length, unsigned long now);
+void writeFleetView(const FleetTable& table, JsonWriter& writer, unsigned long now);
+void broadcastTelemetryFrame(const uint8_t* bytes, size_t length);
+
+#if FEATURE_FLEET_GATEWAY
+void initFleetGateway();
+void serviceFleetGateway();
+void publishFleetView();
+void printFleetStats();
+
+#if BENCHMARK_ENABLED
+void runFleetGatewayBenchmarks();
+#endif
+#endif
+
+#endif
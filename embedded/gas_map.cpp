@@ -0,0 +1,237 @@
+/*
+ * Spatial Gas Map Implementation for ToxiRover
+ */
+
+#include "gas_map.h"
+#include "dead_reckoning.h"
+
+GasMap gasMap;
+
+static int floorDiv(int value, int divisor) {
+  return value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+}
+
+static uint32_t tileHash(int tx, int ty) {
+  return ((uint32_t)tx * 73856093UL ^ (uint32_t)ty * 19349663UL) & (GAS_MAP_HASH_SLOTS - 1);
+}
+
+void gasMapReset(GasMap& map) {
+  memset(&map, 0, sizeof(map));
+  memset(map.slots, -1, sizeof(map.slots));
+}
+
+// Linear probe; returns the slot holding the tile, or the empty slot ending the run
+static int findSlot(const GasMap& map, int tx, int ty) {
+  uint32_t slot = tileHash(tx, ty);
+  while (map.slots[slot] >= 0) {
+    const GasMapTile& tile = map.tiles[map.slots[slot]];
+    if (tile.tx == tx && tile.ty == ty) break;
+    slot = (slot + 1) & (GAS_MAP_HASH_SLOTS - 1);
+  }
+  return slot;
+}
+
+GasMapTile* gasMapFind(GasMap& map, int tx, int ty) {
+  int slot = findSlot(map, tx, ty);
+  return map.slots[slot] >= 0 ? &map.tiles[map.slots[slot]] : NULL;
+}
+
+// Backward-shift delete keeps every probe run unbroken without tombstones
+static void removeSlot(GasMap& map, int slot) {
+  int hole = slot;
+  int next = (hole + 1) & (GAS_MAP_HASH_SLOTS - 1);
+  while (map.slots[next] >= 0) {
+    const GasMapTile& tile = map.tiles[map.slots[next]];
+    int home = tileHash(tile.tx, tile.ty);
+    // Move the entry back if its home is not cyclically within (hole, next]
+    bool between = hole <= next ? (home > hole && home <= next) : (home > hole || home <= next);
+    if (!between) {
+      map.slots[hole] = map.slots[next];
+      hole = next;
+    }
+    next = (next + 1) & (GAS_MAP_HASH_SLOTS - 1);
+  }
+  map.slots[hole] = -1;
+}
+
+// Least recently touched tile, preferring ones with nothing left to upload
+static int pickVictim(const GasMap& map) {
+  int victim = -1;
+  for (int pass = 0; pass < 2 && victim < 0; pass++) {
+    for (int i = 0; i < GAS_MAP_MAX_TILES; i++) {
+      const GasMapTile& tile = map.tiles[i];
+      if (pass == 0 && tile.dirtyCells != 0) continue;
+      if (victim < 0 || tile.touched < map.tiles[victim].touched) victim = i;
+    }
+  }
+  return victim;
+}
+
+static GasMapTile* claimTile(GasMap& map, int tx, int ty, unsigned long now) {
+  int index;
+  if (map.tileCount < GAS_MAP_MAX_TILES) {
+    index = map.tileCount++;
+  } else {
+    index = pickVictim(map);
+    GasMapTile& old = map.tiles[index];
+    removeSlot(map, findSlot(map, old.tx, old.ty));
+    map.evictions++;
+    if (old.dirtyCells != 0) map.dirtyEvictions++;
+  }
+
+  GasMapTile& tile = map.tiles[index];
+  memset(&tile, 0, sizeof(tile));
+  tile.tx = tx;
+  tile.ty = ty;
+  tile.touched = now;
+  map.slots[findSlot(map, tx, ty)] = index;
+  return &tile;
+}
+
+bool gasMapAdd(GasMap& map, float xCm, float yCm, float ppm, unsigned long now) {
+  int cx = (int)floorf(xCm / GAS_MAP_CELL_CM);
+  int cy = (int)floorf(yCm / GAS_MAP_CELL_CM);
+  int tx = floorDiv(cx, GAS_MAP_TILE_SIZE);
+  int ty = floorDiv(cy, GAS_MAP_TILE_SIZE);
+  if (tx < INT16_MIN || tx > INT16_MAX || ty < INT16_MIN || ty > INT16_MAX) return false;
+
+  GasMapTile* tile = gasMapFind(map, tx, ty);
+  if (tile == NULL) tile = claimTile(map, tx, ty, now);
+
+  int index = (cy - ty * GAS_MAP_TILE_SIZE) * GAS_MAP_TILE_SIZE + (cx - tx * GAS_MAP_TILE_SIZE);
+  GasMapCell& cell = tile->cells[index];
+  if (ppm < 0) ppm = 0;
+  if (cell.count < UINT16_MAX) cell.count++;
+  cell.mean += (ppm - cell.mean) / cell.count;
+  cell.max = max(cell.max, (uint16_t)min(ppm, 65535.0f));
+
+  tile->dirtyCells |= 1 << index;
+  tile->touched = now;
+  map.samples++;
+  return true;
+}
+
+// Oldest change first, so a busy tile can't starve the others
+GasMapTile* gasMapNextDirty(GasMap& map) {
+  GasMapTile* next = NULL;
+  for (int i = 0; i < map.tileCount; i++) {
+    GasMapTile& tile = map.tiles[i];
+    if (tile.dirtyCells != 0 && (next == NULL || tile.touched < next->touched)) next = &tile;
+  }
+  return next;
+}
+
+void gasMapTileKey(const GasMapTile& tile, char* key) {
+  snprintf(key, GAS_MAP_KEY_SIZE, "%d_%d", tile.tx, tile.ty);
+}
+
+// Cells as "c<row * size + column>": "mean,max,count", row 0 at the tile's low y edge
+void gasMapWriteCells(const GasMapTile& tile, JsonWriter& writer, bool dirtyOnly) {
+  char key[6];
+  char value[24];
+  for (int i = 0; i < GAS_MAP_TILE_CELLS; i++) {
+    const GasMapCell& cell = tile.cells[i];
+    if (cell.count == 0 || (dirtyOnly && !(tile.dirtyCells & (1 << i)))) continue;
+    snprintf(key, sizeof(key), "c%d", i);
+    snprintf(value, sizeof(value), "%d,%u,%u", (int)(cell.mean + 0.5f), cell.max, cell.count);
+    writer.add(key, value);
+  }
+}
+
+void gasMapMarkSent(GasMap& map, GasMapTile& tile) {
+  tile.dirtyCells = 0;
+  map.uploads++;
+}
+
+// ---------------------------------------------------------------- live map
+
+void initGasMap() {
+  gasMapReset(gasMap);
+  Serial.print("🗺️ Gas map: "); Serial.print(GAS_MAP_CELL_CM); Serial.print(" cm cells, ");
+  Serial.print(GAS_MAP_MAX_TILES); Serial.print(" tiles, ");
+  Serial.print(sizeof(GasMap)); Serial.println(" bytes");
+}
+
+void recordGasAtPose(float ppm) {
+  Pose pose = getPose();
+  gasMapAdd(gasMap, pose.x, pose.y, ppm, millis());
+}
+
+// Dashboard message for the next changed tile; the caller marks it sent once delivered
+const char* formatNextGasTile(char* buffer, size_t size, GasMapTile** tile) {
+  *tile = gasMapNextDirty(gasMap);
+  if (*tile == NULL) return NULL;
+
+  char key[GAS_MAP_KEY_SIZE];
+  gasMapTileKey(**tile, key);
+
+  JsonWriter writer(buffer, size);
+  writer.beginObject();
+  writer.add("tile", key);
+  writer.add("cell_cm", GAS_MAP_CELL_CM);
+  writer.add("size", GAS_MAP_TILE_SIZE);
+  writer.beginObject("cells");
+  gasMapWriteCells(**tile, writer, true);
+  writer.endObject();
+  writer.endObject();
+  return writer.ok() ? buffer : NULL;
+}
+
+void printGasMapStats() {
+  int dirty = 0;
+  for (int i = 0; i < gasMap.tileCount; i++) {
+    if (gasMap.tiles[i].dirtyCells != 0) dirty++;
+  }
+  Serial.println("🗺️ Gas map:");
+  Serial.print("  Tiles: "); Serial.print(gasMap.tileCount);
+  Serial.print("/"); Serial.print(GAS_MAP_MAX_TILES);
+  Serial.print("  Dirty: "); Serial.print(dirty);
+  Serial.print("  Memory: "); Serial.print(sizeof(GasMap)); Serial.println(" bytes");
+  Serial.print("  Samples: "); Serial.print(gasMap.samples);
+  Serial.print("  Uploads: "); Serial.print(gasMap.uploads);
+  Serial.print("  Evictions: "); Serial.print(gasMap.evictions);
+  Serial.print(" ("); Serial.print(gasMap.dirtyEvictions); Serial.println(" unsent)");
+}
+
+#if BENCHMARK_ENABLED
+static float benchX = 0;
+static unsigned long benchNow = 0;
+
+// Walks a lawnmower pattern, so adds mix cell hits, new tiles and evictions
+static void benchGasMapAdd() {
+  benchNow++;
+  benchX += 7;
+  float y = (float)((int)(benchX / 1000) % 10) * 60;
+  gasMapAdd(gasMap, fmodf(benchX, 1000), y, 120, benchNow);
+}
+
+static void benchGasMapHit() {
+  gasMapAdd(gasMap, 30, 30, 120, ++benchNow);
+}
+
+static void benchGasMapFormat() {
+  static char buffer[GAS_MAP_TILE_JSON_SIZE];
+  GasMapTile* tile = &gasMap.tiles[0];
+  tile->dirtyCells = 0xFFFF;
+  JsonWriter writer(buffer, sizeof(buffer));
+  writer.beginObject();
+  gasMapWriteCells(*tile, writer, true);
+  writer.endObject();
+}
+
+// Uses the live map before any samples arrive, then leaves it empty again
+void runGasMapBenchmarks() {
+  gasMapReset(gasMap);
+  printBenchmarkResult(runBenchmark("gasMapHit", benchGasMapHit, 10000));
+  printBenchmarkResult(runBenchmark("gasMapAdd", benchGasMapAdd, 10000));
+  printBenchmarkResult(runBenchmark("gasMapFormat", benchGasMapFormat, 1000));
+
+  Serial.print("GASMAP,bytes="); Serial.print(sizeof(GasMap));
+  Serial.print(",tile_bytes="); Serial.print(sizeof(GasMapTile));
+  Serial.print(",max_tiles="); Serial.print(GAS_MAP_MAX_TILES);
+  Serial.print(",coverage_m2="); Serial.print(GAS_MAP_MAX_TILES * GAS_MAP_TILE_SIZE * GAS_MAP_CELL_CM / 100.0f * GAS_MAP_TILE_SIZE * GAS_MAP_CELL_CM / 100.0f, 1);
+  Serial.print(",samples="); Serial.print(gasMap.samples);
+  Serial.print(",evictions="); Serial.println(gasMap.evictions);
+  gasMapReset(gasMap);
+}
+#endif
@@ -0,0 +1,72 @@
+/*
+ * Spatial Gas Map for ToxiRover
+ * Accumulates gas readings at the dead-reckoned pose into a bounded grid
+ *
+ * Features:
+ * - Sparse tiles of cells found through a small open-addressing hash
+ * - Per-cell mean, max and sample count
+ * - Fixed tile pool; least recently touched (clean first) tiles are evicted
+ * - Per-cell dirty bits so only changed cells of changed tiles are uploaded
+ * - Memory and update-cost benchmark with BENCHMARK_ENABLED
+ */
+
+#ifndef GAS_MAP_H
+#define GAS_MAP_H
+
+#include <Arduino.h>
+#include "json_writer.h"
+#include "benchmark.h"
+
+#define GAS_MAP_CELL_CM 25               // grid resolution
+#define GAS_MAP_TILE_SIZE 4              // cells per tile side; a full tile fits one upload payload
+#define GAS_MAP_TILE_CELLS (GAS_MAP_TILE_SIZE * GAS_MAP_TILE_SIZE)
+#define GAS_MAP_MAX_TILES 24             // 24 m² of coverage in ~3.5 KB
+#define GAS_MAP_HASH_SLOTS 64            // power of two, well above the tile count
+#define GAS_MAP_UPLOAD_INTERVAL 3000     // ms between tile uploads
+#define GAS_MAP_KEY_SIZE 16              // "-32768_-32768"
+#define GAS_MAP_TILE_JSON_SIZE 512       // a full tile of saturated cells
+
+struct GasMapCell {
+  float mean;                     // ppm
+  uint16_t max;                   // ppm
+  uint16_t count;                 // saturates; the mean then stays a running estimate
+};
+
+struct GasMapTile {
+  int16_t tx, ty;                 // tile coordinates; tile (0,0) starts at the origin
+  uint16_t dirtyCells;            // bit per cell changed since the last upload
+  unsigned long touched;
+  GasMapCell cells[GAS_MAP_TILE_CELLS];
+};
+
+struct GasMap {
+  GasMapTile tiles[GAS_MAP_MAX_TILES];
+  int8_t slots[GAS_MAP_HASH_SLOTS];  // tile index, or -1 for empty
+  int tileCount;
+  unsigned long samples;
+  unsigned long evictions;
+  unsigned long dirtyEvictions;   // tiles dropped before their changes were uploaded
+  unsigned long uploads;
+};
+
+// Function declarations
+void gasMapReset(GasMap& map);
+bool gasMapAdd(GasMap& map, float xCm, float yCm, float ppm, unsigned long now);
+GasMapTile* gasMapFind(GasMap& map, int tx, int ty);
+GasMapTile* gasMapNextDirty(GasMap& map);
+void gasMapTileKey(const GasMapTile& tile, char* key);
+void gasMapWriteCells(const GasMapTile& tile, JsonWriter& writer, bool dirtyOnly);
+void gasMapMarkSent(GasMap& map, GasMapTile& tile);
+
+extern GasMap gasMap;
+
+void initGasMap();
+void recordGasAtPose(float ppm);
+const char* formatNextGasTile(char* buffer, size_t size, GasMapTile** tile);
+void printGasMapStats();
+
+#if BENCHMARK_ENABLED
+void runGasMapBenchmarks();
+#endif
+
+#endif
@@ -0,0 +1,366 @@
+/*
+ * Gas Source Seeker Implementation for ToxiRover
+ */
+
+#include "gas_seeker.h"
+#include "gas_sensor.h"
+#include "config_store.h"
+#include "task_scheduler.h"
+#include "power_manager.h"
+#include "json_writer.h"
+
+static const char* const SEEK_STATE_NAMES[SEEK_STATE_COUNT] = {
+  "IDLE",
+  "SURGE",
+  "CAST",
+  "EXPLORE",
+  "FOUND"
+};
+
+static GasSeeker liveSeeker;
+static SeekOutput seekOutput = NULL;
+static TaskId seekTask = TASK_INVALID;
+static int seekSpeed = 0;
+static SeekState reportedState = SEEK_IDLE;
+static unsigned long seekStartedAt = 0;
+static unsigned long lastTimeToSource = 0;
+static unsigned long seekRuns = 0;
+static unsigned long seekFinds = 0;
+static SeekStateHandler stateHandlers[SEEK_MAX_HANDLERS];
+static int stateHandlerCount = 0;
+
+// ---------------------------------------------------------------- policy
+
+static uint32_t seekRandom(GasSeeker& seeker) {
+  seeker.rng = seeker.rng * 1664525UL + 1013904223UL;
+  return seeker.rng >> 8;
+}
+
+static void enterState(GasSeeker& seeker, SeekState state, unsigned long now) {
+  seeker.state = state;
+  seeker.stateSince = now;
+}
+
+static void beginSurge(GasSeeker& seeker, unsigned long now) {
+  enterState(seeker, SEEK_SURGE, now);
+  seeker.best = seeker.filtered;
+  seeker.lastBest = now;
+  seeker.casts = 0;
+}
+
+// Each cast swings back past the last leg, so the turn grows with the count
+static void beginCast(GasSeeker& seeker, unsigned long now) {
+  enterState(seeker, SEEK_CAST, now);
+  seeker.turnMs = SEEK_CAST_TURN * (seeker.casts + 1);
+  seeker.legMs = SEEK_CAST_LEG;
+}
+
+// Casting found nothing: leave in a random direction and start a fresh trail
+static void beginExplore(GasSeeker& seeker, unsigned long now) {
+  enterState(seeker, SEEK_EXPLORE, now);
+  seeker.turnDir = (seekRandom(seeker) & 1) ? 1 : -1;
+  seeker.turnMs = SEEK_CAST_TURN + seekRandom(seeker) % (3 * SEEK_CAST_TURN);
+  seeker.legMs = SEEK_EXPLORE_LEG;
+  seeker.best = seeker.filtered;
+  seeker.casts = 0;
+}
+
+void gasSeekerStart(GasSeeker& seeker, float ppm, float sourcePpm, uint32_t seed, unsigned long now) {
+  memset(&seeker, 0, sizeof(seeker));
+  seeker.filtered = ppm;
+  seeker.sourcePpm = sourcePpm;
+  seeker.turnDir = 1;
+  seeker.rng = seed | 1;
+  beginSurge(seeker, now);
+}
+
+SeekCommand gasSeekerUpdate(GasSeeker& seeker, float ppm, unsigned long now) {
+  SeekCommand command = {false, SEEK_HEADING_AHEAD};
+  if (seeker.state == SEEK_IDLE || seeker.state == SEEK_FOUND) return command;
+
+  seeker.filtered += SEEK_FILTER_ALPHA * (ppm - seeker.filtered);
+  if (seeker.filtered >= seeker.sourcePpm) {
+    enterState(seeker, SEEK_FOUND, now);
+    return command;
+  }
+
+  bool climbing = seeker.filtered > seeker.best + SEEK_RISE_PPM;
+  switch (seeker.state) {
+    case SEEK_SURGE:
+      if (climbing) {
+        seeker.best = seeker.filtered;
+        seeker.lastBest = now;
+      } else if (seeker.filtered < seeker.best * SEEK_LOST_RATIO || now - seeker.lastBest > SEEK_SURGE_TIMEOUT) {
+        beginCast(seeker, now);
+      }
+      break;
+
+    case SEEK_CAST:
+    case SEEK_EXPLORE:
+      if (climbing) {
+        beginSurge(seeker, now);
+      } else if (now - seeker.stateSince >= seeker.turnMs + seeker.legMs) {
+        if (seeker.state == SEEK_CAST) {
+          seeker.turnDir = -seeker.turnDir;
+          seeker.casts++;
+        }
+        if (seeker.casts >= SEEK_MAX_CASTS) beginExplore(seeker, now);
+        else beginCast(seeker, now);
+      }
+      break;
+
+    default:
+      break;
+  }
+
+  command.moving = true;
+  if (seeker.state != SEEK_SURGE && now - seeker.stateSince < seeker.turnMs) {
+    command.heading = SEEK_HEADING_AHEAD + seeker.turnDir * SEEK_TURN_SWING;
+  }
+  return command;
+}
+
+const char* getSeekStateName(SeekState state) {
+  if (state < 0 || state >= SEEK_STATE_COUNT) return "UNKNOWN";
+  return SEEK_STATE_NAMES[state];
+}
+
+// ---------------------------------------------------------------- live seeker
+
+static void reportSeekState() {
+  if (liveSeeker.state == reportedState) return;
+  reportedState = liveSeeker.state;
+
+  Serial.print("👃 Seek: "); Serial.print(SEEK_STATE_NAMES[reportedState]);
+  Serial.print(" at "); Serial.print(liveSeeker.filtered, 0); Serial.println(" ppm");
+  for (int i = 0; i < stateHandlerCount; i++) stateHandlers[i](reportedState, liveSeeker.filtered);
+}
+
+static void finishSeeking() {
+  setTaskEnabled(seekTask, false);
+  seekOutput(SEEK_HEADING_AHEAD, 0);
+  notePowerMotion(false);
+  reportSeekState();
+}
+
+void initGasSeeker(SeekOutput output) {
+  seekOutput = output;
+  liveSeeker.state = SEEK_IDLE;
+  seekTask = addPeriodicTask("seek", serviceGasSeeker, SEEK_SAMPLE_INTERVAL, PRIORITY_NORMAL);
+  setTaskEnabled(seekTask, false);
+}
+
+void startGasSeeking(int speed) {
+  if (seekOutput == NULL || seekTask == TASK_INVALID) return;
+  seekSpeed = speed;
+  seekStartedAt = millis();
+  seekRuns++;
+  gasSeekerStart(liveSeeker, readGasSensor(), roverConfig.gasDangerThreshold, ESP.getChipId() ^ micros(), seekStartedAt);
+
+  setTaskEnabled(seekTask, true);
+  notePowerMotion(true);
+  reportSeekState();
+}
+
+// Only stops the motors if seeking was driving them
+void stopGasSeeking() {
+  if (!isGasSeeking()) return;
+  liveSeeker.state = SEEK_IDLE;
+  finishSeeking();
+}
+
+void serviceGasSeeker() {
+  SeekCommand command = gasSeekerUpdate(liveSeeker, readGasSensor(), millis());
+
+  if (liveSeeker.state == SEEK_FOUND) {
+    seekFinds++;
+    lastTimeToSource = millis() - seekStartedAt;
+    finishSeeking();
+    return;
+  }
+
+  seekOutput(command.heading, command.moving ? seekSpeed : 0);
+  reportSeekState();
+}
+
+// Drive letters and stop from the remote take over from the seeker
+void noteSeekDriveCommand(char command) {
+  if (!isGasSeeking() || command == '\0' || strchr("FBRLGHIJS", command) == NULL) return;
+  Serial.println("👃 Seek cancelled by manual drive");
+  stopGasSeeking();
+}
+
+void addSeekStateHandler(SeekStateHandler handler) {
+  if (stateHandlerCount >= SEEK_MAX_HANDLERS) return;
+  stateHandlers[stateHandlerCount++] = handler;
+}
+
+bool isGasSeeking() {
+  return liveSeeker.state == SEEK_SURGE || liveSeeker.state == SEEK_CAST || liveSeeker.state == SEEK_EXPLORE;
+}
+
+SeekState getSeekState() {
+  return liveSeeker.state;
+}
+
+const char* formatSeekStatus(char* buffer, size_t size) {
+  JsonWriter writer(buffer, size);
+  writer.beginObject();
+  writer.add("state", SEEK_STATE_NAMES[liveSeeker.state]);
+  writer.add("ppm", (double)liveSeeker.filtered, 1);
+  writer.add("best_ppm", (double)liveSeeker.best, 1);
+  writer.add("casts", liveSeeker.casts);
+  writer.add("elapsed_ms", isGasSeeking() ? millis() - seekStartedAt : 0UL);
+  writer.add("runs", seekRuns);
+  writer.add("found", seekFinds);
+  writer.add("last_time_to_source_ms", lastTimeToSource);
+  writer.endObject();
+  return buffer;
+}
+
+void printSeekStats() {
+  Serial.println("👃 Gas seek:");
+  Serial.print("  State: "); Serial.print(SEEK_STATE_NAMES[liveSeeker.state]);
+  Serial.print("  Filtered: "); Serial.print(liveSeeker.filtered, 0); Serial.println(" ppm");
+  Serial.print("  Runs: "); Serial.print(seekRuns);
+  Serial.print("  Found: "); Serial.print(seekFinds);
+  Serial.print("  Last time to source: "); Serial.print(lastTimeToSource); Serial.println(" ms");
+}
+
+#if BENCHMARK_ENABLED
+// ---------------------------------------------------------------- plume simulation
+#include "vfh_planner.h"
+
+#define GASSIM_FIELD 600             // cm square
+#define GASSIM_PEAK 700              // ppm at the source
+#define GASSIM_BACKGROUND 20         // ppm
+#define GASSIM_SOURCE_SIGMA 25       // cm; diffusion around the source, also upwind
+#define GASSIM_PLUME_SIGMA0 20       // cm; plume half width at the source
+#define GASSIM_PLUME_SPREAD 0.25f    // plume widening per cm downwind
+#define GASSIM_SENSOR_TAU 1500       // ms; MQ element response time
+#define GASSIM_CM_PER_PWM 0.06f      // as in the obstacle planner simulation
+#define GASSIM_WHEELBASE 14          // cm
+#define GASSIM_SPEED 300             // PWM
+#define GASSIM_FOUND_RADIUS 50       // cm; a FOUND further away is a false alarm
+#define GASSIM_TIMEOUT 240000        // ms
+
+struct GasSimWorld {
+  float sourceX, sourceY;
+  float windX, windY;                // unit vector the plume travels along
+  float x, y, theta;
+  float sensed;                      // lagged sensor reading
+};
+
+static uint32_t gasSimSeed;
+
+static float gasSimRandom(float low, float high) {
+  gasSimSeed = gasSimSeed * 1664525UL + 1013904223UL;
+  return low + (high - low) * (gasSimSeed >> 8) / 16777216.0f;
+}
+
+// Time-averaged Gaussian plume plus diffusion around the source
+static float gasSimConcentration(const GasSimWorld& world, float x, float y) {
+  float rx = x - world.sourceX, ry = y - world.sourceY;
+  float down = rx * world.windX + ry * world.windY;
+  float cross = -rx * world.windY + ry * world.windX;
+
+  float ppm = GASSIM_PEAK * expf(-(rx * rx + ry * ry) / (2.0f * GASSIM_SOURCE_SIGMA * GASSIM_SOURCE_SIGMA));
+  if (down > 0) {
+    float sigma = GASSIM_PLUME_SIGMA0 + GASSIM_PLUME_SPREAD * down;
+    ppm += GASSIM_PEAK * (GASSIM_PLUME_SIGMA0 / sigma) * expf(-cross * cross / (2 * sigma * sigma));
+  }
+  return ppm;
+}
+
+static void gasSimBuildWorld(GasSimWorld& world, uint32_t seed) {
+  gasSimSeed = seed;
+  world.sourceX = gasSimRandom(150, GASSIM_FIELD - 150);
+  world.sourceY = gasSimRandom(150, GASSIM_FIELD - 150);
+  float wind = gasSimRandom(0, TWO_PI);
+  world.windX = cosf(wind);
+  world.windY = sinf(wind);
+
+  // Start downwind, roughly in the plume, facing a random direction
+  float down = gasSimRandom(200, 320), cross = gasSimRandom(-80, 80);
+  world.x = constrain(world.sourceX + down * world.windX - cross * world.windY, 30.0f, GASSIM_FIELD - 30.0f);
+  world.y = constrain(world.sourceY + down * world.windY + cross * world.windX, 30.0f, GASSIM_FIELD - 30.0f);
+  world.theta = gasSimRandom(0, TWO_PI);
+  world.sensed = GASSIM_BACKGROUND + gasSimConcentration(world, world.x, world.y);
+}
+
+// Plume intermittency and ADC noise, then the sensor's first-order lag
+static float gasSimSense(GasSimWorld& world, unsigned long ms) {
+  float ppm = gasSimConcentration(world, world.x, world.y) * gasSimRandom(0.4f, 1.6f);
+  ppm += GASSIM_BACKGROUND + gasSimRandom(-5, 5);
+  world.sensed += (ppm - world.sensed) * min(1.0f, (float)ms / GASSIM_SENSOR_TAU);
+  return world.sensed;
+}
+
+static void gasSimDrive(GasSimWorld& world, int left, int right, unsigned long ms) {
+  const int substeps = 10;
+  float dt = ms / 1000.0f / substeps;
+  float vl = left * GASSIM_CM_PER_PWM, vr = right * GASSIM_CM_PER_PWM;
+  for (int i = 0; i < substeps; i++) {
+    float v = (vl + vr) / 2;
+    world.theta += (vr - vl) / GASSIM_WHEELBASE * dt;
+    world.x = constrain(world.x + v * cosf(world.theta) * dt, 15.0f, GASSIM_FIELD - 15.0f);  // slides along walls
+    world.y = constrain(world.y + v * sinf(world.theta) * dt, 15.0f, GASSIM_FIELD - 15.0f);
+  }
+}
+
+// Open field; headings go through the planner's steering law as they do live
+static SeekState gasSimRunTrial(uint32_t seed, unsigned long& elapsed, bool& nearSource) {
+  GasSimWorld world;
+  gasSimBuildWorld(world, seed);
+
+  VfhPlanner steering;
+  vfhReset(steering);
+  GasSeeker seeker;
+  gasSeekerStart(seeker, world.sensed, GAS_DANGER_THRESHOLD, seed, 0);
+
+  for (elapsed = 0; elapsed < GASSIM_TIMEOUT; elapsed += SEEK_SAMPLE_INTERVAL) {
+    SeekCommand command = gasSeekerUpdate(seeker, gasSimSense(world, SEEK_SAMPLE_INTERVAL), elapsed);
+    if (seeker.state == SEEK_FOUND) break;
+
+    VfhDecision drive = vfhPlan(steering, command.heading, command.moving ? GASSIM_SPEED : 0, elapsed + 1);
+    gasSimDrive(world, drive.left, drive.right, SEEK_SAMPLE_INTERVAL);
+    if ((elapsed / SEEK_SAMPLE_INTERVAL) % 50 == 0) yield();
+  }
+
+  float dx = world.x - world.sourceX, dy = world.y - world.sourceY;
+  nearSource = sqrtf(dx * dx + dy * dy) < GASSIM_FOUND_RADIUS;
+  return seeker.state;
+}
+
+GasSimResult simulateGasSeek(int trials) {
+  GasSimResult result = {trials, 0, 0, 0, 0, 0};
+  for (int trial = 0; trial < trials; trial++) {
+    unsigned long elapsed;
+    bool nearSource;
+    if (gasSimRunTrial(0x6A500000UL + trial, elapsed, nearSource) != SEEK_FOUND) result.timedOut++;
+    else if (!nearSource) result.falseFound++;
+    else {
+      result.found++;
+      result.totalMs += elapsed;
+      if (elapsed <= GASSIM_TARGET) result.withinTarget++;
+    }
+    yield();
+  }
+  return result;
+}
+
+// Runs the seeker over seeded plume fields and reports time to source
+void runGasSeekSimulation(int trials) {
+  GasSimResult result = simulateGasSeek(trials);
+
+  Serial.print("GASSIM,trials="); Serial.print(trials);
+  Serial.print(",found="); Serial.print(result.found);
+  Serial.print(",false_found="); Serial.print(result.falseFound);
+  Serial.print(",timeout="); Serial.print(result.timedOut);
+  Serial.print(",success_pct="); Serial.print(trials > 0 ? 100.0f * result.found / trials : 0, 1);
+  Serial.print(",mean_time_s="); Serial.print(result.found > 0 ? result.totalMs / 1000.0f / result.found : 0, 2);
+  Serial.print(",target_s="); Serial.print(GASSIM_TARGET / 1000);
+  Serial.print(",within_target_pct=");
+  Serial.println(trials > 0 ? 100.0f * result.withinTarget / trials : 0, 1);
+}
+#endif
@@ -0,0 +1,101 @@
+/*
+ * Gas Source Seeker for ToxiRover
+ * Autonomous mode that follows the concentration gradient to a leak
+ *
+ * Features:
+ * - Surge while readings climb, cast side to side when the trail is lost
+ * - Random exploration legs after repeated failed casts
+ * - Stops and reports when the source threshold is reached
+ * - Drives through the obstacle planner; any manual drive command takes over
+ * - State published to the dashboard and served as JSON at /seek
+ * - Simulated plume benchmark (time to source) with BENCHMARK_ENABLED
+ */
+
+#ifndef GAS_SEEKER_H
+#define GAS_SEEKER_H
+
+#include <Arduino.h>
+#include "benchmark.h"
+
+#define SEEK_SAMPLE_INTERVAL 250    // ms; one gas sample and one steering decision per tick
+#define SEEK_FILTER_ALPHA 0.3       // EMA weight of a new sample; MQ sensors are noisy
+#define SEEK_RISE_PPM 8             // filtered gain over the best so far that counts as climbing
+#define SEEK_LOST_RATIO 0.9         // below this fraction of the best the trail is lost
+#define SEEK_SURGE_TIMEOUT 6000     // ms surging without a new best before casting
+#define SEEK_CAST_TURN 600          // ms first cast turn; each further cast turns longer
+#define SEEK_CAST_LEG 2500          // ms straight after each cast turn
+#define SEEK_MAX_CASTS 5            // failed casts before an exploration leg
+#define SEEK_EXPLORE_LEG 6000       // ms
+#define SEEK_MAX_HANDLERS 4
+#define SEEK_STATUS_SIZE 160
+
+// Body-relative headings as for the obstacle planner: 90 = ahead, 180 = hard left
+#define SEEK_HEADING_AHEAD 90
+#define SEEK_TURN_SWING 90
+
+enum SeekState {
+  SEEK_IDLE,
+  SEEK_SURGE,
+  SEEK_CAST,
+  SEEK_EXPLORE,
+  SEEK_FOUND,
+  SEEK_STATE_COUNT
+};
+
+// Pure state machine; driven by millis() live and by simulated time in the benchmark
+struct GasSeeker {
+  SeekState state;
+  float filtered;                   // ppm
+  float best;                       // highest filtered ppm on the current trail
+  float sourcePpm;                  // filtered reading that counts as at the source
+  unsigned long stateSince;
+  unsigned long lastBest;
+  unsigned long turnMs;             // current manoeuvre: turn this long, then go straight
+  unsigned long legMs;
+  int turnDir;                      // +1 left, -1 right
+  int casts;
+  uint32_t rng;
+};
+
+struct SeekCommand {
+  bool moving;
+  int heading;
+};
+
+typedef void (*SeekOutput)(int heading, int speed);  // speed 0 = stop
+typedef void (*SeekStateHandler)(SeekState state, float ppm);
+
+// Function declarations
+void gasSeekerStart(GasSeeker& seeker, float ppm, float sourcePpm, uint32_t seed, unsigned long now);
+SeekCommand gasSeekerUpdate(GasSeeker& seeker, float ppm, unsigned long now);
+const char* getSeekStateName(SeekState state);
+
+void initGasSeeker(SeekOutput output);
+void startGasSeeking(int speed);
+void stopGasSeeking();
+void serviceGasSeeker();
+void noteSeekDriveCommand(char command);
+void addSeekStateHandler(SeekStateHandler handler);
+bool isGasSeeking();
+SeekState getSeekState();
+const char* formatSeekStatus(char* buffer, size_t size);
+void printSeekStats();
+
+#if BENCHMARK_ENABLED
+#define GASSIM_TARGET 120000         // ms; time-to-source target
+
+// Outcome counts over seeded plume fields; a FOUND away from the source is a false alarm
+struct GasSimResult {
+  int trials;
+  int found;
+  int falseFound;
+  int timedOut;
+  int withinTarget;                 // found within GASSIM_TARGET
+  unsigned long totalMs;            // time to source, summed over the found trials
+};
+
+GasSimResult simulateGasSeek(int trials);
+void runGasSeekSimulation(int trials);
+#endif
+
+#endif
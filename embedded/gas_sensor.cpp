@@ -1,5 +1,8 @@
 #include <Arduino.h>
 #include "gas_sensor.h"
+#include "config_store.h"
+#include "loop_profiler.h"
+#include "trace_recorder.h"
 
 // Global variables
 static float gasConcentration = 0;
@@ -7,9 +10,19 @@ static int gasDigitalValue = 0;
 static int gasAnalogValue = 0;
 static GasLevel currentGasLevel = SAFE;
 
+static const char* const GAS_LEVEL_NAMES[] = {
+  "SAFE",
+  "WARNING",
+  "DANGER",
+  "ERROR"
+};
+
 void initGasSensor() {
   Serial.println("🌬️ Initializing gas sensor...");
   
+  // Thresholds and calibration come from the stored config
+  initConfigStore();
+  
   // Initialize gas sensor pins
   pinMode(GAS_DIGITAL_PIN, INPUT);
   
@@ -25,22 +38,23 @@ void initGasSensor() {
 }
 
 float readGasSensor() {
+  PROFILE_SCOPE("gas_adc");
+  
   // Read analog value
-  gasAnalogValue = analogRead(GAS_ANALOG_PIN);
+  gasAnalogValue = TRACE_INPUT(TRACE_GAS_ADC, analogRead(GAS_ANALOG_PIN));
   
   // Read digital value
-  gasDigitalValue = digitalRead(GAS_DIGITAL_PIN);
+  gasDigitalValue = TRACE_INPUT(TRACE_GAS_DIGITAL, digitalRead(GAS_DIGITAL_PIN));
   
   // Convert analog reading to PPM (approximate conversion)
-  // This conversion depends on your specific sensor model
-  gasConcentration = (float)gasAnalogValue * 2.0; // Adjust multiplier based on your sensor
+  gasConcentration = gasCountsToPpm(gasAnalogValue);
   
   // Update gas level
-  if (gasConcentration >= GAS_DANGER_THRESHOLD) {
+  if (gasConcentration >= roverConfig.gasDangerThreshold) {
     currentGasLevel = DANGER;
-  } else if (gasConcentration >= GAS_WARNING_THRESHOLD) {
+  } else if (gasConcentration >= roverConfig.gasWarningThreshold) {
     currentGasLevel = WARNING;
-  } else if (gasConcentration >= GAS_SAFE_THRESHOLD) {
+  } else if (gasConcentration >= roverConfig.gasSafeThreshold) {
     currentGasLevel = SAFE;
   } else {
     currentGasLevel = SAFE;
@@ -49,6 +63,13 @@ float readGasSensor() {
   return gasConcentration;
 }
 
+// Baseline and multiplier are set by calibration, see config_store.h
+float gasCountsToPpm(int analogValue) {
+  int counts = analogValue - roverConfig.gasBaseline;
+  if (counts < 0) counts = 0;
+  return (float)counts * roverConfig.gasPpmPerCount;
+}
+
 int readGasDigital() {
   gasDigitalValue = digitalRead(GAS_DIGITAL_PIN);
   return gasDigitalValue;
@@ -59,12 +80,12 @@ int readGasAnalog() {
   return gasAnalogValue;
 }
 
-String getGasLevel() {
+const char* getGasLevel() {
   return getGasLevelString(currentGasLevel);
 }
 
 bool isGasDetected() {
-  return gasDigitalValue == HIGH || gasConcentration > GAS_SAFE_THRESHOLD;
+  return gasDigitalValue == HIGH || gasConcentration > roverConfig.gasSafeThreshold;
 }
 
 bool isGasDangerous() {
@@ -87,22 +108,18 @@ void calibrateGasSensor() {
   Serial.print("📊 Average reading: ");
   Serial.println(averageReading);
   
-  // You can store this as baseline for future comparisons
-  // EEPROM.write(100, averageReading); // Example storage
+  // Store as baseline for future readings
+  roverConfig.gasBaseline = averageReading;
+  saveConfig();
 }
 
 float getGasConcentration() {
   return gasConcentration;
 }
 
-String getGasLevelString(GasLevel level) {
-  switch (level) {
-    case SAFE: return "SAFE";
-    case WARNING: return "WARNING";
-    case DANGER: return "DANGER";
-    case ERROR: return "ERROR";
-    default: return "UNKNOWN";
-  }
+const char* getGasLevelString(GasLevel level) {
+  if (level < SAFE || level > ERROR) return "UNKNOWN";
+  return GAS_LEVEL_NAMES[level];
 }
 
 // Additional utility functions
@@ -16,9 +16,10 @@
 // Function declarations
 void initGasSensor();
 float readGasSensor();
+float gasCountsToPpm(int analogValue);
 int readGasDigital();
 int readGasAnalog();
-String getGasLevel();
+const char* getGasLevel();
 bool isGasDetected();
 bool isGasDangerous();
 void calibrateGasSensor();
@@ -33,6 +34,6 @@ enum GasLevel {
 };
 
 // Function to get gas level as string
-String getGasLevelString(GasLevel level);
+const char* getGasLevelString(GasLevel level);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,157 @@
+/*
+ * Fixed-Buffer JSON Writer Implementation for ToxiRover
+ */
+
+#include "json_writer.h"
+
+JsonWriter::JsonWriter(char* buffer, size_t size) {
+  this->buffer = buffer;
+  this->size = size;
+  reset();
+}
+
+void JsonWriter::reset() {
+  len = 0;
+  overflow = size == 0;
+  needComma = false;
+  if (size > 0) buffer[0] = '\0';
+}
+
+void JsonWriter::append(char c) {
+  if (len + 1 >= size) {
+    overflow = true;
+    return;
+  }
+  buffer[len++] = c;
+  buffer[len] = '\0';
+}
+
+void JsonWriter::append(const char* text) {
+  while (*text) append(*text++);
+}
+
+void JsonWriter::appendEscaped(const char* text) {
+  static const char HEX_DIGITS[] = "0123456789abcdef";
+
+  append('"');
+  for (; *text; text++) {
+    char c = *text;
+    if (c == '"' || c == '\\') {
+      append('\\');
+      append(c);
+    } else if ((uint8_t)c < 0x20) {
+      append("\\u00");
+      append(HEX_DIGITS[(c >> 4) & 0x0F]);
+      append(HEX_DIGITS[c & 0x0F]);
+    } else {
+      append(c);
+    }
+  }
+  append('"');
+}
+
+void JsonWriter::appendKey(const char* key) {
+  if (needComma) append(',');
+  appendEscaped(key);
+  append(':');
+  needComma = true;
+}
+
+void JsonWriter::appendUnsigned(unsigned long long value) {
+  char digits[21];
+  int n = 0;
+  do {
+    digits[n++] = '0' + (value % 10);
+    value /= 10;
+  } while (value > 0);
+
+  while (n > 0) append(digits[--n]);
+}
+
+JsonWriter& JsonWriter::beginObject() {
+  if (needComma) append(',');
+  append('{');
+  needComma = false;
+  return *this;
+}
+
+JsonWriter& JsonWriter::beginObject(const char* key) {
+  appendKey(key);
+  append('{');
+  needComma = false;
+  return *this;
+}
+
+JsonWriter& JsonWriter::endObject() {
+  append('}');
+  needComma = true;
+  return *this;
+}
+
+JsonWriter& JsonWriter::add(const char* key, const char* value) {
+  appendKey(key);
+  appendEscaped(value);
+  return *this;
+}
+
+JsonWriter& JsonWriter::add(const char* key, bool value) {
+  appendKey(key);
+  append(value ? "true" : "false");
+  return *this;
+}
+
+JsonWriter& JsonWriter::add(const char* key, int value) {
+  return add(key, (long)value);
+}
+
+JsonWriter& JsonWriter::add(const char* key, unsigned int value) {
+  return add(key, (unsigned long)value);
+}
+
+JsonWriter& JsonWriter::add(const char* key, long value) {
+  appendKey(key);
+  if (value < 0) {
+    append('-');
+    appendUnsigned((unsigned long long)(-(long long)value));
+  } else {
+    appendUnsigned((unsigned long long)value);
+  }
+  return *this;
+}
+
+JsonWriter& JsonWriter::add(const char* key, unsigned long value) {
+  appendKey(key);
+  appendUnsigned(value);
+  return *this;
+}
+
+JsonWriter& JsonWriter::add(const char* key, unsigned long long value) {
+  appendKey(key);
+  appendUnsigned(value);
+  return *this;
+}
+
+JsonWriter& JsonWriter::add(const char* key, double value, int decimals) {
+  appendKey(key);
+  if (isnan(value) || isinf(value)) {
+    append("null");  // JSON has no NaN/Infinity
+    return *this;
+  }
+
+  char text[48];  // fits the widest float with two decimals
+  dtostrf(value, 0, decimals, text);
+  append(text);
+  return *this;
+}
+
+const char* JsonWriter::c_str() const {
+  return buffer;
+}
+
+size_t JsonWriter::length() const {
+  return len;
+}
+
+bool JsonWriter::ok() const {
+  return !overflow;
+}
@@ -0,0 +1,51 @@
+/*
+ * Fixed-Buffer JSON Writer for ToxiRover
+ * Serializes outbound payloads without heap allocation
+ *
+ * Features:
+ * - Writes into a caller-provided buffer, always NUL-terminated
+ * - Nested objects, string escaping, 64-bit timestamps
+ * - Overflow is sticky and reported by ok()
+ */
+
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include <Arduino.h>
+
+#define JSON_FLOAT_DECIMALS 2
+
+class JsonWriter {
+  private:
+    char* buffer;
+    size_t size;
+    size_t len;
+    bool overflow;
+    bool needComma;
+
+    void append(char c);
+    void append(const char* text);
+    void appendEscaped(const char* text);
+    void appendKey(const char* key);
+    void appendUnsigned(unsigned long long value);
+
+  public:
+    JsonWriter(char* buffer, size_t size);
+    void reset();
+    JsonWriter& beginObject();
+    JsonWriter& beginObject(const char* key);
+    JsonWriter& endObject();
+    JsonWriter& add(const char* key, const char* value);
+    JsonWriter& add(const char* key, bool value);
+    JsonWriter& add(const char* key, int value);
+    JsonWriter& add(const char* key, unsigned int value);
+    JsonWriter& add(const char* key, long value);
+    JsonWriter& add(const char* key, unsigned long value);
+    JsonWriter& add(const char* key, unsigned long long value);
+    JsonWriter& add(const char* key, double value, int decimals = JSON_FLOAT_DECIMALS);
+    const char* c_str() const;
+    size_t length() const;
+    bool ok() const;
+};
+
+#endif
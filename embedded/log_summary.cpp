@@ -0,0 +1,203 @@
+/*
+ * Log Summary Implementation for ToxiRover
+ */
+
+#include "log_summary.h"
+
+void logSummaryReset(LogSummary& summary) {
+  memset(&summary, 0, sizeof(summary));
+}
+
+static void closeWindow(LogSummary& summary) {
+  if (summary.windowCount == LOG_SUMMARY_POINTS) {
+    // Offline too long: keep the newest points
+    memmove(&summary.windows[0], &summary.windows[1], sizeof(LogWindow) * (LOG_SUMMARY_POINTS - 1));
+    summary.windowCount--;
+    summary.droppedWindows++;
+  }
+  summary.windows[summary.windowCount++] = summary.current;
+  summary.current.count = 0;
+}
+
+void logSummaryAdd(LogSummary& summary, unsigned long stamp, float ppm, uint8_t alerts) {
+  if (summary.samples > 0) {
+    unsigned long spacing = stamp - summary.lastStamp;
+    if (spacing > LOG_GAP_MS) {
+      summary.gaps++;
+      summary.gapTotalMs += spacing;
+      if (spacing > summary.longestGapMs) {
+        summary.longestGapMs = spacing;
+        summary.longestGapAt = stamp;
+      }
+    }
+  }
+  summary.lastStamp = stamp;
+
+  // Welford's update keeps the variance stable over millions of samples
+  summary.samples++;
+  float delta = ppm - summary.mean;
+  summary.mean += delta / summary.samples;
+  summary.m2 += delta * (ppm - summary.mean);
+  if (summary.samples == 1 || ppm < summary.min) summary.min = ppm;
+  if (summary.samples == 1 || ppm > summary.max) summary.max = ppm;
+
+  LogWindow& window = summary.current;
+  if (window.count > 0 && stamp - window.start >= LOG_SUMMARY_WINDOW) closeWindow(summary);
+  if (window.count == 0) {
+    window.start = stamp;
+    window.min = ppm;
+    window.max = ppm;
+    window.sum = 0;
+    window.alerts = 0;
+  }
+  window.min = min(window.min, ppm);
+  window.max = max(window.max, ppm);
+  window.sum += ppm;
+  if (window.count < UINT16_MAX) window.count++;
+  window.alerts |= alerts;
+}
+
+bool logSummaryReady(const LogSummary& summary) {
+  return summary.windowCount == LOG_SUMMARY_POINTS;
+}
+
+float logSummaryStdDev(const LogSummary& summary) {
+  return summary.samples > 1 ? sqrtf(summary.m2 / (summary.samples - 1)) : 0;
+}
+
+enum LogColumn {
+  COLUMN_OFFSET,
+  COLUMN_MIN,
+  COLUMN_MEAN,
+  COLUMN_MAX,
+  COLUMN_COUNT,
+  COLUMN_ALERTS,
+  LOG_COLUMN_COUNT
+};
+
+static const char* const COLUMN_NAMES[LOG_COLUMN_COUNT] = {
+  "t_s",
+  "min",
+  "mean",
+  "max",
+  "n",
+  "alerts"
+};
+
+static long columnValue(const LogSummary& summary, const LogWindow& window, LogColumn column) {
+  switch (column) {
+    case COLUMN_OFFSET: return (window.start - summary.windows[0].start) / 1000;
+    case COLUMN_MIN: return lroundf(window.min);
+    case COLUMN_MEAN: return lroundf(window.sum / window.count);
+    case COLUMN_MAX: return lroundf(window.max);
+    case COLUMN_COUNT: return window.count;
+    default: return window.alerts;
+  }
+}
+
+// Closed windows as columns ("t_s":"0,60,120", "mean":"40,42,97", ...) plus the
+// since-boot statistics; "t_s" is relative to "start_ms", whole ppm throughout
+void writeLogSummary(const LogSummary& summary, JsonWriter& writer) {
+  writer.beginObject("gas");
+  writer.add("samples", summary.samples);
+  writer.add("min", summary.min, 1);
+  writer.add("max", summary.max, 1);
+  writer.add("mean", summary.mean, 1);
+  writer.add("std", logSummaryStdDev(summary), 1);
+  writer.endObject();
+
+  writer.beginObject("gaps");
+  writer.add("count", summary.gaps);
+  writer.add("total_ms", summary.gapTotalMs);
+  writer.add("longest_ms", summary.longestGapMs);
+  writer.add("longest_at_ms", summary.longestGapAt);
+  writer.endObject();
+
+  if (summary.windowCount == 0) return;
+  writer.add("start_ms", summary.windows[0].start);
+  writer.add("window_ms", (unsigned long)LOG_SUMMARY_WINDOW);
+  writer.add("dropped", summary.droppedWindows);
+
+  char column[LOG_SUMMARY_POINTS * 12];
+  for (int c = 0; c < LOG_COLUMN_COUNT; c++) {
+    size_t len = 0;
+    column[0] = '\0';
+    for (int i = 0; i < summary.windowCount && len < sizeof(column); i++) {
+      long value = columnValue(summary, summary.windows[i], (LogColumn)c);
+      len += snprintf(column + len, sizeof(column) - len, i == 0 ? "%ld" : ",%ld", value);
+    }
+    writer.add(COLUMN_NAMES[c], column);
+  }
+}
+
+void logSummaryMarkSent(LogSummary& summary) {
+  summary.windowCount = 0;
+  summary.droppedWindows = 0;
+  summary.uploads++;
+}
+
+void printLogSummary(const LogSummary& summary) {
+  Serial.println("📒 Log summary:");
+  Serial.print("  Samples: "); Serial.print(summary.samples);
+  Serial.print("  Gas min/mean/max: "); Serial.print(summary.min, 1);
+  Serial.print("/"); Serial.print(summary.mean, 1);
+  Serial.print("/"); Serial.print(summary.max, 1);
+  Serial.print(" ± "); Serial.println(logSummaryStdDev(summary), 1);
+  Serial.print("  Gaps: "); Serial.print(summary.gaps);
+  Serial.print(" (longest "); Serial.print(summary.longestGapMs);
+  Serial.print(" ms, total "); Serial.print(summary.gapTotalMs); Serial.println(" ms)");
+  Serial.print("  Pending points: "); Serial.print(summary.windowCount);
+  Serial.print("/"); Serial.print(LOG_SUMMARY_POINTS);
+  Serial.print("  Uploads: "); Serial.println(summary.uploads);
+}
+
+#if BENCHMARK_ENABLED
+#define LOG_BENCH_RAW_SAMPLE_BYTES 160  // one /logs entry, see SAMPLE_BATCH_PAYLOAD_SIZE
+
+static LogSummary benchSummary;
+static unsigned long benchStamp;
+static uint32_t benchRng = 1;
+
+// 1 Hz sampling with jitter, an occasional stall and a drifting plume
+static void benchLogSummaryAdd() {
+  benchRng = benchRng * 1103515245UL + 12345UL;
+  unsigned long spacing = 1000 + (benchRng >> 16) % 50;
+  if ((benchRng >> 8) % 1000 == 0) spacing += 12000;
+  benchStamp += spacing;
+  float ppm = 40 + 30 * sinf(benchStamp / 600000.0f) + (benchRng >> 20) % 8;
+  logSummaryAdd(benchSummary, benchStamp, ppm, ppm > 65 ? 1 : 0);
+}
+
+static void benchLogSummaryWrite() {
+  static char buffer[LOG_SUMMARY_PAYLOAD_SIZE];
+  JsonWriter writer(buffer, sizeof(buffer));
+  writer.beginObject();
+  writeLogSummary(benchSummary, writer);
+  writer.endObject();
+}
+
+// Throughput of the summarizer and the upload size against raw /logs entries
+void runLogSummaryBenchmarks() {
+  logSummaryReset(benchSummary);
+  benchStamp = 0;
+
+  BenchmarkResult add = runBenchmark("logSummaryAdd", benchLogSummaryAdd, 20000);
+  printBenchmarkResult(add);
+  printBenchmarkResult(runBenchmark("logSummaryWrite", benchLogSummaryWrite, 500));
+
+  // One full upload's worth of windows, as sent
+  static char buffer[LOG_SUMMARY_PAYLOAD_SIZE];
+  JsonWriter writer(buffer, sizeof(buffer));
+  writer.beginObject();
+  writeLogSummary(benchSummary, writer);
+  writer.endObject();
+  unsigned long windowSamples = 0;
+  for (int i = 0; i < benchSummary.windowCount; i++) windowSamples += benchSummary.windows[i].count;
+
+  Serial.print("LOGSUM,samples="); Serial.print(benchSummary.samples);
+  Serial.print(",samples_per_s="); Serial.print(add.nsPerOp > 0 ? 1000000000UL / add.nsPerOp : 0);
+  Serial.print(",gaps="); Serial.print(benchSummary.gaps);
+  Serial.print(",upload_bytes="); Serial.print(writer.ok() ? writer.length() : 0);
+  Serial.print(",raw_bytes="); Serial.println(windowSamples * LOG_BENCH_RAW_SAMPLE_BYTES);
+}
+#endif
@@ -0,0 +1,69 @@
+/*
+ * Log Summary for ToxiRover
+ * Condenses the gas sample stream on the rover so exports need no heavy parsing
+ *
+ * Features:
+ * - Running gas statistics (count, min, max, mean, standard deviation)
+ * - Sampling gap detection: count, total and longest stall
+ * - Downsampled series, one min/mean/max point per window
+ * - Alert timeline as the set of alerts active during each window
+ * - Columnar upload: one comma-separated string per column
+ * - Throughput benchmark on a synthetic sample stream with BENCHMARK_ENABLED
+ */
+
+#ifndef LOG_SUMMARY_H
+#define LOG_SUMMARY_H
+
+#include <Arduino.h>
+#include "json_writer.h"
+#include "benchmark.h"
+
+#define LOG_SUMMARY_WINDOW 60000      // ms per downsampled point
+#define LOG_SUMMARY_POINTS 10         // points per upload; older points drop while offline
+#define LOG_GAP_MS 7500               // spacing that counts as a gap; above the parked gas interval
+#define LOG_SUMMARY_PAYLOAD_SIZE 640
+
+struct LogWindow {
+  unsigned long start;            // millis() of the first sample
+  float min;
+  float max;
+  float sum;
+  uint16_t count;
+  uint8_t alerts;                 // bit per AlertType active during the window
+};
+
+struct LogSummary {
+  // Since boot
+  unsigned long samples;
+  float min;
+  float max;
+  float mean;
+  float m2;                       // Welford sum of squared deviations
+  unsigned long gaps;
+  unsigned long gapTotalMs;
+  unsigned long longestGapMs;
+  unsigned long longestGapAt;     // millis() when the longest gap ended
+  unsigned long lastStamp;
+
+  // Closed windows waiting for upload, oldest first
+  LogWindow windows[LOG_SUMMARY_POINTS];
+  int windowCount;
+  LogWindow current;
+  unsigned long droppedWindows;
+  unsigned long uploads;
+};
+
+// Function declarations
+void logSummaryReset(LogSummary& summary);
+void logSummaryAdd(LogSummary& summary, unsigned long stamp, float ppm, uint8_t alerts);
+bool logSummaryReady(const LogSummary& summary);
+float logSummaryStdDev(const LogSummary& summary);
+void writeLogSummary(const LogSummary& summary, JsonWriter& writer);
+void logSummaryMarkSent(LogSummary& summary);
+void printLogSummary(const LogSummary& summary);
+
+#if BENCHMARK_ENABLED
+void runLogSummaryBenchmarks();
+#endif
+
+#endif
@@ -0,0 +1,102 @@
+/*
+ * Loop Profiler Implementation for ToxiRover
+ */
+
+#include "loop_profiler.h"
+
+#if PROFILER_ENABLED
+
+static ProfileSite sites[PROFILER_MAX_SITES];
+static int siteCount = 0;
+
+int profilerRegisterSite(const char* name) {
+  // Same name from another call site shares the histogram
+  for (int i = 0; i < siteCount; i++) {
+    if (strcmp(sites[i].name, name) == 0) return i;
+  }
+  if (siteCount >= PROFILER_MAX_SITES) return -1;
+
+  memset(&sites[siteCount], 0, sizeof(ProfileSite));
+  sites[siteCount].name = name;
+  return siteCount++;
+}
+
+static int bucketFor(uint32_t micros) {
+  int bucket = 0;
+  while (micros > 1 && bucket < PROFILER_BUCKETS - 1) {
+    micros >>= 1;
+    bucket++;
+  }
+  return bucket;
+}
+
+void profilerRecord(int site, uint32_t cycles) {
+  if (site < 0) return;
+
+  uint32_t micros = cycles / (F_CPU / 1000000);
+  ProfileSite& entry = sites[site];
+  entry.count++;
+  entry.totalMicros += micros;
+  if (micros > entry.maxMicros) entry.maxMicros = micros;
+  entry.buckets[bucketFor(micros)]++;
+}
+
+// Upper edge of the bucket holding the percentile, never above the observed max
+uint32_t profilerPercentile(int site, int percent) {
+  const ProfileSite& entry = sites[site];
+  if (entry.count == 0) return 0;
+
+  uint32_t target = ((uint64_t)entry.count * percent + 99) / 100;
+  uint32_t seen = 0;
+  for (int i = 0; i < PROFILER_BUCKETS; i++) {
+    seen += entry.buckets[i];
+    if (seen >= target) {
+      uint32_t upper = (2UL << i) - 1;
+      return upper < entry.maxMicros ? upper : entry.maxMicros;
+    }
+  }
+  return entry.maxMicros;
+}
+
+size_t formatProfilerReport(char* buffer, size_t size) {
+  size_t len = snprintf(buffer, size, "site count avg_us p50_us p99_us max_us\n");
+
+  for (int i = 0; i < siteCount && len < size; i++) {
+    const ProfileSite& entry = sites[i];
+    unsigned long avg = entry.count > 0 ? (unsigned long)(entry.totalMicros / entry.count) : 0;
+    len += snprintf(buffer + len, size - len, "%s %lu %lu %lu %lu %lu\n",
+                    entry.name, (unsigned long)entry.count, avg,
+                    (unsigned long)profilerPercentile(i, 50),
+                    (unsigned long)profilerPercentile(i, 99),
+                    (unsigned long)entry.maxMicros);
+  }
+  return len < size ? len : size - 1;
+}
+
+void printProfilerReport() {
+  static char report[PROFILER_REPORT_SIZE];
+  formatProfilerReport(report, sizeof(report));
+
+  Serial.println("🔬 Loop profile (us):");
+  Serial.print(report);
+}
+
+// 'p' prints the report, 'r' clears the histograms
+void serviceProfilerSerial() {
+  while (Serial.available() > 0) {
+    int c = Serial.read();
+    if (c == 'p') printProfilerReport();
+    else if (c == 'r') resetProfiler();
+  }
+}
+
+void resetProfiler() {
+  for (int i = 0; i < siteCount; i++) {
+    const char* name = sites[i].name;
+    memset(&sites[i], 0, sizeof(ProfileSite));
+    sites[i].name = name;
+  }
+  Serial.println("🔬 Profiler reset");
+}
+
+#endif
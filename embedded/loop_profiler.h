@@ -0,0 +1,71 @@
+/*
+ * Loop Profiler for ToxiRover
+ * Cycle-counter timing of hot-path calls with fixed-size histograms
+ *
+ * Features:
+ * - PROFILE_SCOPE("name") times the enclosing block
+ * - Log2 latency histograms with p50/p99/max per site
+ * - Report over Serial ('p' on the console) or HTTP (/profile)
+ * - Compiles out to nothing unless PROFILER_ENABLED is 1
+ */
+
+#ifndef LOOP_PROFILER_H
+#define LOOP_PROFILER_H
+
+#include <Arduino.h>
+
+#ifndef PROFILER_ENABLED
+#define PROFILER_ENABLED 0  // build with -DPROFILER_ENABLED=1 to instrument
+#endif
+
+#include "features.h"
+
+// Every scheduler task registers a site, so PROFILE_SCOPE sites get room of their own on top
+#define PROFILER_SCOPE_SITES 12  // gas_adc, sonar, pulseIn, rtdb_write, stream_read, fb_probe, mqtt_connect, spare
+#define PROFILER_MAX_SITES (FEATURE_BOOT_TASKS + PROFILER_SCOPE_SITES)
+#define PROFILER_BUCKETS 24    // bucket i holds runs of [2^i, 2^(i+1)) us; last bucket is open-ended
+#define PROFILER_REPORT_SIZE 2048
+
+#if PROFILER_ENABLED
+
+struct ProfileSite {
+  const char* name;
+  uint32_t count;
+  uint32_t maxMicros;
+  uint64_t totalMicros;
+  uint32_t buckets[PROFILER_BUCKETS];
+};
+
+// Function declarations
+int profilerRegisterSite(const char* name);
+void profilerRecord(int site, uint32_t cycles);
+uint32_t profilerPercentile(int site, int percent);
+size_t formatProfilerReport(char* buffer, size_t size);
+void printProfilerReport();
+void serviceProfilerSerial();
+void resetProfiler();
+
+// Times its own lifetime against one site
+class ProfileScope {
+  private:
+    int site;
+    uint32_t startCycles;
+
+  public:
+    ProfileScope(int site) : site(site), startCycles(ESP.getCycleCount()) {}
+    ~ProfileScope() { profilerRecord(site, ESP.getCycleCount() - startCycles); }
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_SCOPE(name) \
+  static int PROFILE_CONCAT(profileSite_, __LINE__) = profilerRegisterSite(name); \
+  ProfileScope PROFILE_CONCAT(profileScope_, __LINE__)(PROFILE_CONCAT(profileSite_, __LINE__))
+
+#else
+
+#define PROFILE_SCOPE(name) do {} while (0)
+
+#endif
+
+#endif
@@ -1,40 +1,232 @@
-#include "wifi_Control.cpp"
-#include "WANConnection.cpp"
 #include <Arduino.h>
+#include "Wifi_control.h"
+#include "WANconnection.h"
 #include "UltrasonicServo.h"
 #include "gas_sensor.h"
 #include "pin_config.h"
+#include "task_scheduler.h"
+#include "benchmark.h"
+#include "features.h"
+#include "config_store.h"
+#include "boot_sequencer.h"
+#include "power_manager.h"
+#include "vfh_planner.h"
+#include "gas_seeker.h"
+#include "dead_reckoning.h"
+#include "gas_map.h"
+#include "telemetry_frame.h"
+#include "device_id.h"
+#include "fleet_gateway.h"
+#include "sample_bus.h"
+#if FEATURE_FIREBASE
+#include "firebase.h"
+#endif
 
+#if FEATURE_ULTRASONIC_SERVO
 // Create UltrasonicServo object with correct pins
 UltrasonicServo ultraServo(ULTRASONIC_SERVO_TRIG, ULTRASONIC_SERVO_ECHO, 
                            ULTRASONIC_SERVO_SERVO, ULTRASONIC_SERVO_MOTOR1, 
                            ULTRASONIC_SERVO_MOTOR2);
+#endif
+
+// Scheduled tasks
+#if FEATURE_ULTRASONIC_SERVO
+void parkObstacleServo(PowerState state);
+void seekDrive(int heading, int speed);
+#endif
+#if FEATURE_MQTT_WAN
+void publishSeekState(SeekState state, float ppm);
+void publishGasMap();
+void publishTelemetryFrame();
+#endif
+#if FEATURE_FIREBASE
+void firebaseMotionCommand(MotionCommand command);
+void firebaseServoCommand(int angle);
+#endif
+void monitorGas();
+void printStats();
+
+#if BENCHMARK_ENABLED
+void runHotPathBenchmarks();
+#endif
 
 void setup() {
-  Serial.begin(9600);
+  Serial.begin(SERIAL_BAUD);  // the only Serial.begin; modules just print
+  initBootSequencer();
   Serial.println("🚀 ToxiRover Starting (Modular Version)...");
   
-  // Initialize WiFi control
-  setupWiFi();
-  
-  // Initialize all your modules here:
+  // Sensors first so sampling starts before the network is up
   initGasSensor();        // from gas_sensor.cpp
+  initGasMap();           // readings binned at the dead-reckoned pose
+#if FEATURE_ULTRASONIC_SERVO
   ultraServo.begin();     // Initialize UltrasonicServo
+  initAvoidance(&ultraServo, setDrive);  // sweeps the sonar, steers remote 'F'/'G'/'I' around obstacles
+  initGasSeeker(seekDrive);              // autonomous gas-source seeking drives through the planner
+#endif
+  markBootMilestone(BOOT_SENSORS_READY);
+  
+  // Initialize WiFi control; association continues in the background
+  setupWiFi();
+  
+#if FEATURE_MQTT_WAN
   setupWAN();            // from WANconnection.cpp
+  addSeekStateHandler(publishSeekState);
+#endif
+#if FEATURE_FIREBASE
+  initFirebase();        // probes once the network is up
+  setFirebaseCommandHandlers(firebaseMotionCommand, firebaseServoCommand);
+#endif
+#if FEATURE_FLEET_GATEWAY
+  initFleetGateway();    // listens once the network is up
+#endif
+  
+  // Every module runs as a scheduled task; parked rates bound command and gas latency
+  initPowerManager();
+#if FEATURE_HTTP_CONTROL || FEATURE_OTA
+  addPowerManagedTask(addPeriodicTask("wifi", handleClient, 10, PRIORITY_HIGH, 20000), 10, 200);         // WiFi client requests
+#endif
+#if FEATURE_ULTRASONIC_SERVO
+  addPowerManagedTask(addPeriodicTask("obstacle", serviceAvoidance, VFH_CONTROL_INTERVAL, PRIORITY_HIGH, 30000), VFH_CONTROL_INTERVAL, 0);  // Sonar sweep and steering
+  addPowerStateHandler(parkObstacleServo);
+#endif
+#if FEATURE_MQTT_WAN
+  addPowerManagedTask(addPeriodicTask("mqtt", loopWAN, 50, PRIORITY_NORMAL, 50000), 50, 500);            // Handle MQTT commands
+  addPowerManagedTask(addPeriodicTask("gasmap", publishGasMap, GAS_MAP_UPLOAD_INTERVAL, PRIORITY_LOW), GAS_MAP_UPLOAD_INTERVAL, 30000);  // Changed map tiles
+  addPowerManagedTask(addPeriodicTask("telemetry", publishTelemetryFrame, TELEMETRY_FRAME_INTERVAL, PRIORITY_LOW), TELEMETRY_FRAME_INTERVAL, 30000);  // Binary frames
+#endif
+#if FEATURE_FIREBASE
+  addPowerManagedTask(addPeriodicTask("commands", checkFirebaseCommands, 20, PRIORITY_HIGH, 20000), 20, 200);  // Dashboard command stream
+  addPowerManagedTask(addPeriodicTask("firebase", updateFirebaseData, FIREBASE_UPDATE_INTERVAL, PRIORITY_LOW), FIREBASE_UPDATE_INTERVAL, 10000);  // Changed telemetry
+  addPowerManagedTask(addPeriodicTask("logger", logDataToFirebase, SAMPLE_LOG_INTERVAL, PRIORITY_LOW), SAMPLE_LOG_INTERVAL, 30000);  // Batched /logs records
+#endif
+#if FEATURE_FLEET_GATEWAY
+  addPeriodicTask("fleetRx", serviceFleetGateway, FLEET_RECEIVE_INTERVAL, PRIORITY_NORMAL);   // Other rovers' frames
+  addPeriodicTask("fleetView", publishFleetView, FLEET_VIEW_INTERVAL, PRIORITY_LOW);          // Merged fleet view
+#endif
+  addPowerManagedTask(addPeriodicTask("gas", monitorGas, 500, PRIORITY_NORMAL, 5000), 500, 5000);        // Monitor gas
+  addPeriodicTask("stats", printStats, 60000, PRIORITY_LOW);
+  addOneShotTask("bootStats", printBootStats, 30000, PRIORITY_LOW);
+  
+#if PROFILER_ENABLED
+  addPeriodicTask("profiler", serviceProfilerSerial, 200, PRIORITY_LOW);  // 'p' prints, 'r' resets
+#endif
   
   Serial.println("✅ ToxiRover initialized successfully!");
+  printFeatureReport();
+  
+#if BENCHMARK_ENABLED
+  runHotPathBenchmarks();
+#endif
 }
 
 void loop() {
-  // Handle WiFi client requests
-  handleClient();
+  // Runs the next due task, or sleeps until one is due
+  runScheduler();
+}
+
+#if FEATURE_ULTRASONIC_SERVO
+void parkObstacleServo(PowerState state) {
+  ultraServo.setServoAttached(state != POWER_PARKED);
+}
+
+void seekDrive(int heading, int speed) {
+  if (speed > 0) setAvoidanceGoal(heading, speed);
+  else clearAvoidanceGoal();
+}
+#endif
+
+#if FEATURE_MQTT_WAN
+void publishSeekState(SeekState state, float ppm) {
+  char status[48];
+  snprintf(status, sizeof(status), "seek %s %d ppm", getSeekStateName(state), (int)ppm);
+  publishWanStatus(status);
+}
+
+// One changed tile per tick keeps each publish inside the broker's rate limit
+void publishGasMap() {
+  static char tileJson[GAS_MAP_TILE_JSON_SIZE];
+  GasMapTile* tile;
+  if (formatNextGasTile(tileJson, sizeof(tileJson), &tile) && publishWanGasTile(tileJson)) {
+    gasMapMarkSent(gasMap, *tile);
+  }
+}
+
+// Gas is this consumer's latest bus sample rather than the sensor module's global
+void publishTelemetryFrame() {
+  static uint8_t seq = 0;
+  static SampleSnapshot samples;
+  drainSampleSnapshot(BUS_CONSUMER_MQTT, samples);
   
-  // Handle other modules
-  readGasSensor();        // Monitor gas (changed from loopGasSensor)
-  ultraServo.checkAndAct(); // Check obstacles and respond
-  loopWAN();             // Handle MQTT commands
+  TelemetryFrame frame;
+  memset(&frame, 0, sizeof(frame));
+  frame.seq = seq++;
+  frame.stamp = millis();
+  frame.device = getDeviceChipId();
+  setTelemetryFrameGas(frame, samples.value[SAMPLE_GAS_PPM]);
+  Pose pose = getPose();
+  setTelemetryFramePose(frame, pose.x, pose.y, pose.heading);
+  frame.motion = getWheelMotion();
+  frame.distanceCm = TELEMETRY_NO_DISTANCE;
+  frame.servoAngle = TELEMETRY_NO_SERVO;  // the planner sweeps it continuously
+#if FEATURE_ULTRASONIC_SERVO
+  float distance = ultraServo.getLastDistance();
+  if (distance > 0) frame.distanceCm = (uint16_t)distance;
+  if (isGasSeeking()) frame.flags |= FRAME_FLAG_SEEKING;
+#endif
+  if (isGasDetected()) frame.flags |= FRAME_FLAG_GAS_ALARM;
+  if (getPowerState() == POWER_PARKED) frame.flags |= FRAME_FLAG_PARKED;
   
-  delay(500);
+  uint8_t bytes[TELEMETRY_FRAME_MAX_SIZE];
+  size_t length = encodeTelemetryFrame(frame, bytes, sizeof(bytes));
+  publishWanTelemetry(bytes, length);
+  broadcastTelemetryFrame(bytes, length);  // for a fleet gateway on the same network
+}
+#endif
+
+#if FEATURE_FIREBASE
+// Dashboard motion takes the web remote's path, so the planner still steers around obstacles
+void firebaseMotionCommand(MotionCommand command) {
+  static const char REMOTE_KEYS[] = {'S', 'F', 'B', 'L', 'R'};  // indexed by MotionCommand
+  if (command < 0 || command >= MOTION_UNKNOWN) return;
+  char key = REMOTE_KEYS[command];
+  publishSample(SAMPLE_MOTION, command);
+  notePowerDriveCommand(key);
+  noteSeekDriveCommand(key);
+#if FEATURE_ULTRASONIC_SERVO
+  if (steerDriveCommand(key, SPEED)) return;
+#endif
+  dispatchCommand(key);
+}
+
+// The planner owns the sonar servo and sweeps it continuously; the angle is only mirrored
+void firebaseServoCommand(int angle) {
+  publishSample(SAMPLE_SERVO_ANGLE, angle);
+}
+#endif
+
+void printStats() {
+  printSchedulerStats();
+  printPowerStats();
+  printPoseStats();
+  printGasMapStats();
+#if FEATURE_FIREBASE
+  printFirebaseTickStats();
+#endif
+#if FEATURE_FLEET_GATEWAY
+  printFleetStats();
+#endif
+#if FEATURE_ULTRASONIC_SERVO
+  printAvoidanceStats();
+  printSeekStats();
+#endif
+}
+
+void monitorGas() {
+  float ppm = readGasSensor();
+  notePowerGas(ppm);
+  recordGasAtPose(ppm);
+  publishSample(SAMPLE_GAS_PPM, ppm);
+  markBootMilestone(BOOT_FIRST_SAMPLE);
   
   if (isGasDetected()) {
     Serial.println("⚠️ Gas detected!");
@@ -42,3 +234,44 @@ void loop() {
     Serial.println("✅ No gas detected.");
   }
 }
+
+#if BENCHMARK_ENABLED
+static volatile float benchSink;
+
+void benchGasRead() {
+  benchSink = readGasSensor();
+}
+
+#if FEATURE_ULTRASONIC_SERVO
+void benchEchoConversion() {
+  benchSink = UltrasonicServo::echoToCentimeters(1160);  // ~20 cm
+}
+#endif
+
+void benchCommandDispatch() {
+  dispatchCommand('5');  // speed change only, motors untouched
+}
+
+void runHotPathBenchmarks() {
+  int savedSpeed = SPEED;
+  
+  printBenchmarkHeader();
+  printBenchmarkResult(runBenchmark("readGasSensor", benchGasRead, 1000));
+#if FEATURE_ULTRASONIC_SERVO
+  printBenchmarkResult(runBenchmark("echoToCentimeters", benchEchoConversion, 10000));
+#endif
+  printBenchmarkResult(runBenchmark("dispatchCommand", benchCommandDispatch, 10000));
+  runVfhSimulation(50);
+  runGasSeekSimulation(50);
+  runGasMapBenchmarks();
+  runTelemetryFrameBenchmarks(NULL, 0);  // no JSON telemetry in this build
+#if FEATURE_FLEET_GATEWAY
+  runFleetGatewayBenchmarks();
+#endif
+  
+  // The speed benchmark persisted its setting; put the configured one back
+  SPEED = savedSpeed;
+  roverConfig.motorSpeed = savedSpeed;
+  saveConfig();
+}
+#endif
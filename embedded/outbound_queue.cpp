@@ -0,0 +1,270 @@
+/*
+ * Outbound Message Queue Implementation for ToxiRover
+ */
+
+#include "outbound_queue.h"
+
+#if FEATURE_FIREBASE
+
+#include <LittleFS.h>
+
+// Spilled line: <op>\t<path>\t<payload>\n
+#define QUEUE_LINE_SIZE (QUEUE_PATH_SIZE + QUEUE_PAYLOAD_SIZE + 4)
+
+// Replayed lines get their op byte overwritten, so a reboot resumes after them
+#define SPILL_SENT_MARK '-'
+
+struct QueueClass {
+  const char* spillFile;
+  QueuedMessage* ram;
+  uint8_t capacity;
+  uint8_t head;
+  uint8_t count;
+  unsigned long spillCount;   // unread entries in the spill file
+  unsigned long spillOffset;  // read position of the oldest unread entry
+  unsigned long spillBytes;   // spill file size
+};
+
+static QueuedMessage alertRing[QUEUE_RAM_ALERTS];
+static QueuedMessage eventRing[QUEUE_RAM_EVENTS];
+static QueuedMessage sampleRing[QUEUE_RAM_SAMPLES];
+
+static QueueClass queues[QUEUE_CLASSES] = {
+  {"/queue_alert.log", alertRing, QUEUE_RAM_ALERTS, 0, 0, 0, 0, 0},
+  {"/queue_event.log", eventRing, QUEUE_RAM_EVENTS, 0, 0, 0, 0, 0},
+  {"/queue_sample.log", sampleRing, QUEUE_RAM_SAMPLES, 0, 0, 0, 0, 0}
+};
+
+OutboundQueueStats outboundQueueStats = {0, 0, 0, 0, 0};
+
+static bool spillAvailable = false;
+static unsigned long lastDrain = 0;
+static char lineBuffer[QUEUE_LINE_SIZE];
+
+static unsigned long totalSpillBytes() {
+  unsigned long total = 0;
+  for (int i = 0; i < QUEUE_CLASSES; i++) {
+    total += queues[i].spillBytes;
+  }
+  return total;
+}
+
+static void clearSpill(QueueClass& q) {
+  LittleFS.remove(q.spillFile);
+  q.spillCount = 0;
+  q.spillOffset = 0;
+  q.spillBytes = 0;
+}
+
+// Count entries left over from before a reboot; replayed ones are skipped
+static void recoverSpill(QueueClass& q) {
+  if (!LittleFS.exists(q.spillFile)) return;
+
+  File file = LittleFS.open(q.spillFile, "r");
+  if (!file) return;
+
+  q.spillBytes = file.size();
+  unsigned long position = 0;
+  bool atLineStart = true;
+  bool replayed = false;
+  while (file.available()) {
+    size_t n = file.readBytes(lineBuffer, sizeof(lineBuffer));
+    for (size_t i = 0; i < n; i++, position++) {
+      if (atLineStart) replayed = lineBuffer[i] == SPILL_SENT_MARK;
+      atLineStart = lineBuffer[i] == '\n';
+      if (!atLineStart) continue;
+      if (replayed) q.spillOffset = position + 1;
+      else q.spillCount++;
+    }
+  }
+  file.close();
+
+  if (q.spillCount == 0) clearSpill(q);
+}
+
+bool initOutboundQueue() {
+  spillAvailable = LittleFS.begin();
+  if (!spillAvailable) {
+    Serial.println("⚠️ LittleFS unavailable, outbound queue is RAM only");
+    return false;
+  }
+
+  for (int i = 0; i < QUEUE_CLASSES; i++) {
+    recoverSpill(queues[i]);
+  }
+
+  unsigned long depth = getOutboundQueueDepth();
+  if (depth > 0) {
+    Serial.print("📦 Recovered queued messages: ");
+    Serial.println(depth);
+  }
+  return true;
+}
+
+// Free flash by discarding spill of strictly lower priority classes
+static bool makeSpillRoom(int priority, unsigned long bytes) {
+  for (int victim = QUEUE_CLASSES - 1; victim > priority; victim--) {
+    if (totalSpillBytes() + bytes <= QUEUE_SPILL_MAX_BYTES) break;
+    if (queues[victim].spillBytes == 0) continue;
+
+    outboundQueueStats.evicted += queues[victim].spillCount;
+    clearSpill(queues[victim]);
+  }
+  return totalSpillBytes() + bytes <= QUEUE_SPILL_MAX_BYTES;
+}
+
+// Move the oldest RAM entry of a full class to flash (or drop it)
+static void spillOldest(int priority) {
+  QueueClass& q = queues[priority];
+  QueuedMessage& oldest = q.ram[q.head];
+
+  int length = snprintf(lineBuffer, sizeof(lineBuffer), "%c\t%s\t%s\n",
+                        oldest.op, oldest.path, oldest.payload);
+
+  bool spilled = false;
+  if (spillAvailable && makeSpillRoom(priority, length)) {
+    File file = LittleFS.open(q.spillFile, "a");
+    if (file) {
+      spilled = file.write((const uint8_t*)lineBuffer, length) == (size_t)length;
+      file.close();
+    }
+  }
+
+  if (spilled) {
+    q.spillCount++;
+    q.spillBytes += length;
+    outboundQueueStats.spilled++;
+  } else {
+    outboundQueueStats.dropped++;
+  }
+
+  q.head = (q.head + 1) % q.capacity;
+  q.count--;
+}
+
+bool enqueueOutbound(QueuePriority priority, char op, const char* path, const char* payload) {
+  if (strlen(path) >= QUEUE_PATH_SIZE || strlen(payload) >= QUEUE_PAYLOAD_SIZE) {
+    outboundQueueStats.dropped++;
+    return false;
+  }
+
+  QueueClass& q = queues[priority];
+  if (q.count == q.capacity) {
+    spillOldest(priority);
+  }
+
+  QueuedMessage& slot = q.ram[(q.head + q.count) % q.capacity];
+  slot.op = op;
+  strcpy(slot.path, path);
+  strcpy(slot.payload, payload);
+  q.count++;
+
+  outboundQueueStats.enqueued++;
+  return true;
+}
+
+// Read the oldest spilled entry of a class without consuming it
+static bool peekSpill(QueueClass& q, QueuedMessage& message, unsigned long& lineLength) {
+  File file = LittleFS.open(q.spillFile, "r");
+  if (!file || !file.seek(q.spillOffset)) {
+    return false;
+  }
+
+  size_t n = file.readBytesUntil('\n', lineBuffer, sizeof(lineBuffer) - 1);
+  file.close();
+  lineBuffer[n] = '\0';
+  lineLength = n + 1;
+
+  char* path = strchr(lineBuffer, '\t');
+  char* payload = path ? strchr(path + 1, '\t') : NULL;
+  if (!payload) return false;
+
+  *path++ = '\0';
+  *payload++ = '\0';
+  message.op = lineBuffer[0];
+  strncpy(message.path, path, QUEUE_PATH_SIZE - 1);
+  message.path[QUEUE_PATH_SIZE - 1] = '\0';
+  strncpy(message.payload, payload, QUEUE_PAYLOAD_SIZE - 1);
+  message.payload[QUEUE_PAYLOAD_SIZE - 1] = '\0';
+  return true;
+}
+
+// One byte rewrite per replayed entry instead of keeping the offset only in RAM
+static void markSpillSent(QueueClass& q) {
+  File file = LittleFS.open(q.spillFile, "r+");
+  if (!file) return;
+  static const uint8_t mark = SPILL_SENT_MARK;
+  if (file.seek(q.spillOffset)) file.write(&mark, 1);
+  file.close();
+}
+
+int drainOutboundQueue(QueueSender sender) {
+  if (millis() - lastDrain < QUEUE_DRAIN_INTERVAL) return 0;
+  lastDrain = millis();
+
+  static QueuedMessage spilled;
+  int sent = 0;
+
+  // Highest priority first; within a class spilled entries are the oldest
+  for (int i = 0; i < QUEUE_CLASSES && sent < QUEUE_DRAIN_BATCH; i++) {
+    QueueClass& q = queues[i];
+
+    while (q.spillCount > 0 && sent < QUEUE_DRAIN_BATCH) {
+      unsigned long lineLength = 0;
+      if (!peekSpill(q, spilled, lineLength)) {
+        // Unreadable spill: discard it rather than block the queue forever
+        outboundQueueStats.dropped += q.spillCount;
+        clearSpill(q);
+        break;
+      }
+      if (!sender(spilled)) return sent;
+
+      q.spillCount--;
+      if (q.spillCount == 0) {
+        clearSpill(q);
+      } else {
+        markSpillSent(q);
+        q.spillOffset += lineLength;
+      }
+      outboundQueueStats.sent++;
+      sent++;
+    }
+
+    while (q.count > 0 && sent < QUEUE_DRAIN_BATCH) {
+      if (!sender(q.ram[q.head])) return sent;
+
+      q.head = (q.head + 1) % q.capacity;
+      q.count--;
+      outboundQueueStats.sent++;
+      sent++;
+    }
+  }
+
+  return sent;
+}
+
+bool isOutboundQueueEmpty() {
+  return getOutboundQueueDepth() == 0;
+}
+
+unsigned long getOutboundQueueDepth() {
+  unsigned long depth = 0;
+  for (int i = 0; i < QUEUE_CLASSES; i++) {
+    depth += queues[i].count + queues[i].spillCount;
+  }
+  return depth;
+}
+
+void printOutboundQueueStats() {
+  Serial.println("📦 Outbound queue:");
+  Serial.print("  Depth: "); Serial.println(getOutboundQueueDepth());
+  Serial.print("  Enqueued/sent: ");
+  Serial.print(outboundQueueStats.enqueued); Serial.print("/");
+  Serial.println(outboundQueueStats.sent);
+  Serial.print("  Spilled: "); Serial.println(outboundQueueStats.spilled);
+  Serial.print("  Evicted: "); Serial.println(outboundQueueStats.evicted);
+  Serial.print("  Dropped: "); Serial.println(outboundQueueStats.dropped);
+  Serial.print("  Spill bytes: "); Serial.println(totalSpillBytes());
+}
+
+#endif
@@ -0,0 +1,73 @@
+/*
+ * Outbound Message Queue for ToxiRover
+ * Store-and-forward for cloud writes during connectivity loss
+ *
+ * Features:
+ * - Per-priority RAM rings (alerts, events, samples)
+ * - Overflow spills oldest entries to LittleFS; replay resumes where it left off after a reboot
+ * - Lower priority spill is evicted first when flash budget is exhausted
+ * - Oldest-first replay, highest priority first, in rate-limited batches
+ */
+
+#ifndef OUTBOUND_QUEUE_H
+#define OUTBOUND_QUEUE_H
+
+#include <Arduino.h>
+#include "features.h"
+
+// Message buffer sizes
+#define QUEUE_PATH_SIZE 32
+#define QUEUE_PAYLOAD_SIZE 256
+
+// RAM ring capacity per priority class
+#define QUEUE_RAM_ALERTS 4
+#define QUEUE_RAM_EVENTS 4
+#define QUEUE_RAM_SAMPLES 6
+
+// Flash spill budget across all classes
+#define QUEUE_SPILL_MAX_BYTES 32768
+
+// Replay rate limiting
+#define QUEUE_DRAIN_BATCH 5         // messages per drain call
+#define QUEUE_DRAIN_INTERVAL 1000   // ms between drain calls
+
+// Priority classes, highest first
+enum QueuePriority {
+  QUEUE_ALERT = 0,
+  QUEUE_EVENT = 1,
+  QUEUE_SAMPLE = 2,
+  QUEUE_CLASSES = 3
+};
+
+// Operation to perform when the message is replayed
+#define QUEUE_OP_PUSH 'P'    // push under path (new child key)
+#define QUEUE_OP_UPDATE 'U'  // update/patch at path
+
+struct QueuedMessage {
+  char op;
+  char path[QUEUE_PATH_SIZE];
+  char payload[QUEUE_PAYLOAD_SIZE];  // JSON object text
+};
+
+struct OutboundQueueStats {
+  unsigned long enqueued;
+  unsigned long sent;
+  unsigned long spilled;
+  unsigned long evicted;   // spilled entries discarded to make room for higher priority
+  unsigned long dropped;   // entries that could neither stay in RAM nor spill
+};
+
+// Sends one message; return false to stop draining and retry later
+typedef bool (*QueueSender)(const QueuedMessage& message);
+
+extern OutboundQueueStats outboundQueueStats;
+
+// Function declarations
+bool initOutboundQueue();
+bool enqueueOutbound(QueuePriority priority, char op, const char* path, const char* payload);
+int drainOutboundQueue(QueueSender sender);
+bool isOutboundQueueEmpty();
+unsigned long getOutboundQueueDepth();
+void printOutboundQueueStats();
+
+#endif
@@ -0,0 +1,288 @@
+/*
+ * Power Manager Implementation for ToxiRover
+ */
+
+#include <ESP8266WiFi.h>
+#include "power_manager.h"
+#include "config_store.h"
+#include "gas_sensor.h"
+#include "rover_status.h"
+
+extern "C" {
+#include <user_interface.h>
+#include <gpio.h>
+}
+
+#if TRACE_ENABLED
+#include <LittleFS.h>
+#endif
+
+static const char* const POWER_STATE_NAMES[POWER_STATE_COUNT] = {
+  "DRIVING",
+  "MONITORING",
+  "PARKED"
+};
+
+static const uint8_t POWER_STATE_MA[POWER_STATE_COUNT] = {
+  POWER_MA_DRIVING,
+  POWER_MA_MONITORING,
+  POWER_MA_PARKED
+};
+
+struct PowerManagedTask {
+  TaskId id;
+  unsigned long activeMs;
+  unsigned long parkedMs;  // 0 = disabled while parked
+};
+
+static PowerPolicy livePolicy;
+static PowerManagedTask managedTasks[POWER_MAX_TASKS];
+static int managedTaskCount = 0;
+static PowerStateHandler stateHandlers[POWER_MAX_HANDLERS];
+static int stateHandlerCount = 0;
+static volatile bool gasAlarm = false;
+
+// ---------------------------------------------------------------- policy
+
+void powerPolicyReset(PowerPolicy& policy, unsigned long now) {
+  memset(&policy, 0, sizeof(policy));
+  policy.state = POWER_MONITORING;
+  policy.lastActivity = now;
+  policy.lastUpdate = now;
+}
+
+// Accounts time in the current state, then picks the next one; true on a change
+bool powerPolicyUpdate(PowerPolicy& policy, unsigned long now) {
+  policy.stateMs[policy.state] += now - policy.lastUpdate;
+  policy.lastUpdate = now;
+
+  PowerState next;
+  if (policy.moving) next = POWER_DRIVING;
+  else if (now - policy.lastActivity < POWER_PARK_TIMEOUT) next = POWER_MONITORING;
+  else next = POWER_PARKED;
+
+  if (next == policy.state) return false;
+  policy.state = next;
+  policy.transitions++;
+  return true;
+}
+
+void powerPolicyActivity(PowerPolicy& policy, unsigned long now) {
+  policy.lastActivity = now;
+}
+
+void powerPolicyMotion(PowerPolicy& policy, bool moving, unsigned long now) {
+  policy.moving = moving;
+  policy.lastActivity = now;
+}
+
+// Elevated or changing gas keeps the rover awake and sampling at full rate
+void powerPolicyGas(PowerPolicy& policy, float ppm, unsigned long now) {
+  if (ppm >= roverConfig.gasWarningThreshold || fabs(ppm - policy.lastGasPpm) >= POWER_GAS_DELTA) {
+    policy.lastActivity = now;
+  }
+  policy.lastGasPpm = ppm;
+}
+
+float powerPolicyMilliampHours(const PowerPolicy& policy) {
+  float mAh = 0;
+  for (int i = 0; i < POWER_STATE_COUNT; i++) {
+    mAh += (float)policy.stateMs[i] * POWER_STATE_MA[i] / 3600000.0f;
+  }
+  return mAh;
+}
+
+static bool isDriveMotion(char command) {
+  return command != '\0' && strchr("FBRLGHIJ", command) != NULL;
+}
+
+// ---------------------------------------------------------------- live manager
+
+static void IRAM_ATTR onGasAlarm() {
+  gasAlarm = true;
+}
+
+static void applyPowerState(PowerState state) {
+  switch (state) {
+    case POWER_DRIVING:
+      WiFi.setSleepMode(WIFI_NONE_SLEEP);
+      break;
+    case POWER_MONITORING:
+      WiFi.setSleepMode(WIFI_MODEM_SLEEP, POWER_LISTEN_INTERVAL);
+      break;
+    case POWER_PARKED:
+      WiFi.setSleepMode(WIFI_LIGHT_SLEEP, POWER_LISTEN_INTERVAL);
+      break;
+    default:
+      break;
+  }
+
+  // FC-22 D0 going high pulls the CPU out of light sleep
+  if (state == POWER_PARKED) {
+    wifi_enable_gpio_wakeup(GPIO_ID_PIN(GAS_DIGITAL_PIN), GPIO_PIN_INTR_HILEVEL);
+  } else {
+    wifi_disable_gpio_wakeup();
+  }
+  setSchedulerMaxSleep(state == POWER_PARKED ? POWER_PARKED_MAX_SLEEP : SCHEDULER_IDLE_MAX_SLEEP);
+
+  for (int i = 0; i < managedTaskCount; i++) {
+    const PowerManagedTask& task = managedTasks[i];
+    unsigned long interval = state == POWER_PARKED ? task.parkedMs : task.activeMs;
+    setTaskEnabled(task.id, interval > 0);
+    if (interval > 0) setTaskInterval(task.id, interval);
+  }
+
+  for (int i = 0; i < stateHandlerCount; i++) stateHandlers[i](state);
+
+  Serial.print("🔋 Power state: ");
+  Serial.println(POWER_STATE_NAMES[state]);
+}
+
+void initPowerManager() {
+  powerPolicyReset(livePolicy, millis());
+  attachInterrupt(digitalPinToInterrupt(GAS_DIGITAL_PIN), onGasAlarm, RISING);
+  addPeriodicTask("power", servicePowerManager, POWER_SERVICE_INTERVAL, PRIORITY_HIGH);
+  applyPowerState(livePolicy.state);
+}
+
+void servicePowerManager() {
+  if (gasAlarm) {
+    gasAlarm = false;
+    powerPolicyActivity(livePolicy, millis());
+  }
+  if (powerPolicyUpdate(livePolicy, millis())) {
+    applyPowerState(livePolicy.state);
+  }
+}
+
+// Waking is applied at once; parking waits for the service task
+static void wakeIfParked() {
+  if (livePolicy.state == POWER_PARKED && powerPolicyUpdate(livePolicy, millis())) {
+    applyPowerState(livePolicy.state);
+  }
+}
+
+void addPowerManagedTask(TaskId id, unsigned long activeMs, unsigned long parkedMs) {
+  if (id == TASK_INVALID) return;
+  if (managedTaskCount >= POWER_MAX_TASKS) {
+    Serial.print("❌ Power manager full, task not added: ");
+    Serial.println(getTask(id)->name);
+    return;
+  }
+  managedTasks[managedTaskCount++] = {id, activeMs, parkedMs};
+}
+
+void addPowerStateHandler(PowerStateHandler handler) {
+  if (stateHandlerCount >= POWER_MAX_HANDLERS) return;
+  stateHandlers[stateHandlerCount++] = handler;
+}
+
+void notePowerActivity() {
+  powerPolicyActivity(livePolicy, millis());
+  wakeIfParked();
+}
+
+void notePowerMotion(bool moving) {
+  bool changed = moving != livePolicy.moving;
+  powerPolicyMotion(livePolicy, moving, millis());
+  if (changed && powerPolicyUpdate(livePolicy, millis())) {
+    applyPowerState(livePolicy.state);
+  }
+}
+
+// WiFi remote characters: drive letters move, 'S' stops, the rest is activity only
+void notePowerDriveCommand(char command) {
+  if (isDriveMotion(command)) notePowerMotion(true);
+  else if (command == 'S') notePowerMotion(false);
+  else notePowerActivity();
+}
+
+void notePowerGas(float ppm) {
+  powerPolicyGas(livePolicy, ppm, millis());
+  wakeIfParked();
+}
+
+PowerState getPowerState() {
+  return livePolicy.state;
+}
+
+const char* getPowerStateName(PowerState state) {
+  if (state < 0 || state >= POWER_STATE_COUNT) return "UNKNOWN";
+  return POWER_STATE_NAMES[state];
+}
+
+static void printPolicyReport(const char* prefix, const PowerPolicy& policy) {
+  unsigned long total = 0;
+  for (int i = 0; i < POWER_STATE_COUNT; i++) total += policy.stateMs[i];
+  float hours = total / 3600000.0f;
+  float awake = total > 0 ? 100.0f * (total - policy.stateMs[POWER_PARKED]) / total : 0;
+
+  Serial.print(prefix);
+  Serial.print(",duration_ms="); Serial.print(total);
+  for (int i = 0; i < POWER_STATE_COUNT; i++) {
+    Serial.print(","); Serial.print(POWER_STATE_NAMES[i]);
+    Serial.print("_ms="); Serial.print(policy.stateMs[i]);
+  }
+  Serial.print(",transitions="); Serial.print(policy.transitions);
+  Serial.print(",awake_pct="); Serial.print(awake, 1);
+  Serial.print(",mah_per_hour=");
+  Serial.println(hours > 0 ? powerPolicyMilliampHours(policy) / hours : 0, 2);
+}
+
+void printPowerStats() {
+  servicePowerManager();
+  Serial.println("🔋 Power:");
+  Serial.print("  State: "); Serial.println(POWER_STATE_NAMES[livePolicy.state]);
+  Serial.print("  CPU idle: "); Serial.print(schedulerStats.idleMs);
+  Serial.print(" of "); Serial.print(millis()); Serial.println(" ms");
+  printPolicyReport("POWER", livePolicy);
+}
+
+#if TRACE_ENABLED
+// Replays the recorded inputs through the same policy in trace time, without sleeping
+void simulateTracePower() {
+  File file = LittleFS.open(TRACE_FILE, "r");
+  TraceHeader header;
+  if (!file || file.read((uint8_t*)&header, sizeof(header)) != sizeof(header) ||
+      header.magic != TRACE_MAGIC) {
+    if (file) file.close();
+    Serial.println("❌ No valid trace to simulate");
+    return;
+  }
+
+  PowerPolicy policy;
+  powerPolicyReset(policy, 0);
+
+  TraceRecord record;
+  while (file.read((uint8_t*)&record, sizeof(record)) == sizeof(record)) {
+    unsigned long now = record.offsetMs;
+    powerPolicyUpdate(policy, now);
+
+    switch (record.channel) {
+      case TRACE_GAS_ADC:
+        powerPolicyGas(policy, gasCountsToPpm(record.value), now);
+        break;
+      case TRACE_GAS_DIGITAL:
+        if (record.value == HIGH) powerPolicyActivity(policy, now);
+        break;
+      case TRACE_MOTION_CMD:
+        powerPolicyMotion(policy, record.value != MOTION_STOP, now);
+        break;
+      case TRACE_DRIVE_CMD:
+        if (isDriveMotion((char)record.value)) powerPolicyMotion(policy, true, now);
+        else if (record.value == 'S') powerPolicyMotion(policy, false, now);
+        else powerPolicyActivity(policy, now);
+        break;
+      case TRACE_SERVO_CMD:
+        powerPolicyActivity(policy, now);
+        break;
+      default:
+        break;
+    }
+    yield();
+  }
+  file.close();
+
+  printPolicyReport("POWERSIM", policy);
+}
+#endif
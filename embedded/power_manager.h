@@ -0,0 +1,77 @@
+/*
+ * Power Manager for ToxiRover
+ * Duty-cycles the radio, servo and sensors for long monitoring missions
+ *
+ * Features:
+ * - Driving / monitoring / parked states from motion, commands and gas activity
+ * - Modem sleep while stationary, light sleep and detached servo when parked
+ * - Per-task active and parked rates (sonar off, slow gas sampling when parked)
+ * - FC-22 D0 interrupt wakes the rover on gas without waiting for a sample
+ * - Time-in-state energy estimate, and the same policy replayed over a trace
+ */
+
+#ifndef POWER_MANAGER_H
+#define POWER_MANAGER_H
+
+#include <Arduino.h>
+#include "task_scheduler.h"
+#include "trace_recorder.h"
+
+#define POWER_SERVICE_INTERVAL 100     // ms; bounds the gas interrupt to wake latency
+#define POWER_PARK_TIMEOUT 60000       // ms without motion, commands or gas activity before parking
+#define POWER_GAS_DELTA 20             // ppm change between samples that counts as activity
+#define POWER_LISTEN_INTERVAL 3        // DTIM periods the radio may sleep through (~300 ms command latency)
+#define POWER_PARKED_MAX_SLEEP 100     // ms scheduler idle cap while parked
+#define POWER_MAX_TASKS FEATURE_MANAGED_TASKS  // see the task budget in features.h
+#define POWER_MAX_HANDLERS 4
+
+// Estimated ESP8266 module current per state (mA); motors and the FC-22 heater are not included
+#define POWER_MA_DRIVING 80            // radio always on
+#define POWER_MA_MONITORING 20         // modem sleep between beacons
+#define POWER_MA_PARKED 3              // automatic light sleep
+
+enum PowerState {
+  POWER_DRIVING,
+  POWER_MONITORING,
+  POWER_PARKED,
+  POWER_STATE_COUNT
+};
+
+// Pure state machine; driven by millis() live and by record offsets in simulation
+struct PowerPolicy {
+  PowerState state;
+  bool moving;
+  float lastGasPpm;
+  unsigned long lastActivity;
+  unsigned long lastUpdate;
+  unsigned long stateMs[POWER_STATE_COUNT];
+  unsigned long transitions;
+};
+
+typedef void (*PowerStateHandler)(PowerState state);
+
+// Function declarations
+void powerPolicyReset(PowerPolicy& policy, unsigned long now);
+bool powerPolicyUpdate(PowerPolicy& policy, unsigned long now);
+void powerPolicyActivity(PowerPolicy& policy, unsigned long now);
+void powerPolicyMotion(PowerPolicy& policy, bool moving, unsigned long now);
+void powerPolicyGas(PowerPolicy& policy, float ppm, unsigned long now);
+float powerPolicyMilliampHours(const PowerPolicy& policy);
+
+void initPowerManager();
+void servicePowerManager();
+void addPowerManagedTask(TaskId id, unsigned long activeMs, unsigned long parkedMs);
+void addPowerStateHandler(PowerStateHandler handler);
+void notePowerActivity();
+void notePowerMotion(bool moving);
+void notePowerDriveCommand(char command);
+void notePowerGas(float ppm);
+PowerState getPowerState();
+const char* getPowerStateName(PowerState state);
+void printPowerStats();
+
+#if TRACE_ENABLED
+void simulateTracePower();
+#endif
+
+#endif
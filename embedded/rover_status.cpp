@@ -0,0 +1,38 @@
+/*
+ * Rover Status Types Implementation for ToxiRover
+ */
+
+#include "rover_status.h"
+
+static const char* const MOTION_NAMES[MOTION_COMMAND_COUNT] = {
+  "STOP",
+  "FORWARD",
+  "BACKWARD",
+  "LEFT",
+  "RIGHT",
+  "UNKNOWN"
+};
+
+static const char* const DISTANCE_STATUS_NAMES[DISTANCE_STATUS_COUNT] = {
+  "SAFE",
+  "WARNING",
+  "DANGER",
+  "ERROR"
+};
+
+const char* getMotionName(MotionCommand command) {
+  if (command < 0 || command >= MOTION_COMMAND_COUNT) return MOTION_NAMES[MOTION_UNKNOWN];
+  return MOTION_NAMES[command];
+}
+
+MotionCommand parseMotionCommand(const char* name) {
+  for (int i = 0; i < MOTION_UNKNOWN; i++) {
+    if (strcmp(name, MOTION_NAMES[i]) == 0) return (MotionCommand)i;
+  }
+  return MOTION_UNKNOWN;
+}
+
+const char* getDistanceStatusName(DistanceStatus status) {
+  if (status < 0 || status >= DISTANCE_STATUS_COUNT) return DISTANCE_STATUS_NAMES[DISTANCE_ERROR];
+  return DISTANCE_STATUS_NAMES[status];
+}
@@ -0,0 +1,41 @@
+/*
+ * Rover Status Types for ToxiRover
+ * Typed motion and distance states shared by sensors, sketches and Firebase
+ *
+ * Features:
+ * - Enums instead of heap Strings for per-loop state
+ * - Constant name tables for upload and logging
+ * - Allocation-free parsing of command names
+ */
+
+#ifndef ROVER_STATUS_H
+#define ROVER_STATUS_H
+
+#include <Arduino.h>
+
+// Motion state / command
+enum MotionCommand {
+  MOTION_STOP,
+  MOTION_FORWARD,
+  MOTION_BACKWARD,
+  MOTION_LEFT,
+  MOTION_RIGHT,
+  MOTION_UNKNOWN,
+  MOTION_COMMAND_COUNT
+};
+
+// Distance classification
+enum DistanceStatus {
+  DISTANCE_SAFE,
+  DISTANCE_WARNING,
+  DISTANCE_DANGER,
+  DISTANCE_ERROR,
+  DISTANCE_STATUS_COUNT
+};
+
+// Function declarations
+const char* getMotionName(MotionCommand command);
+MotionCommand parseMotionCommand(const char* name);
+const char* getDistanceStatusName(DistanceStatus status);
+
+#endif
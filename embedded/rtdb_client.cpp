@@ -0,0 +1,178 @@
+/*
+ * Realtime Database REST Writer Implementation for ToxiRover
+ */
+
+#include "rtdb_client.h"
+
+#if FEATURE_FIREBASE
+
+#include <WiFiClientSecure.h>
+
+RtdbStats rtdbStats = {0, 0, 0, 0, 0};
+
+static WiFiClientSecure client;
+static const char* rtdbHost = "";
+static const char* rtdbAuth = "";
+static unsigned long rtdbTimeoutMs = 0;
+static bool probeInFlight = false;
+static unsigned long probeSentAt = 0;
+
+void rtdbBegin(const char* host, const char* auth, unsigned long timeoutMs) {
+  rtdbHost = host;
+  rtdbAuth = auth;
+
+  // Same trust model as the FirebaseESP8266 default (no certificate pinning)
+  client.setInsecure();
+  client.setBufferSizes(1024, 512);
+  client.setTimeout(timeoutMs);
+  rtdbTimeoutMs = timeoutMs;
+}
+
+void rtdbStop() {
+  client.stop();
+  probeInFlight = false;
+}
+
+static bool ensureConnected() {
+  if (client.connected()) return true;
+
+  rtdbStats.connects++;
+  return client.connect(rtdbHost, RTDB_PORT);
+}
+
+// Parse status, skip headers and drain any body so the connection can be reused
+static int readResponse() {
+  char line[96];
+  size_t n = client.readBytesUntil('\n', line, sizeof(line) - 1);
+  if (n < 12) {
+    client.stop();  // timed out or garbled: the stream position is unknown
+    return -1;
+  }
+  line[n] = '\0';
+
+  int status = atoi(line + 9);  // "HTTP/1.1 204 No Content"
+  long contentLength = 0;
+  bool closeAfter = false;
+
+  while (true) {
+    n = client.readBytesUntil('\n', line, sizeof(line) - 1);
+    if (n == 0) {
+      closeAfter = true;  // timed out mid-headers
+      break;
+    }
+    line[n] = '\0';
+    if (line[0] == '\r') break;
+
+    if (strncasecmp(line, "Content-Length:", 15) == 0) {
+      contentLength = atol(line + 15);
+    } else if (strncasecmp(line, "Connection: close", 17) == 0 ||
+               strncasecmp(line, "Transfer-Encoding:", 18) == 0) {
+      closeAfter = true;
+    }
+  }
+
+  while (contentLength > 0 && !closeAfter) {
+    size_t chunk = contentLength < (long)sizeof(line) ? contentLength : sizeof(line);
+    size_t got = client.readBytes(line, chunk);
+    if (got == 0) {
+      closeAfter = true;
+      break;
+    }
+    contentLength -= got;
+  }
+
+  if (closeAfter) client.stop();
+  return status;
+}
+
+bool rtdbWrite(const char* method, const char* path, const char* body, size_t length) {
+  char head[RTDB_HEAD_SIZE];
+  int headLength = snprintf(head, sizeof(head),
+    "%s %s%s.json?print=silent%s%s HTTP/1.1\r\n"
+    "Host: %s\r\n"
+    "Content-Type: application/json\r\n"
+    "Content-Length: %u\r\n"
+    "Connection: keep-alive\r\n\r\n",
+    method, path[0] == '/' ? "" : "/", path,
+    rtdbAuth[0] ? "&auth=" : "", rtdbAuth,
+    rtdbHost, (unsigned)length);
+
+  rtdbStats.requests++;
+  if (headLength <= 0 || headLength >= (int)sizeof(head)) {
+    rtdbStats.failures++;
+    rtdbStats.lastStatus = -1;
+    return false;
+  }
+
+  // A kept-alive socket may have been closed by the server; retry the send once
+  bool sent = false;
+  for (int attempt = 0; attempt < 2 && !sent; attempt++) {
+    if (!ensureConnected()) break;
+
+    sent = client.write((const uint8_t*)head, headLength) == (size_t)headLength &&
+           client.write((const uint8_t*)body, length) == length;
+    if (!sent) client.stop();
+  }
+
+  int status = sent ? readResponse() : -1;
+  rtdbStats.lastStatus = status;
+
+  // Any failure drops the socket; the next write starts on a fresh connection
+  if (status < 200 || status >= 300) {
+    client.stop();
+    rtdbStats.failures++;
+    return false;
+  }
+
+  rtdbStats.bytesSent += headLength + length;
+  return true;
+}
+
+// Sends the probe request and returns; only the TCP/TLS connect can block here.
+// The probe runs on the write connection, so a good reply leaves it warm for writes.
+bool rtdbProbeStart(const char* path) {
+  char head[RTDB_HEAD_SIZE];
+  int headLength = snprintf(head, sizeof(head),
+    "GET %s%s.json?shallow=true%s%s HTTP/1.1\r\n"
+    "Host: %s\r\n"
+    "Connection: keep-alive\r\n\r\n",
+    path[0] == '/' ? "" : "/", path,
+    rtdbAuth[0] ? "&auth=" : "", rtdbAuth, rtdbHost);
+
+  probeInFlight = false;
+  if (headLength <= 0 || headLength >= (int)sizeof(head)) return false;
+
+  client.stop();  // a fresh connection: the old one is what failed
+  if (!ensureConnected()) return false;
+  if (client.write((const uint8_t*)head, headLength) != (size_t)headLength) {
+    client.stop();
+    return false;
+  }
+
+  probeInFlight = true;
+  probeSentAt = millis();
+  return true;
+}
+
+// Never waits: the reply is read only once its first bytes have arrived
+RtdbProbeResult rtdbProbePoll() {
+  if (!probeInFlight) return RTDB_PROBE_FAILED;
+
+  if (client.available() > 0) {
+    probeInFlight = false;
+    int status = readResponse();
+    rtdbStats.lastStatus = status;
+    if (status >= 200 && status < 300) return RTDB_PROBE_OK;
+    client.stop();
+    return RTDB_PROBE_FAILED;
+  }
+
+  if (!client.connected() || millis() - probeSentAt >= rtdbTimeoutMs) {
+    probeInFlight = false;
+    client.stop();
+    return RTDB_PROBE_FAILED;
+  }
+  return RTDB_PROBE_PENDING;
+}
+
+#endif
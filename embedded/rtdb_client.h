@@ -0,0 +1,51 @@
+/*
+ * Realtime Database REST Writer for ToxiRover
+ * Keep-alive HTTPS writes of pre-serialized JSON payloads
+ *
+ * Features:
+ * - One persistent TLS connection reused across writes
+ * - Request head built in a fixed buffer, body sent as-is
+ * - print=silent so successful writes return no body
+ * - Per-request counters for round trips and bytes
+ * - Health probe that sends a shallow GET and picks up the reply on later polls
+ */
+
+#ifndef RTDB_CLIENT_H
+#define RTDB_CLIENT_H
+
+#include <Arduino.h>
+#include "features.h"
+
+#define RTDB_PORT 443
+#define RTDB_HEAD_SIZE 256
+
+// HTTP methods used for writes
+#define RTDB_PATCH "PATCH"  // multi-location update
+#define RTDB_POST "POST"    // push with generated key
+#define RTDB_PUT "PUT"      // set
+
+// State of the health probe
+enum RtdbProbeResult {
+  RTDB_PROBE_PENDING,
+  RTDB_PROBE_OK,
+  RTDB_PROBE_FAILED
+};
+
+struct RtdbStats {
+  unsigned long requests;
+  unsigned long failures;
+  unsigned long connects;
+  unsigned long bytesSent;
+  int lastStatus;
+};
+
+extern RtdbStats rtdbStats;
+
+// Function declarations
+void rtdbBegin(const char* host, const char* auth, unsigned long timeoutMs);
+bool rtdbWrite(const char* method, const char* path, const char* body, size_t length);
+void rtdbStop();
+bool rtdbProbeStart(const char* path);
+RtdbProbeResult rtdbProbePoll();
+
+#endif
@@ -0,0 +1,71 @@
+/*
+ * Sample Bus Implementation for ToxiRover
+ */
+
+#include "sample_bus.h"
+
+static SpscRing<BusSample, SAMPLE_BUS_DEPTH> rings[BUS_CONSUMER_COUNT];
+static uint32_t nextSeq[SAMPLE_SOURCE_COUNT];
+
+static const char* const CONSUMER_NAMES[BUS_CONSUMER_COUNT] = {
+  "firebase",
+  "mqtt",
+  "http",
+  "logger"
+};
+
+// Fan out to every consumer; a full consumer ring drops only its own copy.
+// All sources publish from loop context, so each ring keeps a single producer.
+void publishSample(SampleSource source, float value) {
+  BusSample sample;
+  sample.seq = nextSeq[source]++;
+  sample.stamp = millis();
+  sample.source = source;
+  sample.value = value;
+
+  for (int i = 0; i < BUS_CONSUMER_COUNT; i++) {
+    rings[i].push(sample);
+  }
+}
+
+bool consumeSample(BusConsumer consumer, BusSample& sample) {
+  return rings[consumer].pop(sample);
+}
+
+uint32_t getSampleBusDrops(BusConsumer consumer) {
+  return rings[consumer].dropCount();
+}
+
+// Newest value per source; a skipped sequence number counts as a gap
+void updateSampleSnapshot(SampleSnapshot& snapshot, const BusSample& sample) {
+  uint8_t source = sample.source;
+  if (snapshot.seen & (1 << source)) snapshot.gaps += sample.seq - snapshot.nextSeq[source];
+  snapshot.value[source] = sample.value;
+  snapshot.stamp[source] = sample.stamp;
+  snapshot.nextSeq[source] = sample.seq + 1;
+  snapshot.seen |= 1 << source;
+}
+
+// Drain everything queued for a consumer, keeping the newest value per source
+int drainSampleSnapshot(BusConsumer consumer, SampleSnapshot& snapshot) {
+  BusSample sample;
+  int drained = 0;
+  while (rings[consumer].pop(sample)) {
+    updateSampleSnapshot(snapshot, sample);
+    drained++;
+  }
+  return drained;
+}
+
+bool hasSnapshotValue(const SampleSnapshot& snapshot, SampleSource source) {
+  return snapshot.seen & (1 << source);
+}
+
+void printSampleBusStats() {
+  Serial.println("🚌 Sample bus:");
+  for (int i = 0; i < BUS_CONSUMER_COUNT; i++) {
+    Serial.print("  "); Serial.print(CONSUMER_NAMES[i]);
+    Serial.print(": queued="); Serial.print(rings[i].size());
+    Serial.print(" drops="); Serial.println(rings[i].dropCount());
+  }
+}
@@ -0,0 +1,61 @@
+/*
+ * Sample Bus for ToxiRover
+ * Decouples sensor sampling from network consumers
+ *
+ * Features:
+ * - Typed, sequence-numbered samples from sensors and command sources
+ * - One SPSC ring per consumer, drained at the consumer's own pace
+ * - Per-consumer drop counters and per-source sequence gaps
+ * - Latest-value snapshots for consumers that only need the current state
+ */
+
+#ifndef SAMPLE_BUS_H
+#define SAMPLE_BUS_H
+
+#include <Arduino.h>
+#include "spsc_ring.h"
+
+#define SAMPLE_BUS_DEPTH 16  // per consumer; power of two
+
+enum SampleSource {
+  SAMPLE_GAS_PPM,
+  SAMPLE_DISTANCE_CM,
+  SAMPLE_MOTION,       // MotionCommand value
+  SAMPLE_SERVO_ANGLE,
+  SAMPLE_SOURCE_COUNT
+};
+
+enum BusConsumer {
+  BUS_CONSUMER_FIREBASE,  // telemetry tick
+  BUS_CONSUMER_MQTT,      // binary telemetry frames
+  BUS_CONSUMER_HTTP,      // web remote /samples
+  BUS_CONSUMER_LOGGER,    // /logs sample records
+  BUS_CONSUMER_COUNT
+};
+
+struct BusSample {
+  uint32_t seq;          // per source; gaps mean this consumer dropped samples
+  unsigned long stamp;   // millis() when taken
+  uint8_t source;
+  float value;
+};
+
+// Latest sample per source as seen by one consumer
+struct SampleSnapshot {
+  float value[SAMPLE_SOURCE_COUNT];
+  unsigned long stamp[SAMPLE_SOURCE_COUNT];
+  uint32_t nextSeq[SAMPLE_SOURCE_COUNT];  // expected next sequence number
+  uint8_t seen;                           // bit per source with a value
+  uint32_t gaps;                          // samples this consumer missed
+};
+
+// Function declarations
+void publishSample(SampleSource source, float value);
+bool consumeSample(BusConsumer consumer, BusSample& sample);
+uint32_t getSampleBusDrops(BusConsumer consumer);
+void updateSampleSnapshot(SampleSnapshot& snapshot, const BusSample& sample);
+int drainSampleSnapshot(BusConsumer consumer, SampleSnapshot& snapshot);
+bool hasSnapshotValue(const SampleSnapshot& snapshot, SampleSource source);
+void printSampleBusStats();
+
+#endif
@@ -0,0 +1,70 @@
+/*
+ * Lock-Free SPSC Ring for ToxiRover
+ * Fixed-capacity queue between one producer and one consumer
+ *
+ * Features:
+ * - No locks, no heap; safe to push from an ISR
+ * - Power-of-two capacity with free-running indices
+ * - Full ring rejects the new item and counts the drop
+ */
+
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <Arduino.h>
+
+template <typename T, uint32_t N>
+class SpscRing {
+  static_assert(N > 0 && (N & (N - 1)) == 0, "SpscRing capacity must be a power of two");
+
+  private:
+    T slots[N];
+    volatile uint32_t head;   // written only by the producer
+    volatile uint32_t tail;   // written only by the consumer
+    volatile uint32_t drops;  // written only by the producer
+
+  public:
+    SpscRing() : head(0), tail(0), drops(0) {}
+
+    // Producer side
+    bool push(const T& item) {
+      uint32_t h = head;
+      if (h - tail >= N) {
+        drops = drops + 1;
+        return false;
+      }
+      slots[h & (N - 1)] = item;
+      __sync_synchronize();  // slot contents visible before the index moves
+      head = h + 1;
+      return true;
+    }
+
+    // Consumer side
+    bool pop(T& item) {
+      uint32_t t = tail;
+      if (t == head) return false;
+      __sync_synchronize();  // read the index before the slot it guards
+      item = slots[t & (N - 1)];
+      __sync_synchronize();  // finish the read before the producer may reuse the slot
+      tail = t + 1;
+      return true;
+    }
+
+    uint32_t size() const {
+      return head - tail;
+    }
+
+    bool isEmpty() const {
+      return head == tail;
+    }
+
+    uint32_t capacity() const {
+      return N;
+    }
+
+    uint32_t dropCount() const {
+      return drops;
+    }
+};
+
+#endif
@@ -0,0 +1,180 @@
+/*
+ * Cooperative Task Scheduler Implementation for ToxiRover
+ */
+
+#include "task_scheduler.h"
+
+SchedulerStats schedulerStats = {0, 0, 0};
+
+static SchedulerTask tasks[SCHEDULER_MAX_TASKS];
+static int taskCount = 0;
+static unsigned long idleMaxSleep = SCHEDULER_IDLE_MAX_SLEEP;
+
+static bool isValidTask(TaskId id) {
+  return id >= 0 && id < taskCount;
+}
+
+static TaskId addTask(const char* name, TaskCallback callback, unsigned long intervalMs,
+                      unsigned long firstDelay, TaskPriority priority, unsigned long budgetMicros) {
+  // One-shot slots that already fired are reused before growing the table
+  TaskId id = TASK_INVALID;
+  for (int i = 0; i < taskCount; i++) {
+    if (!tasks[i].active && tasks[i].intervalMs == 0 && tasks[i].runs > 0) {
+      id = i;
+      break;
+    }
+  }
+  if (id == TASK_INVALID) {
+    if (taskCount >= SCHEDULER_MAX_TASKS) {
+      Serial.print("❌ Scheduler full, task not added: ");
+      Serial.println(name);
+      return TASK_INVALID;
+    }
+    id = taskCount++;
+  }
+
+  SchedulerTask& task = tasks[id];
+  memset(&task, 0, sizeof(task));
+  task.name = name;
+  task.callback = callback;
+  task.priority = priority;
+  task.intervalMs = intervalMs;
+  task.budgetMicros = budgetMicros;
+  task.nextRun = millis() + firstDelay;
+  task.active = true;
+#if PROFILER_ENABLED
+  task.profileSite = profilerRegisterSite(name);
+#endif
+  return id;
+}
+
+TaskId addPeriodicTask(const char* name, TaskCallback callback, unsigned long intervalMs,
+                       TaskPriority priority, unsigned long budgetMicros) {
+  if (intervalMs == 0) intervalMs = 1;
+  return addTask(name, callback, intervalMs, 0, priority, budgetMicros);
+}
+
+TaskId addOneShotTask(const char* name, TaskCallback callback, unsigned long delayMs,
+                      TaskPriority priority) {
+  return addTask(name, callback, 0, delayMs, priority, 0);
+}
+
+void setTaskInterval(TaskId id, unsigned long intervalMs) {
+  if (!isValidTask(id) || tasks[id].intervalMs == 0 || intervalMs == 0) return;
+
+  // Pull the next run in if the new rate is faster than what's scheduled
+  SchedulerTask& task = tasks[id];
+  unsigned long lastDue = task.nextRun - task.intervalMs;
+  task.intervalMs = intervalMs;
+  if ((long)(task.nextRun - (lastDue + intervalMs)) > 0) {
+    task.nextRun = lastDue + intervalMs;
+  }
+}
+
+void setTaskEnabled(TaskId id, bool enabled) {
+  if (!isValidTask(id) || tasks[id].active == enabled) return;
+
+  tasks[id].active = enabled;
+  if (enabled) tasks[id].nextRun = millis();
+}
+
+// Longer idle sleeps let the SDK's automatic light sleep kick in
+void setSchedulerMaxSleep(unsigned long ms) {
+  idleMaxSleep = ms > 0 ? ms : SCHEDULER_IDLE_MAX_SLEEP;
+}
+
+const SchedulerTask* getTask(TaskId id) {
+  return isValidTask(id) ? &tasks[id] : NULL;
+}
+
+// Highest-priority due task; ties go to the one that has waited longest
+static TaskId pickDueTask(unsigned long now, long& untilNext) {
+  TaskId best = TASK_INVALID;
+  untilNext = idleMaxSleep;
+
+  for (int i = 0; i < taskCount; i++) {
+    SchedulerTask& task = tasks[i];
+    if (!task.active) continue;
+
+    long wait = (long)(task.nextRun - now);
+    if (wait > 0) {
+      if (wait < untilNext) untilNext = wait;
+      continue;
+    }
+
+    if (best == TASK_INVALID ||
+        task.priority < tasks[best].priority ||
+        (task.priority == tasks[best].priority &&
+         (long)(task.nextRun - tasks[best].nextRun) < 0)) {
+      best = i;
+    }
+  }
+  return best;
+}
+
+static void runTask(SchedulerTask& task, unsigned long now) {
+  unsigned long latency = now - task.nextRun;
+  unsigned long deadline = task.intervalMs > 0 ? task.intervalMs : SCHEDULER_ONESHOT_DEADLINE;
+  if (latency >= deadline) task.deadlineMisses++;
+  if (latency > task.maxLatencyMs) task.maxLatencyMs = latency;
+
+  // Reschedule before running so the callback may change its own rate or disable itself
+  if (task.intervalMs > 0) {
+    task.nextRun += task.intervalMs;
+    // Fell a whole period behind: drop the missed runs rather than bursting to catch up
+    if ((long)(now - task.nextRun) >= 0) {
+      task.nextRun = now + task.intervalMs;
+    }
+  } else {
+    task.active = false;
+  }
+
+  unsigned long startMicros = micros();
+  {
+#if PROFILER_ENABLED
+    ProfileScope scope(task.profileSite);
+#endif
+    task.callback();
+  }
+  unsigned long duration = micros() - startMicros;
+
+  task.runs++;
+  task.lastRunMicros = duration;
+  if (duration > task.maxRunMicros) task.maxRunMicros = duration;
+  if (task.budgetMicros > 0 && duration > task.budgetMicros) task.overruns++;
+}
+
+void runScheduler() {
+  schedulerStats.passes++;
+
+  long untilNext;
+  TaskId id = pickDueTask(millis(), untilNext);
+  if (id != TASK_INVALID) {
+    runTask(tasks[id], millis());
+    return;
+  }
+
+  // Nothing due: sleep until the next task, capped so the core keeps getting time
+  if (untilNext > 0) {
+    schedulerStats.idleSleeps++;
+    schedulerStats.idleMs += untilNext;
+    delay(untilNext);
+  }
+}
+
+void printSchedulerStats() {
+  Serial.println("⏱️ Scheduler:");
+  Serial.print("  Passes: "); Serial.print(schedulerStats.passes);
+  Serial.print("  Idle: "); Serial.print(schedulerStats.idleMs); Serial.println(" ms");
+
+  for (int i = 0; i < taskCount; i++) {
+    const SchedulerTask& task = tasks[i];
+    Serial.print("  "); Serial.print(task.name);
+    Serial.print(task.active ? "" : " (off)");
+    Serial.print(": runs="); Serial.print(task.runs);
+    Serial.print(" missed="); Serial.print(task.deadlineMisses);
+    Serial.print(" overruns="); Serial.print(task.overruns);
+    Serial.print(" max="); Serial.print(task.maxRunMicros); Serial.print("us");
+    Serial.print(" lat="); Serial.print(task.maxLatencyMs); Serial.println("ms");
+  }
+}
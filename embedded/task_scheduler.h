@@ -0,0 +1,76 @@
+/*
+ * Cooperative Task Scheduler for ToxiRover
+ * Runs module work from loop() on fixed rates instead of hand-rolled timers
+ *
+ * Features:
+ * - Periodic and one-shot tasks with three priority levels
+ * - Per-task deadline-miss and run-time overrun counters
+ * - Interval changes and enable/disable at runtime
+ * - Idle sleep until the next task is due
+ */
+
+#ifndef TASK_SCHEDULER_H
+#define TASK_SCHEDULER_H
+
+#include <Arduino.h>
+#include "loop_profiler.h"
+#include "features.h"
+
+#define SCHEDULER_SPARE_TASKS 4           // runtime one-shots on top of the boot set
+#define SCHEDULER_MAX_TASKS (FEATURE_BOOT_TASKS + SCHEDULER_SPARE_TASKS)
+#define SCHEDULER_IDLE_MAX_SLEEP 10       // ms; default idle cap, see setSchedulerMaxSleep()
+#define SCHEDULER_ONESHOT_DEADLINE 100    // ms late before a one-shot counts as a deadline miss
+#define TASK_INVALID -1
+
+typedef void (*TaskCallback)();
+typedef int TaskId;
+
+// Lower value runs first when several tasks are due together
+enum TaskPriority {
+  PRIORITY_HIGH,
+  PRIORITY_NORMAL,
+  PRIORITY_LOW
+};
+
+struct SchedulerTask {
+  const char* name;
+  TaskCallback callback;
+  TaskPriority priority;
+  unsigned long intervalMs;     // 0 for one-shot tasks
+  unsigned long budgetMicros;   // run time above this counts as an overrun (0 = no budget)
+  unsigned long nextRun;
+  bool active;
+
+  // Statistics
+  unsigned long runs;
+  unsigned long deadlineMisses; // started a full period (or one-shot deadline) late
+  unsigned long overruns;       // ran longer than budgetMicros
+  unsigned long lastRunMicros;
+  unsigned long maxRunMicros;
+  unsigned long maxLatencyMs;   // due time to start time
+#if PROFILER_ENABLED
+  int profileSite;
+#endif
+};
+
+struct SchedulerStats {
+  unsigned long passes;
+  unsigned long idleSleeps;
+  unsigned long idleMs;
+};
+
+extern SchedulerStats schedulerStats;
+
+// Function declarations
+TaskId addPeriodicTask(const char* name, TaskCallback callback, unsigned long intervalMs,
+                       TaskPriority priority, unsigned long budgetMicros = 0);
+TaskId addOneShotTask(const char* name, TaskCallback callback, unsigned long delayMs,
+                      TaskPriority priority);
+void setTaskInterval(TaskId id, unsigned long intervalMs);
+void setTaskEnabled(TaskId id, bool enabled);
+void runScheduler();
+void setSchedulerMaxSleep(unsigned long ms);
+const SchedulerTask* getTask(TaskId id);
+void printSchedulerStats();
+
+#endif
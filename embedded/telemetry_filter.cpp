@@ -0,0 +1,63 @@
+/*
+ * Telemetry Change Filter Implementation for ToxiRover
+ */
+
+#include "telemetry_filter.h"
+
+bool isFieldDirty(const TelemetryField& field, float value) {
+  if (!field.hasSent) return true;
+
+  float delta = fabs(value - field.lastValue);
+  if (field.mode == DEADBAND_RELATIVE) {
+    return delta > field.deadband * fabs(field.lastValue);
+  }
+  return delta > field.deadband;
+}
+
+void markFieldSent(TelemetryField& field, float value) {
+  field.lastValue = value;
+  field.hasSent = true;
+}
+
+unsigned long fieldPayloadBytes(const TelemetryField& field) {
+  unsigned long bytes = strlen(field.key) + TELEMETRY_FIELD_OVERHEAD;
+  if (field.mirrorKey) {
+    bytes += strlen(field.mirrorKey) + TELEMETRY_FIELD_OVERHEAD;
+  }
+  return bytes;
+}
+
+void recordTelemetryField(TelemetrySavings& savings, const TelemetryField& field, bool sent) {
+  if (sent) {
+    savings.fieldsSent++;
+    savings.bytesSent += fieldPayloadBytes(field);
+  } else {
+    savings.fieldsSuppressed++;
+    savings.bytesSuppressed += fieldPayloadBytes(field);
+  }
+}
+
+void recordTelemetryRequest(TelemetrySavings& savings, bool sent) {
+  if (sent) {
+    savings.requestsSent++;
+  } else {
+    savings.requestsSuppressed++;
+  }
+}
+
+void printTelemetrySavings(const TelemetrySavings& savings) {
+  unsigned long elapsed = millis() - savings.startTime;
+  if (elapsed == 0) elapsed = 1;
+
+  Serial.println("📉 Telemetry suppression:");
+  Serial.print("  Requests sent/suppressed: ");
+  Serial.print(savings.requestsSent); Serial.print("/");
+  Serial.println(savings.requestsSuppressed);
+  Serial.print("  Fields sent/suppressed: ");
+  Serial.print(savings.fieldsSent); Serial.print("/");
+  Serial.println(savings.fieldsSuppressed);
+  Serial.print("  Requests saved per hour: ");
+  Serial.println((float)savings.requestsSuppressed * 3600000.0 / elapsed);
+  Serial.print("  Bytes saved per hour (approx): ");
+  Serial.println((float)savings.bytesSuppressed * 3600000.0 / elapsed);
+}
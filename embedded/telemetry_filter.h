@@ -0,0 +1,52 @@
+/*
+ * Telemetry Change Filter for ToxiRover
+ * Per-field dirty tracking with deadbands and heartbeat
+ *
+ * Features:
+ * - Absolute or relative deadband per channel
+ * - Enum states (e.g. motion) tracked as numbers with a zero deadband
+ * - Forced resend after a maximum heartbeat interval
+ * - Counters for requests and bytes saved
+ */
+
+#ifndef TELEMETRY_FILTER_H
+#define TELEMETRY_FILTER_H
+
+#include <Arduino.h>
+
+// Approximate JSON overhead per field: quotes, colon, comma and value
+#define TELEMETRY_FIELD_OVERHEAD 12
+
+enum DeadbandMode {
+  DEADBAND_ABSOLUTE,  // changed if |new - last| > deadband
+  DEADBAND_RELATIVE   // changed if |new - last| > deadband * |last|
+};
+
+struct TelemetryField {
+  const char* key;        // multi-location update key
+  const char* mirrorKey;  // optional second path carrying the same value
+  DeadbandMode mode;
+  float deadband;
+  float lastValue;
+  bool hasSent;
+};
+
+struct TelemetrySavings {
+  unsigned long startTime;
+  unsigned long requestsSent;
+  unsigned long requestsSuppressed;
+  unsigned long fieldsSent;
+  unsigned long fieldsSuppressed;
+  unsigned long bytesSent;
+  unsigned long bytesSuppressed;
+};
+
+// Function declarations
+bool isFieldDirty(const TelemetryField& field, float value);
+void markFieldSent(TelemetryField& field, float value);
+unsigned long fieldPayloadBytes(const TelemetryField& field);
+void recordTelemetryField(TelemetrySavings& savings, const TelemetryField& field, bool sent);
+void recordTelemetryRequest(TelemetrySavings& savings, bool sent);
+void printTelemetrySavings(const TelemetrySavings& savings);
+
+#endif
@@ -0,0 +1,189 @@
+/*
+ * Compact Telemetry Frames Implementation for ToxiRover
+ */
+
+#include "telemetry_frame.h"
+#include "json_writer.h"
+#include "device_id.h"
+
+// Explicit byte order so frames decode the same on any host
+static void putU16(uint8_t* p, uint16_t value) {
+  p[0] = value & 0xFF;
+  p[1] = value >> 8;
+}
+
+static void putU32(uint8_t* p, uint32_t value) {
+  putU16(p, value & 0xFFFF);
+  putU16(p + 2, value >> 16);
+}
+
+static uint16_t getU16(const uint8_t* p) {
+  return p[0] | (uint16_t)p[1] << 8;
+}
+
+static uint32_t getU32(const uint8_t* p) {
+  return getU16(p) | (uint32_t)getU16(p + 2) << 16;
+}
+
+static int16_t clampI16(float value) {
+  return (int16_t)constrain(value, -32768.0f, 32767.0f);
+}
+
+void setTelemetryFrameGas(TelemetryFrame& frame, float ppm) {
+  frame.gasDeciPpm = (uint16_t)constrain(ppm * 10 + 0.5f, 0.0f, 65535.0f);
+}
+
+void setTelemetryFramePose(TelemetryFrame& frame, float xCm, float yCm, float headingRad) {
+  frame.xCm = clampI16(xCm);
+  frame.yCm = clampI16(yCm);
+  frame.headingCentiDeg = clampI16(headingRad * RAD_TO_DEG * 100);
+}
+
+// Always writes the current version; returns 0 if the buffer is too small
+size_t encodeTelemetryFrame(const TelemetryFrame& frame, uint8_t* buffer, size_t size) {
+  if (size < TELEMETRY_FRAME_MAX_SIZE) return 0;
+
+  buffer[0] = TELEMETRY_FRAME_MAGIC;
+  buffer[1] = TELEMETRY_FRAME_VERSION;
+  buffer[2] = TELEMETRY_FRAME_BODY_SIZE;
+  buffer[3] = frame.seq;
+
+  uint8_t* body = buffer + TELEMETRY_FRAME_HEADER_SIZE;
+  putU32(body + 0, frame.stamp);
+  putU16(body + 4, frame.gasDeciPpm);
+  putU16(body + 6, frame.distanceCm);
+  body[8] = frame.motion;
+  body[9] = frame.servoAngle;
+  putU16(body + 10, (uint16_t)frame.xCm);
+  putU16(body + 12, (uint16_t)frame.yCm);
+  putU16(body + 14, (uint16_t)frame.headingCentiDeg);
+  body[16] = frame.flags;
+  putU32(body + 17, frame.device);
+  return TELEMETRY_FRAME_MAX_SIZE;
+}
+
+// Accepts any version with at least the version 1 body; see the rules in the header
+bool decodeTelemetryFrame(const uint8_t* buffer, size_t length, TelemetryFrame& frame) {
+  if (length < TELEMETRY_FRAME_HEADER_SIZE || buffer[0] != TELEMETRY_FRAME_MAGIC) return false;
+  size_t bodySize = buffer[2];
+  if (bodySize < TELEMETRY_FRAME_V1_BODY_SIZE || length < TELEMETRY_FRAME_HEADER_SIZE + bodySize) return false;
+
+  const uint8_t* body = buffer + TELEMETRY_FRAME_HEADER_SIZE;
+  frame.version = buffer[1];
+  frame.seq = buffer[3];
+  frame.stamp = getU32(body + 0);
+  frame.gasDeciPpm = getU16(body + 4);
+  frame.distanceCm = getU16(body + 6);
+  frame.motion = body[8];
+  frame.servoAngle = body[9];
+  frame.xCm = (int16_t)getU16(body + 10);
+  frame.yCm = (int16_t)getU16(body + 12);
+  frame.headingCentiDeg = (int16_t)getU16(body + 14);
+  frame.flags = body[16];
+  frame.device = bodySize >= 17 + 4 ? getU32(body + 17) : 0;  // appended in version 2
+  return true;
+}
+
+// Same field names as the dashboard's JSON; unknown readings are left out
+const char* formatTelemetryFrameJson(const TelemetryFrame& frame, char* buffer, size_t size) {
+  JsonWriter writer(buffer, size);
+  writer.beginObject();
+  char device[DEVICE_ID_SIZE];
+  snprintf(device, sizeof(device), "%06lx", (unsigned long)frame.device);
+
+  writer.add("version", (unsigned int)frame.version);
+  writer.add("device", device);
+  writer.add("seq", (unsigned int)frame.seq);
+  writer.add("stamp", (unsigned long)frame.stamp);
+  writer.add("gas_ppm", frame.gasDeciPpm / 10.0, 1);
+  if (frame.distanceCm != TELEMETRY_NO_DISTANCE) writer.add("distance_cm", (unsigned int)frame.distanceCm);
+  writer.add("motion", getMotionName((MotionCommand)frame.motion));
+  if (frame.servoAngle != TELEMETRY_NO_SERVO) writer.add("servo_angle", (unsigned int)frame.servoAngle);
+  writer.add("x_cm", (int)frame.xCm);
+  writer.add("y_cm", (int)frame.yCm);
+  writer.add("heading_deg", frame.headingCentiDeg / 100.0, 2);
+  writer.add("gas_alarm", (frame.flags & FRAME_FLAG_GAS_ALARM) != 0);
+  writer.add("seeking", (frame.flags & FRAME_FLAG_SEEKING) != 0);
+  writer.add("time_synced", (frame.flags & FRAME_FLAG_TIME_SYNCED) != 0);
+  writer.add("parked", (frame.flags & FRAME_FLAG_PARKED) != 0);
+  writer.endObject();
+  return writer.ok() ? buffer : NULL;
+}
+
+const char* getTelemetryFrameCsvHeader() {
+  return "version,device,seq,stamp,gas_ppm,distance_cm,motion,servo_angle,x_cm,y_cm,heading_deg,flags";
+}
+
+// Unknown readings are empty columns
+const char* formatTelemetryFrameCsv(const TelemetryFrame& frame, char* buffer, size_t size) {
+  char distance[6] = "";
+  char servo[4] = "";
+  if (frame.distanceCm != TELEMETRY_NO_DISTANCE) snprintf(distance, sizeof(distance), "%u", frame.distanceCm);
+  if (frame.servoAngle != TELEMETRY_NO_SERVO) snprintf(servo, sizeof(servo), "%u", frame.servoAngle);
+
+  int heading = abs(frame.headingCentiDeg);
+
+  int written = snprintf(buffer, size, "%u,%06lx,%u,%lu,%u.%u,%s,%s,%s,%d,%d,%s%d.%02d,%u",
+                         frame.version, (unsigned long)frame.device, frame.seq, (unsigned long)frame.stamp,
+                         frame.gasDeciPpm / 10, frame.gasDeciPpm % 10, distance,
+                         getMotionName((MotionCommand)frame.motion), servo, frame.xCm, frame.yCm,
+                         frame.headingCentiDeg < 0 ? "-" : "", heading / 100, heading % 100, frame.flags);
+  return written > 0 && (size_t)written < size ? buffer : NULL;
+}
+
+#if BENCHMARK_ENABLED
+static volatile size_t benchSink;
+static TelemetryFrame benchFrame;
+static uint8_t benchBytes[TELEMETRY_FRAME_MAX_SIZE];
+
+static void benchFrameEncode() {
+  benchFrame.seq++;
+  benchSink = encodeTelemetryFrame(benchFrame, benchBytes, sizeof(benchBytes));
+}
+
+static void benchFrameDecode() {
+  TelemetryFrame frame;
+  benchSink = decodeTelemetryFrame(benchBytes, sizeof(benchBytes), frame);
+}
+
+static void benchFrameJson() {
+  static char json[TELEMETRY_JSON_SIZE];
+  benchSink = formatTelemetryFrameJson(benchFrame, json, sizeof(json)) != NULL;
+}
+
+// Encoder, decoder and decode-side JSON; compared against the JSON telemetry path when given
+void runTelemetryFrameBenchmarks(const BenchmarkResult* json, size_t jsonBytes) {
+  memset(&benchFrame, 0, sizeof(benchFrame));
+  setTelemetryFrameGas(benchFrame, 412.5f);
+  setTelemetryFramePose(benchFrame, -153, 287, 1.2f);
+  benchFrame.stamp = millis();
+  benchFrame.distanceCm = 37;
+  benchFrame.motion = MOTION_FORWARD;
+  benchFrame.servoAngle = 90;
+  benchFrame.flags = FRAME_FLAG_GAS_ALARM;
+  benchFrame.device = 0xA1B2C3;
+
+  BenchmarkResult encode = runBenchmark("telemetryFrameEncode", benchFrameEncode, 10000);
+  printBenchmarkResult(encode);
+  printBenchmarkResult(runBenchmark("telemetryFrameDecode", benchFrameDecode, 10000));
+  printBenchmarkResult(runBenchmark("telemetryFrameJson", benchFrameJson, 1000));
+
+  TelemetryFrame decoded;
+  bool roundTrip = decodeTelemetryFrame(benchBytes, sizeof(benchBytes), decoded) &&
+                   decoded.gasDeciPpm == benchFrame.gasDeciPpm && decoded.xCm == benchFrame.xCm &&
+                   decoded.headingCentiDeg == benchFrame.headingCentiDeg &&
+                   decoded.device == benchFrame.device;
+
+  Serial.print("TELEFRAME,frame_bytes="); Serial.print(TELEMETRY_FRAME_MAX_SIZE);
+  Serial.print(",round_trip="); Serial.print(roundTrip ? "ok" : "FAIL");
+  if (json != NULL && jsonBytes > 0) {
+    Serial.print(",json_bytes="); Serial.print(jsonBytes);
+    Serial.print(",size_ratio="); Serial.print((float)jsonBytes / TELEMETRY_FRAME_MAX_SIZE, 1);
+    Serial.print(",json_ns="); Serial.print(json->nsPerOp);
+    Serial.print(",frame_ns="); Serial.print(encode.nsPerOp);
+    Serial.print(",encode_speedup=");
+    Serial.print(encode.nsPerOp > 0 ? (float)json->nsPerOp / encode.nsPerOp : 0, 1);
+  }
+  Serial.println();
+}
+#endif
@@ -0,0 +1,92 @@
+/*
+ * Compact Telemetry Frames for ToxiRover
+ * Versioned binary encoding of one telemetry sample
+ *
+ * Features:
+ * - 25-byte little-endian frame instead of ~250 bytes of keyed JSON
+ * - Header with magic, version, body length and sequence number
+ * - Forward and backward compatible schema evolution (rules below)
+ * - Decoder with JSON and CSV output for logs and dashboards
+ * - Size and encode-time comparison against JSON with BENCHMARK_ENABLED
+ *
+ * Layout (version 2):
+ *   header  0  uint8   magic 'T'
+ *           1  uint8   version
+ *           2  uint8   body length in bytes
+ *           3  uint8   sequence, wraps; gaps mean lost frames
+ *   body    0  uint32  stamp, ms since boot
+ *           4  uint16  gas, 0.1 ppm, saturates
+ *           6  uint16  distance, cm (0xFFFF = no reading)
+ *           8  uint8   MotionCommand
+ *           9  uint8   servo angle, degrees (0xFF = unknown)
+ *          10  int16   x, cm
+ *          12  int16   y, cm
+ *          14  int16   heading, 0.01 degrees
+ *          16  uint8   TelemetryFrameFlag bits
+ *          17  uint32  device chip ID (version 2; 0 when decoding version 1)
+ *
+ * Schema evolution:
+ * - New fields are only appended to the body; existing offsets, widths and
+ *   units never change, and removed fields keep their bytes.
+ * - Decoders read the fields that fit in the body length, default the
+ *   rest, and skip trailing bytes they don't know.
+ * - Version goes up for every appended field. A different magic, or a
+ *   body shorter than version 1, is rejected.
+ */
+
+#ifndef TELEMETRY_FRAME_H
+#define TELEMETRY_FRAME_H
+
+#include <Arduino.h>
+#include "rover_status.h"
+#include "benchmark.h"
+
+#define TELEMETRY_FRAME_MAGIC 'T'
+#define TELEMETRY_FRAME_VERSION 2
+#define TELEMETRY_FRAME_HEADER_SIZE 4
+#define TELEMETRY_FRAME_V1_BODY_SIZE 17
+#define TELEMETRY_FRAME_BODY_SIZE 21
+#define TELEMETRY_FRAME_MAX_SIZE (TELEMETRY_FRAME_HEADER_SIZE + TELEMETRY_FRAME_BODY_SIZE)
+#define TELEMETRY_FRAME_INTERVAL 2000  // ms between frames on the MQTT feed
+#define TELEMETRY_NO_DISTANCE 0xFFFF
+#define TELEMETRY_NO_SERVO 0xFF
+#define TELEMETRY_JSON_SIZE 288
+
+enum TelemetryFrameFlag {
+  FRAME_FLAG_GAS_ALARM = 1 << 0,
+  FRAME_FLAG_SEEKING = 1 << 1,
+  FRAME_FLAG_TIME_SYNCED = 1 << 2,
+  FRAME_FLAG_PARKED = 1 << 3
+};
+
+// Decoded sample in wire units; frames only ever carry these
+struct TelemetryFrame {
+  uint8_t version;
+  uint8_t seq;
+  uint32_t stamp;
+  uint16_t gasDeciPpm;
+  uint16_t distanceCm;
+  uint8_t motion;
+  uint8_t servoAngle;
+  int16_t xCm;
+  int16_t yCm;
+  int16_t headingCentiDeg;
+  uint8_t flags;
+  uint32_t device;
+};
+
+// Function declarations
+void setTelemetryFrameGas(TelemetryFrame& frame, float ppm);
+void setTelemetryFramePose(TelemetryFrame& frame, float xCm, float yCm, float headingRad);
+size_t encodeTelemetryFrame(const TelemetryFrame& frame, uint8_t* buffer, size_t size);
+bool decodeTelemetryFrame(const uint8_t* buffer, size_t length, TelemetryFrame& frame);
+const char* formatTelemetryFrameJson(const TelemetryFrame& frame, char* buffer, size_t size);
+const char* getTelemetryFrameCsvHeader();
+const char* formatTelemetryFrameCsv(const TelemetryFrame& frame, char* buffer, size_t size);
+
+#if BENCHMARK_ENABLED
+// json may be NULL in builds without a JSON telemetry path
+void runTelemetryFrameBenchmarks(const BenchmarkResult* json, size_t jsonBytes);
+#endif
+
+#endif
@@ -0,0 +1,75 @@
+/*
+ * Time Synchronization Implementation for ToxiRover
+ */
+
+#include <time.h>
+#include <sys/time.h>
+#include "time_sync.h"
+
+static uint32_t bootId = 0;
+static uint64_t lastEpochMillis = 0;
+
+void initTimeSync() {
+  bootId = RANDOM_REG32;
+
+  // Returns immediately; the SNTP client keeps the clock updated in the background
+  configTime(0, 0, NTP_SERVER_1, NTP_SERVER_2);
+
+  Serial.print("🕒 SNTP started, boot id: ");
+  Serial.println(bootId, HEX);
+}
+
+bool isTimeSynced() {
+  return time(NULL) >= (time_t)TIME_SYNC_MIN_EPOCH;
+}
+
+uint64_t getEpochMillis() {
+  if (!isTimeSynced()) return 0;
+
+  struct timeval now;
+  gettimeofday(&now, NULL);
+  uint64_t epochMillis = (uint64_t)now.tv_sec * 1000 + now.tv_usec / 1000;
+
+  // SNTP corrections may step the clock back; never report time going backwards
+  if (epochMillis < lastEpochMillis) {
+    epochMillis = lastEpochMillis;
+  }
+  lastEpochMillis = epochMillis;
+  return epochMillis;
+}
+
+uint64_t millisToEpochMillis(unsigned long stamp) {
+  uint64_t nowEpoch = getEpochMillis();
+  if (nowEpoch == 0) return 0;
+
+  // Unsigned subtraction stays correct across a millis() wrap
+  unsigned long age = millis() - stamp;
+  return nowEpoch - age;
+}
+
+// Epoch ms once synced, otherwise the raw millis() stamp as before
+uint64_t getRecordTimestamp(unsigned long stamp) {
+  uint64_t epochMillis = millisToEpochMillis(stamp);
+  return epochMillis != 0 ? epochMillis : stamp;
+}
+
+// Zero-padded decimal without relying on printf 64-bit support; out needs 21 bytes
+void formatTimestamp(char* out, uint64_t value, int width) {
+  char digits[21];
+  int n = 0;
+  do {
+    digits[n++] = '0' + (value % 10);
+    value /= 10;
+  } while (value > 0 && n < 20);
+
+  while (n < width && n < 20) digits[n++] = '0';
+
+  for (int i = 0; i < n; i++) {
+    out[i] = digits[n - 1 - i];
+  }
+  out[n] = '\0';
+}
+
+uint32_t getBootId() {
+  return bootId;
+}
@@ -0,0 +1,32 @@
+/*
+ * Time Synchronization for ToxiRover
+ * SNTP wall clock with a monotonic millis() fallback
+ *
+ * Features:
+ * - Non-blocking SNTP via the ESP8266 core
+ * - Epoch milliseconds that never go backwards
+ * - Pre-sync millis() stamps convertible to epoch once synced
+ * - Random boot id so unsynced samples stay orderable per boot
+ */
+
+#ifndef TIME_SYNC_H
+#define TIME_SYNC_H
+
+#include <Arduino.h>
+
+#define NTP_SERVER_1 "pool.ntp.org"
+#define NTP_SERVER_2 "time.nist.gov"
+
+// Any epoch before this means SNTP has not answered yet (2020-09-13)
+#define TIME_SYNC_MIN_EPOCH 1600000000UL
+
+// Function declarations
+void initTimeSync();
+bool isTimeSynced();
+uint64_t getEpochMillis();
+uint64_t millisToEpochMillis(unsigned long stamp);
+uint64_t getRecordTimestamp(unsigned long stamp);
+void formatTimestamp(char* out, uint64_t value, int width);
+uint32_t getBootId();
+
+#endif
@@ -12,23 +12,25 @@
  */
 
 #include <ESP8266WiFi.h>
-#include <FirebaseESP8266.h>
+#include "features.h"
 #include <Servo.h>
 #include <NewPing.h>
 #include "gas_sensor.h"
+#include "config_store.h"
 #include "motion.h"
 #include "servo_control.h"
 #include "ultrasonic.h"
 #include "firebase.h"
+#include "alert_manager.h"
+#include "task_scheduler.h"
+#include "sample_bus.h"
+#include "boot_sequencer.h"
+#include "power_manager.h"
 
 // WiFi Configuration
 const char* ssid = "YOUR_WIFI_SSID";
 const char* password = "YOUR_WIFI_PASSWORD";
 
-// Firebase Configuration
-#define FIREBASE_HOST "your-project.firebaseio.com"
-#define FIREBASE_AUTH "your-firebase-secret"
-
 // Pin Definitions
 #define GAS_SENSOR_PIN A0
 #define ULTRASONIC_TRIG_PIN D5
@@ -44,166 +46,169 @@ const char* password = "YOUR_WIFI_PASSWORD";
 #define ENB D0  // Right motor enable
 
 // Global Objects
-FirebaseData firebaseData;
-FirebaseJson json;
 Servo gasServo;
 NewPing sonar(ULTRASONIC_TRIG_PIN, ULTRASONIC_ECHO_PIN, 200);
 
 // Timing variables
-unsigned long lastGasReading = 0;
-unsigned long lastDistanceReading = 0;
-unsigned long lastFirebaseUpdate = 0;
 const unsigned long GAS_READ_INTERVAL = 1000;    // 1 second
 const unsigned long DISTANCE_READ_INTERVAL = 500; // 500ms
 const unsigned long FIREBASE_UPDATE_INTERVAL = 2000; // 2 seconds
+const unsigned long COMMAND_POLL_INTERVAL = 20;  // stream reads are non-blocking
+
+// Parked rates (power manager); 0 stops the task while parked
+const unsigned long PARKED_GAS_INTERVAL = 5000;      // bounds gas danger latency without the D0 interrupt
+const unsigned long PARKED_COMMAND_INTERVAL = 200;   // bounds command latency on top of the radio listen interval
+const unsigned long PARKED_FIREBASE_INTERVAL = 10000;
 
 // Sensor data
 float gasConcentration = 0;
 int distance = 0;
-String currentMotion = "STOP";
+MotionCommand currentMotion = MOTION_STOP;
 int servoAngle = 90;
 
 void setup() {
-  Serial.begin(115200);
+  Serial.begin(SERIAL_BAUD);
+  initBootSequencer();
   Serial.println("🚀 ToxiRover Starting...");
   
-  // Initialize WiFi
+  // Sensors and actuators first so sampling starts before the network is up
+  initGasSensor();
+  initMotion();
+  initServo();
+  initUltrasonic();
+  
+  // Warm restart: put the servo back and report the last command; motors stay stopped
+  if (isWarmBoot()) {
+    servoAngle = warmState.servoAngle;
+    rotateServo(servoAngle);
+    Serial.print("♨️ Last motion before reset: ");
+    Serial.println(getMotionName((MotionCommand)warmState.lastMotion));
+  }
+  markBootMilestone(BOOT_SENSORS_READY);
+  
+  // Network comes up in the background
   initWiFi();
   
+#if FEATURE_FIREBASE
   // Initialize Firebase
   initFirebase();
+  setFirebaseCommandHandlers(handleMotionCommand, handleServoCommand);
+#endif
   
-  // Initialize sensors and actuators
-  initGasSensor();
-  initMotion();
-  initServo();
-  initUltrasonic();
+  // Register periodic work; obstacle handling outranks telemetry
+  initPowerManager();
+  addPowerStateHandler(parkServos);
+  TaskId distanceId = addPeriodicTask("distance", distanceTask, DISTANCE_READ_INTERVAL, PRIORITY_HIGH, 30000);
+  addPowerManagedTask(distanceId, DISTANCE_READ_INTERVAL, 0);  // sonar off while parked
+#if FEATURE_FIREBASE
+  TaskId commandsId = addPeriodicTask("commands", checkFirebaseCommands, COMMAND_POLL_INTERVAL, PRIORITY_HIGH, 20000);
+  addPowerManagedTask(commandsId, COMMAND_POLL_INTERVAL, PARKED_COMMAND_INTERVAL);
+#endif
+  TaskId gasId = addPeriodicTask("gas", gasTask, GAS_READ_INTERVAL, PRIORITY_NORMAL, 5000);
+  addPowerManagedTask(gasId, GAS_READ_INTERVAL, PARKED_GAS_INTERVAL);
+#if FEATURE_FIREBASE
+  TaskId firebaseId = addPeriodicTask("firebase", updateFirebaseData, FIREBASE_UPDATE_INTERVAL, PRIORITY_LOW);
+  addPowerManagedTask(firebaseId, FIREBASE_UPDATE_INTERVAL, PARKED_FIREBASE_INTERVAL);
+  TaskId loggerId = addPeriodicTask("logger", logDataToFirebase, SAMPLE_LOG_INTERVAL, PRIORITY_LOW);
+  addPowerManagedTask(loggerId, SAMPLE_LOG_INTERVAL, PARKED_FIREBASE_INTERVAL);
+#endif
+  
+#if PROFILER_ENABLED
+  addPeriodicTask("profiler", serviceProfilerSerial, 200, PRIORITY_LOW);  // 'p' prints, 'r' resets
+#endif
   
   Serial.println("✅ ToxiRover initialized successfully!");
+  printFeatureReport();
 }
 
 void loop() {
-  // Read gas sensor
-  if (millis() - lastGasReading >= GAS_READ_INTERVAL) {
-    gasConcentration = readGasSensor();
-    lastGasReading = millis();
-    
-    // Check for dangerous gas levels
-    if (gasConcentration > GAS_DANGER_THRESHOLD) {
-      Serial.println("⚠️ DANGER: High gas concentration detected!");
-      triggerGasAlert();
-    }
-  }
-  
-  // Read ultrasonic sensor
-  if (millis() - lastDistanceReading >= DISTANCE_READ_INTERVAL) {
-    distance = readDistance();
-    lastDistanceReading = millis();
-    
-    // Obstacle avoidance
-    if (distance < OBSTACLE_THRESHOLD && currentMotion != "STOP") {
-      Serial.println("🚫 Obstacle detected! Stopping...");
-      stopMotion();
-      currentMotion = "STOP";
-    }
-  }
+  // Runs the next due task, or sleeps until one is due
+  runScheduler();
+}
+
+void gasTask() {
+  gasConcentration = readGasSensor();
+  markBootMilestone(BOOT_FIRST_SAMPLE);
+  notePowerGas(gasConcentration);
+  publishSample(SAMPLE_GAS_PPM, gasConcentration);
   
-  // Update Firebase
-  if (millis() - lastFirebaseUpdate >= FIREBASE_UPDATE_INTERVAL) {
-    updateFirebaseData();
-    lastFirebaseUpdate = millis();
+  // Check for dangerous gas levels
+  if (gasConcentration > roverConfig.gasDangerThreshold) {
+    Serial.println("⚠️ DANGER: High gas concentration detected!");
+    triggerGasAlert();
   }
   
-  // Check for motion commands from Firebase
-  checkMotionCommands();
-  
-  // Check for servo commands from Firebase
-  checkServoCommands();
-  
-  delay(10); // Small delay to prevent watchdog reset
+  // Resolve alerts that have gone quiet
+  serviceAlerts();
 }
 
-void initWiFi() {
-  Serial.print("📡 Connecting to WiFi: ");
-  Serial.println(ssid);
+void distanceTask() {
+  distance = readDistance();
+  publishSample(SAMPLE_DISTANCE_CM, distance);
   
-  WiFi.begin(ssid, password);
-  
-  while (WiFi.status() != WL_CONNECTED) {
-    delay(500);
-    Serial.print(".");
+  // Obstacle avoidance
+  if (distance < roverConfig.obstacleThreshold && currentMotion != MOTION_STOP) {
+    Serial.println("🚫 Obstacle detected! Stopping...");
+    stopMotion();
+    currentMotion = MOTION_STOP;
+    publishSample(SAMPLE_MOTION, MOTION_STOP);
+    notePowerMotion(false);
   }
-  
-  Serial.println();
-  Serial.println("✅ WiFi connected!");
-  Serial.print("📶 IP Address: ");
-  Serial.println(WiFi.localIP());
+}
+
+// Association finishes in the background; Firebase probes once it is up
+void initWiFi() {
+  beginNetwork(ssid, password);
 }
 
 void triggerGasAlert() {
-  // Send alert to Firebase
-  Firebase.setString(firebaseData, "/alerts/last_alert", "HIGH_GAS_LEVEL");
-  Firebase.setFloat(firebaseData, "/alerts/gas_level", gasConcentration);
-  Firebase.setString(firebaseData, "/alerts/timestamp", String(millis()));
+  // Repeats while the gas stays high fold into one coalesced alert
+  AlertAction action = raiseAlert(ALERT_HIGH_GAS, SEVERITY_DANGER, gasConcentration,
+                                  "High gas concentration detected");
   
-  // Optional: Activate servo for gas dispersal
-  rotateServo(180);
-  delay(1000);
-  rotateServo(90);
+  // Optional: Activate servo for gas dispersal, once per new or escalated alert
+  if (action == ALERT_SENT_NEW || action == ALERT_SENT_ESCALATED) {
+    rotateServo(180);
+    delay(1000);
+    rotateServo(90);
+  }
 }
 
-void updateFirebaseData() {
-  // Update sensor data
-  json.clear();
-  json.add("gas_concentration", gasConcentration);
-  json.add("distance", distance);
-  json.add("motion", currentMotion);
-  json.add("servo_angle", servoAngle);
-  json.add("timestamp", millis());
-  
-  Firebase.updateNode(firebaseData, "/sensor_data", json);
-  
-  // Update individual values for easier access
-  Firebase.setFloat(firebaseData, "/gas_data/ppm", gasConcentration);
-  Firebase.setInt(firebaseData, "/ultrasonic_distance", distance);
-  Firebase.setString(firebaseData, "/motion_command/current", currentMotion);
-  Firebase.setInt(firebaseData, "/servo/angle", servoAngle);
+void handleMotionCommand(MotionCommand command) {
+  notePowerMotion(command != MOTION_STOP && command != MOTION_UNKNOWN);
+  executeMotion(command);
+  currentMotion = command;
+  publishSample(SAMPLE_MOTION, command);
+  warmState.lastMotion = command;
+  saveWarmState();
+  Serial.print("🎮 Motion command: ");
+  Serial.println(getMotionName(command));
 }
 
-void checkMotionCommands() {
-  String command;
-  if (Firebase.getString(firebaseData, "/motion_command/request", command)) {
-    if (command != currentMotion) {
-      executeMotion(command);
-      currentMotion = command;
-      Serial.print("🎮 Motion command: ");
-      Serial.println(command);
-    }
-  }
+void handleServoCommand(int angle) {
+  notePowerActivity();  // re-attaches the servo if parked
+  rotateServo(angle);
+  servoAngle = angle;
+  publishSample(SAMPLE_SERVO_ANGLE, angle);
+  warmState.servoAngle = angle;
+  saveWarmState();
+  Serial.print("⚙️ Servo angle: ");
+  Serial.println(angle);
 }
 
-void checkServoCommands() {
-  int angle;
-  if (Firebase.getInt(firebaseData, "/servo/request", angle)) {
-    if (angle >= 0 && angle <= 180) {
-      rotateServo(angle);
-      servoAngle = angle;
-      Serial.print("⚙️ Servo angle: ");
-      Serial.println(angle);
-    }
-  }
+// Detached servos hold no current; they come back on the first activity
+void parkServos(PowerState state) {
+  if (state == POWER_PARKED) disableServo();
+  else enableServo();
 }
 
-void executeMotion(String command) {
-  if (command == "FORWARD") {
-    moveForward();
-  } else if (command == "BACKWARD") {
-    moveBackward();
-  } else if (command == "LEFT") {
-    turnLeft();
-  } else if (command == "RIGHT") {
-    turnRight();
-  } else if (command == "STOP") {
-    stopMotion();
+void executeMotion(MotionCommand command) {
+  switch (command) {
+    case MOTION_FORWARD: moveForward(); break;
+    case MOTION_BACKWARD: moveBackward(); break;
+    case MOTION_LEFT: turnLeft(); break;
+    case MOTION_RIGHT: turnRight(); break;
+    case MOTION_STOP: stopMotion(); break;
+    default: break;
   }
 }
@@ -13,58 +13,68 @@
  */
 
 #include <ESP8266WiFi.h>
-#include <FirebaseESP8266.h>
+#include "features.h"
 #include <Servo.h>
 #include <NewPing.h>
 #include "gas_sensor.h"
+#include "config_store.h"
 #include "servo_control.h"
 #include "ultrasonic.h"
 #include "firebase.h"
+#include "alert_manager.h"
 #include "UltrasonicServo.h"
 #include "pin_config.h"
+#include "task_scheduler.h"
+#include "sample_bus.h"
+#include "boot_sequencer.h"
+#include "power_manager.h"
+#include "benchmark.h"
+#include "telemetry_frame.h"
+#include "log_summary.h"
+#include "device_id.h"
 
 // WiFi Configuration
 const char* ssid = "YOUR_WIFI_SSID";
 const char* password = "YOUR_WIFI_PASSWORD";
 
-// Firebase Configuration
-#define FIREBASE_HOST "your-project.firebaseio.com"
-#define FIREBASE_AUTH "your-firebase-secret"
-
 // Global Objects
-FirebaseData firebaseData;
-FirebaseJson json;
 Servo gasServo;
 NewPing sonar(ULTRASONIC_TRIG_PIN, ULTRASONIC_ECHO_PIN, 200);
 
+#if FEATURE_ULTRASONIC_SERVO
 // UltrasonicServo object for advanced obstacle avoidance
 UltrasonicServo ultraServo(ULTRASONIC_SERVO_TRIG, ULTRASONIC_SERVO_ECHO, 
                            ULTRASONIC_SERVO_SERVO, ULTRASONIC_SERVO_MOTOR1, 
                            ULTRASONIC_SERVO_MOTOR2);
+#endif
 
-// Timing variables
-unsigned long lastGasReading = 0;
-unsigned long lastDistanceReading = 0;
-unsigned long lastFirebaseUpdate = 0;
-unsigned long lastUltrasonicServoCheck = 0;
+// Task rates
 const unsigned long GAS_READ_INTERVAL = 1000;    // 1 second
 const unsigned long DISTANCE_READ_INTERVAL = 500; // 500ms
 const unsigned long FIREBASE_UPDATE_INTERVAL = 2000; // 2 seconds
 const unsigned long ULTRASONIC_SERVO_CHECK_INTERVAL = 100; // 100ms
+const unsigned long COMMAND_POLL_INTERVAL = 20;  // stream reads are non-blocking
+
+// Parked rates (power manager); 0 stops the task while parked
+const unsigned long PARKED_GAS_INTERVAL = 5000;      // bounds gas danger latency without the D0 interrupt
+const unsigned long PARKED_COMMAND_INTERVAL = 200;   // bounds command latency on top of the radio listen interval
+const unsigned long PARKED_FIREBASE_INTERVAL = 10000;
+const unsigned long STATS_INTERVAL = 60000;      // scheduler report
 
 // Sensor data
 float gasConcentration = 0;
 int distance = 0;
-String currentMotion = "STOP";
+MotionCommand currentMotion = MOTION_STOP;
 int servoAngle = 90;
 
 // UltrasonicServo status
 bool obstacleDetected = false;
-String ultrasonicServoStatus = "SAFE";
+DistanceStatus ultrasonicServoStatus = DISTANCE_SAFE;
 float ultrasonicServoDistance = 0;
 
 void setup() {
-  Serial.begin(115200);
+  Serial.begin(SERIAL_BAUD);
+  initBootSequencer();
   Serial.println("🚀 ToxiRover Starting (Integrated Version)...");
   
   // Print pin configuration
@@ -80,184 +90,243 @@ void setup() {
   Serial.print("  IN4: "); Serial.print(IN4);
   Serial.print("  ENB: "); Serial.println(ENB);
   
-  // Initialize WiFi
-  initWiFi();
-  
-  // Initialize Firebase
-  initFirebase();
-  
-  // Initialize sensors and actuators
+  // Sensors and actuators first so sampling starts before the network is up
   initGasSensor();
   initServo();
   initUltrasonic();
   
+#if FEATURE_ULTRASONIC_SERVO
   // Initialize UltrasonicServo
   ultraServo.begin();
+#endif
   
-  Serial.println("✅ ToxiRover initialized successfully!");
-}
-
-void loop() {
-  // Read gas sensor
-  if (millis() - lastGasReading >= GAS_READ_INTERVAL) {
-    gasConcentration = readGasSensor();
-    lastGasReading = millis();
-    
-    // Check for dangerous gas levels
-    if (gasConcentration > GAS_DANGER_THRESHOLD) {
-      Serial.println("⚠️ DANGER: High gas concentration detected!");
-      triggerGasAlert();
-    }
+  // Warm restart: put the servo back and report the last command; motors stay stopped
+  if (isWarmBoot()) {
+    servoAngle = warmState.servoAngle;
+    rotateServo(servoAngle);
+    Serial.print("♨️ Last motion before reset: ");
+    Serial.println(getMotionName((MotionCommand)warmState.lastMotion));
   }
+  markBootMilestone(BOOT_SENSORS_READY);
   
-  // Read ultrasonic sensor (basic)
-  if (millis() - lastDistanceReading >= DISTANCE_READ_INTERVAL) {
-    distance = readDistance();
-    lastDistanceReading = millis();
-    
-    // Basic obstacle avoidance
-    if (distance < OBSTACLE_THRESHOLD && currentMotion != "STOP") {
-      Serial.println("🚫 Obstacle detected! Stopping...");
-      // Note: Motor control is handled by WiFi/WAN systems
-      currentMotion = "STOP";
-    }
-  }
+  // Network comes up in the background
+  initWiFi();
   
-  // Check UltrasonicServo (advanced obstacle avoidance)
-  if (millis() - lastUltrasonicServoCheck >= ULTRASONIC_SERVO_CHECK_INTERVAL) {
-    ultraServo.checkAndAct();
-    lastUltrasonicServoCheck = millis();
-    
-    // Update status variables
-    obstacleDetected = ultraServo.isObstacleDetected();
-    ultrasonicServoStatus = ultraServo.getDistanceStatus();
-    ultrasonicServoDistance = ultraServo.getLastDistance();
-    
-    // Log status changes
-    if (obstacleDetected) {
-      Serial.println("🚨 UltrasonicServo: Obstacle detected and action taken!");
-    }
-  }
+#if FEATURE_FIREBASE
+  // Initialize Firebase
+  initFirebase();
+  setFirebaseCommandHandlers(handleMotionCommand, handleServoCommand);
+#endif
   
-  // Update Firebase
-  if (millis() - lastFirebaseUpdate >= FIREBASE_UPDATE_INTERVAL) {
-    updateFirebaseData();
-    lastFirebaseUpdate = millis();
-  }
+  // Register periodic work; obstacle handling outranks telemetry
+  initPowerManager();
+  addPowerStateHandler(parkServos);
+#if FEATURE_ULTRASONIC_SERVO
+  TaskId ultraServoId = addPeriodicTask("ultraServo", ultrasonicServoTask, ULTRASONIC_SERVO_CHECK_INTERVAL, PRIORITY_HIGH, 30000);
+  addPowerManagedTask(ultraServoId, ULTRASONIC_SERVO_CHECK_INTERVAL, 0);
+#endif
+  TaskId distanceId = addPeriodicTask("distance", distanceTask, DISTANCE_READ_INTERVAL, PRIORITY_HIGH, 30000);
+  addPowerManagedTask(distanceId, DISTANCE_READ_INTERVAL, 0);  // sonar off while parked
+#if FEATURE_FIREBASE
+  TaskId commandsId = addPeriodicTask("commands", checkFirebaseCommands, COMMAND_POLL_INTERVAL, PRIORITY_HIGH, 20000);
+  addPowerManagedTask(commandsId, COMMAND_POLL_INTERVAL, PARKED_COMMAND_INTERVAL);
+#endif
+  TaskId gasId = addPeriodicTask("gas", gasTask, GAS_READ_INTERVAL, PRIORITY_NORMAL, 5000);
+  addPowerManagedTask(gasId, GAS_READ_INTERVAL, PARKED_GAS_INTERVAL);
+#if FEATURE_FIREBASE
+  TaskId firebaseId = addPeriodicTask("firebase", updateFirebaseData, FIREBASE_UPDATE_INTERVAL, PRIORITY_LOW);
+  addPowerManagedTask(firebaseId, FIREBASE_UPDATE_INTERVAL, PARKED_FIREBASE_INTERVAL);
+  TaskId loggerId = addPeriodicTask("logger", logDataToFirebase, SAMPLE_LOG_INTERVAL, PRIORITY_LOW);
+  addPowerManagedTask(loggerId, SAMPLE_LOG_INTERVAL, PARKED_FIREBASE_INTERVAL);
+#endif
+  addPeriodicTask("stats", printStats, STATS_INTERVAL, PRIORITY_LOW);
+  addOneShotTask("bootStats", printBootStats, 30000, PRIORITY_LOW);
   
-  // Check for motion commands from Firebase
-  checkMotionCommands();
+#if PROFILER_ENABLED
+  addPeriodicTask("profiler", serviceProfilerSerial, 200, PRIORITY_LOW);  // 'p' prints, 'r' resets
+#endif
   
-  // Check for servo commands from Firebase
-  checkServoCommands();
+  Serial.println("✅ ToxiRover initialized successfully!");
+  printFeatureReport();
   
-  delay(10); // Small delay to prevent watchdog reset
+#if BENCHMARK_ENABLED
+  runHotPathBenchmarks();
+#endif
 }
 
-void initWiFi() {
-  Serial.print("📡 Connecting to WiFi: ");
-  Serial.println(ssid);
-  
-  WiFi.begin(ssid, password);
+void loop() {
+  // Runs the next due task, or sleeps until one is due
+  runScheduler();
+}
+
+void gasTask() {
+  gasConcentration = readGasSensor();
+  markBootMilestone(BOOT_FIRST_SAMPLE);
+  notePowerGas(gasConcentration);
+  publishSample(SAMPLE_GAS_PPM, gasConcentration);
   
-  while (WiFi.status() != WL_CONNECTED) {
-    delay(500);
-    Serial.print(".");
+  // Check for dangerous gas levels
+  if (gasConcentration > roverConfig.gasDangerThreshold) {
+    Serial.println("⚠️ DANGER: High gas concentration detected!");
+    triggerGasAlert();
   }
   
-  Serial.println();
-  Serial.println("✅ WiFi connected!");
-  Serial.print("📶 IP Address: ");
-  Serial.println(WiFi.localIP());
+  // Resolve alerts that have gone quiet
+  serviceAlerts();
 }
 
-void triggerGasAlert() {
-  // Send alert to Firebase
-  Firebase.setString(firebaseData, "/alerts/last_alert", "HIGH_GAS_LEVEL");
-  Firebase.setFloat(firebaseData, "/alerts/gas_level", gasConcentration);
-  Firebase.setString(firebaseData, "/alerts/timestamp", String(millis()));
+void distanceTask() {
+  // Read ultrasonic sensor (basic)
+  distance = readDistance();
+  publishSample(SAMPLE_DISTANCE_CM, distance);
   
-  // Optional: Activate servo for gas dispersal
-  rotateServo(180);
-  delay(1000);
-  rotateServo(90);
+  // Basic obstacle avoidance
+  if (distance < roverConfig.obstacleThreshold && currentMotion != MOTION_STOP) {
+    Serial.println("🚫 Obstacle detected! Stopping...");
+    // Note: Motor control is handled by WiFi/WAN systems
+    currentMotion = MOTION_STOP;
+    publishSample(SAMPLE_MOTION, MOTION_STOP);
+    notePowerMotion(false);
+  }
 }
 
-void updateFirebaseData() {
-  // Update sensor data
-  json.clear();
-  json.add("gas_concentration", gasConcentration);
-  json.add("distance", distance);
-  json.add("motion", currentMotion);
-  json.add("servo_angle", servoAngle);
-  json.add("timestamp", millis());
-  
-  // Add UltrasonicServo data
-  json.add("ultrasonic_servo_distance", ultrasonicServoDistance);
-  json.add("ultrasonic_servo_status", ultrasonicServoStatus);
-  json.add("obstacle_detected", obstacleDetected);
-  
-  Firebase.updateNode(firebaseData, "/sensor_data", json);
+#if FEATURE_ULTRASONIC_SERVO
+void ultrasonicServoTask() {
+  // Check UltrasonicServo (advanced obstacle avoidance)
+  ultraServo.checkAndAct();
   
-  // Update individual values for easier access
-  Firebase.setFloat(firebaseData, "/gas_data/ppm", gasConcentration);
-  Firebase.setInt(firebaseData, "/ultrasonic_distance", distance);
-  Firebase.setString(firebaseData, "/motion_command/current", currentMotion);
-  Firebase.setInt(firebaseData, "/servo/angle", servoAngle);
+  // Update status variables
+  obstacleDetected = ultraServo.isObstacleDetected();
+  ultrasonicServoStatus = ultraServo.getDistanceStatus();
+  ultrasonicServoDistance = ultraServo.getLastDistance();
+#if FEATURE_FIREBASE
+  sendObstacleStatus(ultrasonicServoDistance, ultrasonicServoStatus, obstacleDetected);
+#endif
   
-  // UltrasonicServo specific data
-  Firebase.setFloat(firebaseData, "/ultrasonic_servo/distance", ultrasonicServoDistance);
-  Firebase.setString(firebaseData, "/ultrasonic_servo/status", ultrasonicServoStatus);
-  Firebase.setBool(firebaseData, "/ultrasonic_servo/obstacle_detected", obstacleDetected);
+  // Log status changes
+  if (obstacleDetected) {
+    Serial.println("🚨 UltrasonicServo: Obstacle detected and action taken!");
+  }
 }
+#endif
 
-void checkMotionCommands() {
-  String command;
-  if (Firebase.getString(firebaseData, "/motion_command/request", command)) {
-    if (command != currentMotion) {
-      executeMotion(command);
-      currentMotion = command;
-      Serial.print("🎮 Motion command: ");
-      Serial.println(command);
-    }
-  }
+// Association finishes in the background; Firebase probes once it is up
+void initWiFi() {
+  beginNetwork(ssid, password);
 }
 
-void checkServoCommands() {
-  int angle;
-  if (Firebase.getInt(firebaseData, "/servo/request", angle)) {
-    if (angle >= 0 && angle <= 180) {
-      rotateServo(angle);
-      servoAngle = angle;
-      Serial.print("⚙️ Servo angle: ");
-      Serial.println(angle);
-    }
+void triggerGasAlert() {
+  // Repeats while the gas stays high fold into one coalesced alert
+  AlertAction action = raiseAlert(ALERT_HIGH_GAS, SEVERITY_DANGER, gasConcentration,
+                                  "High gas concentration detected");
+  
+  // Optional: Activate servo for gas dispersal, once per new or escalated alert
+  if (action == ALERT_SENT_NEW || action == ALERT_SENT_ESCALATED) {
+    rotateServo(180);
+    delay(1000);
+    rotateServo(90);
   }
 }
 
-void executeMotion(String command) {
+void handleMotionCommand(MotionCommand command) {
+  notePowerMotion(command != MOTION_STOP && command != MOTION_UNKNOWN);
+  executeMotion(command);
+  currentMotion = command;
+  publishSample(SAMPLE_MOTION, command);
+  warmState.lastMotion = command;
+  saveWarmState();
+  Serial.print("🎮 Motion command: ");
+  Serial.println(getMotionName(command));
+}
+
+void handleServoCommand(int angle) {
+  notePowerActivity();  // re-attaches the servo if parked
+  rotateServo(angle);
+  servoAngle = angle;
+  publishSample(SAMPLE_SERVO_ANGLE, angle);
+  warmState.servoAngle = angle;
+  saveWarmState();
+  Serial.print("⚙️ Servo angle: ");
+  Serial.println(angle);
+}
+
+// Detached servos hold no current; they come back on the first activity
+void parkServos(PowerState state) {
+  bool attached = state != POWER_PARKED;
+  if (attached) enableServo();
+  else disableServo();
+#if FEATURE_ULTRASONIC_SERVO
+  ultraServo.setServoAttached(attached);
+#endif
+}
+
+void printStats() {
+  printSchedulerStats();
+  printPowerStats();
+#if FEATURE_FIREBASE
+  printFirebaseLogSummary();
+#endif
+}
+
+void executeMotion(MotionCommand command) {
   // Note: Actual motor control is handled by WiFi/WAN systems
   // This function just updates the status
-  if (command == "FORWARD") {
-    currentMotion = "FORWARD";
-  } else if (command == "BACKWARD") {
-    currentMotion = "BACKWARD";
-  } else if (command == "LEFT") {
-    currentMotion = "LEFT";
-  } else if (command == "RIGHT") {
-    currentMotion = "RIGHT";
-  } else if (command == "STOP") {
-    currentMotion = "STOP";
+  if (command != MOTION_UNKNOWN) {
+    currentMotion = command;
   }
 }
 
 // Emergency stop function that can be called from Firebase
 void emergencyStop() {
   Serial.println("🛑 Emergency stop activated from Firebase!");
-  currentMotion = "STOP";
+  currentMotion = MOTION_STOP;
+  publishSample(SAMPLE_MOTION, MOTION_STOP);
+#if FEATURE_ULTRASONIC_SERVO
   ultraServo.emergencyStop();
+#endif
   
-  // Update Firebase
-  Firebase.setString(firebaseData, "/motion_command/current", "STOP");
-  Firebase.setBool(firebaseData, "/emergency_stop", true);
+#if FEATURE_FIREBASE
+  sendEmergencyStop();
+#endif
+}
+
+#if BENCHMARK_ENABLED
+static volatile float benchSink;
+
+void benchGasRead() {
+  benchSink = readGasSensor();
+}
+
+#if FEATURE_ULTRASONIC_SERVO
+void benchEchoConversion() {
+  benchSink = UltrasonicServo::echoToCentimeters(1160);  // ~20 cm
+}
+#endif
+
+#if FEATURE_FIREBASE
+static char benchPayload[FIREBASE_PAYLOAD_SIZE];
+
+void benchTelemetryPayload() {
+  benchSink = formatTelemetryPayload(benchPayload, sizeof(benchPayload));
+}
+#endif
+
+void benchParseMotion() {
+  benchSink = parseMotionCommand("BACKWARD");
+}
+
+void runHotPathBenchmarks() {
+  printBenchmarkHeader();
+  printBenchmarkResult(runBenchmark("readGasSensor", benchGasRead, 1000));
+#if FEATURE_ULTRASONIC_SERVO
+  printBenchmarkResult(runBenchmark("echoToCentimeters", benchEchoConversion, 10000));
+#endif
+#if FEATURE_FIREBASE
+  BenchmarkResult json = runBenchmark("telemetryPayload", benchTelemetryPayload, 1000);
+  printBenchmarkResult(json);
+  runTelemetryFrameBenchmarks(&json, formatTelemetryPayload(benchPayload, sizeof(benchPayload)));
+#endif
+  printBenchmarkResult(runBenchmark("parseMotionCommand", benchParseMotion, 10000));
+  runLogSummaryBenchmarks();
 }
+#endif
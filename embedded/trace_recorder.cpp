@@ -0,0 +1,183 @@
+/*
+ * Sensor Trace Recorder Implementation for ToxiRover
+ */
+
+#include "trace_recorder.h"
+
+#if TRACE_ENABLED
+
+#include <LittleFS.h>
+#include "time_sync.h"
+
+TraceStats traceStats = {0, 0, 0, 0};
+
+static TraceRecord buffer[TRACE_BUFFER_RECORDS];
+static int bufferCount = 0;
+static bool recording = false;
+static bool replaying = false;
+static unsigned long startMillis = 0;
+static size_t fileBytes = 0;
+
+// Replay: one read position per channel so each input sees its own sequence
+static File replayFile;
+static uint32_t channelPos[TRACE_CHANNEL_COUNT];
+
+static void flushBuffer() {
+  if (bufferCount == 0) return;
+
+  size_t bytes = bufferCount * sizeof(TraceRecord);
+  File file = LittleFS.open(TRACE_FILE, "a");
+  if (file && fileBytes + bytes <= TRACE_MAX_BYTES) {
+    file.write((const uint8_t*)buffer, bytes);
+    fileBytes += bytes;
+  } else {
+    traceStats.dropped += bufferCount;
+  }
+  if (file) file.close();
+  bufferCount = 0;
+}
+
+bool startTraceRecording() {
+  if (recording) return true;
+  stopTraceReplay();
+  if (!LittleFS.begin()) return false;
+
+  File file = LittleFS.open(TRACE_FILE, "w");
+  if (!file) return false;
+
+  startMillis = millis();
+  TraceHeader header = {TRACE_MAGIC, getBootId(), (uint32_t)startMillis, 0};
+  file.write((const uint8_t*)&header, sizeof(header));
+  file.close();
+
+  fileBytes = sizeof(header);
+  bufferCount = 0;
+  traceStats.recorded = 0;
+  traceStats.dropped = 0;
+  recording = true;
+  Serial.println("⏺️ Trace recording started");
+  return true;
+}
+
+void stopTraceRecording() {
+  if (!recording) return;
+  flushBuffer();
+  recording = false;
+  Serial.print("⏹️ Trace recording stopped, bytes: ");
+  Serial.println(fileBytes);
+}
+
+bool isTraceRecording() {
+  return recording;
+}
+
+long traceRecord(TraceChannel channel, long value) {
+  if (!recording) return value;
+
+  if (fileBytes + (bufferCount + 1) * sizeof(TraceRecord) > TRACE_MAX_BYTES) {
+    traceStats.dropped++;
+    return value;
+  }
+
+  TraceRecord& record = buffer[bufferCount++];
+  record.offsetMs = millis() - startMillis;
+  record.channel = channel;
+  record.reserved = 0;
+  record.value = (int16_t)constrain(value, -32768L, 32767L);
+  traceStats.recorded++;
+
+  if (bufferCount == TRACE_BUFFER_RECORDS) flushBuffer();
+  return value;
+}
+
+bool startTraceReplay() {
+  stopTraceRecording();
+  if (!LittleFS.begin()) return false;
+
+  replayFile = LittleFS.open(TRACE_FILE, "r");
+  TraceHeader header;
+  if (!replayFile || replayFile.read((uint8_t*)&header, sizeof(header)) != sizeof(header) ||
+      header.magic != TRACE_MAGIC) {
+    if (replayFile) replayFile.close();
+    Serial.println("❌ No valid trace to replay");
+    return false;
+  }
+
+  for (int i = 0; i < TRACE_CHANNEL_COUNT; i++) channelPos[i] = sizeof(header);
+  traceStats.replayed = 0;
+  traceStats.replayMisses = 0;
+  replaying = true;
+  Serial.println("▶️ Trace replay started");
+  return true;
+}
+
+void stopTraceReplay() {
+  if (!replaying) return;
+  replayFile.close();
+  replaying = false;
+  Serial.println("⏹️ Trace replay stopped");
+}
+
+bool isTraceReplaying() {
+  return replaying;
+}
+
+// Next recorded value for the channel; the last value repeats once it runs out
+long traceReplayValue(TraceChannel channel) {
+  static long lastValue[TRACE_CHANNEL_COUNT];
+
+  TraceRecord record;
+  replayFile.seek(channelPos[channel]);
+  while (replayFile.read((uint8_t*)&record, sizeof(record)) == sizeof(record)) {
+    channelPos[channel] += sizeof(record);
+    if (record.channel == channel) {
+      traceStats.replayed++;
+      lastValue[channel] = record.value;
+      return record.value;
+    }
+  }
+
+  traceStats.replayMisses++;
+  return lastValue[channel];
+}
+
+// Hex lines so the dump survives a text serial console: TRACE,<offset>,<hex>
+void exportTraceSerial() {
+  if (recording) flushBuffer();
+
+  File file = LittleFS.open(TRACE_FILE, "r");
+  if (!file) {
+    Serial.println("❌ No trace file");
+    return;
+  }
+
+  uint8_t chunk[32];
+  size_t offset = 0;
+  int n;
+  while ((n = file.read(chunk, sizeof(chunk))) > 0) {
+    Serial.print("TRACE,"); Serial.print(offset); Serial.print(",");
+    for (int i = 0; i < n; i++) {
+      if (chunk[i] < 0x10) Serial.print('0');
+      Serial.print(chunk[i], HEX);
+    }
+    Serial.println();
+    offset += n;
+    yield();
+  }
+  file.close();
+  Serial.println("TRACE,END");
+}
+
+void printTraceStats() {
+  Serial.println("🎞️ Trace:");
+  Serial.print("  Mode: ");
+  Serial.println(recording ? "recording" : replaying ? "replaying" : "idle");
+  Serial.print("  Recorded/dropped: ");
+  Serial.print(traceStats.recorded); Serial.print("/");
+  Serial.println(traceStats.dropped);
+  Serial.print("  Replayed/misses: ");
+  Serial.print(traceStats.replayed); Serial.print("/");
+  Serial.println(traceStats.replayMisses);
+}
+
+#endif
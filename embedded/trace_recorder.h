@@ -0,0 +1,89 @@
+/*
+ * Sensor Trace Recorder for ToxiRover
+ * Captures raw sensor input and commands to LittleFS for later replay
+ *
+ * Features:
+ * - 8-byte binary records: ms offset, channel, raw value
+ * - RAM batch buffer flushed to /trace.bin, size-capped
+ * - Replay mode feeds recorded values back through TRACE_INPUT()
+ * - Export over HTTP (/trace) or as hex lines over Serial
+ * - Compiles out to nothing unless TRACE_ENABLED is 1
+ */
+
+#ifndef TRACE_RECORDER_H
+#define TRACE_RECORDER_H
+
+#include <Arduino.h>
+
+#ifndef TRACE_ENABLED
+#define TRACE_ENABLED 0  // build with -DTRACE_ENABLED=1 to record/replay
+#endif
+
+#define TRACE_FILE "/trace.bin"
+#define TRACE_MAGIC 0x31565254   // "TRV1"
+#define TRACE_MAX_BYTES 65536
+#define TRACE_BUFFER_RECORDS 32
+
+// Input channels (raw values, before any conversion)
+enum TraceChannel {
+  TRACE_GAS_ADC,         // analogRead counts
+  TRACE_GAS_DIGITAL,     // FC-22 D0 level
+  TRACE_ECHO_US,         // HC-SR04 echo time (NewPing)
+  TRACE_SERVO_ECHO_US,   // UltrasonicServo echo time (pulseIn)
+  TRACE_MOTION_CMD,      // MotionCommand received
+  TRACE_SERVO_CMD,       // servo angle received
+  TRACE_DRIVE_CMD,       // WiFi remote command character
+  TRACE_CHANNEL_COUNT
+};
+
+#if TRACE_ENABLED
+
+struct TraceHeader {
+  uint32_t magic;
+  uint32_t bootId;
+  uint32_t startMillis;
+  uint32_t reserved;
+};
+
+struct TraceRecord {
+  uint32_t offsetMs;  // since recording started
+  uint8_t channel;
+  uint8_t reserved;
+  int16_t value;
+};
+
+struct TraceStats {
+  unsigned long recorded;
+  unsigned long dropped;      // file full or not writable
+  unsigned long replayed;
+  unsigned long replayMisses; // channel ran out of records during replay
+};
+
+extern TraceStats traceStats;
+
+// Function declarations
+bool startTraceRecording();
+void stopTraceRecording();
+bool startTraceReplay();
+void stopTraceReplay();
+bool isTraceRecording();
+bool isTraceReplaying();
+long traceRecord(TraceChannel channel, long value);
+long traceReplayValue(TraceChannel channel);
+void exportTraceSerial();
+void printTraceStats();
+
+// Records a live input, or substitutes the recorded one during replay (expr not evaluated)
+#define TRACE_INPUT(channel, expr) \
+  (isTraceReplaying() ? traceReplayValue(channel) : traceRecord(channel, (expr)))
+#define TRACE_EVENT(channel, value) \
+  do { if (isTraceRecording()) traceRecord(channel, (value)); } while (0)
+
+#else
+
+#define TRACE_INPUT(channel, expr) (expr)
+#define TRACE_EVENT(channel, value) do {} while (0)
+
+#endif
+
+#endif
@@ -1,4 +1,7 @@
 #include "ultrasonic.h"
+#include "config_store.h"
+#include "loop_profiler.h"
+#include "trace_recorder.h"
 
 // Global ultrasonic sensor object
 extern NewPing sonar;
@@ -12,7 +15,9 @@ void initUltrasonic() {
 }
 
 int readDistance() {
-  int distance = sonar.ping_cm();
+  PROFILE_SCOPE("sonar");
+  unsigned int echo = TRACE_INPUT(TRACE_ECHO_US, sonar.ping());
+  int distance = NewPing::convert_cm(echo);
   if (distance == 0) {
     distance = MAX_DISTANCE; // No obstacle detected
   }
@@ -31,20 +36,20 @@ int getAverageDistance() {
   return total / readings;
 }
 
-String getDistanceStatus() {
+DistanceStatus getDistanceStatus() {
   int distance = readDistance();
   
-  if (distance < OBSTACLE_THRESHOLD) {
-    return "DANGER";
+  if (distance < roverConfig.obstacleThreshold) {
+    return DISTANCE_DANGER;
   } else if (distance < SAFE_DISTANCE) {
-    return "WARNING";
+    return DISTANCE_WARNING;
   } else {
-    return "SAFE";
+    return DISTANCE_SAFE;
   }
 }
 
 bool isObstacleDetected() {
-  return readDistance() < OBSTACLE_THRESHOLD;
+  return readDistance() < roverConfig.obstacleThreshold;
 }
 
 bool isDistanceSafe() {
@@ -4,17 +4,18 @@
 #include <Arduino.h>
 #include <NewPing.h>
 #include "pin_config.h"
+#include "rover_status.h"
 
 // Constants
 #define MAX_DISTANCE 200
-#define OBSTACLE_THRESHOLD 20
+#define OBSTACLE_THRESHOLD 20     // cm; default for roverConfig.obstacleThreshold
 #define SAFE_DISTANCE 50
 
 // Function declarations
 void initUltrasonic();
 int readDistance();
 int getAverageDistance();
-String getDistanceStatus();
+DistanceStatus getDistanceStatus();
 bool isObstacleDetected();
 bool isDistanceSafe();
 
@@ -0,0 +1,391 @@
+/*
+ * Vector Field Histogram Planner Implementation for ToxiRover
+ */
+
+#include "vfh_planner.h"
+
+int vfhSectorAngle(int sector) {
+  return sector * VFH_SECTOR_WIDTH + VFH_SECTOR_WIDTH / 2;
+}
+
+static int angleToSector(int angle) {
+  return constrain(angle / VFH_SECTOR_WIDTH, 0, VFH_SECTORS - 1);
+}
+
+void vfhReset(VfhPlanner& planner) {
+  memset(&planner, 0, sizeof(planner));
+  planner.scanSector = VFH_SECTORS / 2;
+  planner.scanStep = 1;
+  planner.lastHeading = VFH_HEADING_AHEAD;
+}
+
+// No echo (negative) means nothing within sonar range
+void vfhAddReading(VfhPlanner& planner, int servoAngle, float distanceCm, unsigned long now) {
+  int sector = angleToSector(servoAngle);
+  planner.distance[sector] = distanceCm < 0 ? VFH_RANGE : distanceCm;
+  planner.stamp[sector] = now == 0 ? 1 : now;
+}
+
+// Ping-pong sweep across the sectors; returns the servo angle to aim at next
+int vfhNextScanAngle(VfhPlanner& planner) {
+  int next = planner.scanSector + planner.scanStep;
+  if (next < 0 || next >= VFH_SECTORS) {
+    planner.scanStep = -planner.scanStep;
+    next = planner.scanSector + planner.scanStep;
+  }
+  planner.scanSector = next;
+  return vfhSectorAngle(next);
+}
+
+static float sectorDistance(const VfhPlanner& planner, int sector, unsigned long now) {
+  if (planner.stamp[sector] == 0 || now - planner.stamp[sector] > VFH_READING_TTL) return VFH_RANGE;
+  return planner.distance[sector];
+}
+
+VfhDecision vfhPlan(VfhPlanner& planner, int goalHeading, int speed, unsigned long now) {
+  // Enlarge each reading by the rover's half width: a close obstacle
+  // shadows every sector the body would clip it in, a far one only its own
+  float clearance[VFH_SECTORS];
+  for (int i = 0; i < VFH_SECTORS; i++) clearance[i] = VFH_RANGE;
+  for (int j = 0; j < VFH_SECTORS; j++) {
+    float distance = sectorDistance(planner, j, now);
+    if (distance >= VFH_RANGE) continue;
+    float spread = asinf(VFH_ROVER_RADIUS / (distance + VFH_ROVER_RADIUS)) * RAD_TO_DEG + VFH_SECTOR_WIDTH / 2;
+    for (int i = 0; i < VFH_SECTORS; i++) {
+      if (abs(vfhSectorAngle(i) - vfhSectorAngle(j)) <= spread) clearance[i] = min(clearance[i], distance);
+    }
+  }
+
+  // Threshold with hysteresis so a noisy reading doesn't flip the choice
+  float density[VFH_SECTORS];
+  for (int i = 0; i < VFH_SECTORS; i++) {
+    density[i] = (VFH_RANGE - clearance[i]) / VFH_RANGE;  // 0 = clear, 1 = touching
+    if (density[i] > VFH_BLOCK_DENSITY) planner.blocked[i] = true;
+    else if (density[i] < VFH_FREE_DENSITY) planner.blocked[i] = false;
+  }
+
+  // The goal's own sector when it is free; otherwise the cheapest free sector,
+  // near the goal and near the last choice so the rover commits to one side
+  // of an obstacle. Ties go to the one with more room
+  goalHeading = constrain(goalHeading, 0, 180);
+  int best = planner.blocked[angleToSector(goalHeading)] ? -1 : angleToSector(goalHeading);
+  float bestCost = 0;
+  for (int i = 0; i < VFH_SECTORS && best != angleToSector(goalHeading); i++) {
+    if (planner.blocked[i]) continue;
+    int angle = vfhSectorAngle(i);
+    float cost = abs(angle - goalHeading) + VFH_COMMIT_WEIGHT * abs(angle - planner.lastHeading);
+    if (best < 0 || cost < bestCost ||
+        (cost == bestCost && clearance[i] > clearance[best])) {
+      best = i;
+      bestCost = cost;
+    }
+  }
+
+  VfhDecision decision;
+  if (best < 0) {
+    // Boxed in: rotate in place toward the emptier half
+    float leftDensity = 0, rightDensity = 0;
+    for (int i = 0; i < VFH_SECTORS / 2; i++) rightDensity += density[i];
+    for (int i = VFH_SECTORS - VFH_SECTORS / 2; i < VFH_SECTORS; i++) leftDensity += density[i];
+    int turn = speed / 2;
+    decision.heading = leftDensity <= rightDensity ? 180 : 0;
+    decision.left = leftDensity <= rightDensity ? -turn : turn;
+    decision.right = -decision.left;
+    decision.boxedIn = true;
+    planner.lastHeading = decision.heading;
+    return decision;
+  }
+
+  // Heading error to wheel speeds; the goal angle itself is used when its sector
+  // is free, so straight stays straight. The body still moves along the centre
+  // line, so the clearance there sets the forward speed
+  decision.heading = angleToSector(goalHeading) == best ? goalHeading : vfhSectorAngle(best);
+  planner.lastHeading = decision.heading;
+  float steer = (float)(decision.heading - VFH_HEADING_AHEAD) / VFH_HEADING_AHEAD;  // +1 = hard left
+  float room = min(clearance[best], clearance[angleToSector(VFH_HEADING_AHEAD)]);
+  float scale = constrain(room / VFH_SLOW_DISTANCE, VFH_MIN_SPEED_SCALE, 1.0);
+  float forward = speed * scale;
+  decision.left = constrain((int)(forward * (1 - VFH_TURN_GAIN * steer)), -speed, speed);
+  decision.right = constrain((int)(forward * (1 + VFH_TURN_GAIN * steer)), -speed, speed);
+  decision.boxedIn = false;
+  return decision;
+}
+
+#if FEATURE_ULTRASONIC_SERVO
+#include "UltrasonicServo.h"
+
+static VfhPlanner livePlanner;
+static UltrasonicServo* sonar = NULL;
+static DriveOutput driveOutput = NULL;
+static int aimedAngle = VFH_HEADING_AHEAD;
+static int goalHeading = VFH_HEADING_AHEAD;
+static int goalSpeed = 0;
+static bool goalActive = false;
+static unsigned long controlTicks = 0;
+static unsigned long boxedInTicks = 0;
+
+void initAvoidance(UltrasonicServo* sensor, DriveOutput output) {
+  vfhReset(livePlanner);
+  sonar = sensor;
+  driveOutput = output;
+  aimedAngle = vfhSectorAngle(livePlanner.scanSector);
+  sonar->aimServo(aimedAngle);
+
+  Serial.print("🧭 Avoidance planner: "); Serial.print(VFH_SECTORS);
+  Serial.print(" sectors, "); Serial.print(VFH_CONTROL_INTERVAL); Serial.println(" ms control");
+}
+
+// One sonar reading per tick: the servo moved there on the previous tick and has settled
+void serviceAvoidance() {
+  if (sonar == NULL) return;
+  unsigned long now = millis();
+
+  vfhAddReading(livePlanner, aimedAngle, sonar->getDistance(), now);
+  aimedAngle = vfhNextScanAngle(livePlanner);
+  sonar->aimServo(aimedAngle);
+
+  if (!goalActive) return;
+  VfhDecision decision = vfhPlan(livePlanner, goalHeading, goalSpeed, now);
+  driveOutput(decision.left, decision.right);
+
+  controlTicks++;
+  if (decision.boxedIn) boxedInTicks++;
+}
+
+void setAvoidanceGoal(int heading, int speed) {
+  goalHeading = constrain(heading, 0, 180);
+  goalSpeed = speed;
+  goalActive = sonar != NULL;
+}
+
+void clearAvoidanceGoal() {
+  if (goalActive && driveOutput != NULL) driveOutput(0, 0);
+  goalActive = false;
+}
+
+bool isAvoidanceActive() {
+  return goalActive;
+}
+
+// Forward-going remote commands become planner goals; anything else hands the motors back
+bool steerDriveCommand(char command, int speed) {
+  if (sonar == NULL) return false;
+  switch (command) {
+    case 'F': setAvoidanceGoal(VFH_HEADING_AHEAD, speed); return true;
+    case 'G': setAvoidanceGoal(VFH_HEADING_AHEAD + 45, speed); return true;
+    case 'I': setAvoidanceGoal(VFH_HEADING_AHEAD - 45, speed); return true;
+    case '\0': return false;
+  }
+  if (strchr("BRLHJS", command) != NULL) goalActive = false;  // the command drives the motors itself
+  return false;
+}
+
+void printAvoidanceStats() {
+  Serial.println("🧭 Avoidance:");
+  Serial.print("  Goal: ");
+  if (goalActive) { Serial.print(goalHeading); Serial.print("° @ "); Serial.println(goalSpeed); }
+  else Serial.println("none");
+  Serial.print("  Control ticks: "); Serial.print(controlTicks);
+  Serial.print("  Boxed in: "); Serial.println(boxedInTicks);
+  Serial.print("  Blocked: ");
+  for (int i = VFH_SECTORS - 1; i >= 0; i--) Serial.print(livePlanner.blocked[i] ? "#" : ".");
+  Serial.println(" (left to right)");
+}
+#endif
+
+#if BENCHMARK_ENABLED
+// ---------------------------------------------------------------- 2-D simulation
+
+#define SIM_FIELD 400            // cm square, walls on every side
+#define SIM_OBSTACLES 8
+#define SIM_ROVER_RADIUS 12      // cm
+#define SIM_WHEELBASE 14         // cm
+#define SIM_CM_PER_PWM 0.06f     // cm/s per PWM count (1023 = ~60 cm/s)
+#define SIM_SONAR_RANGE 200      // cm; beyond this the echo times out
+#define SIM_SONAR_HALF_CONE 10   // degrees
+#define SIM_SUBSTEPS 10
+#define SIM_TIMEOUT 120000       // ms
+#define SIM_GOAL_RADIUS 20       // cm
+#define SIM_SPEED 400            // PWM, remote speed '9'
+#define SIM_BUMP_DISTANCE 20     // cm, UltrasonicServo::checkAndAct threshold
+#define SIM_BUMP_PIVOT 500       // ms, checkAndAct rotation duration
+#define SIM_BUMP_COOLDOWN 2000   // ms, checkAndAct action cooldown
+
+struct SimObstacle {
+  float x, y, r;
+};
+
+struct SimWorld {
+  SimObstacle obstacles[SIM_OBSTACLES];
+  float x, y, theta;             // rover pose; theta 0 = +x, counter-clockwise
+  float goalX, goalY;
+};
+
+enum SimOutcome { SIM_REACHED, SIM_COLLIDED, SIM_TIMED_OUT };
+
+static uint32_t simSeed;
+
+static float simRandom(float low, float high) {
+  simSeed = simSeed * 1664525UL + 1013904223UL;
+  return low + (high - low) * (simSeed >> 8) / 16777216.0f;
+}
+
+static float simDistance(float ax, float ay, float bx, float by) {
+  return sqrtf((ax - bx) * (ax - bx) + (ay - by) * (ay - by));
+}
+
+// Obstacles stay clear of the start and goal so every field is solvable in principle
+static void simBuildWorld(SimWorld& world, uint32_t seed) {
+  simSeed = seed;
+  world.x = 50; world.y = SIM_FIELD / 2; world.theta = 0;
+  world.goalX = SIM_FIELD - 50; world.goalY = SIM_FIELD / 2;
+  for (int i = 0; i < SIM_OBSTACLES; i++) {
+    SimObstacle& o = world.obstacles[i];
+    do {
+      o.x = simRandom(100, SIM_FIELD - 100);
+      o.y = simRandom(60, SIM_FIELD - 60);
+      o.r = simRandom(12, 30);
+    } while (simDistance(o.x, o.y, world.x, world.y) < o.r + 50 ||
+             simDistance(o.x, o.y, world.goalX, world.goalY) < o.r + 50);
+  }
+}
+
+static float simRayDistance(const SimWorld& world, float angle) {
+  float dx = cosf(angle), dy = sinf(angle);
+  float best = SIM_SONAR_RANGE + 1;
+
+  // Walls
+  if (dx > 0) best = min(best, (SIM_FIELD - world.x) / dx);
+  if (dx < 0) best = min(best, -world.x / dx);
+  if (dy > 0) best = min(best, (SIM_FIELD - world.y) / dy);
+  if (dy < 0) best = min(best, -world.y / dy);
+
+  for (int i = 0; i < SIM_OBSTACLES; i++) {
+    const SimObstacle& o = world.obstacles[i];
+    float ox = o.x - world.x, oy = o.y - world.y;
+    float along = ox * dx + oy * dy;
+    float across2 = ox * ox + oy * oy - along * along;
+    if (along <= 0 || across2 > o.r * o.r) continue;
+    best = min(best, along - sqrtf(o.r * o.r - across2));
+  }
+  return best;
+}
+
+// Sonar sits on the rover's front edge; three rays approximate the beam cone
+static float simSonar(const SimWorld& world, int servoAngle) {
+  float center = world.theta + (servoAngle - VFH_HEADING_AHEAD) * DEG_TO_RAD;
+  float distance = SIM_SONAR_RANGE + 1;
+  for (int ray = -1; ray <= 1; ray++) {
+    distance = min(distance, simRayDistance(world, center + ray * SIM_SONAR_HALF_CONE * DEG_TO_RAD));
+  }
+  distance -= SIM_ROVER_RADIUS;
+  return distance > SIM_SONAR_RANGE ? -1.0f : max(distance, 2.0f);
+}
+
+static bool simCollided(const SimWorld& world) {
+  if (world.x < SIM_ROVER_RADIUS || world.y < SIM_ROVER_RADIUS ||
+      world.x > SIM_FIELD - SIM_ROVER_RADIUS || world.y > SIM_FIELD - SIM_ROVER_RADIUS) return true;
+  for (int i = 0; i < SIM_OBSTACLES; i++) {
+    const SimObstacle& o = world.obstacles[i];
+    if (simDistance(o.x, o.y, world.x, world.y) < o.r + SIM_ROVER_RADIUS) return true;
+  }
+  return false;
+}
+
+// The simulated operator always points at the goal, in body-relative servo degrees
+static int simGoalHeading(const SimWorld& world) {
+  float bearing = atan2f(world.goalY - world.y, world.goalX - world.x) - world.theta;
+  while (bearing > PI) bearing -= TWO_PI;
+  while (bearing < -PI) bearing += TWO_PI;
+  return constrain((int)(VFH_HEADING_AHEAD + bearing * RAD_TO_DEG), 0, 180);
+}
+
+static void simDrive(SimWorld& world, int left, int right, unsigned long ms) {
+  float dt = ms / 1000.0f / SIM_SUBSTEPS;
+  float vl = left * SIM_CM_PER_PWM, vr = right * SIM_CM_PER_PWM;
+  for (int i = 0; i < SIM_SUBSTEPS && !simCollided(world); i++) {
+    float v = (vl + vr) / 2;
+    world.theta += (vr - vl) / SIM_WHEELBASE * dt;
+    world.x += v * cosf(world.theta) * dt;
+    world.y += v * sinf(world.theta) * dt;
+  }
+}
+
+// useVfh false runs today's behaviour: operator steering plus checkAndAct's fixed pivot
+static SimOutcome simRunTrial(uint32_t seed, bool useVfh, unsigned long& elapsed) {
+  SimWorld world;
+  simBuildWorld(world, seed);
+
+  VfhPlanner planner;
+  VfhPlanner emptyPlanner;
+  vfhReset(planner);
+  vfhReset(emptyPlanner);
+  int aimed = vfhSectorAngle(planner.scanSector);
+  unsigned long pivotUntil = 0, lastBump = 0;
+  bool bumped = false;
+
+  for (elapsed = 0; elapsed < SIM_TIMEOUT; elapsed += VFH_CONTROL_INTERVAL) {
+    if (simDistance(world.x, world.y, world.goalX, world.goalY) < SIM_GOAL_RADIUS) return SIM_REACHED;
+    unsigned long now = elapsed + 1;  // planner stamps treat 0 as never seen
+    VfhDecision decision;
+
+    if (useVfh) {
+      vfhAddReading(planner, aimed, simSonar(world, aimed), now);
+      aimed = vfhNextScanAngle(planner);
+      decision = vfhPlan(planner, simGoalHeading(world), SIM_SPEED, now);
+    } else {
+      float ahead = simSonar(world, VFH_HEADING_AHEAD);
+      if (ahead > 0 && ahead < SIM_BUMP_DISTANCE && (!bumped || now - lastBump >= SIM_BUMP_COOLDOWN)) {
+        bumped = true;
+        lastBump = now;
+        pivotUntil = now + SIM_BUMP_PIVOT;
+      }
+      if (now < pivotUntil) {
+        decision.left = -SIM_SPEED / 2;
+        decision.right = SIM_SPEED / 2;
+      } else {
+        decision = vfhPlan(emptyPlanner, simGoalHeading(world), SIM_SPEED, now);
+      }
+    }
+
+    simDrive(world, decision.left, decision.right, VFH_CONTROL_INTERVAL);
+    if (simCollided(world)) return SIM_COLLIDED;
+    if ((elapsed / VFH_CONTROL_INTERVAL) % 50 == 0) yield();
+  }
+  return SIM_TIMED_OUT;
+}
+
+VfhSimResult simulateVfh(int trials, bool useVfh) {
+  VfhSimResult result = {trials, 0, 0, 0, 0};
+  for (int trial = 0; trial < trials; trial++) {
+    unsigned long elapsed;
+    // Same seeds for both policies so they face identical fields
+    switch (simRunTrial(0x5EED0000UL + trial, useVfh, elapsed)) {
+      case SIM_REACHED: result.reached++; result.totalMs += elapsed; break;
+      case SIM_COLLIDED: result.collided++; break;
+      default: result.timedOut++; break;
+    }
+    yield();
+  }
+  return result;
+}
+
+static void simReport(const char* policy, int trials, bool useVfh) {
+  VfhSimResult result = simulateVfh(trials, useVfh);
+
+  Serial.print("VFHSIM,policy="); Serial.print(policy);
+  Serial.print(",trials="); Serial.print(trials);
+  Serial.print(",success="); Serial.print(result.reached);
+  Serial.print(",collided="); Serial.print(result.collided);
+  Serial.print(",timeout="); Serial.print(result.timedOut);
+  Serial.print(",success_pct="); Serial.print(trials > 0 ? 100.0f * result.reached / trials : 0, 1);
+  Serial.print(",mean_time_s=");
+  Serial.println(result.reached > 0 ? result.totalMs / 1000.0f / result.reached : 0, 2);
+}
+
+// Runs the planner against a seeded obstacle field, next to the reactive baseline
+void runVfhSimulation(int trials) {
+  simReport("bump", trials, false);
+  simReport("vfh", trials, true);
+}
+#endif
@@ -0,0 +1,87 @@
+/*
+ * Vector Field Histogram Planner for ToxiRover
+ * Steers around obstacles toward the operator's heading instead of stopping
+ *
+ * Features:
+ * - Polar obstacle histogram from servo-swept sonar readings
+ * - Obstacles enlarged by the rover's half width, hysteresis against flicker
+ * - Picks the free sector closest to the commanded heading, committing to one side
+ * - Differential-drive output, slowed by clearance, at a fixed control rate
+ * - Simulated 2-D benchmark (success rate, time to goal) with BENCHMARK_ENABLED
+ */
+
+#ifndef VFH_PLANNER_H
+#define VFH_PLANNER_H
+
+#include <Arduino.h>
+#include "benchmark.h"
+#include "features.h"
+
+class UltrasonicServo;
+
+// Headings are body-relative servo angles: 0 = right, 90 = straight ahead, 180 = left
+#define VFH_SECTORS 9               // 20 degree sectors over the servo sweep
+#define VFH_SECTOR_WIDTH 20
+#define VFH_HEADING_AHEAD 90
+#define VFH_RANGE 100               // cm; readings beyond this add no density
+#define VFH_ROVER_RADIUS 15         // cm; half width plus margin, obstacles are enlarged by it
+#define VFH_BLOCK_DENSITY 0.70      // sector blocked above this (~30 cm)
+#define VFH_FREE_DENSITY 0.55       // and free again below this (~45 cm)
+#define VFH_READING_TTL 2500        // ms; older sectors count as unknown (free, full range)
+#define VFH_SLOW_DISTANCE 60        // cm; forward speed scales down inside this
+#define VFH_MIN_SPEED_SCALE 0.3
+#define VFH_TURN_GAIN 2.0           // wheel speed difference per unit heading error
+#define VFH_COMMIT_WEIGHT 1.0       // cost per degree from the last heading, against 1 per degree from the goal
+#define VFH_CONTROL_INTERVAL 100    // ms; one sonar reading and one drive update per tick
+
+struct VfhPlanner {
+  float distance[VFH_SECTORS];      // cm, latest reading per sector
+  unsigned long stamp[VFH_SECTORS];
+  bool blocked[VFH_SECTORS];
+  int scanSector;
+  int scanStep;                     // +1 or -1, ping-pong sweep
+  int lastHeading;                  // previous choice; keeps it from flipping between two gaps
+};
+
+struct VfhDecision {
+  int heading;                      // chosen body-relative heading
+  int left;                         // signed wheel PWM
+  int right;
+  bool boxedIn;                     // every sector blocked; rotating in place
+};
+
+typedef void (*DriveOutput)(int left, int right);
+
+// Function declarations
+void vfhReset(VfhPlanner& planner);
+void vfhAddReading(VfhPlanner& planner, int servoAngle, float distanceCm, unsigned long now);
+int vfhNextScanAngle(VfhPlanner& planner);
+VfhDecision vfhPlan(VfhPlanner& planner, int goalHeading, int speed, unsigned long now);
+int vfhSectorAngle(int sector);
+
+#if FEATURE_ULTRASONIC_SERVO
+// Live control: the obstacle task sweeps the sonar and drives toward the goal
+void initAvoidance(UltrasonicServo* sensor, DriveOutput output);
+void serviceAvoidance();
+void setAvoidanceGoal(int heading, int speed);
+void clearAvoidanceGoal();
+bool isAvoidanceActive();
+bool steerDriveCommand(char command, int speed);
+void printAvoidanceStats();
+#endif
+
+#if BENCHMARK_ENABLED
+// Outcome counts over seeded obstacle fields; useVfh false is the bump-and-pivot baseline
+struct VfhSimResult {
+  int trials;
+  int reached;
+  int collided;
+  int timedOut;
+  unsigned long totalMs;            // time to goal, summed over the reached trials
+};
+
+VfhSimResult simulateVfh(int trials, bool useVfh);
+void runVfhSimulation(int trials);
+#endif
+
+#endif
@@ -1,7 +1,27 @@
 #include <ESP8266WiFi.h>
+#include "Wifi_control.h"
+#include "features.h"
+#if FEATURE_HTTP_CONTROL
 #include <ESP8266WebServer.h>
+#endif
+#if FEATURE_OTA
 #include <ArduinoOTA.h>
+#endif
 #include "pin_config.h"
+#include "config_store.h"
+#include "boot_sequencer.h"
+#include "task_scheduler.h"
+#include "power_manager.h"
+#include "loop_profiler.h"
+#include "trace_recorder.h"
+#include "vfh_planner.h"
+#include "gas_seeker.h"
+#include "dead_reckoning.h"
+#include "device_id.h"
+#include "sample_bus.h"
+#include "json_writer.h"
+#include "rover_status.h"
+#include <LittleFS.h>
 
 // WiFi Configuration
 String sta_ssid = "Ratul";      // set Wifi networks you want to connect to
@@ -20,20 +40,47 @@ const int buzPin = 16;      // D0 - Buzzer pin (use active buzzer)
 const int ledPin = 5;       // D1 - LED pin (use super bright LED)
 const int wifiLedPin = 4;   // D2 - WiFi indication LED
 
-String command;    // String to store app command state.
-int SPEED = 122;
-int speed_Coeff = 3;
+char command = '\0';  // last app command character
+int SPEED = CONFIG_DEFAULT_SPEED;
+int speed_Coeff = CONFIG_DEFAULT_SPEED_COEFF;
 
-ESP8266WebServer server(80);  // Create a webserver object that listens for HTTP request on port 80
+#if FEATURE_HTTP_CONTROL
+static ESP8266WebServer server(80);  // Create a webserver object that listens for HTTP request on port 80
+#endif
 
-unsigned long previousMillis = 0;
+static String hostname;  // AP name if the STA connection never comes up
+
+#if FEATURE_HTTP_CONTROL && PROFILER_ENABLED
+void HTTP_handleProfile();
+#endif
+#if FEATURE_HTTP_CONTROL && TRACE_ENABLED
+void HTTP_handleTrace();
+#endif
+#if FEATURE_HTTP_CONTROL
+void HTTP_handleSeek();
+void HTTP_handleSamples();
+
+#define HTTP_SAMPLES_SIZE 192
+static SampleSnapshot httpSamples;  // drained every client poll so the ring never goes stale
+#endif
+
+void wifiStaUp();
+void wifiApFallback();
 
 void setupWiFi() {
-  Serial.begin(115200);  // set up Serial library at 115200 bps
   Serial.println();
   Serial.println("*WiFi Robot Remote Control Mode - L298N 2A*");
   Serial.println("------------------------------------------------");
 
+  // Restore motor speed settings; a warm restart keeps the last runtime change
+  initConfigStore();
+  SPEED = roverConfig.motorSpeed;
+  speed_Coeff = roverConfig.speedCoeff;
+  if (isWarmBoot() && warmState.motorSpeed > 0) {
+    SPEED = warmState.motorSpeed;
+    speed_Coeff = warmState.speedCoeff;
+  }
+
   pinMode(buzPin, OUTPUT);      // sets the buzzer pin as an Output
   pinMode(ledPin, OUTPUT);      // sets the LED pin as an Output
   pinMode(wifiLedPin, OUTPUT);  // sets the Wifi LED pin as an Output
@@ -63,180 +110,257 @@ void setupWiFi() {
   Serial.print("  LED: "); Serial.print(ledPin);
   Serial.print("  WiFi LED: "); Serial.println(wifiLedPin);
 
-  // set NodeMCU Wifi hostname based on chip mac address
-  String chip_id = String(ESP.getChipId(), HEX);
-  int i = chip_id.length() - 4;
-  chip_id = chip_id.substring(i);
-  chip_id = "WiFi_RC_Car-" + chip_id;
-  String hostname(chip_id);
+  // per-rover hostname from the full chip ID, so several rovers can share a network
+  hostname = getDeviceHostname();
+  WiFi.hostname(hostname);
 
   Serial.println();
   Serial.println("Hostname: " + hostname);
 
-  // first, set NodeMCU as STA mode to connect with a Wifi network
-  WiFi.mode(WIFI_STA);
-  WiFi.begin(sta_ssid.c_str(), sta_password.c_str());
-  Serial.println("");
-  Serial.print("Connecting to: ");
-  Serial.println(sta_ssid);
-  Serial.print("Password: ");
-  Serial.println(sta_password);
-
-  // try to connect with Wifi network about 10 seconds
-  unsigned long currentMillis = millis();
-  previousMillis = currentMillis;
-  while (WiFi.status() != WL_CONNECTED && currentMillis - previousMillis <= 10000) {
-    delay(500);
-    Serial.print(".");
-    currentMillis = millis();
-  }
-
-  // if failed to connect with Wifi network set NodeMCU as AP mode
-  if (WiFi.status() == WL_CONNECTED) {
-    Serial.println("");
-    Serial.println("*WiFi-STA-Mode*");
-    Serial.print("IP: ");
-    Serial.println(WiFi.localIP());
-    digitalWrite(wifiLedPin, LOW);  // Wifi LED on when connected to Wifi as STA mode
-    delay(3000);
-  } else {
-    WiFi.mode(WIFI_AP);
-    WiFi.softAP(hostname.c_str());
-    IPAddress myIP = WiFi.softAPIP();
-    Serial.println("");
-    Serial.println("WiFi failed connected to " + sta_ssid);
-    Serial.println("");
-    Serial.println("*WiFi-AP-Mode*");
-    Serial.print("AP IP address: ");
-    Serial.println(myIP);
-    digitalWrite(wifiLedPin, HIGH);  // Wifi LED off when status as AP mode
-    delay(3000);
-  }
+  // first, set NodeMCU as STA mode to connect with a Wifi network; association
+  // finishes in the background and AP mode is the fallback after the window
+  addNetworkUpHandler(wifiStaUp);
+  beginNetwork(sta_ssid.c_str(), sta_password.c_str());
+  addOneShotTask("wifiFallback", wifiApFallback, NETWORK_CONNECT_TIMEOUT, PRIORITY_LOW);
 
+#if FEATURE_HTTP_CONTROL
   server.on("/", HTTP_handleRoot);     // call the 'handleRoot' function when a client requests URI "/"
+#if PROFILER_ENABLED
+  server.on("/profile", HTTP_handleProfile);  // loop profile as plain text
+#endif
+#if TRACE_ENABLED
+  server.on("/trace", HTTP_handleTrace);      // ?action=start|stop|replay|dump|powersim, or download
+#endif
+  server.on("/seek", HTTP_handleSeek);        // ?action=start|stop; gas seek state as JSON
+  server.on("/samples", HTTP_handleSamples);  // latest bus samples as JSON
   server.onNotFound(HTTP_handleRoot);  // when a client requests an unknown URI (i.e. something other than "/"), call function "handleNotFound"
   server.begin();                      // actually start the server
+#endif
 
+#if FEATURE_OTA
+  ArduinoOTA.setHostname(getDeviceHostname());
   ArduinoOTA.begin();  // enable to receive update/uploade firmware via Wifi OTA
+#endif
   
   Serial.println("✅ WiFi control initialized successfully!");
 }
 
+void wifiStaUp() {
+  Serial.println("*WiFi-STA-Mode*");
+  digitalWrite(wifiLedPin, LOW);  // Wifi LED on when connected to Wifi as STA mode
+}
+
+// if failed to connect with Wifi network set NodeMCU as AP mode
+void wifiApFallback() {
+  if (isNetworkUp()) return;
+
+  WiFi.mode(WIFI_AP);
+  WiFi.softAP(hostname.c_str());
+  IPAddress myIP = WiFi.softAPIP();
+  Serial.println("WiFi failed connected to " + sta_ssid);
+  Serial.println("*WiFi-AP-Mode*");
+  Serial.print("AP IP address: ");
+  Serial.println(myIP);
+  digitalWrite(wifiLedPin, HIGH);  // Wifi LED off when status as AP mode
+}
+
 void handleClient() {
+#if FEATURE_OTA
   ArduinoOTA.handle();    // listen for update OTA request from clients
-  server.handleClient();  // listen for HTTP requests from clients
-
-  command = server.arg("State");  // check HTPP request, if has arguments "State" then saved the value
-  if (command == "F") Forward();  // check string then call a function or set a value
-  else if (command == "B") Backward();
-  else if (command == "R") TurnRight();
-  else if (command == "L") TurnLeft();
-  else if (command == "G") ForwardLeft();
-  else if (command == "H") BackwardLeft();
-  else if (command == "I") ForwardRight();
-  else if (command == "J") BackwardRight();
-  else if (command == "S") Stop();
-  else if (command == "V") BeepHorn();
-  else if (command == "W") TurnLightOn();
-  else if (command == "w") TurnLightOff();
-  else if (command == "0") SPEED = 60;
-  else if (command == "1") SPEED = 70;
-  else if (command == "2") SPEED = 81;                                                                     
-  else if (command == "3") SPEED = 95;
-  else if (command == "4") SPEED = 105;
-  else if (command == "5") SPEED = 122;
-  else if (command == "6") SPEED = 150;
-  else if (command == "7") SPEED = 196;
-  else if (command == "8") SPEED = 272;
-  else if (command == "9") SPEED = 400;
-  else if (command == "q") SPEED = 1023;
+#endif
+#if FEATURE_HTTP_CONTROL
+  drainSampleSnapshot(BUS_CONSUMER_HTTP, httpSamples);
+  server.handleClient();  // listen for HTTP requests from clients; route handlers run once per request
+#endif
+}
+
+#if FEATURE_HTTP_CONTROL
+// One remote command per request: the web server keeps the last request's
+// arguments, so they must not be polled from the 10 ms client task
+static void handleRemoteCommand(char command) {
+  TRACE_EVENT(TRACE_DRIVE_CMD, command);
+  notePowerDriveCommand(command);
+  noteSeekDriveCommand(command);
+#if FEATURE_ULTRASONIC_SERVO
+  if (steerDriveCommand(command, SPEED)) return;  // the planner drives forward motion
+#endif
+  dispatchCommand(command);
+}
+#endif
+
+void dispatchCommand(char command) {
+  int previousSpeed = SPEED;
+
+  switch (command) {  // check the command then call a function or set a value
+    case 'F': Forward(); break;
+    case 'B': Backward(); break;
+    case 'R': TurnRight(); break;
+    case 'L': TurnLeft(); break;
+    case 'G': ForwardLeft(); break;
+    case 'H': BackwardLeft(); break;
+    case 'I': ForwardRight(); break;
+    case 'J': BackwardRight(); break;
+    case 'S': Stop(); break;
+    case 'V': BeepHorn(); break;
+    case 'W': TurnLightOn(); break;
+    case 'w': TurnLightOff(); break;
+    case '0': SPEED = 60; break;
+    case '1': SPEED = 70; break;
+    case '2': SPEED = 81; break;
+    case '3': SPEED = 95; break;
+    case '4': SPEED = 105; break;
+    case '5': SPEED = 122; break;
+    case '6': SPEED = 150; break;
+    case '7': SPEED = 196; break;
+    case '8': SPEED = 272; break;
+    case '9': SPEED = 400; break;
+    case 'q': SPEED = 1023; break;
+  }
+
+  // Speed changes survive a warm restart and, through the config store, a power cycle
+  if (SPEED != previousSpeed) {
+    warmState.motorSpeed = SPEED;
+    warmState.speedCoeff = speed_Coeff;
+    saveWarmState();
+    roverConfig.motorSpeed = SPEED;
+    roverConfig.speedCoeff = speed_Coeff;
+    saveConfig();  // commits only when the record changed
+  }
 }
 
+#if FEATURE_HTTP_CONTROL
 // function prototypes for HTTP handlers
 void HTTP_handleRoot(void) {
   server.send(200, "text/html", "");  // Send HTTP status 200 (Ok) and send some text to the browser/client
 
-  if (server.hasArg("State")) {
-    Serial.println(server.arg("State"));
+  // Commands are single characters; only read the argument when a request carried one
+  if (!server.hasArg("State")) return;
+  const String& state = server.arg("State");
+  Serial.println(state);
+  command = state.length() == 1 ? state[0] : '\0';
+  handleRemoteCommand(command);
+}
+
+#if PROFILER_ENABLED
+void HTTP_handleProfile() {
+  static char report[PROFILER_REPORT_SIZE];
+  formatProfilerReport(report, sizeof(report));
+  server.send(200, "text/plain", report);
+}
+#endif
+
+#if TRACE_ENABLED
+void HTTP_handleTrace() {
+  const String& action = server.arg("action");
+  if (action == "start") startTraceRecording();
+  else if (action == "stop") { stopTraceRecording(); stopTraceReplay(); }
+  else if (action == "replay") startTraceReplay();
+  else if (action == "dump") exportTraceSerial();
+  else if (action == "powersim") simulateTracePower();  // POWERSIM line over Serial
+  else {
+    File file = LittleFS.open(TRACE_FILE, "r");
+    if (!file) {
+      server.send(404, "text/plain", "no trace");
+      return;
+    }
+    server.streamFile(file, "application/octet-stream");
+    file.close();
+    return;
+  }
+  server.send(200, "text/plain", isTraceRecording() ? "recording" : isTraceReplaying() ? "replaying" : "idle");
+}
+#endif
+
+void HTTP_handleSeek() {
+  static char status[SEEK_STATUS_SIZE];
+  const String& action = server.arg("action");
+  if (action == "start") startGasSeeking(SPEED);
+  else if (action == "stop") stopGasSeeking();
+  server.send(200, "application/json", formatSeekStatus(status, sizeof(status)));
+}
+
+void HTTP_handleSamples() {
+  static char json[HTTP_SAMPLES_SIZE];
+  JsonWriter writer(json, sizeof(json));
+  writer.beginObject();
+  if (hasSnapshotValue(httpSamples, SAMPLE_GAS_PPM)) writer.add("gas_ppm", httpSamples.value[SAMPLE_GAS_PPM]);
+  if (hasSnapshotValue(httpSamples, SAMPLE_DISTANCE_CM)) writer.add("distance_cm", (int)httpSamples.value[SAMPLE_DISTANCE_CM]);
+  if (hasSnapshotValue(httpSamples, SAMPLE_MOTION)) {
+    writer.add("motion", getMotionName((MotionCommand)(int)httpSamples.value[SAMPLE_MOTION]));
   }
+  if (hasSnapshotValue(httpSamples, SAMPLE_SERVO_ANGLE)) writer.add("servo_angle", (int)httpSamples.value[SAMPLE_SERVO_ANGLE]);
+  writer.add("gaps", (unsigned long)httpSamples.gaps);
+  writer.add("drops", (unsigned long)getSampleBusDrops(BUS_CONSUMER_HTTP));
+  writer.endObject();
+  server.send(200, "application/json", json);
 }
 
 void handleNotFound() {
   server.send(404, "text/plain", "404: Not found");  // Send HTTP status 404 (Not Found) when there's no handler for the URI in the request
 }
+#endif
+
+// Every move goes through setDrive(), so the pins and the dead-reckoned wheels always agree
 
 // function to move forward
 void Forward() {
-  analogWrite(in1, SPEED);  // Right Motor Forward
-  digitalWrite(in2, LOW);
-  analogWrite(in3, SPEED);  // Left Motor Forward
-  digitalWrite(in4, LOW);
+  setDrive(SPEED, SPEED);
 }
 
 // function to move backward
 void Backward() {
-  digitalWrite(in1, LOW);
-  analogWrite(in2, SPEED);  // Right Motor Reverse
-  digitalWrite(in3, LOW);
-  analogWrite(in4, SPEED);  // Left Motor Reverse
+  setDrive(-SPEED, -SPEED);
 }
 
 // function to turn right
 void TurnRight() {
-  analogWrite(in1, SPEED);  // Right Motor Forward
-  digitalWrite(in2, LOW);
-  digitalWrite(in3, LOW);   // Left Motor Reverse
-  analogWrite(in4, SPEED);
+  setDrive(SPEED, -SPEED);
 }
 
 // function to turn left
 void TurnLeft() {
-  digitalWrite(in1, LOW);   // Right Motor Reverse
-  analogWrite(in2, SPEED);
-  analogWrite(in3, SPEED);  // Left Motor Forward
-  digitalWrite(in4, LOW);
+  setDrive(-SPEED, SPEED);
 }
 
 // function to move forward left
 void ForwardLeft() {
-  analogWrite(in1, SPEED);
-  digitalWrite(in2, LOW);
-  analogWrite(in3, SPEED / speed_Coeff);
-  digitalWrite(in4, LOW);
+  setDrive(SPEED / speed_Coeff, SPEED);
 }
 
 // function to move backward left
 void BackwardLeft() {
-  digitalWrite(in1, LOW);
-  analogWrite(in2, SPEED);
-  digitalWrite(in3, LOW);
-  analogWrite(in4, SPEED / speed_Coeff);
+  setDrive(-SPEED / speed_Coeff, -SPEED);
 }
 
 // function to move forward right
 void ForwardRight() {
-  analogWrite(in1, SPEED / speed_Coeff);
-  digitalWrite(in2, LOW);
-  analogWrite(in3, SPEED);
-  digitalWrite(in4, LOW);
+  setDrive(SPEED, SPEED / speed_Coeff);
 }
 
 // function to move backward right
 void BackwardRight() {
-  digitalWrite(in1, LOW);
-  analogWrite(in2, SPEED / speed_Coeff);
-  digitalWrite(in3, LOW);
-  analogWrite(in4, SPEED);
+  setDrive(-SPEED, -SPEED / speed_Coeff);
 }
 
 // function to stop motors
 void Stop() {
+  noteWheelCommand(0, 0);
   digitalWrite(in1, LOW);
   digitalWrite(in2, LOW);
   digitalWrite(in3, LOW);
   digitalWrite(in4, LOW);
 }
 
+// signed per-wheel speeds; negative runs the wheel in reverse. IN1/IN2 drive the left
+// motor and IN3/IN4 the right (pin_config.h), the same wiring the MQTT feeds use
+void setDrive(int left, int right) {
+  noteWheelCommand(left, right);
+  if (left >= 0) { analogWrite(in1, left); digitalWrite(in2, LOW); }     // Left Motor
+  else { digitalWrite(in1, LOW); analogWrite(in2, -left); }
+  if (right >= 0) { analogWrite(in3, right); digitalWrite(in4, LOW); }   // Right Motor
+  else { digitalWrite(in3, LOW); analogWrite(in4, -right); }
+}
+
 // function to beep a buzzer
 void BeepHorn() {
   digitalWrite(buzPin, HIGH);
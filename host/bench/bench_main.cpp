@@ -0,0 +1,240 @@
+/*
+ * Host Benchmarks for ToxiRover
+ * Runs the firmware's benchmark and simulation entry points on the PC
+ *
+ * Usage: toxirover_bench [--quick] [--csv FILE] [--baseline FILE]
+ *   --quick          fewer simulation trials (the ctest smoke run)
+ *   --csv FILE       write every BENCH row, plus allocations/op, to FILE
+ *   --baseline FILE  compare with an earlier --csv; fails if a path allocates more than it did
+ * Prints the same BENCH/SIM CSV lines the device prints at boot. Timings are
+ * host nanoseconds: compare runs with each other, not with the ESP8266.
+ */
+
+#include "fake_hal.h"
+#include "benchmark.h"
+#include "boot_sequencer.h"
+#include "config_store.h"
+#include "device_id.h"
+#include "firebase.h"
+#include "fleet_gateway.h"
+#include "gas_map.h"
+#include "gas_seeker.h"
+#include "gas_sensor.h"
+#include "log_summary.h"
+#include "task_scheduler.h"
+#include "telemetry_frame.h"
+#include "UltrasonicServo.h"
+#include "vfh_planner.h"
+#include "WANconnection.h"
+#include "Wifi_control.h"
+
+#include <map>
+#include <sstream>
+#include <string>
+
+#define BENCH_HTTP_PORT 80
+#define BENCH_MQTT_USER "YOUR_ADAFRUIT_USERNAME"  // MQTT_NAME in WANconnection.cpp
+#define BENCH_ALLOC_TOLERANCE 0.01  // allocations/op that still count as unchanged
+
+struct HostBenchRow {
+  std::string line;       // the BENCH line as printed
+  double allocationsPerOp;
+  bool hasAllocations;
+};
+
+static std::map<std::string, double> allocationsPerOp;
+static volatile float benchSink;
+static char benchPayload[FIREBASE_PAYLOAD_SIZE];
+static char forwardFeed[96];
+static BenchmarkResult jsonTelemetry;  // the keyed JSON path binary frames are compared with
+static size_t jsonTelemetryBytes = 0;
+
+// runBenchmark() plus the allocation counter only the host has
+static BenchmarkResult runHostBenchmark(const char* name, BenchmarkOp op, unsigned long iterations) {
+  unsigned long before = fakeHeapStats().allocations;
+  BenchmarkResult result = runBenchmark(name, op, iterations);
+  allocationsPerOp[name] = (double)(fakeHeapStats().allocations - before) / (iterations + BENCHMARK_WARMUP);
+  printBenchmarkResult(result);
+  return result;
+}
+
+static void benchGasRead() {
+  benchSink = readGasSensor();
+}
+
+static void benchEchoConversion() {
+  benchSink = UltrasonicServo::echoToCentimeters(1160);  // ~20 cm
+}
+
+// One web remote request through the server, State parsing and dispatch
+static void benchHttpDispatch() {
+  FakeHttpResponse response;
+  fakeHttpRequest(BENCH_HTTP_PORT, "/?State=5");  // speed change only, motors untouched
+  handleClient();
+  fakeHttpResponse(BENCH_HTTP_PORT, response);
+}
+
+static void benchTelemetryPayload() {
+  benchSink = formatTelemetryPayload(benchPayload, sizeof(benchPayload));
+}
+
+// One drive feed message through the MQTT client and the WAN handler chain
+static void benchMqttHandler() {
+  fakeMqttInject(forwardFeed, "0");
+  loopWAN();
+}
+
+static void runUntil(unsigned long ms) {
+  unsigned long start = millis();
+  while (millis() - start < ms) {
+    unsigned long before = micros();
+    runScheduler();
+    if (micros() == before) fakeAdvanceMicros(100);
+  }
+}
+
+// The paths the device benchmarks at boot, with the network stubs connected
+static void runHotPathBenchmarks() {
+  initBootSequencer();
+  fakeSetAnalog(A0, 300);
+  initGasSensor();
+  setWiFiCredentials("bench", "password1");
+  setupWiFi();
+  setupWAN();
+  runUntil(FAKE_WIFI_CONNECT_MS + 1000);
+  loopWAN();  // connects the MQTT client
+  formatDeviceFeed(forwardFeed, sizeof(forwardFeed), BENCH_MQTT_USER, "forward");
+  int savedSpeed = SPEED;
+
+  printBenchmarkHeader();
+  runHostBenchmark("readGasSensor", benchGasRead, 1000);
+  runHostBenchmark("echoToCentimeters", benchEchoConversion, 10000);
+  runHostBenchmark("httpDispatch", benchHttpDispatch, 2000);
+  jsonTelemetry = runHostBenchmark("telemetryPayload", benchTelemetryPayload, 1000);
+  jsonTelemetryBytes = formatTelemetryPayload(benchPayload, sizeof(benchPayload));
+  runHostBenchmark("mqttHandler", benchMqttHandler, 2000);
+
+  SPEED = savedSpeed;
+  roverConfig.motorSpeed = savedSpeed;
+}
+
+// Every BENCH row printed so far; rows from runHostBenchmark() carry allocations/op
+static std::vector<HostBenchRow> collectRows() {
+  std::vector<HostBenchRow> rows;
+  std::istringstream output(fakeSerialOutput());
+  std::string line;
+  while (std::getline(output, line)) {
+    if (line.compare(0, 6, "BENCH,") != 0 || line.compare(0, 11, "BENCH,name,") == 0) continue;
+    std::string name = line.substr(6, line.find(',', 6) - 6);
+    auto found = allocationsPerOp.find(name);
+    rows.push_back({line, found != allocationsPerOp.end() ? found->second : 0, found != allocationsPerOp.end()});
+  }
+  return rows;
+}
+
+static bool writeCsv(const char* path, const std::vector<HostBenchRow>& rows) {
+  FILE* file = fopen(path, "w");
+  if (file == NULL) {
+    fprintf(stderr, "❌ Cannot write %s\n", path);
+    return false;
+  }
+  fprintf(file, "name,iterations,ns_per_op,heap_bytes_per_op,heap_frag_pct,allocs_per_op\n");
+  for (const HostBenchRow& row : rows) {
+    fprintf(file, "%s,", row.line.c_str() + 6);
+    if (row.hasAllocations) fprintf(file, "%.2f", row.allocationsPerOp);
+    fprintf(file, "\n");
+  }
+  fclose(file);
+  return true;
+}
+
+static std::vector<std::string> splitCsv(const std::string& line) {
+  std::vector<std::string> fields;
+  std::istringstream in(line);
+  std::string field;
+  while (std::getline(in, field, ',')) fields.push_back(field);
+  if (!line.empty() && line.back() == ',') fields.push_back("");
+  return fields;
+}
+
+// Time is reported, not judged (host timings are noisy); more heap per op fails
+static int compareBaseline(const char* path, const std::vector<HostBenchRow>& rows) {
+  FILE* file = fopen(path, "r");
+  if (file == NULL) {
+    fprintf(stderr, "❌ Cannot read %s\n", path);
+    return 1;
+  }
+  std::map<std::string, std::vector<std::string>> baseline;
+  char buffer[256];
+  while (fgets(buffer, sizeof(buffer), file) != NULL) {
+    std::string line(buffer);
+    while (!line.empty() && (line.back() == '\n' || line.back() == '\r')) line.pop_back();
+    std::vector<std::string> fields = splitCsv(line);
+    if (fields.size() >= 4 && fields[0] != "name") baseline[fields[0]] = fields;
+  }
+  fclose(file);
+
+  int regressions = 0;
+  printf("BENCHDIFF,name,ns_before,ns_after,ns_ratio,heap_before,heap_after,allocs_before,allocs_after\n");
+  for (const HostBenchRow& row : rows) {
+    std::vector<std::string> now = splitCsv(row.line.substr(6));
+    auto found = baseline.find(now[0]);
+    if (found == baseline.end()) continue;
+    const std::vector<std::string>& then = found->second;
+    double nsBefore = atof(then[2].c_str());
+    double nsAfter = atof(now[2].c_str());
+    long heapBefore = atol(then[3].c_str());
+    long heapAfter = atol(now[3].c_str());
+    bool hadAllocations = then.size() > 5 && !then[5].empty();
+    double allocsBefore = hadAllocations ? atof(then[5].c_str()) : 0;
+
+    printf("BENCHDIFF,%s,%.0f,%.0f,%.2f,%ld,%ld,", now[0].c_str(), nsBefore, nsAfter,
+           nsBefore > 0 ? nsAfter / nsBefore : 0.0, heapBefore, heapAfter);
+    if (hadAllocations && row.hasAllocations) printf("%.2f,%.2f\n", allocsBefore, row.allocationsPerOp);
+    else printf(",\n");
+
+    bool worse = heapAfter > heapBefore ||
+                 (hadAllocations && row.hasAllocations && row.allocationsPerOp > allocsBefore + BENCH_ALLOC_TOLERANCE);
+    if (worse) {
+      fprintf(stderr, "❌ %s allocates more than in %s\n", now[0].c_str(), path);
+      regressions++;
+    }
+  }
+  return regressions == 0 ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+  bool quick = false;
+  const char* csv = NULL;
+  const char* baseline = NULL;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--quick") == 0) quick = true;
+    else if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc) csv = argv[++i];
+    else if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) baseline = argv[++i];
+  }
+  int trials = quick ? 5 : 200;
+
+  fakeSerialEcho(true);
+  initConfigStore();
+  Serial.println("🏁 ToxiRover host benchmarks");
+
+  runHotPathBenchmarks();
+  runVfhSimulation(trials);
+  runGasSeekSimulation(trials);
+  runGasMapBenchmarks();
+  runTelemetryFrameBenchmarks(&jsonTelemetry, jsonTelemetryBytes);
+  runLogSummaryBenchmarks();
+  runFleetGatewayBenchmarks();
+
+  FakeHeapStats heap = fakeHeapStats();
+  Serial.print("🧮 Heap: ");
+  Serial.print(heap.allocations);
+  Serial.print(" allocations, peak ");
+  Serial.print(heap.peakBytes);
+  Serial.println(" bytes");
+
+  std::vector<HostBenchRow> rows = collectRows();
+  if (csv != NULL && !writeCsv(csv, rows)) return 1;
+  if (baseline != NULL) return compareBaseline(baseline, rows);
+  return 0;
+}
@@ -0,0 +1,68 @@
+/*
+ * Host Adafruit MQTT for ToxiRover
+ * Feeds talk to an in-process broker (fakeMqttInject / fakeMqttPublished)
+ */
+
+#ifndef ADAFRUIT_MQTT_H
+#define ADAFRUIT_MQTT_H
+
+#include <Arduino.h>
+
+#define MAXSUBSCRIPTIONS 5
+#define SUBSCRIPTIONDATALEN 20
+
+class Adafruit_MQTT_Subscribe;
+
+class Adafruit_MQTT {
+public:
+  Adafruit_MQTT(const char* server, uint16_t port, const char* cid, const char* user, const char* pass)
+      : server(server), port(port), clientId(cid), user(user), pass(pass) {}
+  virtual ~Adafruit_MQTT() {}
+
+  int8_t connect();
+  bool connected();
+  bool disconnect();
+  bool ping(uint8_t tries = 1);
+  const char* connectErrorString(int8_t code);
+  bool subscribe(Adafruit_MQTT_Subscribe* subscription);
+  Adafruit_MQTT_Subscribe* readSubscription(int16_t timeoutMs = 0);
+  bool publish(const char* topic, const uint8_t* payload, uint16_t length);
+
+protected:
+  const char* server;
+  uint16_t port;
+  const char* clientId;
+  const char* user;
+  const char* pass;
+  unsigned long session = 0;  // broker session this client joined, 0 = none
+  Adafruit_MQTT_Subscribe* subscriptions[MAXSUBSCRIPTIONS] = {};
+};
+
+class Adafruit_MQTT_Subscribe {
+public:
+  Adafruit_MQTT_Subscribe(Adafruit_MQTT* mqtt, const char* feed, uint8_t qos = 0)
+      : topic(feed), mqtt(mqtt) { (void)qos; }
+
+  const char* topic;
+  uint8_t lastread[SUBSCRIPTIONDATALEN];
+  uint16_t datalen = 0;
+
+private:
+  Adafruit_MQTT* mqtt;
+};
+
+class Adafruit_MQTT_Publish {
+public:
+  Adafruit_MQTT_Publish(Adafruit_MQTT* mqtt, const char* feed, uint8_t qos = 0)
+      : mqtt(mqtt), topic(feed) { (void)qos; }
+
+  bool publish(const char* payload) { return mqtt->publish(topic, (const uint8_t*)payload, strlen(payload)); }
+  bool publish(uint8_t* payload, uint16_t length) { return mqtt->publish(topic, payload, length); }
+  bool publish(int32_t value) { String text(value); return publish(text.c_str()); }
+
+private:
+  Adafruit_MQTT* mqtt;
+  const char* topic;
+};
+
+#endif
@@ -0,0 +1,19 @@
+/*
+ * Host Adafruit MQTT Client for ToxiRover
+ * The transport client is kept only for signature compatibility
+ */
+
+#ifndef ADAFRUIT_MQTT_CLIENT_H
+#define ADAFRUIT_MQTT_CLIENT_H
+
+#include <ESP8266WiFi.h>
+#include "Adafruit_MQTT.h"
+
+class Adafruit_MQTT_Client : public Adafruit_MQTT {
+public:
+  Adafruit_MQTT_Client(WiFiClient* client, const char* server, uint16_t port,
+                       const char* cid, const char* user, const char* pass)
+      : Adafruit_MQTT(server, port, cid, user, pass) { (void)client; }
+};
+
+#endif
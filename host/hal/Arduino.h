@@ -0,0 +1,209 @@
+/*
+ * Host Arduino Core for ToxiRover
+ * Just enough of the ESP8266 Arduino core to build the firmware on a PC
+ *
+ * Features:
+ * - Virtual clock: millis()/micros() only move when delay() or the test advances them
+ * - Scriptable digital pins, ADC and echo pulses (see fake_hal.h)
+ * - Serial output captured for tests, echoed with HOST_SERIAL=1
+ * - ESP object with RTC memory, chip ID and a heap figure from the allocation counter
+ */
+
+#ifndef ARDUINO_H
+#define ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+#include <time.h>
+#include <sys/time.h>
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+#include "WString.h"
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 0x1
+#define LOW 0x0
+
+#define INPUT 0x00
+#define INPUT_PULLUP 0x02
+#define OUTPUT 0x01
+
+#define RISING 0x01
+#define FALLING 0x02
+#define CHANGE 0x03
+
+#define LED_BUILTIN 2
+#define F_CPU 80000000L  // getCycleCount() is scaled to this
+#define A0 17
+
+#define PI 3.1415926535897932384626433832795
+#define HALF_PI 1.5707963267948966192313216916398
+#define TWO_PI 6.283185307179586476925286766559
+#define DEG_TO_RAD 0.017453292519943295769236907684886
+#define RAD_TO_DEG 57.295779513082320876798154814105
+
+#define DEC 10
+#define HEX 16
+
+#define IRAM_ATTR
+#define ICACHE_RAM_ATTR
+#define PROGMEM
+#define F(text) (text)
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+using std::min;
+using std::max;
+using std::isinf;
+using std::isnan;
+
+// The ESP8266 toolchain has strlcpy; glibc only from 2.38
+#if defined(__GLIBC__) && !__GLIBC_PREREQ(2, 38)
+size_t strlcpy(char* dst, const char* src, size_t size);
+#endif
+
+// stdlib_noniso
+char* dtostrf(double number, signed char width, unsigned char precision, char* out);
+
+// Timing (virtual clock)
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+// Pins
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+void analogWrite(uint8_t pin, int value);
+unsigned long pulseIn(uint8_t pin, uint8_t state, unsigned long timeout = 1000000L);
+void attachInterrupt(uint8_t interrupt, void (*isr)(), int mode);
+void detachInterrupt(uint8_t interrupt);
+#define digitalPinToInterrupt(pin) (pin)
+
+// Random numbers (seedable for repeatable runs)
+long random(long howBig);
+long random(long howSmall, long howBig);
+void randomSeed(unsigned long seed);
+uint32_t fakeHardwareRandom();
+#define RANDOM_REG32 fakeHardwareRandom()
+
+// SNTP; the host clock is set with fakeSetEpoch()
+void configTime(int timezone, int daylightOffsetSec, const char* server1,
+                const char* server2 = nullptr, const char* server3 = nullptr);
+
+class Print;
+
+class Printable {
+public:
+  virtual ~Printable() {}
+  virtual size_t printTo(Print& p) const = 0;
+};
+
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t* buffer, size_t size);
+  size_t write(const char* text) { return write((const uint8_t*)text, strlen(text)); }
+
+  size_t print(const char* text) { return write(text); }
+  size_t print(const String& text) { return write(text.c_str()); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(unsigned char value, int base = DEC) { return print((unsigned long)value, base); }
+  size_t print(int value, int base = DEC) { return print((long)value, base); }
+  size_t print(unsigned int value, int base = DEC) { return print((unsigned long)value, base); }
+  size_t print(long value, int base = DEC);
+  size_t print(unsigned long value, int base = DEC);
+  size_t print(long long value, int base = DEC) { return print((long)value, base); }
+  size_t print(unsigned long long value, int base = DEC) { return print((unsigned long)value, base); }
+  size_t print(double value, int digits = 2);
+  size_t print(const Printable& value) { return value.printTo(*this); }
+
+  size_t println() { return write("\r\n"); }
+  template <typename T>
+  size_t println(const T& value) { size_t n = print(value); return n + println(); }
+  template <typename T>
+  size_t println(const T& value, int format) { size_t n = print(value, format); return n + println(); }
+};
+
+class Stream : public Print {
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  void setTimeout(unsigned long timeoutMs) { streamTimeout = timeoutMs; }
+  size_t readBytes(char* buffer, size_t length);
+  size_t readBytes(uint8_t* buffer, size_t length) { return readBytes((char*)buffer, length); }
+  size_t readBytesUntil(char terminator, char* buffer, size_t length);
+  size_t readBytesUntil(char terminator, uint8_t* buffer, size_t length) {
+    return readBytesUntil(terminator, (char*)buffer, length);
+  }
+
+protected:
+  unsigned long streamTimeout = 1000;
+};
+
+class HardwareSerial : public Stream {
+public:
+  void begin(unsigned long baud) { (void)baud; }
+  int available() override;
+  int read() override;
+  void flush() {}
+  using Print::write;
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t* buffer, size_t size) override;
+  operator bool() const { return true; }
+};
+
+extern HardwareSerial Serial;
+
+// Reset cause as reported by the SDK
+enum rst_reason {
+  REASON_DEFAULT_RST = 0,
+  REASON_WDT_RST = 1,
+  REASON_EXCEPTION_RST = 2,
+  REASON_SOFT_WDT_RST = 3,
+  REASON_SOFT_RESTART = 4,
+  REASON_DEEP_SLEEP_AWAKE = 5,
+  REASON_EXT_SYS_RST = 6
+};
+
+struct rst_info {
+  uint32_t reason;
+};
+
+class EspClass {
+public:
+  uint32_t getChipId();
+  uint32_t getCycleCount();
+  uint32_t getFreeHeap();
+  uint8_t getHeapFragmentation();
+  uint32_t getSketchSize();
+  uint32_t getFreeSketchSpace();
+  bool rtcUserMemoryRead(uint32_t offset, uint32_t* data, size_t size);
+  bool rtcUserMemoryWrite(uint32_t offset, uint32_t* data, size_t size);
+  rst_info* getResetInfoPtr();
+  String getResetReason();
+  void restart();
+};
+
+extern EspClass ESP;
+
+// The wall clock is virtual too; it reads as unsynced until SNTP "answers"
+time_t fakeTime(time_t* out);
+int fakeGettimeofday(struct timeval* tv, void* tz);
+#define time(out) fakeTime(out)
+#define gettimeofday(tv, tz) fakeGettimeofday(tv, tz)
+
+#endif
@@ -0,0 +1,24 @@
+/*
+ * Host ArduinoOTA for ToxiRover
+ * No uploads arrive on the host; handle() only counts polls
+ */
+
+#ifndef ARDUINOOTA_H
+#define ARDUINOOTA_H
+
+#include <Arduino.h>
+
+class ArduinoOTAClass {
+public:
+  void setHostname(const char* name) { hostname = name; }
+  void begin() { started = true; }
+  void handle() { polls++; }
+
+  String hostname;
+  bool started = false;
+  unsigned long polls = 0;
+};
+
+extern ArduinoOTAClass ArduinoOTA;
+
+#endif
@@ -0,0 +1,49 @@
+/*
+ * Host EEPROM for ToxiRover
+ * Flash-backed emulation: reads and writes hit a RAM copy, commit() copies it to "flash"
+ *
+ * Features:
+ * - Flash contents survive fakeReboot(), the RAM copy does not
+ * - Commit and byte-write counters for wear tests
+ */
+
+#ifndef EEPROM_H
+#define EEPROM_H
+
+#include <Arduino.h>
+
+#define FAKE_EEPROM_FLASH_SIZE 4096
+
+class EEPROMClass {
+public:
+  void begin(size_t size);
+  uint8_t read(int address);
+  void write(int address, uint8_t value);
+  bool commit();
+  void end();
+  size_t length() { return size; }
+
+  template <typename T>
+  T& get(int address, T& value) {
+    if (address >= 0 && address + sizeof(T) <= size) memcpy(&value, data + address, sizeof(T));
+    return value;
+  }
+
+  template <typename T>
+  const T& put(int address, const T& value) {
+    if (address >= 0 && address + sizeof(T) <= size) {
+      if (memcmp(data + address, &value, sizeof(T)) != 0) dirty = true;
+      memcpy(data + address, &value, sizeof(T));
+    }
+    return value;
+  }
+
+private:
+  uint8_t data[FAKE_EEPROM_FLASH_SIZE];
+  size_t size = 0;
+  bool dirty = false;
+};
+
+extern EEPROMClass EEPROM;
+
+#endif
@@ -0,0 +1,11 @@
+/*
+ * Host ESP8266HTTPClient for ToxiRover
+ * Included by the WAN module; nothing in the firmware uses the client itself
+ */
+
+#ifndef ESP8266HTTPCLIENT_H
+#define ESP8266HTTPCLIENT_H
+
+#include <ESP8266WiFi.h>
+
+#endif
@@ -0,0 +1,62 @@
+/*
+ * Host ESP8266WebServer for ToxiRover
+ * Routes requests queued with fakeHttpRequest(); the first server to begin() owns the port
+ */
+
+#ifndef ESP8266WEBSERVER_H
+#define ESP8266WEBSERVER_H
+
+#include <ESP8266WiFi.h>
+#include <LittleFS.h>
+#include <functional>
+#include <utility>
+#include <vector>
+
+enum HTTPMethod {
+  HTTP_ANY,
+  HTTP_GET,
+  HTTP_POST
+};
+
+class ESP8266WebServer {
+public:
+  typedef std::function<void(void)> THandlerFunction;
+
+  explicit ESP8266WebServer(int port = 80) : port(port) {}
+  ~ESP8266WebServer();
+
+  void on(const char* uri, THandlerFunction handler) { routes.push_back({uri, handler}); }
+  void on(const char* uri, HTTPMethod method, THandlerFunction handler) { (void)method; on(uri, handler); }
+  void onNotFound(THandlerFunction handler) { notFound = handler; }
+  void begin();
+  void stop();
+  void handleClient();
+
+  const String& uri() const { return requestUri; }
+  const String& arg(const char* name) const;
+  const String& arg(const String& name) const { return arg(name.c_str()); }
+  bool hasArg(const char* name) const;
+  int args() const { return (int)requestArgs.size(); }
+
+  void send(int code, const char* contentType, const String& content);
+  void send(int code, const char* contentType, const char* content) { send(code, contentType, String(content)); }
+  void sendHeader(const char* name, const char* value) { (void)name; (void)value; }
+  size_t streamFile(File& file, const char* contentType);
+
+  unsigned long requestsServed = 0;
+
+private:
+  struct Route {
+    String uri;
+    THandlerFunction handler;
+  };
+
+  int port;
+  bool listening = false;
+  std::vector<Route> routes;
+  THandlerFunction notFound;
+  String requestUri;
+  std::vector<std::pair<String, String>> requestArgs;
+};
+
+#endif
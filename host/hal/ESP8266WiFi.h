@@ -0,0 +1,105 @@
+/*
+ * Host ESP8266WiFi for ToxiRover
+ * Station/AP state on the virtual clock and TCP clients over a loopback network
+ *
+ * Features:
+ * - Association completes FAKE_WIFI_CONNECT_MS after begin() when the network is reachable,
+ *   FAKE_WIFI_FAST_CONNECT_MS when begin() is given a channel and BSSID
+ * - WiFiClient talks to in-process endpoints registered with fakeNetListen()
+ * - Request/response exchange: bytes written are handed to the endpoint on the next read
+ * - Network scans take FAKE_WIFI_SCAN_MS; blocking, or polled with scanComplete()
+ */
+
+#ifndef ESP8266WIFI_H
+#define ESP8266WIFI_H
+
+#include <Arduino.h>
+
+#define FAKE_WIFI_CONNECT_MS 1500
+#define FAKE_WIFI_FAST_CONNECT_MS 300
+#define FAKE_WIFI_SCAN_MS 2000
+
+#define WIFI_SCAN_RUNNING (-1)
+#define WIFI_SCAN_FAILED (-2)
+
+enum wl_status_t {
+  WL_IDLE_STATUS = 0,
+  WL_NO_SSID_AVAIL = 1,
+  WL_CONNECTED = 3,
+  WL_CONNECT_FAILED = 4,
+  WL_DISCONNECTED = 6
+};
+
+enum WiFiMode_t {
+  WIFI_OFF = 0,
+  WIFI_STA = 1,
+  WIFI_AP = 2,
+  WIFI_AP_STA = 3
+};
+
+enum WiFiSleepType_t {
+  WIFI_NONE_SLEEP = 0,
+  WIFI_LIGHT_SLEEP = 1,
+  WIFI_MODEM_SLEEP = 2
+};
+
+class IPAddress : public Printable {
+public:
+  IPAddress() : bytes{0, 0, 0, 0} {}
+  IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : bytes{a, b, c, d} {}
+  uint8_t operator[](int index) const { return bytes[index]; }
+  String toString() const;
+  size_t printTo(Print& p) const override;
+  bool operator==(const IPAddress& other) const { return memcmp(bytes, other.bytes, 4) == 0; }
+
+private:
+  uint8_t bytes[4];
+};
+
+struct FakeConnection;
+
+class WiFiClient : public Stream {
+public:
+  WiFiClient() {}
+  virtual ~WiFiClient();
+  virtual int connect(const char* host, uint16_t port);
+  uint8_t connected();
+  void stop();
+  int available() override;
+  int read() override;
+  using Print::write;
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t* buffer, size_t size) override;
+  operator bool() { return connected(); }
+
+private:
+  FakeConnection* connection = nullptr;
+};
+
+class ESP8266WiFiClass {
+public:
+  wl_status_t status();
+  bool mode(WiFiMode_t mode);
+  WiFiMode_t getMode();
+  wl_status_t begin(const char* ssid, const char* password = nullptr, int32_t channel = 0,
+                    const uint8_t* bssid = nullptr, bool connect = true);
+  bool disconnect(bool wifiOff = false);
+  bool hostname(const char* name);
+  bool hostname(const String& name) { return hostname(name.c_str()); }
+  bool softAP(const char* ssid, const char* password = nullptr);
+  IPAddress softAPIP();
+  IPAddress localIP();
+  int32_t channel();
+  uint8_t* BSSID();
+  bool setSleepMode(WiFiSleepType_t type, uint8_t listenInterval = 0);
+  void persistent(bool persistent) { (void)persistent; }
+  int8_t scanNetworks(bool async = false, bool showHidden = false);
+  int8_t scanComplete();
+  void scanDelete();
+  String SSID(uint8_t index = 0);
+  int32_t RSSI(uint8_t index = 0);
+};
+
+extern ESP8266WiFiClass WiFi;
+
+#endif
@@ -0,0 +1,113 @@
+/*
+ * Host Firebase ESP8266 Client for ToxiRover
+ * The subset of the Firebase library the firmware calls, speaking REST over the loopback network
+ *
+ * Features:
+ * - Each FirebaseData owns a keep-alive TLS connection, as in the real library
+ * - Requests block until the response or the read timeout, on the virtual clock
+ * - Streams parse server-sent "put"/"patch" events into FirebaseJson
+ * - FirebaseJson is a flat path/value map: enough for add(), get() and updateNode()
+ */
+
+#ifndef FIREBASE_ESP8266_H
+#define FIREBASE_ESP8266_H
+
+#include <WiFiClientSecure.h>
+#include <utility>
+#include <vector>
+
+struct FirebaseJsonData {
+  bool success = false;
+  String type;
+  String stringValue;
+  int intValue = 0;
+  float floatValue = 0;
+  double doubleValue = 0;
+  bool boolValue = false;
+};
+
+class FirebaseJson {
+public:
+  FirebaseJson& add(const String& key, const String& value) { return setRaw(key, quote(value)); }
+  FirebaseJson& add(const String& key, const char* value) { return setRaw(key, quote(value)); }
+  FirebaseJson& add(const String& key, int value) { return setRaw(key, String(value)); }
+  FirebaseJson& add(const String& key, unsigned long value) { return setRaw(key, String(value)); }
+  FirebaseJson& add(const String& key, float value) { return setRaw(key, String(value, 6)); }
+  FirebaseJson& add(const String& key, double value) { return setRaw(key, String(value, 6)); }
+  FirebaseJson& add(const String& key, bool value) { return setRaw(key, value ? "true" : "false"); }
+  template <typename T>
+  void set(const String& path, T value) { add(path, value); }
+  void clear() { values.clear(); }
+  bool get(FirebaseJsonData& result, const String& path);
+  void toString(String& out) const;
+
+  // Parses a JSON document into path/value pairs; false on malformed text
+  bool setJsonData(const String& text);
+  size_t size() const { return values.size(); }
+
+private:
+  FirebaseJson& setRaw(const String& path, const String& raw);
+  static String quote(const String& text);
+
+  std::vector<std::pair<String, String>> values;  // path -> raw JSON value
+};
+
+class FirebaseData {
+public:
+  String stringData() const { return payload; }
+  int intData() const { return payload.toInt(); }
+  float floatData() const { return payload.toFloat(); }
+  String errorReason() const { return error; }
+  String dataPath() const { return eventPath; }
+  String dataType() const { return type; }
+  FirebaseJson& jsonObject() { return json; }
+  int httpCode() const { return status; }
+  bool streamTimeout() const { return timedOut; }
+  bool streamAvailable() const { return available; }
+
+private:
+  friend class FirebaseESP8266;
+
+  WiFiClientSecure client;
+  unsigned long readTimeout = 5000;
+  int status = 0;
+  String payload;
+  String type;
+  String error;
+  String eventPath;
+  FirebaseJson json;
+  bool streaming = false;
+  bool available = false;
+  bool timedOut = false;
+  unsigned long lastStreamByte = 0;
+  std::string streamBuffer;
+};
+
+class FirebaseESP8266 {
+public:
+  void begin(const char* host, const char* auth);
+  void reconnectWiFi(bool reconnect) { (void)reconnect; }
+  void setReadTimeout(FirebaseData& data, int timeoutMs) { data.readTimeout = timeoutMs; }
+  void setwriteSizeLimit(FirebaseData& data, const String& size) { (void)data; (void)size; }
+
+  bool getString(FirebaseData& data, const String& path);
+  bool setString(FirebaseData& data, const String& path, const String& value);
+  bool setInt(FirebaseData& data, const String& path, int value);
+  bool setFloat(FirebaseData& data, const String& path, float value);
+  bool setBool(FirebaseData& data, const String& path, bool value);
+  bool updateNode(FirebaseData& data, const String& path, FirebaseJson& json);
+  bool deleteNode(FirebaseData& data, const String& path);
+  bool beginStream(FirebaseData& data, const String& path);
+  bool readStream(FirebaseData& data);
+
+private:
+  bool request(FirebaseData& data, const char* method, const String& path, const String& body);
+  bool connect(FirebaseData& data);
+
+  String host;
+  String auth;
+};
+
+extern FirebaseESP8266 Firebase;
+
+#endif
@@ -0,0 +1,64 @@
+/*
+ * Host LittleFS for ToxiRover
+ * In-memory file system; contents survive fakeReboot() like flash does
+ *
+ * Features:
+ * - "r", "w", "a" and "r+" modes with a per-handle position
+ * - Optional capacity limit so full-disk paths can be tested
+ * - Byte counters for flash wear figures
+ */
+
+#ifndef LITTLEFS_H
+#define LITTLEFS_H
+
+#include <Arduino.h>
+#include <memory>
+#include <vector>
+
+enum SeekMode {
+  SeekSet = 0,
+  SeekCur = 1,
+  SeekEnd = 2
+};
+
+class File : public Stream {
+public:
+  File() {}
+  File(std::shared_ptr<std::vector<uint8_t>> contents, bool writable, size_t offset)
+      : contents(contents), writable(writable), offset(offset) {}
+
+  int available() override;
+  int read() override;
+  size_t read(uint8_t* buffer, size_t length);
+  int peek();
+  using Print::write;
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t* buffer, size_t length) override;
+  bool seek(uint32_t position, SeekMode mode = SeekSet);
+  size_t position() const { return offset; }
+  size_t size() const { return contents ? contents->size() : 0; }
+  bool truncate(uint32_t size);
+  void flush() {}
+  void close() { contents.reset(); }
+  operator bool() const { return (bool)contents; }
+
+private:
+  std::shared_ptr<std::vector<uint8_t>> contents;
+  bool writable = false;
+  size_t offset = 0;
+};
+
+class LittleFSClass {
+public:
+  bool begin();
+  void end() {}
+  bool format();
+  bool exists(const char* path);
+  File open(const char* path, const char* mode);
+  bool remove(const char* path);
+  bool rename(const char* from, const char* to);
+};
+
+extern LittleFSClass LittleFS;
+
+#endif
@@ -0,0 +1,29 @@
+/*
+ * Host NewPing for ToxiRover
+ * Echo time comes from the pulse scripted on the echo pin (fakeSetEcho)
+ */
+
+#ifndef NEWPING_H
+#define NEWPING_H
+
+#include <Arduino.h>
+
+#define US_ROUNDTRIP_CM 57
+#define NO_ECHO 0
+
+class NewPing {
+public:
+  NewPing(uint8_t trigger, uint8_t echo, unsigned int maxCm = 500)
+      : triggerPin(trigger), echoPin(echo), maxDistance(maxCm) {}
+  unsigned int ping();
+  static unsigned int convert_cm(unsigned int echoUs) {
+    return echoUs == 0 ? 0 : max(echoUs / US_ROUNDTRIP_CM, 1u);
+  }
+
+private:
+  uint8_t triggerPin;
+  uint8_t echoPin;
+  unsigned int maxDistance;
+};
+
+#endif
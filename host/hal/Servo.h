@@ -0,0 +1,24 @@
+/*
+ * Host Servo for ToxiRover
+ * Keeps the commanded angle; fakeServoWrites() counts every write for tests
+ */
+
+#ifndef SERVO_H
+#define SERVO_H
+
+#include <Arduino.h>
+
+class Servo {
+public:
+  uint8_t attach(int pin);
+  void detach();
+  void write(int value);
+  int read() { return angle; }
+  bool attached() { return pin >= 0; }
+
+private:
+  int pin = -1;
+  int angle = 90;
+};
+
+#endif
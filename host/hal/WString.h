@@ -0,0 +1,108 @@
+/*
+ * Host String for ToxiRover
+ * Arduino String on top of std::string; allocations show up in the host heap counter
+ */
+
+#ifndef WSTRING_H
+#define WSTRING_H
+
+#include <stdlib.h>
+#include <string>
+
+class String {
+public:
+  String() {}
+  String(const char* text) : value(text ? text : "") {}
+  String(const std::string& text) : value(text) {}
+  explicit String(char c) : value(1, c) {}
+  explicit String(int number, unsigned char base = 10) : value(format((long)number, base)) {}
+  explicit String(unsigned int number, unsigned char base = 10) : value(formatUnsigned(number, base)) {}
+  explicit String(long number, unsigned char base = 10) : value(format(number, base)) {}
+  explicit String(unsigned long number, unsigned char base = 10) : value(formatUnsigned(number, base)) {}
+  explicit String(unsigned char number, unsigned char base = 10) : value(formatUnsigned(number, base)) {}
+  explicit String(float number, unsigned char decimals = 2) : value(formatFloat(number, decimals)) {}
+  explicit String(double number, unsigned char decimals = 2) : value(formatFloat(number, decimals)) {}
+
+  const char* c_str() const { return value.c_str(); }
+  unsigned int length() const { return (unsigned int)value.size(); }
+  bool isEmpty() const { return value.empty(); }
+  bool reserve(unsigned int size) { value.reserve(size); return true; }
+
+  char charAt(unsigned int index) const { return index < value.size() ? value[index] : '\0'; }
+  char operator[](unsigned int index) const { return charAt(index); }
+  char& operator[](unsigned int index) { return value[index]; }
+
+  String& operator=(const char* text) { value = text ? text : ""; return *this; }
+  String& operator+=(const String& other) { value += other.value; return *this; }
+  String& operator+=(const char* text) { if (text) value += text; return *this; }
+  String& operator+=(char c) { value += c; return *this; }
+  String& operator+=(int number) { value += format(number, 10); return *this; }
+  String& operator+=(unsigned int number) { value += formatUnsigned(number, 10); return *this; }
+  String& operator+=(long number) { value += format(number, 10); return *this; }
+  String& operator+=(unsigned long number) { value += formatUnsigned(number, 10); return *this; }
+  bool concat(const String& other) { value += other.value; return true; }
+
+  bool operator==(const String& other) const { return value == other.value; }
+  bool operator==(const char* text) const { return value == (text ? text : ""); }
+  bool operator!=(const String& other) const { return value != other.value; }
+  bool operator!=(const char* text) const { return !(*this == text); }
+  bool equals(const String& other) const { return value == other.value; }
+  bool startsWith(const String& prefix) const { return value.compare(0, prefix.value.size(), prefix.value) == 0; }
+  bool endsWith(const String& suffix) const {
+    return value.size() >= suffix.value.size() &&
+           value.compare(value.size() - suffix.value.size(), suffix.value.size(), suffix.value) == 0;
+  }
+
+  int indexOf(char c, unsigned int from = 0) const {
+    size_t at = value.find(c, from);
+    return at == std::string::npos ? -1 : (int)at;
+  }
+  int indexOf(const String& text, unsigned int from = 0) const {
+    size_t at = value.find(text.value, from);
+    return at == std::string::npos ? -1 : (int)at;
+  }
+  String substring(unsigned int from) const { return from < value.size() ? String(value.substr(from)) : String(); }
+  String substring(unsigned int from, unsigned int to) const {
+    if (from > to || from >= value.size()) return String();
+    return String(value.substr(from, to - from));
+  }
+  void trim() {
+    size_t begin = value.find_first_not_of(" \t\r\n");
+    size_t end = value.find_last_not_of(" \t\r\n");
+    value = begin == std::string::npos ? "" : value.substr(begin, end - begin + 1);
+  }
+  long toInt() const { return atol(value.c_str()); }
+  float toFloat() const { return (float)atof(value.c_str()); }
+
+  friend String operator+(const String& a, const String& b) { return String(a.value + b.value); }
+  friend String operator+(const String& a, const char* b) { return String(a.value + (b ? b : "")); }
+  friend String operator+(const char* a, const String& b) { return String((a ? a : "") + b.value); }
+  friend String operator+(const String& a, char b) { return String(a.value + b); }
+
+private:
+  std::string value;
+
+  static std::string formatUnsigned(unsigned long number, unsigned char base) {
+    char text[33];
+    char* p = text + sizeof(text) - 1;
+    *p = '\0';
+    if (base < 2) base = 10;
+    do {
+      unsigned digit = number % base;
+      *--p = (char)(digit < 10 ? '0' + digit : 'A' + digit - 10);
+      number /= base;
+    } while (number);
+    return p;
+  }
+  static std::string format(long number, unsigned char base) {
+    if (number < 0 && base == 10) return "-" + formatUnsigned((unsigned long)-number, base);
+    return formatUnsigned((unsigned long)number, base);
+  }
+  static std::string formatFloat(double number, unsigned char decimals) {
+    char text[48];
+    snprintf(text, sizeof(text), "%.*f", decimals, number);
+    return text;
+  }
+};
+
+#endif
@@ -0,0 +1,17 @@
+/*
+ * Host WiFiClientSecure for ToxiRover
+ * TLS client over the loopback network; the handshake costs one endpoint round trip
+ */
+
+#ifndef WIFICLIENTSECURE_H
+#define WIFICLIENTSECURE_H
+
+#include <ESP8266WiFi.h>
+
+class WiFiClientSecure : public WiFiClient {
+public:
+  void setInsecure() {}
+  void setBufferSizes(int receive, int transmit) { (void)receive; (void)transmit; }
+};
+
+#endif
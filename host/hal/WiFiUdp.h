@@ -0,0 +1,36 @@
+/*
+ * Host WiFiUDP for ToxiRover
+ * Datagrams loop back to sockets bound to the destination port in this process
+ *
+ * Features:
+ * - Broadcast and unicast both deliver to every socket bound to the port
+ * - Tests inject frames from other rovers with fakeUdpInject()
+ */
+
+#ifndef WIFIUDP_H
+#define WIFIUDP_H
+
+#include <ESP8266WiFi.h>
+#include <vector>
+
+class WiFiUDP {
+public:
+  ~WiFiUDP() { stop(); }
+  uint8_t begin(uint16_t port);
+  void stop();
+  int beginPacket(IPAddress ip, uint16_t port);
+  size_t write(const uint8_t* buffer, size_t size);
+  int endPacket();
+  int parsePacket();
+  int read(uint8_t* buffer, size_t length);
+  int available() { return (int)(current.size() - readPos); }
+
+private:
+  uint16_t localPort = 0;
+  uint16_t sendPort = 0;
+  std::vector<uint8_t> outgoing;
+  std::vector<uint8_t> current;
+  size_t readPos = 0;
+};
+
+#endif
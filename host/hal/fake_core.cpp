@@ -0,0 +1,478 @@
+/*
+ * Fake Core Implementation for ToxiRover host builds
+ */
+
+#include "fake_hal.h"
+#include "fake_internal.h"
+#include "user_interface.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <new>
+
+HardwareSerial Serial;
+EspClass ESP;
+
+FakeCoreState fakeCore;
+
+// ---------------------------------------------------------------- heap counter
+
+static std::atomic<unsigned long> heapAllocations(0);
+static std::atomic<unsigned long> heapFrees(0);
+static std::atomic<long> heapLiveBytes(0);
+static std::atomic<long> heapPeakBytes(0);
+
+// Each block carries its size in front so delete can account for it; the top
+// bit marks blocks the fake itself allocated (see FakeUntrackedHeap)
+static const size_t HEAP_HEADER = alignof(std::max_align_t);
+static const size_t HEAP_UNTRACKED = (size_t)1 << (sizeof(size_t) * 8 - 1);
+
+thread_local int FakeUntrackedHeap::depth = 0;
+
+static void* countedAlloc(size_t size) {
+  unsigned char* block = (unsigned char*)malloc(size + HEAP_HEADER);
+  if (!block) throw std::bad_alloc();
+  if (FakeUntrackedHeap::depth > 0) {
+    *(size_t*)block = size | HEAP_UNTRACKED;
+    return block + HEAP_HEADER;
+  }
+  *(size_t*)block = size;
+  heapAllocations++;
+  long live = heapLiveBytes += (long)size;
+  long peak = heapPeakBytes.load();
+  while (live > peak && !heapPeakBytes.compare_exchange_weak(peak, live)) {}
+  return block + HEAP_HEADER;
+}
+
+static void countedFree(void* pointer) {
+  if (!pointer) return;
+  unsigned char* block = (unsigned char*)pointer - HEAP_HEADER;
+  size_t size = *(size_t*)block;
+  if (!(size & HEAP_UNTRACKED)) {
+    heapFrees++;
+    heapLiveBytes -= (long)size;
+  }
+  free(block);
+}
+
+void* operator new(size_t size) { return countedAlloc(size); }
+void* operator new[](size_t size) { return countedAlloc(size); }
+void operator delete(void* pointer) noexcept { countedFree(pointer); }
+void operator delete[](void* pointer) noexcept { countedFree(pointer); }
+void operator delete(void* pointer, size_t) noexcept { countedFree(pointer); }
+void operator delete[](void* pointer, size_t) noexcept { countedFree(pointer); }
+
+FakeHeapStats fakeHeapStats() {
+  return {heapAllocations.load(), heapFrees.load(), heapLiveBytes.load(), heapPeakBytes.load()};
+}
+
+// ---------------------------------------------------------------- clock
+
+unsigned long millis() {
+  return (unsigned long)(fakeCore.micros / 1000);
+}
+
+unsigned long micros() {
+  return (unsigned long)fakeCore.micros;
+}
+
+void fakeAdvanceMicros(unsigned long us) {
+  fakeCore.micros += us;
+}
+
+void fakeAdvanceMillis(unsigned long ms) {
+  fakeCore.micros += (uint64_t)ms * 1000;
+}
+
+void delay(unsigned long ms) {
+  fakeAdvanceMillis(ms);
+}
+
+void delayMicroseconds(unsigned int us) {
+  fakeAdvanceMicros(us);
+}
+
+void yield() {
+}
+
+#if defined(__GLIBC__) && !__GLIBC_PREREQ(2, 38)
+size_t strlcpy(char* dst, const char* src, size_t size) {
+  size_t length = strlen(src);
+  if (size > 0) {
+    size_t n = length < size - 1 ? length : size - 1;
+    memcpy(dst, src, n);
+    dst[n] = '\0';
+  }
+  return length;
+}
+#endif
+
+char* dtostrf(double number, signed char width, unsigned char precision, char* out) {
+  sprintf(out, "%*.*f", width, precision, number);
+  return out;
+}
+
+// ---------------------------------------------------------------- pins
+
+static FakePin& pinState(uint8_t pin) {
+  return fakeCore.pins[pin % FAKE_PIN_COUNT];
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  pinState(pin).mode = mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+  FakePin& state = pinState(pin);
+  state.output = value ? HIGH : LOW;
+  state.pwm = 0;
+  state.writes++;
+}
+
+int digitalRead(uint8_t pin) {
+  FakePin& state = pinState(pin);
+  return state.mode == OUTPUT ? state.output : state.input;
+}
+
+int analogRead(uint8_t pin) {
+  FakePin& state = pinState(pin);
+  return state.analogSource ? state.analogSource(millis()) : state.analog;
+}
+
+void analogWrite(uint8_t pin, int value) {
+  FakePin& state = pinState(pin);
+  state.pwm = value;
+  state.output = value > 0 ? HIGH : LOW;
+  state.writes++;
+}
+
+unsigned long fakeEchoMicros(uint8_t pin) {
+  FakePin& state = pinState(pin);
+  return state.echoSource ? (unsigned long)state.echoSource(millis()) : state.echoUs;
+}
+
+// The echo pulse takes as long as it lasts; no echo waits out the timeout
+unsigned long pulseIn(uint8_t pin, uint8_t level, unsigned long timeout) {
+  (void)level;
+  unsigned long echo = fakeEchoMicros(pin);
+  if (echo == 0 || echo > timeout) {
+    fakeAdvanceMicros(timeout);
+    return 0;
+  }
+  fakeAdvanceMicros(echo);
+  return echo;
+}
+
+void attachInterrupt(uint8_t interrupt, void (*isr)(), int mode) {
+  FakePin& state = pinState(interrupt);
+  state.isr = isr;
+  state.isrMode = mode;
+}
+
+void detachInterrupt(uint8_t interrupt) {
+  pinState(interrupt).isr = nullptr;
+}
+
+void fakeSetDigital(uint8_t pin, int level) {
+  FakePin& state = pinState(pin);
+  int previous = state.input;
+  state.input = level ? HIGH : LOW;
+  if (!state.isr || previous == state.input) return;
+  bool rising = state.input == HIGH;
+  if (state.isrMode == CHANGE || (state.isrMode == RISING && rising) || (state.isrMode == FALLING && !rising)) {
+    state.isr();
+  }
+}
+
+void fakeSetAnalog(uint8_t pin, int counts) {
+  pinState(pin).analog = counts;
+  pinState(pin).analogSource = nullptr;
+}
+
+void fakeSetAnalogSource(uint8_t pin, FakeSignalSource source) {
+  pinState(pin).analogSource = source;
+}
+
+void fakeSetEcho(uint8_t pin, unsigned long echoUs) {
+  pinState(pin).echoUs = echoUs;
+  pinState(pin).echoSource = nullptr;
+}
+
+void fakeSetEchoSource(uint8_t pin, FakeSignalSource source) {
+  pinState(pin).echoSource = source;
+}
+
+int fakePinLevel(uint8_t pin) { return pinState(pin).output; }
+int fakePinMode(uint8_t pin) { return pinState(pin).mode; }
+int fakePwm(uint8_t pin) { return pinState(pin).pwm; }
+unsigned long fakePinWrites(uint8_t pin) { return pinState(pin).writes; }
+
+void wifi_enable_gpio_wakeup(uint32_t pin, GPIO_INT_TYPE type) {
+  (void)type;
+  fakeCore.wakeupPin = pin;
+}
+
+void wifi_disable_gpio_wakeup() {
+  fakeCore.wakeupPin = 0xFFFFFFFF;
+}
+
+uint32_t fakeGpioWakeupPin() {
+  return fakeCore.wakeupPin;
+}
+
+// ---------------------------------------------------------------- random
+
+static uint32_t nextRandom() {
+  // xorshift32: repeatable across hosts, unlike rand()
+  uint32_t x = fakeCore.randomState;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  fakeCore.randomState = x;
+  return x;
+}
+
+long random(long howBig) {
+  if (howBig <= 0) return 0;
+  return (long)(nextRandom() % (uint32_t)howBig);
+}
+
+long random(long howSmall, long howBig) {
+  if (howSmall >= howBig) return howSmall;
+  return howSmall + random(howBig - howSmall);
+}
+
+void randomSeed(unsigned long seed) {
+  fakeCore.randomState = seed ? (uint32_t)seed : 1;
+}
+
+uint32_t fakeHardwareRandom() {
+  return nextRandom();
+}
+
+// ---------------------------------------------------------------- print / stream
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+  size_t n = 0;
+  while (size--) n += write(*buffer++);
+  return n;
+}
+
+size_t Print::print(long value, int base) {
+  if (base == DEC) {
+    char text[24];
+    snprintf(text, sizeof(text), "%ld", value);
+    return write(text);
+  }
+  return print((unsigned long)value, base);
+}
+
+size_t Print::print(unsigned long value, int base) {
+  char text[24];
+  snprintf(text, sizeof(text), base == HEX ? "%lX" : "%lu", value);
+  return write(text);
+}
+
+size_t Print::print(double value, int digits) {
+  char text[48];
+  snprintf(text, sizeof(text), "%.*f", digits, value);
+  return write(text);
+}
+
+// Blocking reads wait on the virtual clock, like the SDK's timed reads
+size_t Stream::readBytes(char* buffer, size_t length) {
+  size_t count = 0;
+  unsigned long start = millis();
+  while (count < length) {
+    int c = read();
+    if (c < 0) {
+      if (millis() - start >= streamTimeout) break;
+      delay(1);
+      continue;
+    }
+    buffer[count++] = (char)c;
+  }
+  return count;
+}
+
+size_t Stream::readBytesUntil(char terminator, char* buffer, size_t length) {
+  size_t count = 0;
+  unsigned long start = millis();
+  while (count < length) {
+    int c = read();
+    if (c < 0) {
+      if (millis() - start >= streamTimeout) break;
+      delay(1);
+      continue;
+    }
+    if (c == terminator) break;
+    buffer[count++] = (char)c;
+  }
+  return count;
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+  return write(&c, 1);
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+  FakeUntrackedHeap untracked;
+  fakeCore.serialOutput.append((const char*)buffer, size);
+  if (fakeCore.serialEcho) fwrite(buffer, 1, size, stdout);
+  return size;
+}
+
+int HardwareSerial::available() {
+  return (int)(fakeCore.serialInput.size() - fakeCore.serialInputPos);
+}
+
+int HardwareSerial::read() {
+  if (fakeCore.serialInputPos >= fakeCore.serialInput.size()) return -1;
+  return (unsigned char)fakeCore.serialInput[fakeCore.serialInputPos++];
+}
+
+const std::string& fakeSerialOutput() {
+  return fakeCore.serialOutput;
+}
+
+void fakeSerialClear() {
+  fakeCore.serialOutput.clear();
+}
+
+void fakeSerialInput(const char* text) {
+  FakeUntrackedHeap untracked;
+  fakeCore.serialInput.append(text);
+}
+
+void fakeSerialEcho(bool echo) {
+  fakeCore.serialEcho = echo;
+}
+
+// ---------------------------------------------------------------- ESP
+
+uint32_t EspClass::getChipId() {
+  return fakeCore.chipId;
+}
+
+// Host time, scaled to the ESP8266's 80 MHz; the virtual clock does not move inside a benchmark
+uint32_t EspClass::getCycleCount() {
+  auto now = std::chrono::steady_clock::now().time_since_epoch();
+  return (uint32_t)(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count() * 80 / 1000);
+}
+
+uint32_t EspClass::getFreeHeap() {
+  long free = FAKE_HEAP_SIZE - heapLiveBytes.load() + fakeCore.heapBaseline;
+  return free > 0 ? (uint32_t)free : 0;
+}
+
+uint8_t EspClass::getHeapFragmentation() {
+  return 0;
+}
+
+uint32_t EspClass::getSketchSize() {
+  return 400000;
+}
+
+uint32_t EspClass::getFreeSketchSpace() {
+  return 600000;
+}
+
+bool EspClass::rtcUserMemoryRead(uint32_t offset, uint32_t* data, size_t size) {
+  if (offset * 4 + size > FAKE_RTC_USER_BYTES) return false;
+  memcpy(data, fakeCore.rtcMemory + offset * 4, size);
+  return true;
+}
+
+bool EspClass::rtcUserMemoryWrite(uint32_t offset, uint32_t* data, size_t size) {
+  if (offset * 4 + size > FAKE_RTC_USER_BYTES) return false;
+  memcpy(fakeCore.rtcMemory + offset * 4, data, size);
+  return true;
+}
+
+rst_info* EspClass::getResetInfoPtr() {
+  return &fakeCore.resetInfo;
+}
+
+String EspClass::getResetReason() {
+  static const char* const NAMES[] = {
+    "Power On", "Hardware Watchdog", "Exception", "Software Watchdog",
+    "Software/System restart", "Deep-Sleep Wake", "External System"
+  };
+  uint32_t reason = fakeCore.resetInfo.reason;
+  return reason < sizeof(NAMES) / sizeof(NAMES[0]) ? NAMES[reason] : "Unknown";
+}
+
+void EspClass::restart() {
+  fakeCore.restarts++;
+}
+
+void fakeSetChipId(uint32_t chipId) {
+  fakeCore.chipId = chipId;
+}
+
+void fakeSetResetReason(uint32_t reason) {
+  fakeCore.resetInfo.reason = reason;
+}
+
+unsigned long fakeRestarts() {
+  return fakeCore.restarts;
+}
+
+// ---------------------------------------------------------------- time
+
+void configTime(int timezone, int daylightOffsetSec, const char* server1, const char* server2, const char* server3) {
+  (void)timezone; (void)daylightOffsetSec; (void)server1; (void)server2; (void)server3;
+  fakeCore.sntpStarted = true;
+}
+
+void fakeSetNtpReachable(bool reachable) {
+  fakeCore.ntpReachable = reachable;
+}
+
+void fakeSetEpoch(time_t epochSeconds) {
+  fakeCore.epochAtZeroMicros = (uint64_t)epochSeconds * 1000000 - fakeCore.micros;
+  fakeCore.epochValid = true;
+}
+
+// SNTP answers on the first query after the network is up
+static void serviceSntp() {
+  if (fakeCore.epochValid || !fakeCore.sntpStarted || !fakeCore.ntpReachable) return;
+  if (!fakeWiFiConnected()) return;
+  fakeSetEpoch(FAKE_NTP_EPOCH);
+}
+
+time_t fakeTime(time_t* out) {
+  serviceSntp();
+  uint64_t now = fakeCore.micros + (fakeCore.epochValid ? fakeCore.epochAtZeroMicros : 0);
+  time_t seconds = (time_t)(now / 1000000);
+  if (out) *out = seconds;
+  return seconds;
+}
+
+int fakeGettimeofday(struct timeval* tv, void* tz) {
+  (void)tz;
+  serviceSntp();
+  uint64_t now = fakeCore.micros + (fakeCore.epochValid ? fakeCore.epochAtZeroMicros : 0);
+  tv->tv_sec = (time_t)(now / 1000000);
+  tv->tv_usec = (suseconds_t)(now % 1000000);
+  return 0;
+}
+
+// ---------------------------------------------------------------- reset
+
+void fakeResetCore() {
+  fakeCore = FakeCoreState();
+  fakeCore.heapBaseline = heapLiveBytes.load();
+}
+
+unsigned long fakeServoWrites() {
+  return fakeCore.servoWrites;
+}
+
+void fakeReset() {
+  fakeResetCore();
+  fakeResetNetwork();
+  fakeResetStorage();
+}
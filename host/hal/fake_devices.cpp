@@ -0,0 +1,34 @@
+/*
+ * Fake Servo and Sonar Implementation for ToxiRover host builds
+ */
+
+#include "fake_internal.h"
+#include <Servo.h>
+#include <NewPing.h>
+
+uint8_t Servo::attach(int servoPin) {
+  pin = servoPin;
+  return 1;
+}
+
+void Servo::detach() {
+  pin = -1;
+}
+
+void Servo::write(int value) {
+  angle = constrain(value, 0, 180);
+  fakeCore.servoWrites++;
+}
+
+// NewPing gives up past the configured range and reports no echo
+unsigned int NewPing::ping() {
+  (void)triggerPin;
+  unsigned long echo = fakeEchoMicros(echoPin);
+  unsigned long maxEcho = (unsigned long)maxDistance * US_ROUNDTRIP_CM + US_ROUNDTRIP_CM / 2;
+  if (echo == 0 || echo > maxEcho) {
+    fakeAdvanceMicros(maxEcho);
+    return NO_ECHO;
+  }
+  fakeAdvanceMicros(echo);
+  return (unsigned int)echo;
+}
@@ -0,0 +1,269 @@
+/*
+ * Fake Firebase Library Implementation for ToxiRover host builds
+ */
+
+#include <FirebaseESP8266.h>
+#include "fake_json.h"
+
+FirebaseESP8266 Firebase;
+
+#define FAKE_FIREBASE_PORT 443
+#define FAKE_STREAM_KEEPALIVE_TIMEOUT 45000  // the server sends keep-alive every 30 s
+
+// ---------------------------------------------------------------- FirebaseJson
+
+String FirebaseJson::quote(const String& text) {
+  return String(fakeJsonQuote(text.c_str()));
+}
+
+FirebaseJson& FirebaseJson::setRaw(const String& path, const String& raw) {
+  for (auto& value : values) {
+    if (value.first == path) {
+      value.second = raw;
+      return *this;
+    }
+  }
+  values.push_back({path, raw});
+  return *this;
+}
+
+bool FirebaseJson::get(FirebaseJsonData& result, const String& path) {
+  result = FirebaseJsonData();
+  for (const auto& value : values) {
+    if (value.first != path) continue;
+    std::string raw = value.second.c_str();
+    result.success = true;
+    if (!raw.empty() && raw[0] == '"') {
+      result.type = "string";
+      result.stringValue = String(fakeJsonUnquote(raw));
+    } else if (raw == "true" || raw == "false") {
+      result.type = "boolean";
+      result.boolValue = raw == "true";
+      result.stringValue = String(raw);
+    } else if (raw == "null") {
+      result.type = "null";
+    } else {
+      bool isInt = raw.find_first_of(".eE") == std::string::npos;
+      result.type = isInt ? "int" : "double";
+      result.stringValue = String(raw);
+    }
+    result.doubleValue = atof(raw.c_str());
+    result.floatValue = (float)result.doubleValue;
+    result.intValue = (int)result.doubleValue;
+    return true;
+  }
+  return false;
+}
+
+void FirebaseJson::toString(String& out) const {
+  std::string text = "{";
+  for (size_t i = 0; i < values.size(); i++) {
+    if (i > 0) text += ",";
+    text += fakeJsonQuote(values[i].first.c_str()) + ":" + values[i].second.c_str();
+  }
+  out = String(text + "}");
+}
+
+bool FirebaseJson::setJsonData(const String& text) {
+  FakeJsonLeaves leaves;
+  values.clear();
+  if (!fakeJsonFlatten(text.c_str(), leaves)) return false;
+  for (const auto& leaf : leaves) values.push_back({String(leaf.first), String(leaf.second)});
+  return true;
+}
+
+// ---------------------------------------------------------------- REST
+
+void FirebaseESP8266::begin(const char* databaseHost, const char* databaseAuth) {
+  host = databaseHost;
+  auth = databaseAuth;
+}
+
+bool FirebaseESP8266::connect(FirebaseData& data) {
+  if (data.client.connected()) return true;
+  data.client.setTimeout(data.readTimeout);
+  if (data.client.connect(host.c_str(), FAKE_FIREBASE_PORT)) return true;
+  data.status = -1;
+  data.error = "connection refused";
+  return false;
+}
+
+static bool readHead(WiFiClient& client, int& status, long& contentLength) {
+  char line[256];
+  size_t n = client.readBytesUntil('\n', line, sizeof(line) - 1);
+  line[n] = '\0';
+  if (n < 12 || strncmp(line, "HTTP/1.1 ", 9) != 0) return false;
+  status = atoi(line + 9);
+  contentLength = -1;
+  while (true) {
+    n = client.readBytesUntil('\n', line, sizeof(line) - 1);
+    line[n] = '\0';
+    if (n == 0) return false;
+    if (strcmp(line, "\r") == 0) return true;
+    if (strncasecmp(line, "Content-Length:", 15) == 0) contentLength = atol(line + 15);
+  }
+}
+
+// One keep-alive round trip; blocks up to the read timeout like the library does
+bool FirebaseESP8266::request(FirebaseData& data, const char* method, const String& path, const String& body) {
+  data.payload = "";
+  data.type = "";
+  data.error = "";
+  if (!connect(data)) return false;
+
+  String head = String(method) + " " + path + ".json?auth=" + auth + " HTTP/1.1\r\nHost: " + host +
+                "\r\nConnection: keep-alive\r\nContent-Length: " + String(body.length()) + "\r\n\r\n";
+  if (data.client.write((const uint8_t*)head.c_str(), head.length()) != head.length() ||
+      data.client.write((const uint8_t*)body.c_str(), body.length()) != body.length()) {
+    data.client.stop();
+    data.status = -1;
+    data.error = "send request failed";
+    return false;
+  }
+
+  long contentLength;
+  if (!readHead(data.client, data.status, contentLength)) {
+    data.client.stop();
+    data.status = -4;
+    data.error = "read Timeout";
+    return false;
+  }
+
+  std::string text;
+  if (contentLength > 0) {
+    text.resize(contentLength);
+    text.resize(data.client.readBytes(&text[0], contentLength));
+  }
+  data.payload = String(fakeJsonUnquote(text));
+  data.type = !text.empty() && text[0] == '"' ? "string" : !text.empty() && text[0] == '{' ? "json" : "int";
+  if (data.status != 200) {
+    data.error = String("bad request, status ") + String(data.status);
+    return false;
+  }
+  return true;
+}
+
+bool FirebaseESP8266::getString(FirebaseData& data, const String& path) {
+  return request(data, "GET", path, "");
+}
+
+bool FirebaseESP8266::setString(FirebaseData& data, const String& path, const String& value) {
+  return request(data, "PUT", path, String(fakeJsonQuote(value.c_str())));
+}
+
+bool FirebaseESP8266::setInt(FirebaseData& data, const String& path, int value) {
+  return request(data, "PUT", path, String(value));
+}
+
+bool FirebaseESP8266::setFloat(FirebaseData& data, const String& path, float value) {
+  return request(data, "PUT", path, String(value, 6));
+}
+
+bool FirebaseESP8266::setBool(FirebaseData& data, const String& path, bool value) {
+  return request(data, "PUT", path, value ? "true" : "false");
+}
+
+bool FirebaseESP8266::updateNode(FirebaseData& data, const String& path, FirebaseJson& json) {
+  String body;
+  json.toString(body);
+  return request(data, "PATCH", path, body);
+}
+
+bool FirebaseESP8266::deleteNode(FirebaseData& data, const String& path) {
+  return request(data, "DELETE", path, "");
+}
+
+// ---------------------------------------------------------------- streaming
+
+bool FirebaseESP8266::beginStream(FirebaseData& data, const String& path) {
+  data.streaming = false;
+  data.streamBuffer.clear();
+  data.client.stop();
+  if (!connect(data)) return false;
+
+  String head = "GET " + path + ".json?auth=" + auth + " HTTP/1.1\r\nHost: " + host +
+                "\r\nAccept: text/event-stream\r\nConnection: keep-alive\r\n\r\n";
+  data.client.write((const uint8_t*)head.c_str(), head.length());
+  long contentLength;
+  if (!readHead(data.client, data.status, contentLength) || data.status != 200) {
+    data.client.stop();
+    data.error = "stream connection failed";
+    return false;
+  }
+  data.streaming = true;
+  data.lastStreamByte = millis();
+  return true;
+}
+
+// Non-blocking: consumes what has arrived and reports at most one event
+bool FirebaseESP8266::readStream(FirebaseData& data) {
+  data.available = false;
+  data.timedOut = false;
+  if (!data.streaming || !data.client.connected()) {
+    data.streaming = false;
+    data.error = "connection lost";
+    return false;
+  }
+
+  while (data.client.available() > 0) {
+    data.streamBuffer += (char)data.client.read();
+    data.lastStreamByte = millis();
+  }
+
+  size_t end;
+  while ((end = data.streamBuffer.find("\n\n")) != std::string::npos) {
+    std::string event = data.streamBuffer.substr(0, end);
+    data.streamBuffer.erase(0, end + 2);
+
+    std::string name, payload;
+    size_t start = 0;
+    while (start < event.size()) {
+      size_t lineEnd = event.find('\n', start);
+      if (lineEnd == std::string::npos) lineEnd = event.size();
+      std::string line = event.substr(start, lineEnd - start);
+      if (line.compare(0, 7, "event: ") == 0) name = line.substr(7);
+      else if (line.compare(0, 6, "data: ") == 0) payload = line.substr(6);
+      start = lineEnd + 1;
+    }
+    if (name != "put" && name != "patch") continue;  // keep-alive, cancel, auth_revoked
+
+    FakeJsonLeaves leaves;
+    if (!fakeJsonFlatten(payload, leaves)) continue;
+    std::string eventPath = "/";
+    std::string prefix = "data/";
+    FakeJsonLeaves dataLeaves;
+    for (const auto& leaf : leaves) {
+      if (leaf.first == "path") eventPath = fakeJsonUnquote(leaf.second);
+      else if (leaf.first == "data") dataLeaves.push_back({"", leaf.second});
+      else if (leaf.first.compare(0, prefix.size(), prefix) == 0) {
+        dataLeaves.push_back({leaf.first.substr(prefix.size()), leaf.second});
+      }
+    }
+
+    data.eventPath = String(eventPath);
+    data.json.clear();
+    if (dataLeaves.size() == 1 && dataLeaves[0].first.empty()) {
+      const std::string& raw = dataLeaves[0].second;
+      data.payload = String(fakeJsonUnquote(raw));
+      data.type = raw[0] == '"' ? "string" : raw == "null" ? "null" :
+                  raw.find('.') != std::string::npos ? "float" : "int";
+    } else {
+      std::string rebuilt = "{";
+      for (size_t i = 0; i < dataLeaves.size(); i++) {
+        if (i > 0) rebuilt += ",";
+        rebuilt += fakeJsonQuote(dataLeaves[i].first) + ":" + dataLeaves[i].second;
+      }
+      data.json.setJsonData(String(rebuilt + "}"));
+      data.payload = String(rebuilt + "}");
+      data.type = "json";
+    }
+    data.available = true;
+    return true;
+  }
+
+  if (millis() - data.lastStreamByte > FAKE_STREAM_KEEPALIVE_TIMEOUT) {
+    data.timedOut = true;
+    data.lastStreamByte = millis();
+  }
+  return true;
+}
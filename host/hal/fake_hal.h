@@ -0,0 +1,151 @@
+/*
+ * Fake HAL Control for ToxiRover
+ * What host tests use to drive the fake Arduino/ESP8266 core
+ *
+ * Features:
+ * - Virtual clock: advance time without sleeping
+ * - Scriptable digital levels (with interrupts), ADC counts and echo pulses
+ * - Serial capture and injected Serial input
+ * - Loopback network: in-process TCP endpoints, UDP ports, web server requests, MQTT broker
+ * - Flash (EEPROM + LittleFS + RTC memory) that survives a simulated reboot
+ * - Heap allocation counter behind ESP.getFreeHeap()
+ */
+
+#ifndef FAKE_HAL_H
+#define FAKE_HAL_H
+
+#include <Arduino.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+// ---------------------------------------------------------------- clock
+void fakeAdvanceMillis(unsigned long ms);
+void fakeAdvanceMicros(unsigned long us);
+
+// ---------------------------------------------------------------- pins
+typedef int (*FakeSignalSource)(unsigned long ms);
+
+void fakeSetDigital(uint8_t pin, int level);  // input level; fires an attached interrupt on its edge
+void fakeSetAnalog(uint8_t pin, int counts);
+void fakeSetAnalogSource(uint8_t pin, FakeSignalSource source);  // counts as a function of millis()
+void fakeSetEcho(uint8_t pin, unsigned long echoUs);              // pulseIn()/NewPing echo time, 0 = none
+void fakeSetEchoSource(uint8_t pin, FakeSignalSource source);
+int fakePinLevel(uint8_t pin);       // last digitalWrite()
+int fakePinMode(uint8_t pin);
+int fakePwm(uint8_t pin);            // last analogWrite(), 0 after a digitalWrite()
+unsigned long fakePinWrites(uint8_t pin);
+unsigned long fakeServoWrites();
+uint32_t fakeGpioWakeupPin();        // armed light-sleep wakeup pin, or 0xFFFFFFFF
+
+// ---------------------------------------------------------------- serial
+const std::string& fakeSerialOutput();
+void fakeSerialClear();
+void fakeSerialInput(const char* text);
+void fakeSerialEcho(bool echo);  // also copy output to stdout (default: HOST_SERIAL set)
+
+// ---------------------------------------------------------------- ESP
+void fakeSetChipId(uint32_t chipId);
+void fakeSetResetReason(uint32_t reason);
+unsigned long fakeRestarts();
+
+struct FakeHeapStats {
+  unsigned long allocations;
+  unsigned long frees;
+  long liveBytes;
+  long peakBytes;
+};
+
+FakeHeapStats fakeHeapStats();
+
+// ---------------------------------------------------------------- time
+void fakeSetNtpReachable(bool reachable);
+void fakeSetEpoch(time_t epochSeconds);  // wall clock at the current millis(), as if synced
+time_t fakeTime(time_t* out);
+int fakeGettimeofday(struct timeval* tv, void* tz);
+
+// ---------------------------------------------------------------- Wi-Fi
+void fakeWiFiSetReachable(bool reachable);  // whether begin() associates
+void fakeWiFiDrop();                        // access point goes away
+int fakeWiFiSleepMode();
+
+// ---------------------------------------------------------------- loopback TCP
+// One accepted connection; endpoints keep it to push data later (e.g. SSE)
+class FakeSocket {
+public:
+  void send(const std::string& bytes);  // delivered after the endpoint latency
+  void close();
+  bool isOpen() const { return open; }
+
+  std::string rx;                       // bytes the client can read
+  std::vector<unsigned long> rxReadyAt; // per byte, millis() when it arrives
+  size_t rxPos = 0;                     // next byte to read
+  bool open = true;
+  unsigned long latencyMs = 0;
+};
+
+class FakeEndpoint {
+public:
+  virtual ~FakeEndpoint() {}
+  virtual bool onConnect(std::shared_ptr<FakeSocket> socket) { (void)socket; return true; }
+  virtual void onData(std::shared_ptr<FakeSocket> socket, const std::string& bytes) = 0;
+  virtual void onClose(std::shared_ptr<FakeSocket> socket) { (void)socket; }
+
+  unsigned long latencyMs = 0;  // one way, per send
+  unsigned long connectMs = 0;  // handshake time charged to connect()
+};
+
+struct FakeNetStats {
+  unsigned long connects;
+  unsigned long refused;
+  unsigned long bytesSent;     // client to endpoint
+  unsigned long bytesReceived; // endpoint to client
+};
+
+void fakeNetListen(const char* host, uint16_t port, FakeEndpoint* endpoint);
+void fakeNetUnlisten(const char* host, uint16_t port);
+FakeNetStats fakeNetStats();
+
+// ---------------------------------------------------------------- UDP
+void fakeUdpInject(uint16_t port, const uint8_t* bytes, size_t length);
+unsigned long fakeUdpSent();
+
+// ---------------------------------------------------------------- web server
+struct FakeHttpResponse {
+  int code;
+  std::string contentType;
+  std::string body;
+};
+
+void fakeHttpRequest(uint16_t port, const char* uri);  // served by that port's next handleClient()
+bool fakeHttpResponse(uint16_t port, FakeHttpResponse& response);
+
+// ---------------------------------------------------------------- MQTT broker
+struct FakeMqttMessage {
+  std::string topic;
+  std::string payload;
+};
+
+void fakeMqttSetReachable(bool reachable);
+void fakeMqttInject(const char* topic, const char* payload);
+std::vector<FakeMqttMessage>& fakeMqttPublished();
+unsigned long fakeMqttConnects();  // connect() attempts, failed ones included
+
+// ---------------------------------------------------------------- flash
+void fakeEepromErase();
+uint8_t* fakeEepromFlash();
+unsigned long fakeEepromCommits();
+void fakeFsSetAvailable(bool available);
+void fakeFsSetCapacity(size_t bytes);  // 0 = unlimited
+size_t fakeFsUsed();
+unsigned long fakeFsBytesWritten();
+std::vector<uint8_t> fakeFsRead(const char* path);
+
+// Flash image for a simulated reboot into a fresh process
+bool fakeSaveFlashImage(const char* path);
+bool fakeLoadFlashImage(const char* path);
+
+// ---------------------------------------------------------------- reset
+void fakeReset();  // clock, pins, network, flash and counters back to power-on
+
+#endif
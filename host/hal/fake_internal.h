@@ -0,0 +1,68 @@
+/*
+ * Fake HAL Internals for ToxiRover host builds
+ * State shared between the fake core, network and storage files
+ */
+
+#ifndef FAKE_INTERNAL_H
+#define FAKE_INTERNAL_H
+
+#include "fake_hal.h"
+
+#define FAKE_PIN_COUNT 32
+#define FAKE_RTC_USER_BYTES 512
+#define FAKE_HEAP_SIZE 52000          // free heap an idle ESP8266 sketch starts with
+#define FAKE_NTP_EPOCH 1767225600     // 2026-01-01T00:00:00Z
+
+struct FakePin {
+  int mode = 0;
+  int output = LOW;
+  int input = LOW;
+  int pwm = 0;
+  int analog = 0;
+  unsigned long echoUs = 0;
+  FakeSignalSource analogSource = nullptr;
+  FakeSignalSource echoSource = nullptr;
+  void (*isr)() = nullptr;
+  int isrMode = 0;
+  unsigned long writes = 0;
+};
+
+// Allocations made while one of these is alive belong to the fake (captured
+// Serial output, flash contents) and stay out of the firmware's heap numbers
+struct FakeUntrackedHeap {
+  FakeUntrackedHeap() { depth++; }
+  ~FakeUntrackedHeap() { depth--; }
+  static thread_local int depth;
+};
+
+struct FakeCoreState {
+  uint64_t micros = 0;
+  FakePin pins[FAKE_PIN_COUNT];
+  uint32_t wakeupPin = 0xFFFFFFFF;
+  uint32_t randomState = 0x2545F491;
+  std::string serialOutput;
+  std::string serialInput;
+  size_t serialInputPos = 0;
+  bool serialEcho = getenv("HOST_SERIAL") != nullptr;
+  uint32_t chipId = 0x00C0FFEE;
+  rst_info resetInfo = {REASON_DEFAULT_RST};
+  uint8_t rtcMemory[FAKE_RTC_USER_BYTES] = {};
+  unsigned long restarts = 0;
+  bool sntpStarted = false;
+  bool ntpReachable = true;
+  bool epochValid = false;
+  uint64_t epochAtZeroMicros = 0;
+  long heapBaseline = 0;
+  unsigned long servoWrites = 0;
+};
+
+extern FakeCoreState fakeCore;
+
+unsigned long fakeEchoMicros(uint8_t pin);
+bool fakeWiFiConnected();
+
+void fakeResetCore();
+void fakeResetNetwork();
+void fakeResetStorage();
+
+#endif
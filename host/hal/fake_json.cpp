@@ -0,0 +1,150 @@
+/*
+ * Host JSON Helpers Implementation for ToxiRover
+ */
+
+#include "fake_json.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace {
+
+struct Parser {
+  const std::string& text;
+  size_t pos;
+
+  void skipSpace() {
+    while (pos < text.size() && isspace((unsigned char)text[pos])) pos++;
+  }
+
+  bool parseString(std::string& raw) {
+    size_t start = pos;
+    if (pos >= text.size() || text[pos] != '"') return false;
+    for (pos++; pos < text.size(); pos++) {
+      if (text[pos] == '\\') { pos++; continue; }
+      if (text[pos] == '"') {
+        pos++;
+        raw = text.substr(start, pos - start);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool parseValue(FakeJsonLeaves& out, const std::string& path) {
+    skipSpace();
+    if (pos >= text.size()) return false;
+    char c = text[pos];
+    if (c == '{') {
+      pos++;
+      skipSpace();
+      if (pos < text.size() && text[pos] == '}') { pos++; return true; }
+      while (true) {
+        skipSpace();
+        std::string key;
+        if (!parseString(key)) return false;
+        skipSpace();
+        if (pos >= text.size() || text[pos++] != ':') return false;
+        std::string name = fakeJsonUnquote(key);
+        if (!parseValue(out, path.empty() ? name : path + "/" + name)) return false;
+        skipSpace();
+        if (pos < text.size() && text[pos] == ',') { pos++; continue; }
+        if (pos < text.size() && text[pos] == '}') { pos++; return true; }
+        return false;
+      }
+    }
+    if (c == '[') {
+      pos++;
+      skipSpace();
+      if (pos < text.size() && text[pos] == ']') { pos++; return true; }
+      for (int index = 0;; index++) {
+        if (!parseValue(out, (path.empty() ? "" : path + "/") + std::to_string(index))) return false;
+        skipSpace();
+        if (pos < text.size() && text[pos] == ',') { pos++; continue; }
+        if (pos < text.size() && text[pos] == ']') { pos++; return true; }
+        return false;
+      }
+    }
+    std::string raw;
+    if (c == '"') {
+      if (!parseString(raw)) return false;
+    } else {
+      size_t start = pos;
+      while (pos < text.size() && !strchr(",}] \t\r\n", text[pos])) pos++;
+      raw = text.substr(start, pos - start);
+      if (raw.empty()) return false;
+    }
+    out.push_back({path, raw});
+    return true;
+  }
+};
+
+}  // namespace
+
+bool fakeJsonFlatten(const std::string& text, FakeJsonLeaves& out, const std::string& prefix) {
+  Parser parser{text, 0};
+  if (!parser.parseValue(out, prefix)) return false;
+  parser.skipSpace();
+  return parser.pos == text.size();
+}
+
+std::string fakeJsonUnquote(const std::string& raw) {
+  if (raw.size() < 2 || raw[0] != '"') return raw;
+  std::string out;
+  for (size_t i = 1; i + 1 < raw.size(); i++) {
+    char c = raw[i];
+    if (c != '\\' || i + 2 >= raw.size()) { out += c; continue; }
+    c = raw[++i];
+    switch (c) {
+      case 'n': out += '\n'; break;
+      case 't': out += '\t'; break;
+      case 'r': out += '\r'; break;
+      case 'b': out += '\b'; break;
+      case 'f': out += '\f'; break;
+      case 'u':
+        if (i + 4 < raw.size()) {
+          long code = strtol(raw.substr(i + 1, 4).c_str(), nullptr, 16);
+          out += code < 0x80 ? (char)code : '?';
+          i += 4;
+        }
+        break;
+      default: out += c; break;
+    }
+  }
+  return out;
+}
+
+std::string fakeJsonQuote(const std::string& text) {
+  std::string out = "\"";
+  for (char c : text) {
+    if (c == '"' || c == '\\') { out += '\\'; out += c; }
+    else if (c == '\n') out += "\\n";
+    else if ((unsigned char)c < 0x20) {
+      char escape[8];
+      snprintf(escape, sizeof(escape), "\\u%04x", c);
+      out += escape;
+    } else out += c;
+  }
+  return out + "\"";
+}
+
+// Leaves are sorted, so each object's children are contiguous
+std::string fakeJsonBuild(const std::map<std::string, std::string>& leaves, const std::string& prefix) {
+  auto exact = leaves.find(prefix);
+  if (exact != leaves.end()) return exact->second;
+
+  std::string base = prefix.empty() ? "" : prefix + "/";
+  std::string out;
+  std::string lastChild;
+  for (auto it = leaves.lower_bound(base); it != leaves.end(); ++it) {
+    if (it->first.compare(0, base.size(), base) != 0) break;
+    std::string rest = it->first.substr(base.size());
+    std::string child = rest.substr(0, rest.find('/'));
+    if (child == lastChild) continue;
+    lastChild = child;
+    out += out.empty() ? "{" : ",";
+    out += fakeJsonQuote(child) + ":" + fakeJsonBuild(leaves, base + child);
+  }
+  return out.empty() ? "null" : out + "}";
+}
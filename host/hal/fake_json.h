@@ -0,0 +1,27 @@
+/*
+ * Host JSON Helpers for ToxiRover
+ * Flattens JSON into "a/b/c" leaf paths and builds it back; used by the fake
+ * Firebase library and the RTDB stand-in
+ */
+
+#ifndef FAKE_JSON_H
+#define FAKE_JSON_H
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+typedef std::vector<std::pair<std::string, std::string>> FakeJsonLeaves;  // path -> raw JSON leaf
+
+// Appends every leaf under prefix; an empty object or array becomes no leaves
+bool fakeJsonFlatten(const std::string& text, FakeJsonLeaves& out, const std::string& prefix = "");
+
+// Nested JSON for the leaves under prefix ("null" if there are none)
+std::string fakeJsonBuild(const std::map<std::string, std::string>& leaves, const std::string& prefix);
+
+// Decoded text of a raw JSON string leaf; other leaves come back unchanged
+std::string fakeJsonUnquote(const std::string& raw);
+std::string fakeJsonQuote(const std::string& text);
+
+#endif
@@ -0,0 +1,614 @@
+/*
+ * Fake Network Implementation for ToxiRover host builds
+ */
+
+#include "fake_internal.h"
+#include <ESP8266WiFi.h>
+#include <WiFiUdp.h>
+#include <ESP8266WebServer.h>
+#include <ArduinoOTA.h>
+#include "Adafruit_MQTT.h"
+
+#include <deque>
+#include <map>
+
+ESP8266WiFiClass WiFi;
+ArduinoOTAClass ArduinoOTA;
+
+struct FakeListener {
+  std::string host;
+  uint16_t port;
+  FakeEndpoint* endpoint;
+};
+
+struct FakeConnection {
+  std::shared_ptr<FakeSocket> socket;
+  FakeEndpoint* endpoint;
+};
+
+struct FakeHttpServer {
+  ESP8266WebServer* owner = nullptr;
+  std::deque<std::string> requests;
+  std::deque<FakeHttpResponse> responses;
+};
+
+struct FakeNetworkState {
+  // Wi-Fi
+  bool reachable = true;
+  bool begun = false;
+  WiFiMode_t mode = WIFI_STA;
+  unsigned long attemptStart = 0;
+  unsigned long connectMs = FAKE_WIFI_CONNECT_MS;
+  bool apActive = false;
+  int sleepMode = WIFI_NONE_SLEEP;
+  uint8_t bssid[6] = {0x02, 0x1A, 0x2B, 0x3C, 0x4D, 0x5E};
+  bool scanning = false;
+  unsigned long scanStart = 0;
+
+  // Loopback TCP
+  std::vector<FakeListener> listeners;
+  std::vector<FakeConnection*> connections;
+  FakeNetStats stats = {0, 0, 0, 0};
+
+  // UDP
+  std::map<uint16_t, std::deque<std::vector<uint8_t>>> udpQueues;
+  unsigned long udpSent = 0;
+
+  // Web servers
+  std::map<uint16_t, FakeHttpServer> httpServers;
+
+  // MQTT broker
+  bool mqttReachable = true;
+  unsigned long mqttSession = 1;
+  unsigned long mqttConnects = 0;
+  std::deque<FakeMqttMessage> mqttInbox;
+  std::vector<FakeMqttMessage> mqttPublished;
+};
+
+static FakeNetworkState& net() {
+  static FakeNetworkState state;
+  return state;
+}
+
+void fakeResetNetwork() {
+  for (FakeConnection* connection : net().connections) {
+    connection->socket->open = false;
+  }
+  FakeNetworkState& state = net();
+  state.reachable = true;
+  state.begun = false;
+  state.mode = WIFI_STA;
+  state.attemptStart = 0;
+  state.connectMs = FAKE_WIFI_CONNECT_MS;
+  state.apActive = false;
+  state.sleepMode = WIFI_NONE_SLEEP;
+  state.listeners.clear();
+  state.stats = {0, 0, 0, 0};
+  state.udpQueues.clear();
+  state.udpSent = 0;
+  state.httpServers.clear();
+  state.mqttReachable = true;
+  state.mqttSession++;
+  state.mqttConnects = 0;
+  state.mqttInbox.clear();
+  state.mqttPublished.clear();
+}
+
+// ---------------------------------------------------------------- Wi-Fi
+
+bool fakeWiFiConnected() {
+  FakeNetworkState& state = net();
+  return state.begun && state.reachable && (state.mode & WIFI_STA) &&
+         millis() - state.attemptStart >= state.connectMs;
+}
+
+void fakeWiFiSetReachable(bool reachable) {
+  FakeNetworkState& state = net();
+  if (reachable && !state.reachable) state.attemptStart = millis();  // the SDK retries on its own
+  state.reachable = reachable;
+}
+
+void fakeWiFiDrop() {
+  fakeWiFiSetReachable(false);
+}
+
+int fakeWiFiSleepMode() {
+  return net().sleepMode;
+}
+
+wl_status_t ESP8266WiFiClass::status() {
+  FakeNetworkState& state = net();
+  if (!state.begun) return WL_IDLE_STATUS;
+  if (fakeWiFiConnected()) return WL_CONNECTED;
+  if (!state.reachable && millis() - state.attemptStart >= FAKE_WIFI_CONNECT_MS) return WL_NO_SSID_AVAIL;
+  return WL_DISCONNECTED;
+}
+
+bool ESP8266WiFiClass::mode(WiFiMode_t mode) {
+  net().mode = mode;
+  return true;
+}
+
+WiFiMode_t ESP8266WiFiClass::getMode() {
+  return net().mode;
+}
+
+wl_status_t ESP8266WiFiClass::begin(const char* ssid, const char* password, int32_t channel,
+                                    const uint8_t* bssid, bool connect) {
+  (void)ssid; (void)password;
+  FakeNetworkState& state = net();
+  state.begun = connect;
+  state.attemptStart = millis();
+  state.connectMs = channel > 0 && bssid != nullptr ? FAKE_WIFI_FAST_CONNECT_MS : FAKE_WIFI_CONNECT_MS;  // no scan
+  if (!(state.mode & WIFI_STA)) state.mode = WIFI_STA;
+  return status();
+}
+
+bool ESP8266WiFiClass::disconnect(bool wifiOff) {
+  (void)wifiOff;
+  net().begun = false;
+  return true;
+}
+
+bool ESP8266WiFiClass::hostname(const char* name) {
+  (void)name;
+  return true;
+}
+
+bool ESP8266WiFiClass::softAP(const char* ssid, const char* password) {
+  (void)ssid; (void)password;
+  FakeNetworkState& state = net();
+  state.apActive = true;
+  state.mode = (WiFiMode_t)(state.mode | WIFI_AP);
+  return true;
+}
+
+IPAddress ESP8266WiFiClass::softAPIP() {
+  return net().apActive ? IPAddress(192, 168, 4, 1) : IPAddress();
+}
+
+IPAddress ESP8266WiFiClass::localIP() {
+  return fakeWiFiConnected() ? IPAddress(192, 168, 1, 50) : IPAddress();
+}
+
+int32_t ESP8266WiFiClass::channel() {
+  return 6;
+}
+
+uint8_t* ESP8266WiFiClass::BSSID() {
+  return net().bssid;
+}
+
+bool ESP8266WiFiClass::setSleepMode(WiFiSleepType_t type, uint8_t listenInterval) {
+  (void)listenInterval;
+  net().sleepMode = type;
+  return true;
+}
+
+// A scan dwells on every channel, about two seconds in all
+int8_t ESP8266WiFiClass::scanNetworks(bool async, bool showHidden) {
+  (void)showHidden;
+  FakeNetworkState& state = net();
+  state.scanning = true;
+  state.scanStart = millis();
+  if (async) return WIFI_SCAN_RUNNING;
+  delay(FAKE_WIFI_SCAN_MS);
+  return scanComplete();
+}
+
+int8_t ESP8266WiFiClass::scanComplete() {
+  FakeNetworkState& state = net();
+  if (!state.scanning) return WIFI_SCAN_FAILED;
+  if (millis() - state.scanStart < FAKE_WIFI_SCAN_MS) return WIFI_SCAN_RUNNING;
+  return state.reachable ? 2 : 0;
+}
+
+void ESP8266WiFiClass::scanDelete() {
+  net().scanning = false;
+}
+
+String ESP8266WiFiClass::SSID(uint8_t index) {
+  return index == 0 ? "RoverNet" : "Workshop";
+}
+
+int32_t ESP8266WiFiClass::RSSI(uint8_t index) {
+  return index == 0 ? -58 : -71;
+}
+
+String IPAddress::toString() const {
+  char text[16];
+  snprintf(text, sizeof(text), "%u.%u.%u.%u", bytes[0], bytes[1], bytes[2], bytes[3]);
+  return String(text);
+}
+
+size_t IPAddress::printTo(Print& p) const {
+  return p.print(toString());
+}
+
+// ---------------------------------------------------------------- loopback TCP
+
+void FakeSocket::send(const std::string& bytes) {
+  if (!open) return;
+  FakeUntrackedHeap untracked;
+  unsigned long readyAt = millis() + latencyMs;
+  if (rxPos > 4096) {
+    rx.erase(0, rxPos);
+    rxReadyAt.erase(rxReadyAt.begin(), rxReadyAt.begin() + rxPos);
+    rxPos = 0;
+  }
+  rx += bytes;
+  rxReadyAt.insert(rxReadyAt.end(), bytes.size(), readyAt);
+}
+
+void FakeSocket::close() {
+  open = false;
+}
+
+void fakeNetListen(const char* host, uint16_t port, FakeEndpoint* endpoint) {
+  fakeNetUnlisten(host, port);
+  net().listeners.push_back({host, port, endpoint});
+}
+
+void fakeNetUnlisten(const char* host, uint16_t port) {
+  std::vector<FakeListener>& listeners = net().listeners;
+  for (size_t i = 0; i < listeners.size(); i++) {
+    if (listeners[i].host != host || listeners[i].port != port) continue;
+    for (FakeConnection* connection : net().connections) {
+      if (connection->endpoint == listeners[i].endpoint) {
+        connection->socket->open = false;
+        connection->endpoint = nullptr;
+      }
+    }
+    listeners.erase(listeners.begin() + i);
+    return;
+  }
+}
+
+FakeNetStats fakeNetStats() {
+  return net().stats;
+}
+
+WiFiClient::~WiFiClient() {
+  stop();
+}
+
+int WiFiClient::connect(const char* host, uint16_t port) {
+  stop();
+  FakeNetworkState& state = net();
+  FakeEndpoint* endpoint = nullptr;
+  for (const FakeListener& listener : state.listeners) {
+    if (listener.host == host && listener.port == port) endpoint = listener.endpoint;
+  }
+  if (!endpoint || !fakeWiFiConnected()) {
+    state.stats.refused++;
+    return 0;
+  }
+
+  delay(endpoint->connectMs);
+  std::shared_ptr<FakeSocket> socket = std::make_shared<FakeSocket>();
+  socket->latencyMs = endpoint->latencyMs;
+  if (!endpoint->onConnect(socket)) {
+    state.stats.refused++;
+    return 0;
+  }
+
+  connection = new FakeConnection{socket, endpoint};
+  state.connections.push_back(connection);
+  state.stats.connects++;
+  return 1;
+}
+
+static bool hasUnread(const FakeSocket& socket) {
+  return socket.rxPos < socket.rx.size();
+}
+
+uint8_t WiFiClient::connected() {
+  if (!connection) return 0;
+  if (!fakeWiFiConnected()) connection->socket->open = false;
+  return connection->socket->open || hasUnread(*connection->socket);
+}
+
+void WiFiClient::stop() {
+  if (!connection) return;
+  FakeNetworkState& state = net();
+  connection->socket->open = false;
+  if (connection->endpoint) connection->endpoint->onClose(connection->socket);
+  for (size_t i = 0; i < state.connections.size(); i++) {
+    if (state.connections[i] == connection) {
+      state.connections.erase(state.connections.begin() + i);
+      break;
+    }
+  }
+  delete connection;
+  connection = nullptr;
+}
+
+int WiFiClient::available() {
+  if (!connection) return 0;
+  const FakeSocket& socket = *connection->socket;
+  int count = 0;
+  unsigned long now = millis();
+  for (size_t i = socket.rxPos; i < socket.rx.size() && socket.rxReadyAt[i] <= now; i++) count++;
+  return count;
+}
+
+int WiFiClient::read() {
+  if (!connection) return -1;
+  FakeSocket& socket = *connection->socket;
+  if (!hasUnread(socket) || socket.rxReadyAt[socket.rxPos] > millis()) return -1;
+  net().stats.bytesReceived++;
+  return (unsigned char)socket.rx[socket.rxPos++];
+}
+
+size_t WiFiClient::write(const uint8_t* buffer, size_t size) {
+  if (!connected() || !connection->socket->open || !connection->endpoint) return 0;
+  net().stats.bytesSent += size;
+  FakeUntrackedHeap untracked;  // the far end's memory, not the rover's
+  connection->endpoint->onData(connection->socket, std::string((const char*)buffer, size));
+  return size;
+}
+
+// ---------------------------------------------------------------- UDP
+
+uint8_t WiFiUDP::begin(uint16_t port) {
+  localPort = port;
+  return 1;
+}
+
+void WiFiUDP::stop() {
+  localPort = 0;
+}
+
+int WiFiUDP::beginPacket(IPAddress ip, uint16_t port) {
+  (void)ip;
+  sendPort = port;
+  outgoing.clear();
+  return 1;
+}
+
+size_t WiFiUDP::write(const uint8_t* buffer, size_t size) {
+  FakeUntrackedHeap untracked;
+  outgoing.insert(outgoing.end(), buffer, buffer + size);
+  return size;
+}
+
+int WiFiUDP::endPacket() {
+  if (!fakeWiFiConnected()) return 0;
+  FakeUntrackedHeap untracked;
+  net().udpQueues[sendPort].push_back(outgoing);
+  net().udpSent++;
+  return 1;
+}
+
+int WiFiUDP::parsePacket() {
+  if (localPort == 0) return 0;
+  FakeUntrackedHeap untracked;
+  std::deque<std::vector<uint8_t>>& queue = net().udpQueues[localPort];
+  if (queue.empty()) return 0;
+  current = queue.front();
+  queue.pop_front();
+  readPos = 0;
+  return (int)current.size();
+}
+
+int WiFiUDP::read(uint8_t* buffer, size_t length) {
+  size_t n = std::min(length, current.size() - readPos);
+  memcpy(buffer, current.data() + readPos, n);
+  readPos += n;
+  return (int)n;
+}
+
+void fakeUdpInject(uint16_t port, const uint8_t* bytes, size_t length) {
+  FakeUntrackedHeap untracked;
+  net().udpQueues[port].push_back(std::vector<uint8_t>(bytes, bytes + length));
+}
+
+unsigned long fakeUdpSent() {
+  return net().udpSent;
+}
+
+// ---------------------------------------------------------------- web server
+
+ESP8266WebServer::~ESP8266WebServer() {
+  stop();
+}
+
+void ESP8266WebServer::begin() {
+  FakeHttpServer& http = net().httpServers[port];
+  if (!http.owner) http.owner = this;  // a second listener on the port fails to bind
+  listening = http.owner == this;
+}
+
+void ESP8266WebServer::stop() {
+  if (!listening) return;
+  std::map<uint16_t, FakeHttpServer>& servers = net().httpServers;
+  auto it = servers.find(port);
+  if (it != servers.end() && it->second.owner == this) it->second.owner = nullptr;
+  listening = false;
+}
+
+static String urlDecode(const std::string& text) {
+  std::string out;
+  for (size_t i = 0; i < text.size(); i++) {
+    if (text[i] == '+') out += ' ';
+    else if (text[i] == '%' && i + 2 < text.size()) {
+      out += (char)strtol(text.substr(i + 1, 2).c_str(), nullptr, 16);
+      i += 2;
+    } else out += text[i];
+  }
+  return String(out);
+}
+
+// Arguments stay readable until the next request, as on the device
+void ESP8266WebServer::handleClient() {
+  if (!listening) return;
+  FakeHttpServer& http = net().httpServers[port];
+  if (http.requests.empty()) return;
+
+  std::string request = http.requests.front();
+  http.requests.pop_front();
+  size_t query = request.find('?');
+  requestUri = String(request.substr(0, query));
+  requestArgs.clear();
+  if (query != std::string::npos) {
+    std::string args = request.substr(query + 1);
+    size_t start = 0;
+    while (start <= args.size()) {
+      size_t end = args.find('&', start);
+      if (end == std::string::npos) end = args.size();
+      std::string pair = args.substr(start, end - start);
+      size_t equals = pair.find('=');
+      if (!pair.empty()) {
+        requestArgs.push_back({urlDecode(pair.substr(0, equals)),
+                               equals == std::string::npos ? String() : urlDecode(pair.substr(equals + 1))});
+      }
+      start = end + 1;
+    }
+  }
+
+  requestsServed++;
+  for (const Route& route : routes) {
+    if (route.uri == requestUri) {
+      route.handler();
+      return;
+    }
+  }
+  if (notFound) notFound();
+  else send(404, "text/plain", "Not found");
+}
+
+const String& ESP8266WebServer::arg(const char* name) const {
+  static const String empty;
+  for (const auto& pair : requestArgs) {
+    if (pair.first == name) return pair.second;
+  }
+  return empty;
+}
+
+bool ESP8266WebServer::hasArg(const char* name) const {
+  for (const auto& pair : requestArgs) {
+    if (pair.first == name) return true;
+  }
+  return false;
+}
+
+void ESP8266WebServer::send(int code, const char* contentType, const String& content) {
+  net().httpServers[port].responses.push_back({code, contentType, content.c_str()});
+}
+
+size_t ESP8266WebServer::streamFile(File& file, const char* contentType) {
+  std::string body;
+  int c;
+  while ((c = file.read()) >= 0) body += (char)c;
+  net().httpServers[port].responses.push_back({200, contentType, body});
+  return body.size();
+}
+
+void fakeHttpRequest(uint16_t port, const char* uri) {
+  FakeUntrackedHeap untracked;  // the browser's memory, not the rover's
+  net().httpServers[port].requests.push_back(uri);
+}
+
+bool fakeHttpResponse(uint16_t port, FakeHttpResponse& response) {
+  FakeUntrackedHeap untracked;
+  std::deque<FakeHttpResponse>& responses = net().httpServers[port].responses;
+  if (responses.empty()) return false;
+  response = responses.front();
+  responses.pop_front();
+  return true;
+}
+
+// ---------------------------------------------------------------- MQTT broker
+
+void fakeMqttSetReachable(bool reachable) {
+  if (!reachable) net().mqttSession++;  // drops every open session
+  net().mqttReachable = reachable;
+}
+
+void fakeMqttInject(const char* topic, const char* payload) {
+  FakeUntrackedHeap untracked;
+  net().mqttInbox.push_back({topic, payload});
+}
+
+std::vector<FakeMqttMessage>& fakeMqttPublished() {
+  return net().mqttPublished;
+}
+
+unsigned long fakeMqttConnects() {
+  return net().mqttConnects;
+}
+
+int8_t Adafruit_MQTT::connect() {
+  FakeNetworkState& state = net();
+  state.mqttConnects++;
+  if (!fakeWiFiConnected()) return -1;
+  if (!state.mqttReachable) return 3;  // server unavailable
+  session = state.mqttSession;
+  return 0;
+}
+
+bool Adafruit_MQTT::connected() {
+  FakeNetworkState& state = net();
+  return session != 0 && session == state.mqttSession && state.mqttReachable && fakeWiFiConnected();
+}
+
+bool Adafruit_MQTT::disconnect() {
+  session = 0;
+  return true;
+}
+
+bool Adafruit_MQTT::ping(uint8_t tries) {
+  (void)tries;
+  return connected();
+}
+
+const char* Adafruit_MQTT::connectErrorString(int8_t code) {
+  switch (code) {
+    case -1: return "Connection failed";
+    case 1: return "The Server does not support the level of the MQTT protocol requested";
+    case 2: return "The Client identifier is correct UTF-8 but not allowed by the Server";
+    case 3: return "The MQTT service is unavailable";
+    case 4: return "The data in the user name or password is malformed";
+    case 5: return "Not authorized to connect";
+    default: return "Unknown error";
+  }
+}
+
+bool Adafruit_MQTT::subscribe(Adafruit_MQTT_Subscribe* subscription) {
+  for (int i = 0; i < MAXSUBSCRIPTIONS; i++) {
+    if (subscriptions[i] == subscription) return true;
+    if (!subscriptions[i]) {
+      subscriptions[i] = subscription;
+      return true;
+    }
+  }
+  return false;
+}
+
+// Waits up to the timeout for a message on a subscribed feed
+Adafruit_MQTT_Subscribe* Adafruit_MQTT::readSubscription(int16_t timeoutMs) {
+  std::deque<FakeMqttMessage>& inbox = net().mqttInbox;
+  while (connected() && !inbox.empty()) {
+    FakeUntrackedHeap untracked;
+    FakeMqttMessage message = inbox.front();
+    inbox.pop_front();
+    for (int i = 0; i < MAXSUBSCRIPTIONS; i++) {
+      Adafruit_MQTT_Subscribe* subscription = subscriptions[i];
+      if (!subscription || message.topic != subscription->topic) continue;
+      size_t n = std::min(message.payload.size(), (size_t)SUBSCRIPTIONDATALEN - 1);
+      memcpy(subscription->lastread, message.payload.data(), n);
+      subscription->lastread[n] = '\0';
+      subscription->datalen = n;
+      return subscription;
+    }
+  }
+  delay(timeoutMs);
+  return nullptr;
+}
+
+bool Adafruit_MQTT::publish(const char* topic, const uint8_t* payload, uint16_t length) {
+  if (!connected()) return false;
+  FakeUntrackedHeap untracked;
+  net().mqttPublished.push_back({topic, std::string((const char*)payload, length)});
+  return true;
+}
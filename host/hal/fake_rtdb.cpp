@@ -0,0 +1,243 @@
+/*
+ * Fake Realtime Database Implementation for ToxiRover host builds
+ */
+
+#include "fake_internal.h"
+#include "fake_rtdb.h"
+#include "fake_json.h"
+
+// "/a/b/" -> "a/b"; the root is ""
+static std::string normalizePath(const std::string& path) {
+  size_t start = path.find_first_not_of('/');
+  if (start == std::string::npos) return "";
+  size_t end = path.find_last_not_of('/');
+  return path.substr(start, end - start + 1);
+}
+
+// Whether path is base itself or somewhere below it
+static bool isWithin(const std::string& path, const std::string& base) {
+  if (base.empty()) return true;
+  if (path.compare(0, base.size(), base) != 0) return false;
+  return path.size() == base.size() || path[base.size()] == '/';
+}
+
+static const char* reasonPhrase(int status) {
+  switch (status) {
+    case 200: return "OK";
+    case 204: return "No Content";
+    case 400: return "Bad Request";
+    case 401: return "Unauthorized";
+    case 404: return "Not Found";
+    case 429: return "Too Many Requests";
+    case 500: return "Internal Server Error";
+    case 503: return "Service Unavailable";
+    default: return "Status";
+  }
+}
+
+FakeRtdb::FakeRtdb(const char* listenHost, uint16_t listenPort) : host(listenHost), port(listenPort) {
+  fakeNetListen(host.c_str(), port, this);
+}
+
+FakeRtdb::~FakeRtdb() {
+  for (Stream& stream : streams) stream.socket->close();
+  fakeNetUnlisten(host.c_str(), port);
+}
+
+bool FakeRtdb::onConnect(std::shared_ptr<FakeSocket> socket) {
+  (void)socket;
+  return !refuse;
+}
+
+void FakeRtdb::onClose(std::shared_ptr<FakeSocket> socket) {
+  pending.erase(socket.get());
+  for (size_t i = 0; i < streams.size(); i++) {
+    if (streams[i].socket == socket) {
+      streams.erase(streams.begin() + i);
+      break;
+    }
+  }
+}
+
+// Requests may arrive split across writes (head, then body) or several at once
+void FakeRtdb::onData(std::shared_ptr<FakeSocket> socket, const std::string& bytes) {
+  FakeUntrackedHeap untracked;
+  bytesReceived += bytes.size();
+  std::string& buffer = pending[socket.get()];
+  buffer += bytes;
+
+  while (true) {
+    size_t headEnd = buffer.find("\r\n\r\n");
+    if (headEnd == std::string::npos) return;
+    std::string head = buffer.substr(0, headEnd);
+    size_t contentLength = 0;
+    bool eventStream = false;
+    size_t lineStart = head.find("\r\n");
+    while (lineStart != std::string::npos) {
+      lineStart += 2;
+      size_t lineEnd = head.find("\r\n", lineStart);
+      std::string line = head.substr(lineStart, lineEnd == std::string::npos ? std::string::npos : lineEnd - lineStart);
+      if (strncasecmp(line.c_str(), "Content-Length:", 15) == 0) contentLength = strtoul(line.c_str() + 15, NULL, 10);
+      if (strncasecmp(line.c_str(), "Accept: text/event-stream", 25) == 0) eventStream = true;
+      lineStart = lineEnd;
+    }
+    if (buffer.size() < headEnd + 4 + contentLength) return;
+
+    FakeRtdbRequest request;
+    std::string requestLine = head.substr(0, head.find("\r\n"));
+    size_t space = requestLine.find(' ');
+    std::string target = requestLine.substr(space + 1, requestLine.rfind(' ') - space - 1);
+    size_t query = target.find('?');
+    request.method = requestLine.substr(0, space);
+    request.path = target.substr(0, query);
+    request.query = query == std::string::npos ? "" : target.substr(query + 1);
+    if (request.path.size() >= 5 && request.path.compare(request.path.size() - 5, 5, ".json") == 0) {
+      request.path.erase(request.path.size() - 5);
+    }
+    request.body = buffer.substr(headEnd + 4, contentLength);
+    request.at = millis();
+    buffer.erase(0, headEnd + 4 + contentLength);
+
+    requests.push_back(request);
+    handle(socket, request, eventStream);
+    if (!socket->isOpen()) return;
+  }
+}
+
+void FakeRtdb::handle(std::shared_ptr<FakeSocket> socket, const FakeRtdbRequest& request, bool eventStream) {
+  std::string path = normalizePath(request.path);
+
+  if (eventStream) {
+    std::string head = "HTTP/1.1 200 OK\r\nContent-Type: text/event-stream\r\nCache-Control: no-cache\r\n\r\n";
+    socket->send(head + "event: put\ndata: {\"path\":\"/\",\"data\":" + get(path) + "}\n\n");
+    streams.push_back({socket, path});
+    return;
+  }
+
+  FakeRtdbFault applied = fault;
+  if (faultCount > 0 && --faultCount == 0) fault = FAKE_RTDB_OK;
+  switch (applied) {
+    case FAKE_RTDB_STATUS: reply(socket, faultStatus, "{\"error\":\"fault injected\"}"); return;
+    case FAKE_RTDB_GARBLED: socket->send("<html>\n"); return;
+    case FAKE_RTDB_STALL: return;
+    case FAKE_RTDB_CLOSE: socket->close(); return;
+    case FAKE_RTDB_OK: break;
+  }
+
+  bool silent = request.query.find("print=silent") != std::string::npos;
+  if (request.method == "GET") {
+    reply(socket, 200, get(path));
+    return;
+  }
+  if (request.method == "DELETE") {
+    write(path, "null", false);
+    reply(socket, silent ? 204 : 200, silent ? "" : "null");
+    return;
+  }
+
+  FakeJsonLeaves check;
+  if (!fakeJsonFlatten(request.body, check)) {
+    reply(socket, 400, "{\"error\":\"Invalid data; couldn't parse JSON object\"}");
+    return;
+  }
+  if (request.method == "POST") {
+    char key[24];
+    snprintf(key, sizeof(key), "-Nfake%014lu", ++pushes);
+    write(path.empty() ? key : path + "/" + key, request.body, false);
+    reply(socket, silent ? 204 : 200, silent ? "" : std::string("{\"name\":\"") + key + "\"}");
+  } else if (request.method == "PUT" || request.method == "PATCH") {
+    write(path, request.body, request.method == "PATCH");
+    reply(socket, silent ? 204 : 200, silent ? "" : request.body);
+  } else {
+    reply(socket, 405, "{\"error\":\"method not allowed\"}");
+  }
+}
+
+void FakeRtdb::reply(std::shared_ptr<FakeSocket> socket, int status, const std::string& body) {
+  char head[160];
+  snprintf(head, sizeof(head),
+           "HTTP/1.1 %d %s\r\nContent-Type: application/json; charset=utf-8\r\n"
+           "Content-Length: %u\r\nConnection: keep-alive\r\n\r\n",
+           status, reasonPhrase(status), (unsigned)body.size());
+  socket->send(head + body);
+}
+
+// PUT replaces the subtree; PATCH merges leaf by leaf (multi-location keys like "a/b" included)
+void FakeRtdb::write(const std::string& path, const std::string& json, bool merge) {
+  FakeJsonLeaves incoming;
+  if (!fakeJsonFlatten(json, incoming, path)) return;
+
+  if (!merge) {
+    for (auto it = leaves.begin(); it != leaves.end();) {
+      it = isWithin(it->first, path) ? leaves.erase(it) : std::next(it);
+    }
+  }
+  for (const auto& leaf : incoming) {
+    std::string key = normalizePath(leaf.first);
+    for (auto it = leaves.begin(); it != leaves.end();) {
+      bool replaced = isWithin(it->first, key) || isWithin(key, it->first);
+      it = replaced ? leaves.erase(it) : std::next(it);
+    }
+    if (leaf.second != "null") leaves[key] = leaf.second;
+  }
+  notify(merge ? "patch" : "put", path, json);
+}
+
+void FakeRtdb::notify(const std::string& event, const std::string& path, const std::string& json) {
+  for (Stream& stream : streams) {
+    std::string data;
+    if (isWithin(path, stream.path)) {
+      std::string relative = "/" + path.substr(std::min(path.size(), stream.path.size() + (stream.path.empty() ? 0 : 1)));
+      data = "event: " + event + "\ndata: {\"path\":\"" + relative + "\",\"data\":" + json + "}\n\n";
+    } else if (isWithin(stream.path, path)) {
+      data = "event: put\ndata: {\"path\":\"/\",\"data\":" + get(stream.path) + "}\n\n";
+    } else {
+      continue;
+    }
+    stream.socket->send(data);
+  }
+}
+
+std::string FakeRtdb::get(const std::string& path) const {
+  return fakeJsonBuild(leaves, normalizePath(path));
+}
+
+double FakeRtdb::getNumber(const std::string& path) const {
+  return atof(get(path).c_str());
+}
+
+size_t FakeRtdb::count(const std::string& path) const {
+  std::string base = normalizePath(path);
+  std::string prefix = base.empty() ? "" : base + "/";
+  size_t children = 0;
+  std::string last;
+  for (auto it = leaves.lower_bound(prefix); it != leaves.end() && it->first.compare(0, prefix.size(), prefix) == 0; ++it) {
+    std::string child = it->first.substr(prefix.size());
+    child = child.substr(0, child.find('/'));
+    if (child != last) children++;
+    last = child;
+  }
+  return children;
+}
+
+void FakeRtdb::put(const std::string& path, const std::string& json) {
+  FakeUntrackedHeap untracked;
+  write(normalizePath(path), json, false);
+}
+
+void FakeRtdb::patch(const std::string& path, const std::string& json) {
+  FakeUntrackedHeap untracked;
+  write(normalizePath(path), json, true);
+}
+
+void FakeRtdb::clear() {
+  leaves.clear();
+  requests.clear();
+  bytesReceived = 0;
+}
+
+void FakeRtdb::setFault(FakeRtdbFault newFault, int status, unsigned long count) {
+  fault = newFault;
+  faultStatus = status;
+  faultCount = count;
+}
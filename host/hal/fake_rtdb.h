@@ -0,0 +1,85 @@
+/*
+ * Fake Realtime Database for ToxiRover host builds
+ * An in-process stand-in for the Firebase RTDB REST endpoint on the loopback network
+ *
+ * Features:
+ * - GET/PUT/PATCH/POST/DELETE on ".json" paths over keep-alive HTTP, as the REST API does
+ * - print=silent answered with 204, POST answered with a generated push key
+ * - "Accept: text/event-stream" GETs become streams that push "put"/"patch" events
+ * - Fault injection: refused connections, error statuses, garbled replies, stalls
+ * - Every request is recorded for the tests to inspect
+ */
+
+#ifndef FAKE_RTDB_H
+#define FAKE_RTDB_H
+
+#include "fake_hal.h"
+#include <map>
+
+#define FAKE_RTDB_HOST "your-project.firebaseio.com"
+#define FAKE_RTDB_PORT 443
+
+struct FakeRtdbRequest {
+  std::string method;
+  std::string path;  // without ".json" or the query
+  std::string query;
+  std::string body;
+  unsigned long at;  // millis() when the request arrived
+};
+
+enum FakeRtdbFault {
+  FAKE_RTDB_OK,
+  FAKE_RTDB_STATUS,   // reply with faultStatus
+  FAKE_RTDB_GARBLED,  // reply with a line that is not an HTTP status
+  FAKE_RTDB_STALL,    // read the request, never answer
+  FAKE_RTDB_CLOSE     // close the connection without answering
+};
+
+class FakeRtdb : public FakeEndpoint {
+public:
+  explicit FakeRtdb(const char* host = FAKE_RTDB_HOST, uint16_t port = FAKE_RTDB_PORT);
+  ~FakeRtdb();
+
+  bool onConnect(std::shared_ptr<FakeSocket> socket) override;
+  void onData(std::shared_ptr<FakeSocket> socket, const std::string& bytes) override;
+  void onClose(std::shared_ptr<FakeSocket> socket) override;
+
+  // Database contents, as nested JSON ("null" if nothing is stored there)
+  std::string get(const std::string& path) const;
+  double getNumber(const std::string& path) const;
+  size_t count(const std::string& path) const;  // children of an object
+  void put(const std::string& path, const std::string& json);    // as a dashboard would; streams see it
+  void patch(const std::string& path, const std::string& json);
+  void clear();
+
+  // Faults apply to the next `count` requests (0 = until changed); streams are not affected
+  void setFault(FakeRtdbFault fault, int status = 503, unsigned long count = 0);
+  bool refuse = false;  // refuse new connections
+
+  std::vector<FakeRtdbRequest> requests;
+  unsigned long bytesReceived = 0;
+  size_t openStreams() const { return streams.size(); }
+
+private:
+  struct Stream {
+    std::shared_ptr<FakeSocket> socket;
+    std::string path;
+  };
+
+  void handle(std::shared_ptr<FakeSocket> socket, const FakeRtdbRequest& request, bool eventStream);
+  void reply(std::shared_ptr<FakeSocket> socket, int status, const std::string& body);
+  void write(const std::string& path, const std::string& json, bool merge);
+  void notify(const std::string& event, const std::string& path, const std::string& json);
+
+  std::string host;
+  uint16_t port;
+  std::map<std::string, std::string> leaves;  // "a/b/c" -> raw JSON leaf
+  std::map<FakeSocket*, std::string> pending;  // partial requests per connection
+  std::vector<Stream> streams;
+  FakeRtdbFault fault = FAKE_RTDB_OK;
+  int faultStatus = 503;
+  unsigned long faultCount = 0;
+  unsigned long pushes = 0;
+};
+
+#endif
@@ -0,0 +1,244 @@
+/*
+ * Fake Flash Storage Implementation for ToxiRover host builds
+ */
+
+#include "fake_internal.h"
+#include <EEPROM.h>
+#include <LittleFS.h>
+
+#include <map>
+
+EEPROMClass EEPROM;
+LittleFSClass LittleFS;
+
+struct FakeStorageState {
+  uint8_t eepromFlash[FAKE_EEPROM_FLASH_SIZE];
+  unsigned long eepromCommits = 0;
+  std::map<std::string, std::shared_ptr<std::vector<uint8_t>>> files;
+  bool fsAvailable = true;
+  size_t fsCapacity = 0;
+  unsigned long fsBytesWritten = 0;
+
+  FakeStorageState() { memset(eepromFlash, 0xFF, sizeof(eepromFlash)); }
+};
+
+static FakeStorageState& storage() {
+  static FakeStorageState state;
+  return state;
+}
+
+void fakeResetStorage() {
+  storage() = FakeStorageState();
+}
+
+// ---------------------------------------------------------------- EEPROM
+
+void EEPROMClass::begin(size_t requested) {
+  size = std::min(requested, (size_t)FAKE_EEPROM_FLASH_SIZE);
+  memcpy(data, storage().eepromFlash, size);
+  dirty = false;
+}
+
+uint8_t EEPROMClass::read(int address) {
+  if (address < 0 || (size_t)address >= size) return 0;
+  return data[address];
+}
+
+void EEPROMClass::write(int address, uint8_t value) {
+  if (address < 0 || (size_t)address >= size) return;
+  if (data[address] != value) dirty = true;
+  data[address] = value;
+}
+
+// Only a changed sector is erased and written, as in the core
+bool EEPROMClass::commit() {
+  if (size == 0) return false;
+  if (!dirty) return true;
+  memcpy(storage().eepromFlash, data, size);
+  storage().eepromCommits++;
+  dirty = false;
+  return true;
+}
+
+void EEPROMClass::end() {
+  commit();
+  size = 0;
+}
+
+void fakeEepromErase() {
+  memset(storage().eepromFlash, 0xFF, sizeof(storage().eepromFlash));
+}
+
+uint8_t* fakeEepromFlash() {
+  return storage().eepromFlash;
+}
+
+unsigned long fakeEepromCommits() {
+  return storage().eepromCommits;
+}
+
+// ---------------------------------------------------------------- LittleFS
+
+size_t fakeFsUsed() {
+  size_t used = 0;
+  for (const auto& file : storage().files) used += file.second->size();
+  return used;
+}
+
+int File::available() {
+  return contents && offset < contents->size() ? (int)(contents->size() - offset) : 0;
+}
+
+int File::read() {
+  if (!contents || offset >= contents->size()) return -1;
+  return (*contents)[offset++];
+}
+
+size_t File::read(uint8_t* buffer, size_t length) {
+  if (!contents) return 0;
+  size_t n = std::min(length, contents->size() - std::min(offset, contents->size()));
+  memcpy(buffer, contents->data() + offset, n);
+  offset += n;
+  return n;
+}
+
+int File::peek() {
+  if (!contents || offset >= contents->size()) return -1;
+  return (*contents)[offset];
+}
+
+size_t File::write(const uint8_t* buffer, size_t length) {
+  if (!contents || !writable) return 0;
+  FakeStorageState& state = storage();
+  size_t growth = offset + length > contents->size() ? offset + length - contents->size() : 0;
+  if (state.fsCapacity > 0 && fakeFsUsed() + growth > state.fsCapacity) return 0;
+  if (offset + length > contents->size()) {
+    FakeUntrackedHeap untracked;  // flash, not RAM
+    contents->resize(offset + length);
+  }
+  memcpy(contents->data() + offset, buffer, length);
+  offset += length;
+  state.fsBytesWritten += length;
+  return length;
+}
+
+bool File::seek(uint32_t position, SeekMode mode) {
+  if (!contents) return false;
+  size_t base = mode == SeekSet ? 0 : mode == SeekCur ? offset : contents->size();
+  size_t target = base + position;
+  if (target > contents->size()) return false;
+  offset = target;
+  return true;
+}
+
+bool File::truncate(uint32_t length) {
+  if (!contents || !writable || length > contents->size()) return false;
+  contents->resize(length);
+  if (offset > length) offset = length;
+  return true;
+}
+
+bool LittleFSClass::begin() {
+  return storage().fsAvailable;
+}
+
+bool LittleFSClass::format() {
+  storage().files.clear();
+  return true;
+}
+
+bool LittleFSClass::exists(const char* path) {
+  return storage().files.count(path) > 0;
+}
+
+File LittleFSClass::open(const char* path, const char* mode) {
+  FakeUntrackedHeap untracked;
+  FakeStorageState& state = storage();
+  if (!state.fsAvailable) return File();
+  auto it = state.files.find(path);
+  bool reading = mode[0] == 'r';
+  bool plus = strchr(mode, '+') != nullptr;
+
+  if (reading) {
+    if (it == state.files.end()) return File();
+    return File(it->second, plus, 0);
+  }
+  if (it == state.files.end()) {
+    it = state.files.emplace(path, std::make_shared<std::vector<uint8_t>>()).first;
+  }
+  if (mode[0] == 'w') it->second->clear();
+  return File(it->second, true, mode[0] == 'a' ? it->second->size() : 0);
+}
+
+bool LittleFSClass::remove(const char* path) {
+  return storage().files.erase(path) > 0;
+}
+
+bool LittleFSClass::rename(const char* from, const char* to) {
+  FakeUntrackedHeap untracked;
+  FakeStorageState& state = storage();
+  auto it = state.files.find(from);
+  if (it == state.files.end()) return false;
+  state.files[to] = it->second;
+  state.files.erase(it);
+  return true;
+}
+
+void fakeFsSetAvailable(bool available) {
+  storage().fsAvailable = available;
+}
+
+void fakeFsSetCapacity(size_t bytes) {
+  storage().fsCapacity = bytes;
+}
+
+unsigned long fakeFsBytesWritten() {
+  return storage().fsBytesWritten;
+}
+
+std::vector<uint8_t> fakeFsRead(const char* path) {
+  auto it = storage().files.find(path);
+  return it == storage().files.end() ? std::vector<uint8_t>() : *it->second;
+}
+
+// ---------------------------------------------------------------- flash images
+
+// Layout: EEPROM flash, RTC memory, then (name length, name, size, bytes) per file
+bool fakeSaveFlashImage(const char* path) {
+  FILE* out = fopen(path, "wb");
+  if (!out) return false;
+  FakeStorageState& state = storage();
+  fwrite(state.eepromFlash, 1, sizeof(state.eepromFlash), out);
+  fwrite(fakeCore.rtcMemory, 1, sizeof(fakeCore.rtcMemory), out);
+  for (const auto& file : state.files) {
+    uint32_t nameLength = (uint32_t)file.first.size();
+    uint32_t size = (uint32_t)file.second->size();
+    fwrite(&nameLength, sizeof(nameLength), 1, out);
+    fwrite(file.first.data(), 1, nameLength, out);
+    fwrite(&size, sizeof(size), 1, out);
+    fwrite(file.second->data(), 1, size, out);
+  }
+  return fclose(out) == 0;
+}
+
+bool fakeLoadFlashImage(const char* path) {
+  FakeUntrackedHeap untracked;
+  FILE* in = fopen(path, "rb");
+  if (!in) return false;
+  FakeStorageState& state = storage();
+  bool ok = fread(state.eepromFlash, 1, sizeof(state.eepromFlash), in) == sizeof(state.eepromFlash) &&
+            fread(fakeCore.rtcMemory, 1, sizeof(fakeCore.rtcMemory), in) == sizeof(fakeCore.rtcMemory);
+  state.files.clear();
+  uint32_t nameLength;
+  while (ok && fread(&nameLength, sizeof(nameLength), 1, in) == 1) {
+    std::string name(nameLength, '\0');
+    uint32_t size = 0;
+    ok = fread(&name[0], 1, nameLength, in) == nameLength && fread(&size, sizeof(size), 1, in) == 1;
+    if (!ok) break;
+    auto contents = std::make_shared<std::vector<uint8_t>>(size);
+    ok = fread(contents->data(), 1, size, in) == size;
+    state.files[name] = contents;
+  }
+  fclose(in);
+  return ok;
+}
@@ -0,0 +1,11 @@
+/*
+ * Host SDK gpio.h for ToxiRover
+ * Wakeup declarations live in user_interface.h
+ */
+
+#ifndef GPIO_H
+#define GPIO_H
+
+#include "user_interface.h"
+
+#endif
@@ -0,0 +1,32 @@
+/*
+ * Host SDK user_interface.h for ToxiRover
+ * GPIO wakeup from light sleep; the host records the armed pin
+ */
+
+#ifndef USER_INTERFACE_H
+#define USER_INTERFACE_H
+
+#include <stdint.h>
+
+#define GPIO_ID_PIN(pin) (pin)
+
+enum GPIO_INT_TYPE {
+  GPIO_PIN_INTR_DISABLE = 0,
+  GPIO_PIN_INTR_POSEDGE = 1,
+  GPIO_PIN_INTR_NEGEDGE = 2,
+  GPIO_PIN_INTR_ANYEDGE = 3,
+  GPIO_PIN_INTR_LOLEVEL = 4,
+  GPIO_PIN_INTR_HILEVEL = 5
+};
+
+// C linkage, as in the SDK; the firmware includes this inside extern "C"
+#ifdef __cplusplus
+extern "C" {
+#endif
+void wifi_enable_gpio_wakeup(uint32_t pin, GPIO_INT_TYPE type);
+void wifi_disable_gpio_wakeup();
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,119 @@
+/*
+ * Alert Pipeline Tests for ToxiRover
+ * Replays gas leak traces through the alert manager and firebase.cpp into the RTDB stand-in
+ */
+
+#include "test_harness.h"
+#include "fake_rtdb.h"
+#include "alert_manager.h"
+#include "firebase.h"
+#include "outbound_queue.h"
+#include "boot_sequencer.h"
+#include "config_store.h"
+#include "device_id.h"
+
+#define LEAK_MESSAGE "High gas concentration detected"
+
+static FakeRtdb rtdb;
+
+static size_t alertWrites(size_t from = 0) {
+  std::string path = roverPath(FIREBASE_ALERTS);
+  size_t writes = 0;
+  for (size_t i = from; i < rtdb.requests.size(); i++) {
+    if (rtdb.requests[i].path == path) writes++;
+  }
+  return writes;
+}
+
+// One second of a leak as the sketches see it: a reading, an alert, the resolver;
+// the Firebase task runs every other second
+static void leakSecond(float ppm, AlertSeverity severity, bool tick) {
+  if (ppm > 0) raiseAlert(ALERT_HIGH_GAS, severity, ppm, LEAK_MESSAGE);
+  serviceAlerts();
+  if (tick) updateFirebaseData();
+  fakeAdvanceMillis(1000);
+}
+
+static std::string episodeRecord() {
+  const AlertRecord& alert = getAlert(ALERT_HIGH_GAS);
+  char id[48];
+  snprintf(id, sizeof(id), "/%s_%lx_%lu", getAlertTypeName(alert.type), (unsigned long)getBootId(), alert.firstSeen);
+  return std::string(roverPath(FIREBASE_ALERTS)) + id;
+}
+
+TEST_CASE(worstCaseAlertFitsQueueSlot) {
+  initBootSequencer();
+  initConfigStore();
+  initFirebase();  // no network yet: everything queues
+
+  AlertRecord alert;
+  memset(&alert, 0, sizeof(alert));
+  alert.type = ALERT_OBSTACLE;  // longest type name
+  alert.severity = SEVERITY_WARNING;
+  alert.count = 4294967295UL;
+  alert.firstSeen = 4294967295UL;
+  alert.lastSeen = 4294967295UL;
+  alert.peak = 99999.99f;
+  memset(alert.message, 'm', ALERT_MESSAGE_SIZE - 1);
+
+  unsigned long dropped = outboundQueueStats.dropped;
+  unsigned long depth = getOutboundQueueDepth();
+  sendAlertRecord(alert);
+  CHECK_EQ(outboundQueueStats.dropped, dropped);
+  CHECK_EQ(getOutboundQueueDepth(), depth + 2);
+}
+
+TEST_CASE(offlineLeakIsQueuedNotDropped) {
+  for (int second = 0; second < 300; second++) {
+    leakSecond(600 + second, SEVERITY_DANGER, second % 2 == 0);
+  }
+  CHECK_EQ(outboundQueueStats.dropped, 0ul);
+  CHECK(getOutboundQueueDepth() >= 2 * (300 / 30));
+  CHECK_EQ(rtdb.requests.size(), (size_t)0);
+}
+
+TEST_CASE(queuedAlertsReplayOnReconnect) {
+  beginNetwork("lab", "password1");
+  runSchedulerFor(FAKE_WIFI_CONNECT_MS + 1000);
+  serviceFirebaseConnection();  // picks up the probe reply sent when the network came up
+  CHECK(isFirebaseConnected());
+
+  for (int second = 0; second < 60 && !isOutboundQueueEmpty(); second++) {
+    leakSecond(0, SEVERITY_DANGER, second % 2 == 0);
+  }
+  CHECK(isOutboundQueueEmpty());
+  CHECK_EQ(outboundQueueStats.dropped, 0ul);
+
+  // The resolver's final update carries the whole episode
+  std::string record = episodeRecord();
+  CHECK_EQ(rtdb.getNumber(record + "/count"), 300.0);
+  CHECK_NEAR(rtdb.getNumber(record + "/peak"), 899.0, 0.01);
+  CHECK_EQ(rtdb.get(std::string(roverPath(FIREBASE_ALERTS)) + "/last_alert"), std::string("\"HIGH_GAS_LEVEL\""));
+}
+
+// Warning for three minutes, danger for seven, then clean air
+TEST_CASE(tenMinuteLeakCoalesces) {
+  fakeAdvanceMillis(ALERT_RESOLVE_TIMEOUT);
+  serviceAlerts();
+  size_t before = rtdb.requests.size();
+  unsigned long sent = alertStats.sent;
+
+  for (int second = 0; second < 600; second++) {
+    AlertSeverity severity = second < 180 ? SEVERITY_WARNING : SEVERITY_DANGER;
+    leakSecond(400 + (second % 97), severity, second % 2 == 0);
+  }
+  for (int second = 0; second < 30; second++) leakSecond(0, SEVERITY_INFO, second % 2 == 0);
+
+  // New, escalated, one per 30 s rate-limit window and the resolver's final update
+  unsigned long deliveries = alertStats.sent - sent;
+  CHECK(deliveries >= 600 / 30 && deliveries <= 600 / 30 + 3);
+  CHECK_EQ(alertWrites(before), (size_t)(2 * deliveries));  // record + latest fields each
+  printf("LEAKTRACE,readings=600,alerts_sent=%lu,alert_writes=%zu,uncoalesced_round_trips=%d\n",
+         deliveries, alertWrites(before), 600 * 4);
+
+  std::string record = episodeRecord();
+  CHECK_EQ(rtdb.getNumber(record + "/count"), 600.0);
+  CHECK_EQ(rtdb.get(record + "/severity"), std::string("\"DANGER\""));
+  CHECK_NEAR(rtdb.getNumber(record + "/peak"), 496.0, 0.01);
+  CHECK(!getAlert(ALERT_HIGH_GAS).active);
+}
@@ -0,0 +1,91 @@
+/*
+ * Boot Sequencer Tests for ToxiRover
+ * Boots the modular sketch (main.cpp) and times sensors, network and first upload, cold and warm
+ */
+
+#include "test_harness.h"
+#include "fake_rtdb.h"
+#include "boot_sequencer.h"
+#include <ESP8266WiFi.h>
+
+#define FIRST_SAMPLE_LIMIT_MS 100   // sensors never wait on the network
+#define WARM_NETWORK_LIMIT_MS 1000  // resume target with the cached channel
+#define UPLOAD_TIMEOUT_MS 30000
+
+static FakeRtdb rtdb;
+
+void setup();
+void loop();
+
+// loop() on the virtual clock until the milestone is reached; host_main's stall guard included
+static bool runUntil(BootMilestone milestone, unsigned long limitMs) {
+  while (getBootMilestone(milestone) == 0 && millis() < limitMs) {
+    unsigned long before = micros();
+    loop();
+    if (micros() == before) fakeAdvanceMicros(1);
+  }
+  return getBootMilestone(milestone) != 0;
+}
+
+static void reportBoot(const char* kind) {
+  printf("BOOT_TIMES,%s,sensors_ready=%lu,first_sample=%lu,network_up=%lu,first_upload=%lu\n", kind,
+         getBootMilestone(BOOT_SENSORS_READY), getBootMilestone(BOOT_FIRST_SAMPLE),
+         getBootMilestone(BOOT_NETWORK_UP), getBootMilestone(BOOT_FIRST_UPLOAD));
+}
+
+TEST_CASE(coldBootSamplesBeforeTheNetworkIsUp) {
+  fakeSetResetReason(REASON_DEFAULT_RST);
+  setup();
+  CHECK(!isWarmBoot());
+  CHECK(runUntil(BOOT_FIRST_UPLOAD, UPLOAD_TIMEOUT_MS));
+  reportBoot("cold");
+
+  CHECK(getBootMilestone(BOOT_FIRST_SAMPLE) <= FIRST_SAMPLE_LIMIT_MS);
+  CHECK(getBootMilestone(BOOT_FIRST_SAMPLE) < getBootMilestone(BOOT_NETWORK_UP));
+  CHECK(getBootMilestone(BOOT_NETWORK_UP) >= FAKE_WIFI_CONNECT_MS);  // a full scan and association
+  CHECK(getBootMilestone(BOOT_NETWORK_UP) <= getBootMilestone(BOOT_FIRST_UPLOAD));
+  CHECK(warmState.wifiChannel != 0);  // cached for the next restart
+  CHECK(rtdb.requests.size() > 0);
+}
+
+REBOOT_PHASE(warmRestartReusesTheCachedChannel) {
+  fakeSetResetReason(REASON_SOFT_RESTART);
+  setup();
+  CHECK(isWarmBoot());
+  CHECK_EQ(warmState.bootCount, 1u);
+  CHECK(runUntil(BOOT_FIRST_UPLOAD, UPLOAD_TIMEOUT_MS));
+  reportBoot("warm");
+
+  CHECK(getBootMilestone(BOOT_FIRST_SAMPLE) <= FIRST_SAMPLE_LIMIT_MS);
+  CHECK(getBootMilestone(BOOT_NETWORK_UP) < WARM_NETWORK_LIMIT_MS);
+  CHECK(fakeSerialOutput().find("(cached channel)") != std::string::npos);
+}
+
+TEST_CASE(warmRestartResumesInUnderASecond) {
+  CHECK_EQ(rebootInto("warmRestartReusesTheCachedChannel"), 0);
+}
+
+// RTC memory is undefined after power loss, so its contents are never trusted then
+REBOOT_PHASE(powerOnIgnoresRtcMemory) {
+  fakeSetResetReason(REASON_DEFAULT_RST);
+  setup();
+  CHECK(!isWarmBoot());
+  CHECK(runUntil(BOOT_NETWORK_UP, UPLOAD_TIMEOUT_MS));
+  CHECK(getBootMilestone(BOOT_NETWORK_UP) >= FAKE_WIFI_CONNECT_MS);
+}
+
+REBOOT_PHASE(corruptWarmStateBootsCold) {
+  fakeSetResetReason(REASON_EXCEPTION_RST);
+  setup();
+  CHECK(!isWarmBoot());
+  CHECK_EQ(warmState.bootCount, 0u);
+}
+
+TEST_CASE(untrustedRtcMemoryBootsCold) {
+  CHECK_EQ(rebootInto("powerOnIgnoresRtcMemory"), 0);
+
+  WarmState corrupt = warmState;
+  corrupt.crc ^= 1;
+  ESP.rtcUserMemoryWrite(WARM_STATE_RTC_OFFSET, (uint32_t*)&corrupt, sizeof(corrupt));
+  CHECK_EQ(rebootInto("corruptWarmStateBootsCold"), 0);
+}
@@ -0,0 +1,127 @@
+/*
+ * Command Stream Tests for ToxiRover
+ * Dashboard commands pushed through the RTDB stand-in's event stream: idle request rate and latency
+ */
+
+#include "test_harness.h"
+#include "fake_rtdb.h"
+#include "firebase.h"
+#include "task_scheduler.h"
+#include "boot_sequencer.h"
+#include "config_store.h"
+#include "device_id.h"
+
+#define IDLE_WINDOW_MS 60000UL
+#define POLLED_GETS_PER_LOOP 2  // motion_command/request and servo/request, every loop
+
+static FakeRtdb rtdb;
+static TaskId commandsTask;
+
+static MotionCommand lastMotion = MOTION_UNKNOWN;
+static int lastServo = -1;
+static int handlerCalls = 0;
+static unsigned long handledAt = 0;
+
+static void onMotion(MotionCommand command) {
+  lastMotion = command;
+  handlerCalls++;
+  handledAt = millis();
+}
+
+static void onServo(int angle) {
+  lastServo = angle;
+  handlerCalls++;
+  handledAt = millis();
+}
+
+// Requests the rover sent under /commands since `from`
+static size_t commandPathRequests(size_t from) {
+  std::string prefix = roverPath(FIREBASE_COMMANDS);
+  size_t count = 0;
+  for (size_t i = from; i < rtdb.requests.size(); i++) {
+    if (rtdb.requests[i].path.compare(0, prefix.size(), prefix) == 0) count++;
+  }
+  return count;
+}
+
+// Pushes a command as the dashboard does and runs the scheduler until a handler sees it
+static unsigned long pushCommand(const char* node, const std::string& json) {
+  int calls = handlerCalls;
+  unsigned long pushedAt = millis();
+  rtdb.put(roverPath((std::string(FIREBASE_COMMANDS) + node).c_str()), json);
+  while (handlerCalls == calls && millis() - pushedAt < 1000) runSchedulerFor(1);
+  return handlerCalls == calls ? 1000 : handledAt - pushedAt;
+}
+
+TEST_CASE(pendingCommandsAtBootAreNotReplayed) {
+  initBootSequencer();
+  initConfigStore();
+  initFirebase();
+  setFirebaseCommandHandlers(onMotion, onServo);
+  commandsTask = addPeriodicTask("commands", checkFirebaseCommands, 20, PRIORITY_HIGH, 20000);
+  rtdb.put(roverPath((std::string(FIREBASE_COMMANDS) + "/motion").c_str()),
+           "{\"command\":\"FORWARD\",\"issued_at\":1767225600000}");  // left over from the last session
+
+  beginNetwork("lab", "password1");
+  runSchedulerFor(FAKE_WIFI_CONNECT_MS + 1000);
+  serviceFirebaseConnection();
+  runSchedulerFor(200);
+
+  CHECK(isFirebaseConnected());
+  CHECK_EQ(rtdb.openStreams(), (size_t)1);
+  CHECK_EQ(commandStreamStats.events, 1ul);  // the snapshot
+  CHECK_EQ(commandStreamStats.commands, 0ul);
+  CHECK_EQ(handlerCalls, 0);
+}
+
+TEST_CASE(idleStreamSendsNoRequests) {
+  size_t from = rtdb.requests.size();
+  unsigned long restBefore = commandStreamStats.restRequests;
+  unsigned long bytesBefore = rtdb.bytesReceived;
+  runSchedulerFor(IDLE_WINDOW_MS);
+
+  size_t requests = commandPathRequests(from);
+  unsigned long loops = getTask(commandsTask)->runs;
+  printf("COMMAND_STREAM,idle_ms=%lu,requests=%zu,requests_per_s=%.3f,polled_requests_per_s=%.1f,"
+         "bytes_sent=%lu\n", IDLE_WINDOW_MS, requests, requests * 1000.0 / IDLE_WINDOW_MS,
+         loops * POLLED_GETS_PER_LOOP * 1000.0 / IDLE_WINDOW_MS, rtdb.bytesReceived - bytesBefore);
+
+  CHECK_EQ(requests, (size_t)0);
+  CHECK_EQ(commandStreamStats.restRequests, restBefore);
+  CHECK_EQ(commandStreamStats.reconnects, 0ul);  // keep-alive timeouts resume the same stream
+  CHECK_EQ(rtdb.openStreams(), (size_t)1);
+  CHECK(loops > IDLE_WINDOW_MS / 40);            // the task kept reading all along
+}
+
+TEST_CASE(pushedCommandsApplyWithinOneTaskPeriod) {
+  size_t from = rtdb.requests.size();
+  unsigned long worst = 0;
+  for (int i = 0; i < 20; i++) {
+    unsigned long latency = pushCommand("/motion", "{\"command\":\"" + std::string(i % 2 ? "STOP" : "FORWARD") +
+                                        "\",\"issued_at\":" + std::to_string(1767225700000ull + i) + "}");
+    if (latency > worst) worst = latency;
+    runSchedulerFor(7 * i);  // land pushes at different points of the task period
+  }
+  unsigned long servoLatency = pushCommand("/servo", "{\"angle\":45,\"issued_at\":1767225800000}");
+
+  printf("COMMAND_STREAM,commands=%lu,max_latency_ms=%lu,servo_latency_ms=%lu,max_apply_us=%lu\n",
+         commandStreamStats.commands, worst, servoLatency, commandStreamStats.maxApplyMicros);
+
+  CHECK(worst <= 20 + 1);  // the task period; nothing waits on a poll round trip
+  CHECK(servoLatency <= 20 + 1);
+  CHECK_EQ(lastMotion, MOTION_STOP);
+  CHECK_EQ(lastServo, 45);
+  CHECK_EQ(commandStreamStats.commands, 21ul);
+  CHECK_EQ(commandPathRequests(from), (size_t)0);  // no deleteNode after each command either
+}
+
+TEST_CASE(repeatedIssuedAtIsAppliedOnce) {
+  int calls = handlerCalls;
+  rtdb.put(roverPath((std::string(FIREBASE_COMMANDS) + "/servo").c_str()),
+           "{\"angle\":45,\"issued_at\":1767225800000}");  // a dashboard retrying the same write
+  runSchedulerFor(200);
+  CHECK_EQ(handlerCalls, calls);
+
+  CHECK(pushCommand("/servo/angle", "120") <= 20 + 1);  // a bare leaf write has no issued_at
+  CHECK_EQ(lastServo, 120);
+}
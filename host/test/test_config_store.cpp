@@ -0,0 +1,101 @@
+/*
+ * EEPROM Configuration Store Tests for ToxiRover
+ * Power cycles run as reboot phases on the saved flash image
+ */
+
+#include "test_harness.h"
+#include "config_store.h"
+#include "boot_sequencer.h"
+#include "gas_sensor.h"
+#include "ultrasonic.h"
+#include "Wifi_control.h"
+#include <EEPROM.h>
+
+TEST_CASE(erasedFlashLoadsDefaults) {
+  CHECK_EQ(initConfigStore(), CONFIG_DEFAULTS);
+  CHECK_EQ(roverConfig.gasDangerThreshold, (float)GAS_DANGER_THRESHOLD);
+  CHECK_EQ(roverConfig.gasWarningThreshold, (float)GAS_WARNING_THRESHOLD);
+  CHECK_EQ(roverConfig.obstacleThreshold, (int16_t)OBSTACLE_THRESHOLD);
+  CHECK_EQ(roverConfig.motorSpeed, (int16_t)CONFIG_DEFAULT_SPEED);
+  CHECK_EQ(SPEED, CONFIG_DEFAULT_SPEED);  // before setupWiFi() reads the record
+  CHECK_EQ(fakeEepromCommits(), 0ul);  // defaults are not written until something changes
+}
+
+TEST_CASE(saveCommitsOnlyOnChange) {
+  CHECK(saveConfig());
+  CHECK_EQ(fakeEepromCommits(), 1ul);
+  CHECK(saveConfig());
+  CHECK_EQ(fakeEepromCommits(), 1ul);
+
+  roverConfig.gasDangerThreshold = 250;
+  CHECK(saveConfig());
+  CHECK_EQ(fakeEepromCommits(), 2ul);
+}
+
+REBOOT_PHASE(thresholdSurvivesPowerCycle) {
+  CHECK_EQ(initConfigStore(), CONFIG_LOADED);
+  CHECK_EQ(roverConfig.gasDangerThreshold, 250.0f);
+
+  // 150 counts at 2 ppm/count is under the 500 ppm default, over the stored threshold
+  initGasSensor();
+  fakeSetAnalog(A0, 150);
+  readGasSensor();
+  CHECK(isGasDangerous());
+}
+
+TEST_CASE(storedThresholdDrivesGasLevel) {
+  CHECK_EQ(rebootInto("thresholdSurvivesPowerCycle"), 0);
+}
+
+TEST_CASE(speedCommandsPersist) {
+  initBootSequencer();
+  setupWiFi();
+  unsigned long commits = fakeEepromCommits();
+  dispatchCommand('7');
+  CHECK_EQ(roverConfig.motorSpeed, (int16_t)196);
+  CHECK_EQ(fakeEepromCommits(), commits + 1);
+
+  // Repeats and drive commands leave the flash alone
+  dispatchCommand('7');
+  dispatchCommand('F');
+  dispatchCommand('S');
+  CHECK_EQ(fakeEepromCommits(), commits + 1);
+}
+
+REBOOT_PHASE(speedSurvivesPowerCycle) {
+  initBootSequencer();
+  CHECK(!isWarmBoot());  // no RTC state to fall back on
+  setupWiFi();
+  CHECK_EQ(SPEED, 196);
+}
+
+TEST_CASE(speedRestoredAfterPowerCycle) {
+  CHECK_EQ(rebootInto("speedSurvivesPowerCycle"), 0);
+}
+
+REBOOT_PHASE(corruptRecordFallsBackToDefaults) {
+  CHECK_EQ(initConfigStore(), CONFIG_DEFAULTS);
+  CHECK_EQ(roverConfig.gasDangerThreshold, 500.0f);
+  CHECK(!hasWiFiCredentials());
+}
+
+TEST_CASE(crcRejectsCorruptRecord) {
+  fakeEepromFlash()[offsetof(RoverConfig, gasDangerThreshold)] ^= 0x40;
+  CHECK_EQ(rebootInto("corruptRecordFallsBackToDefaults"), 0);
+  fakeEepromFlash()[offsetof(RoverConfig, gasDangerThreshold)] ^= 0x40;
+}
+
+REBOOT_PHASE(legacyCredentialsMigrate) {
+  CHECK_EQ(initConfigStore(), CONFIG_MIGRATED);
+  CHECK_EQ(std::string(roverConfig.ssid), std::string("oldlab"));
+  CHECK_EQ(std::string(roverConfig.password), std::string("secret99"));
+  CHECK_EQ(fakeEepromCommits(), 1ul);  // rewritten once in the new layout
+}
+
+TEST_CASE(legacyLayoutMigrates) {
+  uint8_t* flash = fakeEepromFlash();
+  memset(flash, 0, LEGACY_PASS_ADDR + LEGACY_PASS_LEN);
+  memcpy(flash + LEGACY_SSID_ADDR, "oldlab", 6);
+  memcpy(flash + LEGACY_PASS_ADDR, "secret99", 8);
+  CHECK_EQ(rebootInto("legacyCredentialsMigrate"), 0);
+}
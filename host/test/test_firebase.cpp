@@ -0,0 +1,287 @@
+/*
+ * Firebase Tests for ToxiRover
+ * Runs firebase.cpp and the keep-alive writer against the RTDB stand-in
+ */
+
+#include "test_harness.h"
+#include "fake_rtdb.h"
+#include "firebase.h"
+#include "rtdb_client.h"
+#include "json_writer.h"
+#include "boot_sequencer.h"
+#include "config_store.h"
+#include "device_id.h"
+#include "sample_bus.h"
+#include "outbound_queue.h"
+#include "log_summary.h"
+
+#include <chrono>
+
+static FakeRtdb rtdb;
+
+static std::string rover(const char* path) {
+  return roverPath(path);
+}
+
+// Every request since `from` came from rtdb_client (print=silent writes), none from the library
+static bool allKeepAliveWrites(size_t from) {
+  for (size_t i = from; i < rtdb.requests.size(); i++) {
+    const FakeRtdbRequest& request = rtdb.requests[i];
+    if (request.method == "GET" || request.query.find("print=silent") == std::string::npos) return false;
+  }
+  return true;
+}
+
+TEST_CASE(probeConnectsOnceNetworkIsUp) {
+  initBootSequencer();
+  initConfigStore();
+  initFirebase();
+  CHECK(!isFirebaseConnected());  // boot does not wait on the backend
+
+  beginNetwork("lab", "password1");
+  runSchedulerFor(FAKE_WIFI_CONNECT_MS + 1000);
+  serviceFirebaseConnection();  // picks up the probe reply sent when the network came up
+  CHECK(isFirebaseConnected());
+  CHECK_EQ(rtdb.get(rover("/status")), std::string("\"ONLINE\""));
+  CHECK_EQ(rtdb.get(rover("/sensor_data/servo_angle")), std::string("90"));
+}
+
+TEST_CASE(tickWritesBusSamplesThroughKeepAliveWriter) {
+  publishSample(SAMPLE_GAS_PPM, 123.0f);
+  publishSample(SAMPLE_DISTANCE_CM, 42);
+  publishSample(SAMPLE_MOTION, MOTION_FORWARD);
+  fakeAdvanceMillis(FIREBASE_UPDATE_INTERVAL);
+
+  size_t before = rtdb.requests.size();
+  updateFirebaseData();
+  CHECK(rtdb.requests.size() > before);
+  CHECK(allKeepAliveWrites(before));
+  CHECK_NEAR(rtdb.getNumber(rover("/sensor_data/gas_concentration")), 123.0, 0.01);
+  CHECK_NEAR(rtdb.getNumber(rover("/gas_data/ppm")), 123.0, 0.01);
+  CHECK_EQ(rtdb.get(rover("/sensor_data/distance")), std::string("42"));
+  CHECK_EQ(rtdb.get(rover("/motion_command/current")), std::string("\"FORWARD\""));
+}
+
+TEST_CASE(unchangedTickSendsNothing) {
+  fakeAdvanceMillis(FIREBASE_UPDATE_INTERVAL);
+  size_t before = rtdb.requests.size();
+  updateFirebaseData();
+  CHECK_EQ(rtdb.requests.size(), before);
+}
+
+TEST_CASE(obstacleStatusIsEdgeTriggered) {
+  size_t before = rtdb.requests.size();
+  sendObstacleStatus(18.5f, DISTANCE_DANGER, true);
+  sendObstacleStatus(17.0f, DISTANCE_DANGER, true);
+  CHECK_EQ(rtdb.requests.size(), before + 1);
+  CHECK_EQ(rtdb.get(rover("/ultrasonic_servo/obstacle_detected")), std::string("true"));
+
+  sendObstacleStatus(80.0f, DISTANCE_SAFE, false);
+  CHECK_EQ(rtdb.requests.size(), before + 2);
+  CHECK_EQ(rtdb.get(rover("/ultrasonic_servo/obstacle_detected")), std::string("false"));
+}
+
+TEST_CASE(emergencyStopReachesDashboard) {
+  sendEmergencyStop();
+  CHECK_EQ(rtdb.get(rover("/emergency_stop")), std::string("true"));
+  CHECK_EQ(rtdb.get(rover("/motion_command/current")), std::string("\"STOP\""));
+}
+
+// ---------------------------------------------------------------- tick accounting
+
+TEST_CASE(tickCountsEveryRoundTrip) {
+  for (int i = 0; i < 3; i++) {
+    CHECK(enqueueOutbound(QUEUE_EVENT, QUEUE_OP_PUSH, "/events", "{\"event\":\"replayed\"}"));
+  }
+  publishSample(SAMPLE_GAS_PPM, 300.0f);
+  fakeAdvanceMillis(QUEUE_DRAIN_INTERVAL + FIREBASE_UPDATE_INTERVAL);
+
+  size_t before = rtdb.requests.size();
+  unsigned long ticks = firebaseTickStats.ticks;
+  unsigned long total = firebaseTickStats.requests;
+  updateFirebaseData();
+  CHECK_EQ(rtdb.requests.size(), before + 4);  // three replayed events and the telemetry update
+  CHECK_EQ(firebaseTickStats.lastRequests, 4ul);
+  CHECK_EQ(firebaseTickStats.requests, total + 4);
+  CHECK_EQ(firebaseTickStats.ticks, ticks + 1);
+  CHECK_EQ(rtdb.count(rover("/events")), (size_t)3);
+}
+
+TEST_CASE(tickDurationIncludesReplay) {
+  rtdb.latencyMs = 40;
+  rtdbStop();  // latency applies from the next connection
+  for (int i = 0; i < 2; i++) {
+    CHECK(enqueueOutbound(QUEUE_EVENT, QUEUE_OP_PUSH, "/events", "{\"event\":\"slow\"}"));
+  }
+  fakeAdvanceMillis(QUEUE_DRAIN_INTERVAL);
+
+  unsigned long start = millis();
+  updateFirebaseData();
+  unsigned long elapsed = millis() - start;
+  CHECK_EQ(firebaseTickStats.lastRequests, 2ul);  // telemetry unchanged, replay only
+  CHECK(elapsed >= 80);
+  CHECK_EQ(firebaseTickStats.lastDurationMs, elapsed);
+  CHECK(firebaseTickStats.maxDurationMs >= elapsed);
+
+  rtdb.latencyMs = 0;
+  rtdbStop();
+}
+
+TEST_CASE(quietTickCountsNoRoundTrips) {
+  fakeAdvanceMillis(FIREBASE_UPDATE_INTERVAL);
+  updateFirebaseData();
+  CHECK_EQ(firebaseTickStats.lastRequests, 0ul);
+}
+
+// ---------------------------------------------------------------- sample logger
+
+TEST_CASE(loggerDrainsItsOwnChannel) {
+  BusSample stale;
+  while (consumeSample(BUS_CONSUMER_LOGGER, stale)) {}  // earlier cases never ran the logger
+  publishSample(SAMPLE_GAS_PPM, 77.0f);
+  publishSample(SAMPLE_DISTANCE_CM, 55);
+
+  // No telemetry tick in between: the logger does not depend on it
+  size_t logged = rtdb.count(rover("/logs"));
+  for (int i = 0; i < SAMPLE_BATCH_SIZE; i++) {
+    fakeAdvanceMillis(SAMPLE_LOG_INTERVAL);
+    logDataToFirebase();
+  }
+  CHECK_EQ(rtdb.count(rover("/logs")), logged + SAMPLE_BATCH_SIZE);
+  std::string logs = rtdb.get(rover("/logs"));
+  CHECK(logs.find("\"gas_ppm\":77") != std::string::npos);
+  CHECK(logs.find("\"distance_cm\":55") != std::string::npos);
+}
+
+// The summary is fed from the logger channel; the telemetry tick only uploads it
+TEST_CASE(loggerFeedsLogSummary) {
+  uint32_t drops = getSampleBusDrops(BUS_CONSUMER_LOGGER);
+  const int steps = (LOG_SUMMARY_POINTS + 1) * LOG_SUMMARY_WINDOW / 500;
+  for (int step = 0; step < steps; step++) {
+    publishSample(SAMPLE_GAS_PPM, 50.0f + step % 20);
+    fakeAdvanceMillis(500);
+    if (step % (SAMPLE_LOG_INTERVAL / 500) == 0) logDataToFirebase();
+  }
+  CHECK_EQ(rtdb.count(rover("/log_summary")), (size_t)0);
+
+  fakeAdvanceMillis(FIREBASE_UPDATE_INTERVAL);
+  updateFirebaseData();
+  CHECK_EQ(rtdb.count(rover("/log_summary")), (size_t)1);
+  std::string summary = rtdb.get(rover("/log_summary"));
+  CHECK(summary.find("\"n\":\"120,120,120") != std::string::npos);  // every 500 ms sample, none lost to the slower drain
+  CHECK(summary.find("\"gaps\":{\"count\":1,") != std::string::npos);  // only the idle stretch after the previous case
+  CHECK_EQ(getSampleBusDrops(BUS_CONSUMER_LOGGER), drops);
+}
+
+// ---------------------------------------------------------------- rtdb_client failure paths
+
+static bool probeWrite() {
+  static const char body[] = "{\"probe\":1}";
+  return rtdbWrite(RTDB_PATCH, "/diagnostics", body, sizeof(body) - 1);
+}
+
+TEST_CASE(keptAliveWritesReuseTheConnection) {
+  CHECK(probeWrite());
+  unsigned long connects = rtdbStats.connects;
+  CHECK(probeWrite());
+  CHECK(probeWrite());
+  CHECK_EQ(rtdbStats.connects, connects);
+}
+
+TEST_CASE(garbledReplyDropsTheConnection) {
+  unsigned long connects = rtdbStats.connects;
+  rtdb.setFault(FAKE_RTDB_GARBLED, 0, 1);
+  CHECK(!probeWrite());
+  CHECK_EQ(rtdbStats.lastStatus, -1);
+  CHECK(probeWrite());  // a fresh socket, not the rest of the garbled reply
+  CHECK_EQ(rtdbStats.connects, connects + 1);
+}
+
+TEST_CASE(serverErrorDropsTheConnection) {
+  unsigned long connects = rtdbStats.connects;
+  rtdb.setFault(FAKE_RTDB_STATUS, 503, 1);
+  CHECK(!probeWrite());
+  CHECK_EQ(rtdbStats.lastStatus, 503);
+  CHECK(probeWrite());
+  CHECK_EQ(rtdbStats.connects, connects + 1);
+}
+
+TEST_CASE(stalledReplyTimesOutAndReconnects) {
+  unsigned long connects = rtdbStats.connects;
+  rtdb.setFault(FAKE_RTDB_STALL, 0, 1);
+  unsigned long start = millis();
+  CHECK(!probeWrite());
+  CHECK(millis() - start <= FIREBASE_READ_TIMEOUT + 100);
+  CHECK(probeWrite());
+  CHECK_EQ(rtdbStats.connects, connects + 1);
+}
+
+// ---------------------------------------------------------------- JsonWriter vs FirebaseJson
+
+#define PAYLOAD_ROUNDS 2000
+
+static void fillTelemetry(JsonWriter& writer, int round) {
+  writer.reset();
+  writer.beginObject();
+  writer.add("sensor_data/gas_concentration", 100.0 + round % 50);
+  writer.add("gas_data/ppm", 100.0 + round % 50);
+  writer.add("sensor_data/distance", 40 + round % 7);
+  writer.add("ultrasonic_distance", 40 + round % 7);
+  writer.add("sensor_data/motion", "FORWARD");
+  writer.add("sensor_data/timestamp", 1767225600000ULL + round);
+  writer.endObject();
+}
+
+static void fillTelemetry(FirebaseJson& json, int round) {
+  json.clear();
+  json.add("sensor_data/gas_concentration", 100.0 + round % 50);
+  json.add("gas_data/ppm", 100.0 + round % 50);
+  json.add("sensor_data/distance", 40 + round % 7);
+  json.add("ultrasonic_distance", 40 + round % 7);
+  json.add("sensor_data/motion", "FORWARD");
+  json.add("sensor_data/timestamp", String("1767225600000"));
+}
+
+struct PayloadRun {
+  unsigned long allocations;
+  unsigned long bytes;
+  double seconds;
+};
+
+template <typename Write>
+static PayloadRun measurePayloads(Write write) {
+  FakeHeapStats heapBefore = fakeHeapStats();
+  unsigned long bytesBefore = rtdb.bytesReceived;
+  auto start = std::chrono::steady_clock::now();
+  for (int round = 0; round < PAYLOAD_ROUNDS; round++) write(round);
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  return {fakeHeapStats().allocations - heapBefore.allocations, rtdb.bytesReceived - bytesBefore, elapsed.count()};
+}
+
+static void printPayloadRun(const char* name, const PayloadRun& run) {
+  printf("PAYLOAD,%s,writes=%d,bytes=%lu,allocs_per_write=%.2f,bytes_per_s=%.0f\n", name, PAYLOAD_ROUNDS,
+         run.bytes, (double)run.allocations / PAYLOAD_ROUNDS, run.seconds > 0 ? run.bytes / run.seconds : 0.0);
+}
+
+TEST_CASE(jsonWriterTicksAllocateNothing) {
+  static char buffer[FIREBASE_PAYLOAD_SIZE];
+  static JsonWriter writer(buffer, sizeof(buffer));
+  probeWrite();  // connection open before counting
+
+  PayloadRun writerRun = measurePayloads([](int round) {
+    fillTelemetry(writer, round);
+    rtdbWrite(RTDB_PATCH, "/bench", writer.c_str(), writer.length());
+  });
+
+  static FirebaseJson json;
+  FirebaseData& data = firebaseDataObj;
+  PayloadRun libraryRun = measurePayloads([&data](int round) {
+    fillTelemetry(json, round);
+    Firebase.updateNode(data, "/bench", json);
+  });
+
+  printPayloadRun("jsonwriter", writerRun);
+  printPayloadRun("firebasejson", libraryRun);
+  CHECK_EQ(writerRun.allocations, 0ul);
+  CHECK(libraryRun.allocations >= (unsigned long)PAYLOAD_ROUNDS);
+}
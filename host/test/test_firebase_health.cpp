@@ -0,0 +1,116 @@
+/*
+ * Firebase Connection Health Tests for ToxiRover
+ * A stalled, refusing and flaky RTDB stand-in behind the scheduled Firebase tasks
+ */
+
+#include "test_harness.h"
+#include "fake_rtdb.h"
+#include "firebase.h"
+#include "outbound_queue.h"
+#include "task_scheduler.h"
+#include "boot_sequencer.h"
+#include "config_store.h"
+#include "device_id.h"
+
+#define TASK_BLOCK_LIMIT_US 100000UL  // FIREBASE_STALL_THRESHOLD
+
+static FakeRtdb rtdb;
+static TaskId commandsTask;
+static TaskId firebaseTask;
+
+TEST_CASE(stalledBackendNeverBlocksTasks) {
+  rtdb.connectMs = 30;  // TLS handshake
+  rtdb.setFault(FAKE_RTDB_STALL);
+
+  initBootSequencer();
+  initConfigStore();
+  initFirebase();
+  commandsTask = addPeriodicTask("commands", checkFirebaseCommands, 20, PRIORITY_HIGH, 20000);
+  firebaseTask = addPeriodicTask("firebase", updateFirebaseData, FIREBASE_UPDATE_INTERVAL, PRIORITY_LOW);
+  beginNetwork("lab", "password1");
+  runSchedulerFor(30000);
+
+  CHECK(!isFirebaseConnected());
+  CHECK(firebaseHealthStats.probes >= 2);
+  CHECK(firebaseHealthStats.probeFailures + 1 >= firebaseHealthStats.probes);  // the last may still be in flight
+  CHECK(firebaseHealthStats.maxProbeMs >= FIREBASE_READ_TIMEOUT);            // each waited out the timeout...
+  CHECK_EQ(firebaseHealthStats.stalls, 0ul);                                  // ...without holding the loop
+  CHECK(getTask(commandsTask)->maxRunMicros < TASK_BLOCK_LIMIT_US);
+  CHECK(getTask(firebaseTask)->maxRunMicros < TASK_BLOCK_LIMIT_US);
+  CHECK(getTask(commandsTask)->maxLatencyMs < 50);
+}
+
+TEST_CASE(refusedProbesBackOffExponentially) {
+  rtdb.setFault(FAKE_RTDB_OK);
+  rtdb.refuse = true;
+
+  std::vector<unsigned long> probeTimes;
+  unsigned long probes = firebaseHealthStats.probes;
+  unsigned long end = millis() + 150000;
+  while (millis() < end) {
+    runSchedulerFor(100);
+    if (firebaseHealthStats.probes != probes) {
+      probes = firebaseHealthStats.probes;
+      probeTimes.push_back(millis());
+    }
+  }
+
+  CHECK(probeTimes.size() >= 4);
+  for (size_t i = 2; i < probeTimes.size(); i++) {
+    unsigned long gap = probeTimes[i] - probeTimes[i - 1];
+    unsigned long previous = probeTimes[i - 1] - probeTimes[i - 2];
+    CHECK(gap * 4 >= previous * 2);  // doubling, give or take the +/-25% jitter
+    CHECK(gap <= FIREBASE_BACKOFF_MAX * 5 / 4 + FIREBASE_UPDATE_INTERVAL);
+  }
+  CHECK(probeTimes.size() < 15);  // not a retry storm
+  CHECK_EQ(firebaseHealthStats.stalls, 0ul);
+}
+
+TEST_CASE(recoversOnceBackendReturns) {
+  rtdb.refuse = false;
+  unsigned long start = millis();
+  while (!isFirebaseConnected() && millis() - start < FIREBASE_BACKOFF_MAX * 2) runSchedulerFor(100);
+  CHECK(isFirebaseConnected());
+  CHECK_EQ(firebaseHealthStats.backoffMs, (unsigned long)FIREBASE_BACKOFF_MIN);
+  CHECK_EQ(rtdb.get(std::string(roverPath(FIREBASE_STATUS))), std::string("\"ONLINE\""));
+}
+
+TEST_CASE(failingWritesQueueInstantly) {
+  rtdb.setFault(FAKE_RTDB_STATUS, 503);
+  sendEmergencyStop();  // fails and is queued
+  fakeAdvanceMillis(QUEUE_DRAIN_INTERVAL);
+  updateFirebaseData();  // the replay fails too: link marked down
+  CHECK(!isFirebaseConnected());
+
+  unsigned long depth = getOutboundQueueDepth();
+  unsigned long start = millis();
+  sendEmergencyStop();
+  CHECK_EQ(millis() - start, 0ul);  // no round trip while the link is down
+  CHECK_EQ(getOutboundQueueDepth(), depth + 1);
+
+  rtdb.setFault(FAKE_RTDB_OK);
+  start = millis();
+  while ((!isFirebaseConnected() || !isOutboundQueueEmpty()) && millis() - start < 60000) runSchedulerFor(100);
+  CHECK(isOutboundQueueEmpty());
+  CHECK_EQ(rtdb.get(std::string(roverPath("/emergency_stop"))), std::string("true"));
+  CHECK(getTask(commandsTask)->maxRunMicros < TASK_BLOCK_LIMIT_US);
+}
+
+// Every other write fails for two minutes: the link flaps but the loop never stalls
+TEST_CASE(flakyBackendKeepsLoopResponsive) {
+  unsigned long start = millis();
+  while (millis() - start < 120000) {
+    rtdb.setFault(FAKE_RTDB_STATUS, 500, 1);
+    sendObstacleStatus(15.0f, DISTANCE_DANGER, true);
+    sendObstacleStatus(90.0f, DISTANCE_SAFE, false);
+    runSchedulerFor(1000);
+  }
+  rtdb.setFault(FAKE_RTDB_OK);
+  CHECK_EQ(outboundQueueStats.dropped, 0ul);
+  CHECK_EQ(firebaseHealthStats.stalls, 0ul);
+  CHECK(getTask(commandsTask)->maxRunMicros < TASK_BLOCK_LIMIT_US);
+  CHECK(getTask(firebaseTask)->maxRunMicros < TASK_BLOCK_LIMIT_US);
+  printf("FLAKY,probes=%lu,probe_failures=%lu,disconnects=%lu,max_probe_ms=%lu,stalls=%lu\n",
+         firebaseHealthStats.probes, firebaseHealthStats.probeFailures, firebaseHealthStats.disconnects,
+         firebaseHealthStats.maxProbeMs, firebaseHealthStats.stalls);
+}
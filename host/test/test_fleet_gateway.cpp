@@ -0,0 +1,259 @@
+/*
+ * Fleet Gateway Tests for ToxiRover
+ * Per-rover namespacing, the bounded fleet table, and a load test of the booted sketch with 120 simulated rovers
+ */
+
+#include "test_harness.h"
+#include "fleet_gateway.h"
+#include "device_id.h"
+#include "firebase.h"
+#include "WANconnection.h"
+#include "boot_sequencer.h"
+#include "config_store.h"
+#include "task_scheduler.h"
+
+#include <chrono>
+
+#define AIO_USER "YOUR_ADAFRUIT_USERNAME"
+#define CHIP_ID 0xC0FFEE
+#define LOAD_ROVERS FLEET_BENCH_ROVERS
+#define LOAD_SECONDS 60
+#define FRAME_COST_LIMIT_NS 2000  // per frame through fleetTableAdd() on the host
+
+static FleetTable table;
+
+void setup();
+
+static std::vector<uint8_t> roverFrame(uint32_t device, uint8_t seq, float ppm, bool alarm, uint32_t stamp = 0) {
+  TelemetryFrame frame;
+  memset(&frame, 0, sizeof(frame));
+  frame.device = device;
+  frame.seq = seq;
+  frame.stamp = stamp;
+  setTelemetryFrameGas(frame, ppm);
+  setTelemetryFramePose(frame, device % 500, -(int)(device % 300), 0);
+  if (alarm) frame.flags = FRAME_FLAG_GAS_ALARM;
+  uint8_t bytes[TELEMETRY_FRAME_MAX_SIZE];
+  size_t length = encodeTelemetryFrame(frame, bytes, sizeof(bytes));
+  return std::vector<uint8_t>(bytes, bytes + length);
+}
+
+static FleetResult add(const std::vector<uint8_t>& bytes, unsigned long now) {
+  return fleetTableAdd(table, bytes.data(), bytes.size(), now);
+}
+
+static std::string view(unsigned long now) {
+  static char buffer[FLEET_VIEW_SIZE];
+  JsonWriter writer(buffer, sizeof(buffer));
+  writer.beginObject();
+  writeFleetView(table, writer, now);
+  writer.endObject();
+  return writer.ok() ? buffer : "";
+}
+
+// ---------------------------------------------------------------- namespacing
+
+TEST_CASE(everyPathAndFeedCarriesTheChipId) {
+  fakeSetChipId(CHIP_ID);  // before the id is first derived and cached
+  CHECK_EQ(std::string(getDeviceId()), std::string("c0ffee"));
+  CHECK_EQ(std::string(getDeviceHostname()), std::string("ToxiRover-c0ffee"));
+  CHECK_EQ(std::string(roverPath(FIREBASE_GAS_DATA)), std::string("/rovers/c0ffee") + FIREBASE_GAS_DATA);
+  CHECK_EQ(std::string(roverPath("/")), std::string("/rovers/c0ffee"));
+
+  char topic[96];
+  CHECK_EQ(std::string(formatDeviceFeed(topic, sizeof(topic), AIO_USER, "forward")),
+           std::string(AIO_USER "/f/rover-c0ffee.forward"));
+}
+
+// ---------------------------------------------------------------- fleet table
+
+TEST_CASE(framesAreKeyedByDevice) {
+  fleetTableReset(table);
+  CHECK_EQ(add(roverFrame(0xA1, 0, 50, false), 1000), FLEET_NEW_ROVER);
+  CHECK_EQ(add(roverFrame(0xB2, 0, 60, false), 1000), FLEET_NEW_ROVER);
+  CHECK_EQ(add(roverFrame(0xA1, 1, 70, false), 2000), FLEET_ACCEPTED);
+  CHECK_EQ(table.count, 2);
+  CHECK_EQ(table.frames, 3ul);
+
+  std::vector<uint8_t> anonymous = roverFrame(0, 0, 50, false);
+  CHECK_EQ(add(anonymous, 2000), FLEET_REJECTED);  // no device id: a pre-fleet rover
+  const uint8_t junk[] = {'x', 'y', 'z'};
+  CHECK_EQ(fleetTableAdd(table, junk, sizeof(junk), 2000), FLEET_REJECTED);
+  CHECK_EQ(table.rejected, 2ul);
+}
+
+TEST_CASE(chattyRoversAreRateLimitedAndGapsCounted) {
+  CHECK_EQ(add(roverFrame(0xA1, 2, 70, false), 2000 + FLEET_MIN_FRAME_MS / 2), FLEET_RATE_LIMITED);
+  CHECK_EQ(table.rateLimited, 1ul);
+  CHECK_EQ(add(roverFrame(0xA1, 3, 70, false), 2000 + FLEET_MIN_FRAME_MS), FLEET_ACCEPTED);
+  CHECK_EQ(add(roverFrame(0xA1, 6, 70, false), 4000), FLEET_ACCEPTED);  // 4 and 5 lost
+  std::string json = view(4000);
+  CHECK(json.find("\"lost\":2") != std::string::npos);
+  CHECK(json.find("\"rate_limited\":1") != std::string::npos);
+}
+
+// UDP repeats and reorders; only a forward step is a gap, and a restart starts over
+TEST_CASE(repeatsAndRestartsAreNotLosses) {
+  fleetTableReset(table);
+  unsigned long now = 1000;
+  CHECK_EQ(add(roverFrame(0xC1, 10, 50, false, 20000), now), FLEET_NEW_ROVER);
+  CHECK_EQ(add(roverFrame(0xC1, 12, 50, false, 24000), now += 2000), FLEET_ACCEPTED);   // 11 lost
+  CHECK_EQ(add(roverFrame(0xC1, 12, 50, false, 24000), now += 10), FLEET_OUT_OF_ORDER);  // duplicate
+  CHECK_EQ(add(roverFrame(0xC1, 11, 60, false, 22000), now += 10), FLEET_OUT_OF_ORDER);  // one late
+  CHECK_EQ(table.rovers[0].latest.seq, 12);  // the newer frame stays
+  CHECK_EQ(table.rovers[0].lost, 1ul);
+
+  // A reboot resets both the sequence and the clock
+  CHECK_EQ(add(roverFrame(0xC1, 0, 50, false, 1500), now += 2000), FLEET_ACCEPTED);
+  CHECK_EQ(add(roverFrame(0xC1, 1, 50, false, 3500), now += 2000), FLEET_ACCEPTED);
+  CHECK_EQ(table.rovers[0].lost, 1ul);
+  CHECK_EQ(table.outOfOrder, 2ul);
+
+  // Far ahead is as likely a stale datagram as 200 lost frames
+  CHECK_EQ(add(roverFrame(0xC1, 1 + FLEET_SEQ_WINDOW, 50, false, 5500), now += 2000), FLEET_OUT_OF_ORDER);
+  CHECK(view(now).find("\"lost\":1,") != std::string::npos);
+}
+
+TEST_CASE(viewRanksAlarmsFirstAndDropsStaleRovers) {
+  fleetTableReset(table);
+  for (uint32_t i = 1; i <= 20; i++) add(roverFrame(0x100 + i, 0, i * 10, false), 1000);
+  add(roverFrame(0x999, 0, 5, true), 1000);              // low reading, but in alarm
+  add(roverFrame(0x777, 0, 900, false), 1000 - FLEET_STALE_MS);  // highest, but long silent
+
+  std::string json = view(1000 + FLEET_STALE_MS / 2);
+  CHECK(json.find("\"rovers\":22") != std::string::npos);
+  CHECK(json.find("\"online\":21") != std::string::npos);
+  CHECK(json.find("\"alarms\":1") != std::string::npos);
+  CHECK(json.find("\"gas_max_ppm\":200.0") != std::string::npos);
+  CHECK(json.find("\"top\":{\"000999\":\"5.0,") != std::string::npos);
+  CHECK(json.find("\"000114\"") != std::string::npos);  // 200 ppm, first after the alarm
+  CHECK(json.find("000777") == std::string::npos);
+  CHECK(json.find("000101") == std::string::npos);      // beyond the top five
+}
+
+TEST_CASE(fullTableEvictsTheLongestSilentRover) {
+  fleetTableReset(table);
+  for (uint32_t i = 0; i < FLEET_MAX_ROVERS; i++) add(roverFrame(0x1000 + i, 0, 50, false), 1000 + i);
+  CHECK_EQ(table.count, FLEET_MAX_ROVERS);
+  CHECK_EQ(add(roverFrame(0x9000, 0, 50, false), 5000), FLEET_NEW_ROVER);
+  CHECK_EQ(table.count, FLEET_MAX_ROVERS);
+  CHECK_EQ(table.evictions, 1ul);
+
+  // The first rover was the one dropped; everyone else is still found in place
+  CHECK_EQ(add(roverFrame(0x1001, 1, 50, false), 6000), FLEET_ACCEPTED);
+  CHECK_EQ(add(roverFrame(0x1000, 1, 50, false), 6000), FLEET_NEW_ROVER);
+  CHECK_EQ(table.evictions, 2ul);
+}
+
+TEST_CASE(fanInCostIsConstantPerFrame) {
+  fleetTableReset(table);
+  std::vector<std::vector<uint8_t>> frames;
+  for (uint32_t i = 0; i < FLEET_MAX_ROVERS; i++) {
+    frames.push_back(roverFrame(0x100000 + i * 7919, 0, 20 + i, i % 17 == 0));
+  }
+
+  const int rounds = 500;
+  unsigned long now = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int round = 0; round < rounds; round++) {
+    for (std::vector<uint8_t>& frame : frames) {
+      frame[3]++;  // sequence
+      add(frame, now);
+    }
+    now += TELEMETRY_FRAME_INTERVAL;
+  }
+  double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+              (rounds * FLEET_MAX_ROVERS);
+
+  std::string json = view(now);
+  printf("FLEET_TABLE,rovers=%d,table_bytes=%zu,frames=%lu,ns_per_frame=%.1f,view_bytes=%zu\n", FLEET_MAX_ROVERS,
+         sizeof(FleetTable), table.frames, ns, json.size());
+  CHECK_EQ(table.frames, (unsigned long)rounds * FLEET_MAX_ROVERS);
+  CHECK(ns < FRAME_COST_LIMIT_NS);
+  CHECK(!json.empty() && json.size() < FLEET_VIEW_SIZE);  // fixed size, however many rovers report
+}
+
+// ---------------------------------------------------------------- live gateway
+
+static std::vector<std::string> fleetViews() {
+  std::vector<std::string> views;
+  std::string topic = AIO_USER "/f/fleet";
+  for (const FakeMqttMessage& message : fakeMqttPublished()) {
+    if (message.topic == topic) views.push_back(message.payload);
+  }
+  return views;
+}
+
+static const SchedulerTask* findTask(const char* name) {
+  for (TaskId id = 0; id < SCHEDULER_MAX_TASKS; id++) {
+    const SchedulerTask* task = getTask(id);
+    if (task && task->name && strcmp(task->name, name) == 0) return task;
+  }
+  return NULL;
+}
+
+// 120 rovers broadcasting every 2 s, phases spread, into the gateway main.cpp sets up
+TEST_CASE(gatewayMergesALoadedFleet) {
+  fakeSerialClear();
+  setup();
+  CHECK(fakeSerialOutput().find("full, task not added") == std::string::npos);
+  const char* const tasks[] = {"fleetRx", "fleetView", "gas", "stats", "bootStats", "profiler"};
+  for (const char* name : tasks) CHECK(findTask(name) != NULL);
+  runSchedulerFor(FAKE_WIFI_CONNECT_MS + 1000);  // network up, MQTT connected
+  size_t viewsBefore = fleetViews().size();
+
+  std::vector<std::vector<uint8_t>> frames;
+  for (uint32_t i = 0; i < LOAD_ROVERS; i++) {
+    frames.push_back(roverFrame(0x200000 + i * 104729, 0, 20 + i, i == 42));
+  }
+  unsigned long start = millis();
+  for (unsigned long t = 0; t < LOAD_SECONDS * 1000UL; t += FLEET_RECEIVE_INTERVAL) {
+    for (uint32_t i = 0; i < LOAD_ROVERS; i++) {
+      if ((t + i * 16) % TELEMETRY_FRAME_INTERVAL >= FLEET_RECEIVE_INTERVAL) continue;
+      frames[i][3]++;
+      fakeUdpInject(FLEET_UDP_PORT, frames[i].data(), frames[i].size());
+    }
+    while (millis() - start < t + FLEET_RECEIVE_INTERVAL) runSchedulerFor(FLEET_RECEIVE_INTERVAL);
+  }
+
+  std::vector<std::string> views = fleetViews();
+  CHECK_EQ(views.size() - viewsBefore, (size_t)(LOAD_SECONDS * 1000 / FLEET_VIEW_INTERVAL));  // one per interval
+  const std::string& last = views.back();
+  printf("FLEET_LOAD,rovers=%d,seconds=%d,views=%zu,view_bytes=%zu\n", LOAD_ROVERS, LOAD_SECONDS,
+         views.size() - viewsBefore, last.size());
+  CHECK(last.find("\"gateway\":\"c0ffee\"") != std::string::npos);
+  CHECK(last.find("\"rovers\":121,\"online\":121,\"alarms\":1") != std::string::npos);  // and the gateway itself
+  CHECK(last.find("\"lost\":0") != std::string::npos);
+  CHECK(last.find("\"rate_limited\":0") != std::string::npos);
+  CHECK(last.find("\"evictions\":0") != std::string::npos);
+  CHECK(last.size() < FLEET_VIEW_SIZE);
+}
+
+// Frames the gateway took off the socket so far, whatever became of them
+static unsigned long handledFrames() {
+  fakeSerialClear();
+  printFleetStats();
+  std::string stats = fakeSerialOutput();
+  return strtoul(stats.substr(stats.find("Frames: ") + 8).c_str(), NULL, 10) +
+         strtoul(stats.substr(stats.find("Rate limited: ") + 14).c_str(), NULL, 10) +
+         strtoul(stats.substr(stats.find("Out of order: ") + 14).c_str(), NULL, 10);
+}
+
+// A burst is drained over several ticks instead of in one long one; repeats are not losses
+TEST_CASE(burstsAreDrainedABoundedAmountPerTick) {
+  std::vector<uint8_t> frame = roverFrame(0x300000, 0, 50, false);
+  for (int i = 0; i < 3 * FLEET_MAX_PACKETS; i++) fakeUdpInject(FLEET_UDP_PORT, frame.data(), frame.size());
+
+  unsigned long before = handledFrames();
+  for (int tick = 1; tick <= 3; tick++) {
+    serviceFleetGateway();
+    CHECK_EQ(handledFrames(), before + tick * FLEET_MAX_PACKETS);
+  }
+  serviceFleetGateway();
+  CHECK_EQ(handledFrames(), before + 3 * FLEET_MAX_PACKETS);
+
+  publishFleetView();
+  const std::string& last = fleetViews().back();
+  CHECK(last.find("\"lost\":0,") != std::string::npos);
+  CHECK(last.find("\"rovers\":122,") != std::string::npos);
+}
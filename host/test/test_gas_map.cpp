@@ -0,0 +1,158 @@
+/*
+ * Gas Map Tests for ToxiRover
+ * Cell statistics, the bounded tile store, changed-tile uploads and the dead-reckoned pose
+ */
+
+#include "test_harness.h"
+#include "gas_map.h"
+#include "dead_reckoning.h"
+
+#include <chrono>
+
+#define MAP_BYTES_LIMIT 4096   // the whole store, statically allocated
+#define ADD_COST_LIMIT_NS 2000 // mean gasMapAdd on the host, with misses and evictions
+#define TILE_CM (GAS_MAP_TILE_SIZE * GAS_MAP_CELL_CM)
+
+static GasMap map;
+
+static bool allTilesFindable() {
+  for (int i = 0; i < map.tileCount; i++) {
+    if (gasMapFind(map, map.tiles[i].tx, map.tiles[i].ty) != &map.tiles[i]) return false;
+  }
+  return true;
+}
+
+TEST_CASE(cellsKeepMeanMaxAndCount) {
+  gasMapReset(map);
+  CHECK(gasMapAdd(map, 10, 10, 100, 1));
+  CHECK(gasMapAdd(map, 20, 5, 300, 2));  // same 25 cm cell
+  CHECK(gasMapAdd(map, 30, 10, 50, 3));  // next cell along x
+
+  GasMapTile* tile = gasMapFind(map, 0, 0);
+  CHECK(tile != NULL);
+  CHECK_EQ(map.tileCount, 1);
+  CHECK_EQ(tile->cells[0].count, 2);
+  CHECK_NEAR(tile->cells[0].mean, 200.0, 0.01);
+  CHECK_EQ(tile->cells[0].max, 300);
+  CHECK_EQ(tile->cells[1].count, 1);
+  CHECK_EQ(tile->dirtyCells, 0x3);
+  CHECK_EQ(map.samples, 3ul);
+}
+
+TEST_CASE(negativeCoordinatesFloorIntoTheirTiles) {
+  gasMapAdd(map, -1, -1, 80, 4);
+  GasMapTile* tile = gasMapFind(map, -1, -1);
+  CHECK(tile != NULL);
+  CHECK_EQ(tile->cells[GAS_MAP_TILE_CELLS - 1].count, 1);  // top-right cell of the tile below-left of the origin
+
+  gasMapAdd(map, -TILE_CM, 0, 80, 5);
+  CHECK(gasMapFind(map, -1, 0) != NULL);
+  gasMapAdd(map, -TILE_CM - 1, 0, 80, 6);
+  CHECK(gasMapFind(map, -2, 0) != NULL);
+  CHECK(!gasMapAdd(map, 40000.0f * TILE_CM, 0, 80, 7));  // beyond the int16 tile range
+}
+
+TEST_CASE(storeStaysBoundedAndEvictsCleanTilesFirst) {
+  gasMapReset(map);
+  unsigned long now = 0;
+  for (int i = 0; i < GAS_MAP_MAX_TILES; i++) gasMapAdd(map, i * TILE_CM, 0, 100, ++now);
+  CHECK_EQ(map.tileCount, GAS_MAP_MAX_TILES);
+  CHECK_EQ(map.evictions, 0ul);
+
+  // Upload all but the oldest tile; the oldest clean one goes when a new tile arrives
+  for (int i = 1; i < GAS_MAP_MAX_TILES; i++) gasMapMarkSent(map, *gasMapFind(map, i, 0));
+  gasMapAdd(map, 0, TILE_CM, 100, ++now);
+  CHECK_EQ(map.tileCount, GAS_MAP_MAX_TILES);
+  CHECK_EQ(map.evictions, 1ul);
+  CHECK_EQ(map.dirtyEvictions, 0ul);
+  CHECK(gasMapFind(map, 0, 0) != NULL);   // dirty, kept
+  CHECK(gasMapFind(map, 1, 0) == NULL);   // oldest clean
+  CHECK(allTilesFindable());
+
+  // A long wander keeps memory fixed and the hash consistent through many evictions
+  for (int i = 0; i < 50 * GAS_MAP_MAX_TILES; i++) {
+    gasMapAdd(map, (i % 37) * TILE_CM, (i / 37) * TILE_CM, 100, ++now);
+  }
+  CHECK_EQ(map.tileCount, GAS_MAP_MAX_TILES);
+  CHECK(map.evictions > (unsigned long)(40 * GAS_MAP_MAX_TILES));
+  CHECK(allTilesFindable());
+}
+
+TEST_CASE(updatesCostNoHeapAndStayCheap) {
+  CHECK(sizeof(GasMap) <= MAP_BYTES_LIMIT);
+
+  gasMapReset(map);
+  FakeHeapStats before = fakeHeapStats();
+  const int adds = 200000;
+  unsigned long now = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < adds; i++) {
+    float x = (i * 7) % 1000;                     // lawnmower sweep as in the device benchmark
+    float y = (float)((i * 7 / 1000) % 10) * 60;
+    gasMapAdd(map, x, y, 120, ++now);
+  }
+  double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / adds;
+  FakeHeapStats after = fakeHeapStats();
+
+  printf("GAS_MAP,bytes=%zu,tile_bytes=%zu,max_tiles=%d,adds=%d,evictions=%lu,ns_per_add=%.1f\n", sizeof(GasMap),
+         sizeof(GasMapTile), GAS_MAP_MAX_TILES, adds, map.evictions, ns);
+  CHECK_EQ(after.allocations, before.allocations);
+  CHECK(map.evictions > 0);
+  CHECK(ns < ADD_COST_LIMIT_NS);
+}
+
+TEST_CASE(onlyChangedCellsAreUploaded) {
+  resetPose();
+  gasMapReset(gasMap);
+  recordGasAtPose(150);                       // cell 0 of tile 0_0
+  gasMapAdd(gasMap, TILE_CM + 30, 0, 90, millis() + 1);  // a second tile, changed later
+
+  char buffer[GAS_MAP_TILE_JSON_SIZE];
+  GasMapTile* tile = NULL;
+  std::string json = formatNextGasTile(buffer, sizeof(buffer), &tile);
+  CHECK(json.find("\"tile\":\"0_0\"") != std::string::npos);  // oldest change first
+  CHECK(json.find("\"c0\":\"150,150,1\"") != std::string::npos);
+  gasMapMarkSent(gasMap, *tile);
+
+  json = formatNextGasTile(buffer, sizeof(buffer), &tile);
+  CHECK(json.find("\"tile\":\"1_0\"") != std::string::npos);
+  gasMapMarkSent(gasMap, *tile);
+  CHECK(formatNextGasTile(buffer, sizeof(buffer), &tile) == NULL);
+  CHECK(tile == NULL);
+
+  fakeAdvanceMillis(10);
+  recordGasAtPose(250);                       // same cell again: only it is sent, with the new stats
+  json = formatNextGasTile(buffer, sizeof(buffer), &tile);
+  CHECK(json.find("\"c0\":\"200,250,2\"") != std::string::npos);
+  CHECK(json.find("\"c1\"") == std::string::npos);
+  CHECK_EQ(gasMap.uploads, 2ul);
+}
+
+TEST_CASE(fullTileFitsOnePayload) {
+  gasMapReset(gasMap);
+  for (int i = 0; i < GAS_MAP_TILE_CELLS; i++) {
+    float x = (i % GAS_MAP_TILE_SIZE) * GAS_MAP_CELL_CM, y = (i / GAS_MAP_TILE_SIZE) * GAS_MAP_CELL_CM;
+    gasMapAdd(gasMap, x, y, 65535, 1);
+    gasMapFind(gasMap, 0, 0)->cells[i].count = UINT16_MAX;  // saturated counts are the longest values
+  }
+  char buffer[GAS_MAP_TILE_JSON_SIZE];
+  GasMapTile* tile = NULL;
+  CHECK(formatNextGasTile(buffer, sizeof(buffer), &tile) != NULL);
+}
+
+TEST_CASE(readingsLandAtTheDeadReckonedPose) {
+  resetPose();
+  gasMapReset(gasMap);
+  noteWheelCommand(500, 500);                 // 30 cm/s straight along +x
+  fakeAdvanceMillis(4000);
+  noteWheelCommand(0, 0);
+  Pose pose = getPose();
+  CHECK_NEAR(pose.x, 120.0, 1.0);
+  CHECK_NEAR(pose.y, 0.0, 0.5);
+
+  recordGasAtPose(400);
+  GasMapTile* tile = gasMapFind(gasMap, 1, 0);  // 120 cm is in the second metre-wide tile
+  CHECK(tile != NULL);
+  CHECK_EQ(tile->cells[0].count, 1);
+  CHECK_EQ(tile->cells[0].max, 400);
+}
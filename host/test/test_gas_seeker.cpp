@@ -0,0 +1,171 @@
+/*
+ * Gas Seeker Tests for ToxiRover
+ * Surge/cast/explore policy, the live seeking task, and time to source over simulated plumes
+ */
+
+#include "test_harness.h"
+#include "gas_seeker.h"
+#include "gas_sensor.h"
+#include "config_store.h"
+#include "task_scheduler.h"
+#include "boot_sequencer.h"
+
+#define SIM_TRIALS 50
+#define SPEED 300
+#define PPM_PER_COUNT 2  // readGasSensor() with a zero baseline
+
+static GasSeeker seeker;
+static unsigned long now = 0;
+
+// Feeds one reading per sample tick for the given time; returns the last command
+static SeekCommand feed(float ppm, unsigned long ms) {
+  SeekCommand command = {false, SEEK_HEADING_AHEAD};
+  for (unsigned long end = now + ms; now < end;) {
+    now += SEEK_SAMPLE_INTERVAL;
+    command = gasSeekerUpdate(seeker, ppm, now);
+  }
+  return command;
+}
+
+TEST_CASE(risingTrailSurgesStraightAhead) {
+  now = 0;
+  gasSeekerStart(seeker, 50, 500, 1, now);
+  CHECK_EQ(seeker.state, SEEK_SURGE);
+  for (float ppm = 60; ppm < 300; ppm += 20) {
+    SeekCommand command = feed(ppm, 1000);
+    CHECK(command.moving);
+    CHECK_EQ(command.heading, SEEK_HEADING_AHEAD);
+  }
+  CHECK_EQ(seeker.state, SEEK_SURGE);
+  CHECK(seeker.best > 200);
+}
+
+TEST_CASE(lostTrailCastsToAlternateSides) {
+  feed(seeker.best * SEEK_LOST_RATIO * 0.8f, 2 * SEEK_SAMPLE_INTERVAL);  // fell off the plume
+  CHECK_EQ(seeker.state, SEEK_CAST);
+
+  SeekCommand turn = feed(seeker.filtered, SEEK_SAMPLE_INTERVAL);
+  CHECK(turn.moving);
+  CHECK(turn.heading != SEEK_HEADING_AHEAD);
+  SeekCommand leg = feed(seeker.filtered, SEEK_CAST_TURN);
+  CHECK_EQ(leg.heading, SEEK_HEADING_AHEAD);
+
+  feed(seeker.filtered, SEEK_CAST_LEG);  // next cast swings the other way, for longer
+  CHECK_EQ(seeker.casts, 1);
+  SeekCommand back = feed(seeker.filtered, SEEK_SAMPLE_INTERVAL);
+  CHECK_EQ(back.heading - SEEK_HEADING_AHEAD, -(turn.heading - SEEK_HEADING_AHEAD));
+  CHECK_EQ(seeker.turnMs, 2UL * SEEK_CAST_TURN);
+}
+
+TEST_CASE(failedCastsExploreThenRegainedTrailSurges) {
+  for (int i = 0; i < SEEK_MAX_CASTS && seeker.state == SEEK_CAST; i++) {
+    feed(seeker.filtered, 6 * SEEK_CAST_TURN + SEEK_CAST_LEG);
+  }
+  CHECK_EQ(seeker.state, SEEK_EXPLORE);
+  CHECK_EQ(seeker.casts, 0);
+
+  feed(seeker.filtered + 4 * SEEK_RISE_PPM, 2 * SEEK_SAMPLE_INTERVAL);
+  CHECK_EQ(seeker.state, SEEK_SURGE);
+}
+
+TEST_CASE(flatReadingsTimeOutIntoCasting) {
+  now = 0;
+  gasSeekerStart(seeker, 80, 500, 2, now);
+  feed(80, SEEK_SURGE_TIMEOUT);
+  CHECK_EQ(seeker.state, SEEK_SURGE);
+  feed(80, 2 * SEEK_SAMPLE_INTERVAL);
+  CHECK_EQ(seeker.state, SEEK_CAST);
+}
+
+TEST_CASE(sourceThresholdStopsTheRover) {
+  SeekCommand command = feed(600, 3000);
+  CHECK_EQ(seeker.state, SEEK_FOUND);
+  CHECK(!command.moving);
+  CHECK(!feed(600, 1000).moving);  // stays put until restarted
+}
+
+// ---------------------------------------------------------------- live seeking
+
+static int outputs = 0;
+static int lastHeading = 0, lastSpeed = -1;
+static SeekState lastReported = SEEK_IDLE;
+static int reports = 0;
+
+static void recordOutput(int heading, int speed) {
+  outputs++;
+  lastHeading = heading;
+  lastSpeed = speed;
+}
+
+static void recordState(SeekState state, float ppm) {
+  reports++;
+  lastReported = state;
+}
+
+TEST_CASE(liveSeekRunsOnTheSchedulerAndReports) {
+  initBootSequencer();
+  initConfigStore();
+  fakeSetAnalog(GAS_ANALOG_PIN, 30);
+  initGasSensor();
+  initGasSeeker(recordOutput);
+  addSeekStateHandler(recordState);
+  CHECK(!isGasSeeking());
+
+  startGasSeeking(SPEED);
+  CHECK(isGasSeeking());
+  CHECK_EQ(lastReported, SEEK_SURGE);
+  runSchedulerFor(5000);
+  CHECK(outputs >= 5000 / SEEK_SAMPLE_INTERVAL - 1);
+  CHECK_EQ(lastSpeed, SPEED);
+
+  // Climb to the source: the seeker stops the motors itself and reports FOUND
+  for (int counts = 60; counts <= 300; counts += 30) {
+    fakeSetAnalog(GAS_ANALOG_PIN, counts);
+    runSchedulerFor(2000);
+  }
+  CHECK(roverConfig.gasDangerThreshold < 300 * PPM_PER_COUNT);
+  CHECK_EQ(getSeekState(), SEEK_FOUND);
+  CHECK_EQ(lastReported, SEEK_FOUND);
+  CHECK(!isGasSeeking());
+  CHECK_EQ(lastSpeed, 0);
+
+  int calls = outputs;
+  runSchedulerFor(2000);
+  CHECK_EQ(outputs, calls);  // task disabled once found
+
+  char status[SEEK_STATUS_SIZE];
+  std::string json = formatSeekStatus(status, sizeof(status));
+  CHECK(json.find("\"state\":\"FOUND\"") != std::string::npos);
+  CHECK(json.find("\"found\":1") != std::string::npos);
+}
+
+TEST_CASE(manualDriveTakesOver) {
+  fakeSetAnalog(GAS_ANALOG_PIN, 30);
+  runSchedulerFor(3000);  // let the sensor filter settle back down
+  startGasSeeking(SPEED);
+  runSchedulerFor(1000);
+  CHECK(isGasSeeking());
+
+  noteSeekDriveCommand('X');  // not a drive letter
+  CHECK(isGasSeeking());
+  noteSeekDriveCommand('L');
+  CHECK(!isGasSeeking());
+  CHECK_EQ(lastSpeed, 0);
+  CHECK_EQ(lastReported, SEEK_IDLE);
+}
+
+// ---------------------------------------------------------------- simulation
+
+TEST_CASE(simulatedPlumesMeetTimeToSourceTarget) {
+  GasSimResult result = simulateGasSeek(SIM_TRIALS);
+  printf("GAS_SEEK_SIM,trials=%d,found=%d,false_found=%d,timeout=%d,mean_time_s=%.2f,target_s=%d,"
+         "within_target_pct=%.1f\n", SIM_TRIALS, result.found, result.falseFound, result.timedOut,
+         result.found > 0 ? result.totalMs / 1000.0 / result.found : 0, GASSIM_TARGET / 1000,
+         100.0 * result.withinTarget / SIM_TRIALS);
+
+  CHECK_EQ(result.found + result.falseFound + result.timedOut, SIM_TRIALS);
+  CHECK(result.found * 100 >= SIM_TRIALS * 70);
+  CHECK(result.falseFound * 100 <= SIM_TRIALS * 10);
+  CHECK(result.found > 0 && result.totalMs / result.found <= GASSIM_TARGET);  // mean time to source
+  CHECK(result.withinTarget * 100 >= SIM_TRIALS * 55);
+}
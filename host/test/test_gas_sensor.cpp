@@ -0,0 +1,55 @@
+/*
+ * Gas Sensor Tests for ToxiRover
+ */
+
+#include "test_harness.h"
+#include "gas_sensor.h"
+#include "config_store.h"
+
+TEST_CASE(cleanAirIsSafe) {
+  fakeSetAnalog(GAS_ANALOG_PIN, 20);
+  fakeSetDigital(GAS_DIGITAL_PIN, LOW);
+  initGasSensor();
+  CHECK_NEAR(readGasSensor(), 40.0, 0.01);  // 20 counts x 2 ppm/count, zero baseline
+  CHECK(!isGasDetected());
+  CHECK(!isGasDangerous());
+  CHECK_EQ(std::string(getGasLevel()), std::string("SAFE"));
+}
+
+TEST_CASE(levelsFollowConfiguredThresholds) {
+  fakeSetAnalog(GAS_ANALOG_PIN, 160);  // 320 ppm
+  readGasSensor();
+  CHECK(isGasDetected());
+  CHECK_EQ(std::string(getGasLevel()), std::string("WARNING"));
+
+  fakeSetAnalog(GAS_ANALOG_PIN, 260);  // 520 ppm
+  readGasSensor();
+  CHECK(isGasDangerous());
+
+  roverConfig.gasDangerThreshold = 600;
+  readGasSensor();
+  CHECK(!isGasDangerous());
+  roverConfig.gasDangerThreshold = 500;
+}
+
+TEST_CASE(digitalTripCountsAsDetection) {
+  fakeSetAnalog(GAS_ANALOG_PIN, 10);
+  fakeSetDigital(GAS_DIGITAL_PIN, HIGH);
+  readGasSensor();
+  CHECK(isGasDetected());
+  fakeSetDigital(GAS_DIGITAL_PIN, LOW);
+  readGasSensor();
+  CHECK(!isGasDetected());
+}
+
+TEST_CASE(calibrationStoresBaseline) {
+  fakeSetAnalog(GAS_ANALOG_PIN, 75);
+  unsigned long commits = fakeEepromCommits();
+  unsigned long start = millis();
+  calibrateGasSensor();
+  CHECK_EQ(roverConfig.gasBaseline, 75);
+  CHECK(fakeEepromCommits() > commits);
+  CHECK(millis() - start >= 1000);  // ten readings, 100 ms apart
+  CHECK_NEAR(gasCountsToPpm(75), 0.0, 0.01);
+  CHECK_NEAR(gasCountsToPpm(50), 0.0, 0.01);  // below baseline clamps to zero
+}
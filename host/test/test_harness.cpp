@@ -0,0 +1,107 @@
+/*
+ * Host Test Harness Implementation for ToxiRover
+ */
+
+#include "test_harness.h"
+#include "task_scheduler.h"
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+struct RegisteredTest {
+  const char* name;
+  TestFunction function;
+  bool rebootPhase;
+};
+
+static std::vector<RegisteredTest>& registry() {
+  static std::vector<RegisteredTest> tests;
+  return tests;
+}
+
+static int failures = 0;
+static int argCount = 0;
+static char** argValues = nullptr;
+
+TestRegistration::TestRegistration(const char* name, TestFunction function, bool rebootPhase) {
+  registry().push_back({name, function, rebootPhase});
+}
+
+void testFailure(const char* file, int line, const std::string& message) {
+  failures++;
+  fprintf(stderr, "  %s:%d: CHECK failed: %s\n", file, line, message.c_str());
+}
+
+const char* testArgument(const char* name) {
+  size_t length = strlen(name);
+  for (int i = 1; i < argCount; i++) {
+    const char* arg = argValues[i];
+    if (strncmp(arg, "--", 2) == 0 && strncmp(arg + 2, name, length) == 0 && arg[2 + length] == '=') {
+      return arg + 3 + length;
+    }
+  }
+  return NULL;
+}
+
+// A pass that neither runs a task nor sleeps still moves the clock, so a
+// scheduler with nothing due cannot hang the test
+void runSchedulerFor(unsigned long ms) {
+  unsigned long start = millis();
+  while (millis() - start < ms) {
+    unsigned long before = micros();
+    runScheduler();
+    if (micros() == before) fakeAdvanceMicros(100);
+  }
+}
+
+// Flash (EEPROM, LittleFS, RTC memory) goes to a file; the phase starts from
+// fresh firmware statics in a new process, like code running after a reset
+int rebootInto(const char* phase) {
+  char image[] = "/tmp/toxirover_flash_XXXXXX";
+  int fd = mkstemp(image);
+  if (fd < 0) return -1;
+  close(fd);
+  if (!fakeSaveFlashImage(image)) return -1;
+
+  std::string phaseArg = std::string("--phase=") + phase;
+  std::string flashArg = std::string("--flash=") + image;
+  fflush(stdout);
+  fflush(stderr);
+  pid_t pid = fork();
+  if (pid == 0) {
+    execl(argValues[0], argValues[0], phaseArg.c_str(), flashArg.c_str(), (char*)NULL);
+    _exit(127);
+  }
+  int status = -1;
+  waitpid(pid, &status, 0);
+  unlink(image);
+  return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+int main(int argc, char** argv) {
+  argCount = argc;
+  argValues = argv;
+  const char* phase = testArgument("phase");
+  const char* flash = testArgument("flash");
+  if (flash && !fakeLoadFlashImage(flash)) {
+    fprintf(stderr, "cannot load flash image %s\n", flash);
+    return 1;
+  }
+
+  int run = 0;
+  for (const RegisteredTest& test : registry()) {
+    bool selected = phase ? (test.rebootPhase && strcmp(test.name, phase) == 0) : !test.rebootPhase;
+    if (!selected) continue;
+    int before = failures;
+    test.function();
+    run++;
+    printf("%s %s\n", failures == before ? "PASS" : "FAIL", test.name);
+  }
+
+  if (run == 0) {
+    fprintf(stderr, "no tests selected\n");
+    return 1;
+  }
+  if (!phase) printf("%d test(s), %d failed check(s)\n", run, failures);
+  return failures == 0 ? 0 : 1;
+}
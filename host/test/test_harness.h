@@ -0,0 +1,62 @@
+/*
+ * Host Test Harness for ToxiRover
+ * Registration and check macros for the host tests; one executable per test file
+ *
+ * Features:
+ * - TEST_CASE blocks run in file order, sharing firmware state like one boot does
+ * - CHECK/CHECK_EQ/CHECK_NEAR report file:line and keep going
+ * - REBOOT_PHASE blocks run in a fresh process on the saved flash (rebootInto)
+ * - runSchedulerFor() drives the firmware's task scheduler on the virtual clock
+ */
+
+#ifndef TEST_HARNESS_H
+#define TEST_HARNESS_H
+
+#include "fake_hal.h"
+#include <sstream>
+
+typedef void (*TestFunction)();
+
+struct TestRegistration {
+  TestRegistration(const char* name, TestFunction function, bool rebootPhase = false);
+};
+
+void testFailure(const char* file, int line, const std::string& message);
+int rebootInto(const char* phase);  // exit status of the phase, run after a simulated power cycle
+const char* testArgument(const char* name);  // "--name=value" from the command line, or NULL
+void runSchedulerFor(unsigned long ms);      // runScheduler() until the virtual clock has moved ms
+
+template <typename A, typename B>
+std::string describeMismatch(const char* a, const char* b, const A& left, const B& right) {
+  std::ostringstream out;
+  out << a << " == " << b << " (" << left << " vs " << right << ")";
+  return out.str();
+}
+
+#define TEST_CASE(name) \
+  static void name(); \
+  static TestRegistration name##Registration(#name, name); \
+  static void name()
+
+#define REBOOT_PHASE(name) \
+  static void name(); \
+  static TestRegistration name##Registration(#name, name, true); \
+  static void name()
+
+#define CHECK(condition) \
+  do { if (!(condition)) testFailure(__FILE__, __LINE__, #condition); } while (0)
+
+#define CHECK_EQ(a, b) \
+  do { \
+    auto checkLeft = (a); auto checkRight = (b); \
+    if (!(checkLeft == checkRight)) testFailure(__FILE__, __LINE__, describeMismatch(#a, #b, checkLeft, checkRight)); \
+  } while (0)
+
+#define CHECK_NEAR(a, b, tolerance) \
+  do { \
+    double checkLeft = (a); double checkRight = (b); \
+    if (fabs(checkLeft - checkRight) > (tolerance)) \
+      testFailure(__FILE__, __LINE__, describeMismatch(#a, #b, checkLeft, checkRight)); \
+  } while (0)
+
+#endif
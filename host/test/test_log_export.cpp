@@ -0,0 +1,182 @@
+/*
+ * Log Export Tests for ToxiRover
+ * The host analyzer against hand-written and synthetic RTDB exports, split every way
+ */
+
+#include "test_harness.h"
+#include "log_export.h"
+
+#include <fstream>
+
+// Two rovers; braces and quotes inside strings, nodes that are not logs, a
+// gap, a gas plume and records from before the clock was synced
+static const char EXPORT[] = R"({
+  "rovers": {
+    "1a2b3c": {
+      "alerts": {"HIGH_GAS_1_2": {"message": "Gas 350 ppm", "timestamp": "1767225600000", "type": "HIGH_GAS"}},
+      "event_logs": {
+        "-Na1": {"data": "peak \"350\" ppm, {zone} A\\", "event": "gas_alert", "timestamp": 1767225603000},
+        "-Na2": {"data": "back to normal", "event": "gas_clear", "timestamp": 1767225612000}
+      },
+      "logs": {
+        "1767225600000": {"distance_cm": 40, "gas_ppm": 50.00, "motion": "FORWARD", "servo_angle": 90, "timestamp": 1767225600000, "x_cm": 0, "y_cm": 0},
+        "1767225603000": {"distance_cm": 38, "gas_ppm": 350.00, "motion": "FORWARD", "servo_angle": 90, "timestamp": 1767225603000, "x_cm": 5, "y_cm": 0},
+        "1767225606000": {"distance_cm": 35, "gas_ppm": 420.00, "motion": "STOP", "servo_angle": 90, "timestamp": 1767225606000, "x_cm": 9, "y_cm": 0},
+        "1767225609000": {"distance_cm": 35, "gas_ppm": 60.00, "motion": "STOP", "servo_angle": 90, "timestamp": 1767225609000, "x_cm": 9, "y_cm": 0},
+        "1767225700000": {"distance_cm": 35, "gas_ppm": 70.00, "motion": "STOP", "servo_angle": 90, "timestamp": 1767225700000, "x_cm": 9, "y_cm": 0},
+        "b0000abcd_0000001000": {"boot_id": "0000abcd", "gas_ppm": 80.00, "timestamp": 1000},
+        "b0000abcd_0000004000": {"boot_id": "0000abcd", "gas_ppm": 90.00, "timestamp": 4000}
+      },
+      "sensor_data": {"distance": 35, "gas_concentration": 90, "timestamp": 1767225700000},
+      "status": "ONLINE"
+    },
+    "4d5e6f": {
+      "logs": {
+        "1767225600000": {"gas_ppm": 10.5, "timestamp": 1767225600000}
+      }
+    }
+  }
+})";
+
+// Everything the analysis produced, as text, so two runs compare in one check.
+// Merged chunks sum in a different order, so the moments are rounded.
+static std::string describe(const LogExportResult& result) {
+  std::ostringstream out;
+  out << result.samples << " " << result.events << "\n";
+  for (auto& entry : result.devices) {
+    const LogSeries& series = entry.second.series;
+    out << entry.first << " " << series.samples << " " << series.min << " " << series.max << " "
+        << llround(series.mean * 1000) << " " << llround(logSeriesStdDev(series) * 1000) << " "
+        << series.first << "-" << series.last << " " << series.reboots << "\n";
+    for (const LogSeriesPoint& point : series.points) {
+      out << " p " << point.boot << " " << point.start << " " << point.min << " " << point.max << " "
+          << point.sum << " " << point.count << "\n";
+    }
+    for (const LogGap& gap : series.gaps) out << " g " << gap.start << " " << gap.lengthMs << "\n";
+    for (const LogAlertEpisode& alert : series.alerts) {
+      out << " a " << alert.start << " " << alert.end << " " << alert.peak << " " << alert.samples << "\n";
+    }
+    for (const LogEvent& event : entry.second.events) {
+      out << " e " << event.timestamp << " " << event.event << "|" << event.data << "\n";
+    }
+  }
+  return out.str();
+}
+
+static LogExportResult analyze(const char* data, size_t size, int threads, size_t chunkBytes) {
+  LogExportOptions options = defaultLogExportOptions();
+  options.threads = threads;
+  options.chunkBytes = chunkBytes;
+  LogExportResult result = {};
+  analyzeLogExport(data, size, options, result);
+  return result;
+}
+
+TEST_CASE(roverExportGivesPerDeviceAnalysis) {
+  LogExportResult result = analyze(EXPORT, sizeof(EXPORT) - 1, 1, 0);
+  CHECK_EQ(result.samples, 8ull);
+  CHECK_EQ(result.events, 2ull);
+  CHECK_EQ(result.devices.size(), (size_t)2);  // alerts and sensor_data are not records
+
+  const DeviceLogs& rover = result.devices["1a2b3c"];
+  const LogSeries& series = rover.series;
+  CHECK_EQ(series.samples, 7ull);
+  CHECK_NEAR(series.mean, 160.0, 0.001);
+  CHECK_NEAR(series.min, 50.0, 0.001);
+  CHECK_NEAR(series.max, 420.0, 0.001);
+  CHECK_EQ(series.reboots, 1u);  // synced records, then a boot before the clock was set
+
+  CHECK_EQ(series.gaps.size(), (size_t)1);
+  CHECK_EQ(series.gaps[0].start, 1767225609000ull);
+  CHECK_EQ(series.gaps[0].lengthMs, 91000ull);
+
+  CHECK_EQ(series.alerts.size(), (size_t)1);
+  CHECK_EQ(series.alerts[0].start, 1767225603000ull);
+  CHECK_EQ(series.alerts[0].end, 1767225606000ull);
+  CHECK_NEAR(series.alerts[0].peak, 420.0, 0.001);
+
+  CHECK_EQ(series.points.size(), (size_t)3);
+  CHECK_EQ(series.points[0].count, 4u);
+  CHECK_EQ(series.points[2].boot, 0xabcdu);
+  CHECK_EQ(series.points[2].start, 0ull);
+
+  CHECK_EQ(rover.events.size(), (size_t)2);
+  CHECK_EQ(rover.events[0].data, std::string("peak \"350\" ppm, {zone} A\\"));
+  CHECK_EQ(rover.events[1].event, std::string("gas_clear"));
+  CHECK_EQ(result.devices["4d5e6f"].series.samples, 1ull);
+}
+
+TEST_CASE(singleNodeExportUsesDeviceOption) {
+  static const char LOGS[] =
+      "{\"1767225600000\":{\"gas_ppm\":12.5,\"timestamp\":1767225600000},"
+      "\"1767225603000\":{\"gas_ppm\":13.5,\"timestamp\":1767225603000}}";
+  LogExportOptions options = defaultLogExportOptions();
+  options.device = "bench-rover";
+  LogExportResult result = {};
+  analyzeLogExport(LOGS, sizeof(LOGS) - 1, options, result);
+  CHECK_EQ(result.devices.size(), (size_t)1);
+  CHECK_EQ(result.devices["bench-rover"].series.samples, 2ull);
+  CHECK_NEAR(result.devices["bench-rover"].series.mean, 13.0, 0.001);
+}
+
+// Every chunk size down to one byte lands the boundaries somewhere different
+TEST_CASE(chunkingDoesNotChangeTheAnswer) {
+  std::string expected = describe(analyze(EXPORT, sizeof(EXPORT) - 1, 1, 0));
+  int mismatches = 0;
+  for (size_t chunkBytes = 1; chunkBytes < sizeof(EXPORT); chunkBytes++) {
+    if (describe(analyze(EXPORT, sizeof(EXPORT) - 1, 3, chunkBytes)) != expected) mismatches++;
+  }
+  CHECK_EQ(mismatches, 0);
+}
+
+TEST_CASE(syntheticExportMatchesWhatWasWritten) {
+  const char* path = "/tmp/toxirover_test_log_export.json";
+  SyntheticExport written;
+  CHECK(writeSyntheticExport(path, 3, 2 << 20, written));
+
+  LogExportOptions options = defaultLogExportOptions();
+  options.threads = 1;
+  LogExportResult whole = {};
+  CHECK(analyzeLogFile(path, options, whole));
+  CHECK_EQ(whole.bytes, written.bytes);
+  CHECK_EQ(whole.samples, written.samples);
+  CHECK_EQ(whole.events, written.events);
+  uint64_t gaps = 0, alerts = 0;
+  for (auto& entry : whole.devices) {
+    gaps += entry.second.series.gaps.size();
+    alerts += entry.second.series.alerts.size();
+  }
+  CHECK_EQ(gaps, written.gaps);
+  CHECK_EQ(alerts, written.alerts);
+
+  options.threads = 4;
+  options.chunkBytes = 4099;  // hundreds of boundaries, mid-record and mid-string
+  LogExportResult chunked = {};
+  CHECK(analyzeLogFile(path, options, chunked));
+  CHECK(chunked.chunks > 500);
+  CHECK(describe(chunked) == describe(whole));
+  remove(path);
+}
+
+static std::string readFile(const std::string& path) {
+  std::ifstream in(path);
+  std::stringstream text;
+  text << in.rdbuf();
+  return text.str();
+}
+
+TEST_CASE(tablesAreOneCsvPerKind) {
+  LogExportResult result = analyze(EXPORT, sizeof(EXPORT) - 1, 1, 0);
+  const char* directory = "/tmp/toxirover_test_log_tables";
+  CHECK(writeLogTables(result, directory));
+
+  std::string devices = readFile(std::string(directory) + "/devices.csv");
+  CHECK(devices.find("\n1a2b3c,7,1767225600000,4000,50.00,160.00,420.00,") != std::string::npos);
+  CHECK(readFile(std::string(directory) + "/gaps.csv").find("1a2b3c,,1767225609000,91000\n") != std::string::npos);
+  CHECK(readFile(std::string(directory) + "/alerts.csv").find("1a2b3c,,1767225603000,1767225606000,420.00,2\n") !=
+        std::string::npos);
+  CHECK(readFile(std::string(directory) + "/series.csv").find("1a2b3c,0000abcd,0,80.00,85.00,90.00,2\n") !=
+        std::string::npos);
+  CHECK(readFile(std::string(directory) + "/events.csv").find(
+        "1a2b3c,1767225603000,gas_alert,\"peak \"\"350\"\" ppm, {zone} A\\\"\n") != std::string::npos);
+}
@@ -0,0 +1,132 @@
+/*
+ * Loop Profiler Tests for ToxiRover
+ * Histogram percentiles, scoped timing, the report and its console commands, and the booted sketch
+ */
+
+#include "test_harness.h"
+#include "fake_rtdb.h"
+#include "loop_profiler.h"
+#include "task_scheduler.h"
+
+#include <chrono>
+
+#define CYCLES_PER_US (F_CPU / 1000000)
+#define BOOTED_RUN_MS 60000
+
+static FakeRtdb rtdb;
+
+void setup();
+
+static uint32_t cycles(uint32_t us) { return us * CYCLES_PER_US; }
+
+static std::string report() {
+  static char buffer[PROFILER_REPORT_SIZE];
+  formatProfilerReport(buffer, sizeof(buffer));
+  return buffer;
+}
+
+// The report line for one site, or "" when it isn't registered
+static std::string reportLine(const char* name) {
+  std::string text = report();
+  size_t at = text.find(std::string("\n") + name + " ");
+  if (at == std::string::npos) return "";
+  return text.substr(at + 1, text.find('\n', at + 1) - at - 1);
+}
+
+TEST_CASE(percentilesComeFromTheLog2Buckets) {
+  int site = profilerRegisterSite("spiky");
+  for (int i = 0; i < 99; i++) profilerRecord(site, cycles(10));
+  profilerRecord(site, cycles(5000));  // one stall in a hundred
+
+  CHECK_EQ(profilerPercentile(site, 50), 15u);  // upper edge of [8, 16)
+  CHECK_EQ(profilerPercentile(site, 99), 15u);
+  CHECK_EQ(profilerPercentile(site, 100), 5000u);  // clamped to the observed max
+  CHECK_EQ(reportLine("spiky"), std::string("spiky 100 59 15 15 5000"));
+
+  profilerRecord(site, cycles(5000));  // now the stall reaches p99
+  CHECK_EQ(profilerPercentile(site, 99), 5000u);
+}
+
+TEST_CASE(sameNameSharesOneHistogram) {
+  int site = profilerRegisterSite("shared");
+  CHECK_EQ(profilerRegisterSite("shared"), site);
+  CHECK(profilerRegisterSite("other") != site);
+}
+
+TEST_CASE(scopeTimesItsBlock) {
+  resetProfiler();
+  for (int i = 0; i < 3; i++) {
+    PROFILE_SCOPE("spin");
+    auto start = std::chrono::steady_clock::now();
+    while (std::chrono::steady_clock::now() - start < std::chrono::microseconds(2000)) {}
+  }
+  std::string line = reportLine("spin");
+  CHECK(line.find("spin 3 ") == 0);
+  unsigned long maxUs = strtoul(line.substr(line.rfind(' ') + 1).c_str(), NULL, 10);
+  CHECK(maxUs >= 2000 && maxUs < 100000);
+}
+
+static void idleTask() {}
+
+TEST_CASE(scheduledTasksAreProfiledByName) {
+  addPeriodicTask("idleTask", idleTask, 10, PRIORITY_NORMAL);
+  runSchedulerFor(105);
+  std::string line = reportLine("idleTask");
+  CHECK(!line.empty());
+  CHECK(strtoul(line.substr(9).c_str(), NULL, 10) >= 10);
+}
+
+TEST_CASE(consoleCommandsPrintAndReset) {
+  fakeSerialClear();
+  fakeSerialInput("p");
+  serviceProfilerSerial();
+  CHECK(fakeSerialOutput().find("site count avg_us p50_us p99_us max_us") != std::string::npos);
+  CHECK(fakeSerialOutput().find("\nspiky ") != std::string::npos);
+
+  fakeSerialInput("r");
+  serviceProfilerSerial();
+  CHECK(fakeSerialOutput().find("Profiler reset") != std::string::npos);
+  CHECK_EQ(reportLine("spiky"), std::string("spiky 0 0 0 0 0"));  // names kept, counts cleared
+}
+
+// ---------------------------------------------------------------- booted sketch
+
+// main.cpp in the instrumented build: every task and the scoped hot paths get a site
+REBOOT_PHASE(bootedSketchProfilesTasksAndScopes) {
+  fakeSerialClear();
+  setup();
+  CHECK(fakeSerialOutput().find("full, task not added") == std::string::npos);
+  runSchedulerFor(BOOTED_RUN_MS);
+
+  const char* const sites[] = {"gas", "obstacle", "mqtt", "commands", "fleetRx", "stats", "profiler",
+                               "gas_adc", "pulseIn", "rtdb_write", "stream_read", "fb_probe", "mqtt_connect"};
+  for (const char* site : sites) {
+    if (reportLine(site).empty()) printf("  missing site %s\n", site);
+    CHECK(!reportLine(site).empty());
+  }
+  printf("%s", report().c_str());
+  CHECK(report().size() < PROFILER_REPORT_SIZE - 1);  // nothing truncated
+
+  // The console task is scheduled, so 'p' reaches it without a direct call
+  fakeSerialClear();
+  fakeSerialInput("p");
+  runSchedulerFor(500);
+  CHECK(fakeSerialOutput().find("site count avg_us p50_us p99_us max_us") != std::string::npos);
+}
+
+TEST_CASE(profilerCoversTheBootedSketch) {
+  CHECK_EQ(rebootInto("bootedSketchProfilesTasksAndScopes"), 0);
+}
+
+// Last: it fills the site table for the rest of the process
+TEST_CASE(sitesBeyondTheTableAreIgnored) {
+  static char names[PROFILER_MAX_SITES][8];
+  int last = 0;
+  for (int i = 0; i < PROFILER_MAX_SITES; i++) {
+    snprintf(names[i], sizeof(names[i]), "s%d", i);
+    last = profilerRegisterSite(names[i]);
+  }
+  CHECK_EQ(last, -1);
+  profilerRecord(-1, cycles(10));  // a full table never corrupts another site
+  CHECK(report().size() < PROFILER_REPORT_SIZE);
+}
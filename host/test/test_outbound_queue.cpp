@@ -0,0 +1,125 @@
+/*
+ * Outbound Queue Tests for ToxiRover
+ * Overflow to LittleFS, eviction by priority, and replay across a reboot
+ */
+
+#include "test_harness.h"
+#include "outbound_queue.h"
+#include <LittleFS.h>
+
+static std::vector<std::string> delivered;
+static bool backendUp = true;
+
+static bool recordSend(const QueuedMessage& message) {
+  if (!backendUp) return false;
+  delivered.push_back(message.payload);
+  return true;
+}
+
+static int drainOnce() {
+  fakeAdvanceMillis(QUEUE_DRAIN_INTERVAL);
+  return drainOutboundQueue(recordSend);
+}
+
+static std::string event(int index) {
+  return "{\"event\":" + std::to_string(index) + "}";
+}
+
+// Spilled lines waiting in a class's file, replayed ones excluded
+static int unsentLines(const char* path) {
+  std::vector<uint8_t> bytes = fakeFsRead(path);
+  int lines = 0;
+  bool lineStart = true;
+  for (uint8_t c : bytes) {
+    if (lineStart && c != '-') lines++;
+    lineStart = c == '\n';
+  }
+  return lines;
+}
+
+TEST_CASE(ramRingHoldsWithoutFlash) {
+  CHECK(initOutboundQueue());
+  for (int i = 0; i < QUEUE_RAM_EVENTS; i++) {
+    CHECK(enqueueOutbound(QUEUE_EVENT, QUEUE_OP_PUSH, "/events", event(i).c_str()));
+  }
+  CHECK_EQ(fakeFsUsed(), (size_t)0);
+  CHECK_EQ(getOutboundQueueDepth(), (unsigned long)QUEUE_RAM_EVENTS);
+}
+
+TEST_CASE(overflowSpillsOldestToFlash) {
+  for (int i = QUEUE_RAM_EVENTS; i < 20; i++) {
+    CHECK(enqueueOutbound(QUEUE_EVENT, QUEUE_OP_PUSH, "/events", event(i).c_str()));
+  }
+  CHECK_EQ(getOutboundQueueDepth(), 20ul);
+  CHECK_EQ(outboundQueueStats.spilled, 16ul);
+  CHECK_EQ(unsentLines("/queue_event.log"), 16);
+}
+
+TEST_CASE(replayIsOldestFirstAndRateLimited) {
+  CHECK_EQ(drainOnce(), QUEUE_DRAIN_BATCH);
+  CHECK_EQ(drainOutboundQueue(recordSend), 0);  // within the drain interval
+  CHECK_EQ(delivered.size(), (size_t)QUEUE_DRAIN_BATCH);
+  for (int i = 0; i < QUEUE_DRAIN_BATCH; i++) CHECK_EQ(delivered[i], event(i));
+
+  backendUp = false;
+  CHECK_EQ(drainOnce(), 0);  // a failed send keeps the entry
+  backendUp = true;
+  CHECK_EQ(unsentLines("/queue_event.log"), 16 - QUEUE_DRAIN_BATCH);
+}
+
+// RAM entries are lost with the reset; everything spilled and not yet sent comes back once
+REBOOT_PHASE(replayResumesAfterReboot) {
+  CHECK(initOutboundQueue());
+  CHECK_EQ(getOutboundQueueDepth(), (unsigned long)(16 - QUEUE_DRAIN_BATCH));
+  while (drainOnce() > 0) {}
+  CHECK_EQ(delivered.size(), (size_t)(16 - QUEUE_DRAIN_BATCH));
+  for (size_t i = 0; i < delivered.size(); i++) CHECK_EQ(delivered[i], event(QUEUE_DRAIN_BATCH + (int)i));
+  CHECK(!LittleFS.exists("/queue_event.log"));  // fully replayed spill is removed
+}
+
+TEST_CASE(rebootDoesNotResendReplayedEntries) {
+  CHECK_EQ(rebootInto("replayResumesAfterReboot"), 0);
+}
+
+TEST_CASE(drainedQueueRemovesSpill) {
+  while (drainOnce() > 0) {}
+  CHECK(isOutboundQueueEmpty());
+  CHECK(!LittleFS.exists("/queue_event.log"));
+}
+
+// ---------------------------------------------------------------- eviction
+
+static std::string bulkPayload(int index) {
+  return "{\"seq\":" + std::to_string(index) + ",\"pad\":\"" + std::string(180, 'x') + "\"}";
+}
+
+TEST_CASE(alertsEvictSampleSpill) {
+  int samples = 0;
+  while (outboundQueueStats.dropped == 0 && samples < 1000) {
+    enqueueOutbound(QUEUE_SAMPLE, QUEUE_OP_PUSH, "/logs", bulkPayload(samples++).c_str());
+  }
+  CHECK(outboundQueueStats.dropped > 0);  // samples cannot evict each other
+  CHECK(fakeFsUsed() <= QUEUE_SPILL_MAX_BYTES);
+
+  unsigned long evicted = outboundQueueStats.evicted;
+  for (int i = 0; i < QUEUE_RAM_ALERTS + 3; i++) {
+    CHECK(enqueueOutbound(QUEUE_ALERT, QUEUE_OP_PUSH, "/alerts", bulkPayload(i).c_str()));
+  }
+  CHECK(outboundQueueStats.evicted > evicted);
+  CHECK_EQ(unsentLines("/queue_alert.log"), 3);
+  CHECK(fakeFsUsed() <= QUEUE_SPILL_MAX_BYTES);
+}
+
+TEST_CASE(alertsReplayBeforeSamples) {
+  delivered.clear();
+  drainOnce();
+  CHECK_EQ(delivered.size(), (size_t)QUEUE_DRAIN_BATCH);
+  for (int i = 0; i < QUEUE_DRAIN_BATCH; i++) CHECK_EQ(delivered[i], bulkPayload(i));
+}
+
+TEST_CASE(oversizedMessageIsRejected) {
+  unsigned long dropped = outboundQueueStats.dropped;
+  std::string payload(QUEUE_PAYLOAD_SIZE, 'x');
+  CHECK(!enqueueOutbound(QUEUE_ALERT, QUEUE_OP_PUSH, "/alerts", payload.c_str()));
+  CHECK_EQ(outboundQueueStats.dropped, dropped + 1);
+}
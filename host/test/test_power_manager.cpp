@@ -0,0 +1,56 @@
+/*
+ * Power Manager Tests for ToxiRover
+ * Boots the modular sketch (main.cpp) and checks every managed task drops to its parked rate
+ */
+
+#include "test_harness.h"
+#include "fake_rtdb.h"
+#include "power_manager.h"
+#include "task_scheduler.h"
+
+#define GAS_ACTIVE_MS 500    // main.cpp's gas task rates
+#define GAS_PARKED_MS 5000
+
+static FakeRtdb rtdb;
+
+void setup();
+
+static const SchedulerTask* findTask(const char* name) {
+  for (TaskId id = 0; id < SCHEDULER_MAX_TASKS; id++) {
+    const SchedulerTask* task = getTask(id);
+    if (task && task->name && strcmp(task->name, name) == 0) return task;
+  }
+  return NULL;
+}
+
+TEST_CASE(bootRegistersEveryManagedTask) {
+  fakeSerialClear();
+  setup();
+  CHECK(fakeSerialOutput().find("full, task not added") == std::string::npos);
+  CHECK(findTask("gas") != NULL);
+  CHECK_EQ(findTask("gas")->intervalMs, (unsigned long)GAS_ACTIVE_MS);
+}
+
+TEST_CASE(parkedRoverSamplesGasAtTheParkedRate) {
+  runSchedulerFor(POWER_PARK_TIMEOUT + 1000);
+  CHECK_EQ(getPowerState(), POWER_PARKED);
+
+  // The last tasks main.cpp registers were the ones a short table left at full rate
+  CHECK_EQ(findTask("gas")->intervalMs, (unsigned long)GAS_PARKED_MS);
+  CHECK_EQ(findTask("logger")->intervalMs, 30000ul);
+  CHECK_EQ(findTask("firebase")->intervalMs, 10000ul);
+  CHECK(!findTask("obstacle")->active);  // sonar off while parked
+
+  unsigned long runs = findTask("gas")->runs;
+  runSchedulerFor(60000);
+  unsigned long parkedRuns = findTask("gas")->runs - runs;
+  printf("POWER_PARKED,gas_runs_per_min=%lu\n", parkedRuns);
+  CHECK(parkedRuns >= 60000 / GAS_PARKED_MS - 1 && parkedRuns <= 60000 / GAS_PARKED_MS + 1);
+}
+
+TEST_CASE(fullTableIsReported) {
+  fakeSerialClear();
+  TaskId extra = addOneShotTask("extra", NULL, 60000, PRIORITY_LOW);
+  addPowerManagedTask(extra, 1000, 5000);
+  CHECK(fakeSerialOutput().find("❌ Power manager full, task not added: extra") != std::string::npos);
+}
@@ -0,0 +1,83 @@
+/*
+ * Rover Status Tests for ToxiRover
+ * Enum name tables, and the heap counter over the per-loop status paths
+ */
+
+#include "test_harness.h"
+#include "fake_rtdb.h"
+#include "rover_status.h"
+#include "gas_sensor.h"
+#include "ultrasonic.h"
+#include "firebase.h"
+#include "Wifi_control.h"
+#include "boot_sequencer.h"
+#include "config_store.h"
+#include "sample_bus.h"
+#include "device_id.h"
+
+NewPing sonar(ULTRASONIC_TRIG_PIN, ULTRASONIC_ECHO_PIN, MAX_DISTANCE);  // defined by the sketch on the device
+
+static FakeRtdb rtdb;
+
+#define STEADY_STATE_ROUNDS 500
+
+TEST_CASE(namesRoundTrip) {
+  for (int i = 0; i < MOTION_UNKNOWN; i++) {
+    CHECK_EQ(parseMotionCommand(getMotionName((MotionCommand)i)), (MotionCommand)i);
+  }
+  CHECK_EQ(parseMotionCommand("SIDEWAYS"), MOTION_UNKNOWN);
+  CHECK_EQ(std::string(getMotionName((MotionCommand)42)), std::string("UNKNOWN"));
+  CHECK_EQ(std::string(getDistanceStatusName(DISTANCE_DANGER)), std::string("DANGER"));
+  CHECK_EQ(std::string(getDistanceStatusName((DistanceStatus)-1)), std::string("ERROR"));
+}
+
+// One loop's worth of status work: sensor reads and classification, a remote
+// drive command, and a Firebase tick that uploads the changed values
+static void statusRound(int round) {
+  fakeSetAnalog(GAS_ANALOG_PIN, 100 + (round % 3) * 80);
+  fakeSetEcho(ULTRASONIC_ECHO_PIN, (10 + (round % 4) * 20) * US_ROUNDTRIP_CM);
+
+  float ppm = readGasSensor();
+  const char* gasLevel = getGasLevel();
+  int distance = readDistance();
+  DistanceStatus status = getDistanceStatus();
+  MotionCommand motion = (MotionCommand)(round % MOTION_UNKNOWN);
+
+  dispatchCommand(motion == MOTION_STOP ? 'S' : motion == MOTION_BACKWARD ? 'B' : 'F');
+  CHECK(parseMotionCommand(getMotionName(motion)) == motion);
+  CHECK(gasLevel[0] != '\0');
+
+  publishSample(SAMPLE_GAS_PPM, ppm);
+  publishSample(SAMPLE_DISTANCE_CM, distance);
+  publishSample(SAMPLE_MOTION, motion);
+  sendObstacleStatus(distance, status, status == DISTANCE_DANGER);
+  fakeAdvanceMillis(FIREBASE_UPDATE_INTERVAL);
+  updateFirebaseData();
+}
+
+TEST_CASE(statusPathsAllocateNothingInSteadyState) {
+  initBootSequencer();
+  initConfigStore();
+  initGasSensor();
+  initUltrasonic();
+  initFirebase();
+  beginNetwork("lab", "password1");
+  runSchedulerFor(FAKE_WIFI_CONNECT_MS + 1000);
+  serviceFirebaseConnection();  // picks up the probe reply sent when the network came up
+  CHECK(isFirebaseConnected());
+
+  // Warm-up opens the keep-alive connection and fills every static buffer once
+  for (int round = 0; round < 12; round++) statusRound(round);
+
+  size_t requests = rtdb.requests.size();
+  FakeHeapStats before = fakeHeapStats();
+  for (int round = 0; round < STEADY_STATE_ROUNDS; round++) statusRound(round);
+  FakeHeapStats after = fakeHeapStats();
+
+  printf("STEADY_STATE,rounds=%d,writes=%zu,allocations=%lu\n", STEADY_STATE_ROUNDS,
+         rtdb.requests.size() - requests, after.allocations - before.allocations);
+  CHECK(rtdb.requests.size() > requests + STEADY_STATE_ROUNDS / 2);  // values kept changing
+  CHECK_EQ(after.allocations - before.allocations, 0ul);
+  CHECK_EQ(rtdb.get(roverPath("/motion_command/current")),
+           std::string("\"") + getMotionName((MotionCommand)((STEADY_STATE_ROUNDS - 1) % MOTION_UNKNOWN)) + "\"");
+}
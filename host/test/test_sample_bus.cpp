@@ -0,0 +1,166 @@
+/*
+ * Sample Bus Tests for ToxiRover
+ * SPSC ring and bus fan-out, with producer and consumers on separate threads
+ */
+
+#include "test_harness.h"
+#include "sample_bus.h"
+#include "spsc_ring.h"
+#include "rover_status.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#define STRESS_SAMPLES 2000000
+#define BUS_STRESS_SAMPLES 200000
+
+TEST_CASE(snapshotKeepsLatestAndCountsGaps) {
+  SampleSnapshot snapshot = {};
+  CHECK(!hasSnapshotValue(snapshot, SAMPLE_GAS_PPM));
+
+  // Nobody drains the HTTP channel here, so it fills and rejects the newest samples
+  for (int i = 1; i <= 40; i++) publishSample(SAMPLE_GAS_PPM, i);
+  CHECK_EQ(drainSampleSnapshot(BUS_CONSUMER_HTTP, snapshot), SAMPLE_BUS_DEPTH);
+  CHECK(hasSnapshotValue(snapshot, SAMPLE_GAS_PPM));
+  CHECK(!hasSnapshotValue(snapshot, SAMPLE_MOTION));
+  CHECK_NEAR(snapshot.value[SAMPLE_GAS_PPM], SAMPLE_BUS_DEPTH, 0.001);
+  CHECK_EQ(snapshot.gaps, 0u);
+  CHECK_EQ(getSampleBusDrops(BUS_CONSUMER_HTTP), (uint32_t)(40 - SAMPLE_BUS_DEPTH));
+
+  publishSample(SAMPLE_GAS_PPM, 41);
+  publishSample(SAMPLE_MOTION, MOTION_LEFT);
+  CHECK_EQ(drainSampleSnapshot(BUS_CONSUMER_HTTP, snapshot), 2);
+  CHECK_NEAR(snapshot.value[SAMPLE_GAS_PPM], 41, 0.001);
+  CHECK_EQ((int)snapshot.value[SAMPLE_MOTION], (int)MOTION_LEFT);
+  CHECK_EQ(snapshot.gaps, getSampleBusDrops(BUS_CONSUMER_HTTP));  // every drop shows up as a gap
+
+  // Channels are independent: the Firebase one saw the same stream with its own drops
+  BusSample sample;
+  int firebaseSamples = 0;
+  while (consumeSample(BUS_CONSUMER_FIREBASE, sample)) firebaseSamples++;
+  CHECK_EQ(firebaseSamples, SAMPLE_BUS_DEPTH);
+}
+
+// Producer never waits; every sample is either delivered in order or counted as a drop
+TEST_CASE(ringStressAcrossThreads) {
+  static SpscRing<BusSample, SAMPLE_BUS_DEPTH> ring;
+  std::atomic<bool> done(false);
+
+  std::thread producer([&]() {
+    for (uint32_t i = 0; i < STRESS_SAMPLES; i++) {
+      BusSample sample = {i, (unsigned long)i * 3, SAMPLE_GAS_PPM, (float)(i % 1000)};
+      ring.push(sample);
+      if ((i & 31) == 0) std::this_thread::yield();  // interleave even on one core
+    }
+    done = true;
+  });
+
+  uint32_t received = 0, corrupt = 0, reordered = 0;
+  uint32_t lastSeq = 0;
+  BusSample sample;
+  while (!done || !ring.isEmpty()) {
+    if (!ring.pop(sample)) {
+      std::this_thread::yield();  // the sandbox may have a single core
+      continue;
+    }
+    if (sample.stamp != (unsigned long)sample.seq * 3 || sample.value != (float)(sample.seq % 1000)) corrupt++;
+    if (received > 0 && sample.seq <= lastSeq) reordered++;
+    lastSeq = sample.seq;
+    received++;
+  }
+  producer.join();
+
+  printf("SPSC_STRESS,samples=%d,received=%u,drops=%u\n", STRESS_SAMPLES, received, ring.dropCount());
+  CHECK_EQ(corrupt, 0u);
+  CHECK_EQ(reordered, 0u);
+  CHECK_EQ(received + ring.dropCount(), (uint32_t)STRESS_SAMPLES);
+  CHECK(received > STRESS_SAMPLES / 100);  // the threads really ran concurrently
+}
+
+// A producer that waits for room loses nothing
+TEST_CASE(ringIsLosslessWhenProducerWaits) {
+  static SpscRing<BusSample, SAMPLE_BUS_DEPTH> ring;
+
+  std::thread producer([&]() {
+    for (uint32_t i = 0; i < STRESS_SAMPLES; i++) {
+      while (ring.size() >= ring.capacity()) std::this_thread::yield();
+      BusSample sample = {i, (unsigned long)i, SAMPLE_DISTANCE_CM, (float)(i & 0xFFFF)};
+      ring.push(sample);
+    }
+  });
+
+  uint32_t expected = 0, mismatches = 0;
+  BusSample sample;
+  while (expected < STRESS_SAMPLES) {
+    if (!ring.pop(sample)) {
+      std::this_thread::yield();
+      continue;
+    }
+    if (sample.seq != expected || sample.value != (float)(expected & 0xFFFF)) mismatches++;
+    expected++;
+  }
+  producer.join();
+
+  CHECK_EQ(mismatches, 0u);
+  CHECK_EQ(ring.dropCount(), 0u);
+  CHECK(ring.isEmpty());
+}
+
+// The sampling side publishes to every channel; each consumer drains on its own thread
+// and a slow one only costs itself samples
+TEST_CASE(busFansOutToIndependentConsumers) {
+  BusSample sample;
+  uint32_t dropsBefore[BUS_CONSUMER_COUNT];
+  for (int c = 0; c < BUS_CONSUMER_COUNT; c++) {
+    while (consumeSample((BusConsumer)c, sample)) {}
+    dropsBefore[c] = getSampleBusDrops((BusConsumer)c);
+  }
+
+  std::atomic<bool> done(false);
+  uint32_t received[BUS_CONSUMER_COUNT] = {0};
+  uint32_t gaps[BUS_CONSUMER_COUNT] = {0};
+  uint32_t reordered[BUS_CONSUMER_COUNT] = {0};
+
+  std::vector<std::thread> consumers;
+  for (int c = 0; c < BUS_CONSUMER_COUNT; c++) {
+    consumers.emplace_back([&, c]() {
+      bool slow = c == BUS_CONSUMER_LOGGER;
+      uint32_t nextSeq = 0;  // servo samples are first published here
+      BusSample item;
+      for (;;) {
+        bool finished = done;  // read before the pop, so nothing published earlier is missed
+        if (!consumeSample((BusConsumer)c, item)) {
+          if (finished) break;
+          std::this_thread::yield();
+          continue;
+        }
+        if (item.seq < nextSeq) reordered[c]++;
+        else gaps[c] += item.seq - nextSeq;
+        nextSeq = item.seq + 1;
+        received[c]++;
+        if (slow && received[c] % 100 == 0) std::this_thread::sleep_for(std::chrono::microseconds(200));
+      }
+    });
+  }
+
+  std::thread producer([&]() {
+    for (int i = 0; i < BUS_STRESS_SAMPLES; i++) {
+      publishSample(SAMPLE_SERVO_ANGLE, i % 180);
+      if ((i & 7) == 0) std::this_thread::yield();
+    }
+    done = true;
+  });
+  producer.join();
+  for (std::thread& consumer : consumers) consumer.join();
+
+  for (int c = 0; c < BUS_CONSUMER_COUNT; c++) {
+    uint32_t drops = getSampleBusDrops((BusConsumer)c) - dropsBefore[c];
+    printf("BUS_STRESS,consumer=%d,received=%u,drops=%u\n", c, received[c], drops);
+    CHECK_EQ(reordered[c], 0u);
+    CHECK_EQ(received[c] + drops, (uint32_t)BUS_STRESS_SAMPLES);
+    CHECK(gaps[c] <= drops);  // drops after the last delivered sample leave no gap
+  }
+  CHECK(received[BUS_CONSUMER_FIREBASE] > BUS_STRESS_SAMPLES / 100);
+  CHECK(received[BUS_CONSUMER_LOGGER] < received[BUS_CONSUMER_FIREBASE]);  // only the slow one falls behind
+}
@@ -0,0 +1,45 @@
+/*
+ * Servo Control Tests for ToxiRover
+ */
+
+#include "test_harness.h"
+#include "servo_control.h"
+
+Servo gasServo;  // defined by the sketch on the device
+
+TEST_CASE(initCentersServo) {
+  initServo();
+  CHECK(isServoEnabled());
+  CHECK_EQ(gasServo.read(), SERVO_CENTER_ANGLE);
+}
+
+TEST_CASE(outOfRangeAnglesAreIgnored) {
+  rotateServo(45);
+  CHECK_EQ(gasServo.read(), 45);
+  rotateServo(-10);
+  rotateServo(200);
+  CHECK_EQ(gasServo.read(), 45);
+}
+
+TEST_CASE(smoothRotationSteps) {
+  unsigned long writes = fakeServoWrites();
+  unsigned long start = millis();
+  rotateServoSmooth(55);
+  CHECK_EQ(gasServo.read(), 55);
+  CHECK_EQ(fakeServoWrites() - writes, 10ul);
+  CHECK_EQ(millis() - start, 10ul * SERVO_STEP_DELAY);
+}
+
+TEST_CASE(dispersalEndsCentered) {
+  servoGasDispersal();
+  CHECK_EQ(gasServo.read(), SERVO_CENTER_ANGLE);
+  sweepServo();
+  CHECK_EQ(gasServo.read(), SERVO_CENTER_ANGLE);
+}
+
+TEST_CASE(disableDetaches) {
+  disableServo();
+  CHECK(!isServoEnabled());
+  enableServo();
+  CHECK(isServoEnabled());
+}
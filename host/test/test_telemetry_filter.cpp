@@ -0,0 +1,109 @@
+/*
+ * Telemetry Filter Tests for ToxiRover
+ * Deadband rules, and an hour of replayed sensor input through the Firebase tick
+ */
+
+#include "test_harness.h"
+#include "fake_rtdb.h"
+#include "telemetry_filter.h"
+#include "firebase.h"
+#include "sample_bus.h"
+#include "boot_sequencer.h"
+#include "config_store.h"
+#include "device_id.h"
+
+#define TRACE_TICKS (3600000 / FIREBASE_UPDATE_INTERVAL)  // one hour
+
+static FakeRtdb rtdb;
+
+TEST_CASE(deadbandsByMode) {
+  TelemetryField gas = {"gas", NULL, DEADBAND_RELATIVE, 0.05f, 0, false};
+  CHECK(isFieldDirty(gas, 100));  // never sent
+  markFieldSent(gas, 100);
+  CHECK(!isFieldDirty(gas, 104.5f));
+  CHECK(!isFieldDirty(gas, 95.5f));
+  CHECK(isFieldDirty(gas, 105.5f));
+
+  TelemetryField distance = {"distance", "mirror", DEADBAND_ABSOLUTE, 2, 0, false};
+  markFieldSent(distance, 80);
+  CHECK(!isFieldDirty(distance, 82));
+  CHECK(isFieldDirty(distance, 77));
+
+  TelemetryField motion = {"motion", NULL, DEADBAND_ABSOLUTE, 0, 0, false};
+  markFieldSent(motion, MOTION_STOP);
+  CHECK(!isFieldDirty(motion, MOTION_STOP));
+  CHECK(isFieldDirty(motion, MOTION_FORWARD));
+
+  CHECK_EQ(fieldPayloadBytes(distance), strlen("distance") + strlen("mirror") + 2ul * TELEMETRY_FIELD_OVERHEAD);
+}
+
+struct TraceStep {
+  float gas;
+  int distance;
+  MotionCommand motion;
+  int servo;
+};
+
+// A parked monitoring hour: gas noise within 2%, sonar jitter of ±1 cm, a
+// two-minute plume at half past and a minute of driving at a quarter to
+static TraceStep traceAt(int tick) {
+  static uint32_t rng = 7;
+  rng = rng * 1103515245UL + 12345UL;
+  int second = tick * FIREBASE_UPDATE_INTERVAL / 1000;
+  bool plume = second >= 1800 && second < 1920;
+  bool driving = second >= 2700 && second < 2760;
+
+  TraceStep step;
+  step.gas = (plume ? 400.0f : 120.0f) * (1.0f + ((int)((rng >> 16) % 41) - 20) / 1000.0f);
+  step.distance = (driving ? 40 + (second - 2700) / 2 : 80) + (int)((rng >> 8) % 3) - 1;
+  step.motion = driving ? MOTION_FORWARD : MOTION_STOP;
+  step.servo = 90;
+  return step;
+}
+
+TEST_CASE(replayedHourSavesRequestsAndBytes) {
+  initBootSequencer();
+  initConfigStore();
+  initFirebase();
+  beginNetwork("lab", "password1");
+  runSchedulerFor(FAKE_WIFI_CONNECT_MS + 1000);
+  serviceFirebaseConnection();
+  CHECK(isFirebaseConnected());
+  fakeAdvanceMillis(FIREBASE_UPDATE_INTERVAL);
+  updateFirebaseData();  // the first tick sends every field
+
+  size_t requests = rtdb.requests.size();
+  unsigned long savedBefore = firebaseSavings.requestsSuppressed;
+  unsigned long bytesBefore = firebaseSavings.bytesSuppressed;
+  unsigned long sentBytes = 0, everyFieldBytes = 0;
+  bool plumeShown = false;
+  char full[FIREBASE_PAYLOAD_SIZE];
+
+  for (int tick = 0; tick < TRACE_TICKS; tick++) {
+    TraceStep step = traceAt(tick);
+    publishSample(SAMPLE_GAS_PPM, step.gas);
+    publishSample(SAMPLE_DISTANCE_CM, step.distance);
+    publishSample(SAMPLE_MOTION, step.motion);
+    publishSample(SAMPLE_SERVO_ANGLE, step.servo);
+    fakeAdvanceMillis(FIREBASE_UPDATE_INTERVAL);
+
+    size_t before = rtdb.requests.size();
+    updateFirebaseData();
+    for (size_t i = before; i < rtdb.requests.size(); i++) sentBytes += rtdb.requests[i].body.size();
+    everyFieldBytes += formatTelemetryPayload(full, sizeof(full));  // what a tick without the filter sends
+    if (step.gas > 300 && rtdb.getNumber(roverPath("/gas_data/ppm")) > 300) plumeShown = true;
+  }
+
+  size_t sent = rtdb.requests.size() - requests;
+  printf("TELEMETRY_SAVINGS,ticks=%d,requests_sent=%zu,requests_saved_per_hour=%lu,bytes_sent=%lu,"
+         "bytes_unfiltered=%lu,field_bytes_saved_per_hour=%lu\n", TRACE_TICKS, sent,
+         firebaseSavings.requestsSuppressed - savedBefore, sentBytes, everyFieldBytes,
+         firebaseSavings.bytesSuppressed - bytesBefore);
+
+  CHECK(sent >= 3600000 / FIREBASE_HEARTBEAT_INTERVAL);  // the heartbeat still goes out every minute
+  CHECK(sent < TRACE_TICKS / 5);
+  CHECK(sentBytes < everyFieldBytes / 5);
+  CHECK_EQ(firebaseSavings.requestsSuppressed - savedBefore, (unsigned long)(TRACE_TICKS - sent));
+  CHECK(plumeShown);  // real changes still get through
+  CHECK_EQ(rtdb.get(roverPath("/motion_command/current")), std::string("\"STOP\""));
+}
@@ -0,0 +1,235 @@
+/*
+ * Telemetry Frame Tests for ToxiRover
+ * Encoding, schema evolution, the host decoder and the size and encode time against JSON
+ */
+
+#include "test_harness.h"
+#include "frame_decoder.h"
+#include "firebase.h"
+
+#include <chrono>
+
+#define ENCODE_RUNS 100000
+
+static TelemetryFrame sample() {
+  TelemetryFrame frame;
+  memset(&frame, 0, sizeof(frame));
+  frame.version = TELEMETRY_FRAME_VERSION;
+  frame.seq = 7;
+  frame.stamp = 123456;
+  setTelemetryFrameGas(frame, 412.5f);
+  frame.distanceCm = 37;
+  frame.motion = MOTION_FORWARD;
+  frame.servoAngle = 90;
+  setTelemetryFramePose(frame, -153, 287, -1.2f);
+  frame.flags = FRAME_FLAG_GAS_ALARM | FRAME_FLAG_TIME_SYNCED;
+  frame.device = 0xA1B2C3;
+  return frame;
+}
+
+static std::vector<uint8_t> encode(const TelemetryFrame& frame) {
+  uint8_t bytes[TELEMETRY_FRAME_MAX_SIZE];
+  size_t length = encodeTelemetryFrame(frame, bytes, sizeof(bytes));
+  return std::vector<uint8_t>(bytes, bytes + length);
+}
+
+TEST_CASE(roundTripKeepsEveryField) {
+  TelemetryFrame frame = sample();
+  std::vector<uint8_t> bytes = encode(frame);
+  CHECK_EQ(bytes.size(), (size_t)TELEMETRY_FRAME_MAX_SIZE);
+  CHECK_EQ(bytes[0], (uint8_t)'T');
+  CHECK_EQ(bytes[1], TELEMETRY_FRAME_VERSION);
+  CHECK_EQ(bytes[4], 0x40);  // stamp, little-endian
+  CHECK_EQ(bytes[5], 0xE2);
+
+  TelemetryFrame decoded;
+  CHECK(decodeTelemetryFrame(bytes.data(), bytes.size(), decoded));
+  CHECK_EQ(decoded.seq, 7);
+  CHECK_EQ(decoded.stamp, 123456u);
+  CHECK_EQ(decoded.gasDeciPpm, 4125);
+  CHECK_EQ(decoded.distanceCm, 37);
+  CHECK_EQ(decoded.xCm, -153);
+  CHECK_EQ(decoded.yCm, 287);
+  CHECK_EQ(decoded.headingCentiDeg, -6875);
+  CHECK_EQ(decoded.flags, FRAME_FLAG_GAS_ALARM | FRAME_FLAG_TIME_SYNCED);
+  CHECK_EQ(decoded.device, 0xA1B2C3u);
+
+  CHECK_EQ(encodeTelemetryFrame(frame, bytes.data(), TELEMETRY_FRAME_MAX_SIZE - 1), (size_t)0);
+}
+
+TEST_CASE(outOfRangeValuesSaturate) {
+  TelemetryFrame frame = sample();
+  setTelemetryFrameGas(frame, 99999);
+  setTelemetryFramePose(frame, 1e6f, -1e6f, 0);
+  CHECK_EQ(frame.gasDeciPpm, 65535);
+  CHECK_EQ(frame.xCm, 32767);
+  CHECK_EQ(frame.yCm, -32768);
+  setTelemetryFrameGas(frame, -5);
+  CHECK_EQ(frame.gasDeciPpm, 0);
+}
+
+TEST_CASE(versionOneFramesStillDecode) {
+  std::vector<uint8_t> bytes = encode(sample());
+  bytes[1] = 1;
+  bytes[2] = TELEMETRY_FRAME_V1_BODY_SIZE;
+  bytes.resize(TELEMETRY_FRAME_HEADER_SIZE + TELEMETRY_FRAME_V1_BODY_SIZE);
+
+  TelemetryFrame decoded;
+  CHECK(decodeTelemetryFrame(bytes.data(), bytes.size(), decoded));
+  CHECK_EQ(decoded.version, 1);
+  CHECK_EQ(decoded.device, 0u);  // appended in version 2, defaulted
+  CHECK_EQ(decoded.gasDeciPpm, 4125);
+}
+
+TEST_CASE(newerVersionsSkipUnknownTrailingFields) {
+  std::vector<uint8_t> bytes = encode(sample());
+  bytes[1] = TELEMETRY_FRAME_VERSION + 1;
+  bytes[2] = TELEMETRY_FRAME_BODY_SIZE + 3;
+  bytes.insert(bytes.end(), {0xDE, 0xAD, 0xBE});
+  bytes.insert(bytes.end(), bytes.begin(), bytes.end());  // and the next frame right behind it
+
+  std::vector<TelemetryFrame> frames;
+  FrameDecodeStats stats = {};
+  decodeFrameStream(bytes, frames, stats);
+  CHECK_EQ(frames.size(), (size_t)2);
+  CHECK_EQ(stats.skippedBytes, 0ul);
+  CHECK_EQ(frames[1].device, 0xA1B2C3u);
+}
+
+TEST_CASE(malformedFramesAreRejected) {
+  std::vector<uint8_t> bytes = encode(sample());
+  TelemetryFrame decoded;
+  CHECK(!decodeTelemetryFrame(bytes.data(), bytes.size() - 1, decoded));  // truncated
+  CHECK(!decodeTelemetryFrame(bytes.data(), 3, decoded));
+  bytes[2] = TELEMETRY_FRAME_V1_BODY_SIZE - 1;
+  CHECK(!decodeTelemetryFrame(bytes.data(), bytes.size(), decoded));      // shorter than version 1
+  bytes = encode(sample());
+  bytes[0] = 'X';
+  CHECK(!decodeTelemetryFrame(bytes.data(), bytes.size(), decoded));
+}
+
+TEST_CASE(jsonAndCsvCarryTheDashboardFields) {
+  TelemetryFrame frame = sample();
+  char line[TELEMETRY_JSON_SIZE];
+  std::string json = formatTelemetryFrameJson(frame, line, sizeof(line));
+  CHECK_EQ(json, std::string("{\"version\":2,\"device\":\"a1b2c3\",\"seq\":7,\"stamp\":123456,\"gas_ppm\":412.5,"
+                             "\"distance_cm\":37,\"motion\":\"FORWARD\",\"servo_angle\":90,\"x_cm\":-153,"
+                             "\"y_cm\":287,\"heading_deg\":-68.75,\"gas_alarm\":true,\"seeking\":false,"
+                             "\"time_synced\":true,\"parked\":false}"));
+  CHECK_EQ(std::string(formatTelemetryFrameCsv(frame, line, sizeof(line))),
+           std::string("2,a1b2c3,7,123456,412.5,37,FORWARD,90,-153,287,-68.75,5"));
+
+  frame.distanceCm = TELEMETRY_NO_DISTANCE;
+  frame.servoAngle = TELEMETRY_NO_SERVO;
+  json = formatTelemetryFrameJson(frame, line, sizeof(line));
+  CHECK(json.find("distance_cm") == std::string::npos);
+  CHECK(json.find("servo_angle") == std::string::npos);
+  CHECK_EQ(std::string(formatTelemetryFrameCsv(frame, line, sizeof(line))),
+           std::string("2,a1b2c3,7,123456,412.5,,FORWARD,,-153,287,-68.75,5"));
+}
+
+// ---------------------------------------------------------------- host decoder
+
+TEST_CASE(decoderResyncsAndCountsLostFrames) {
+  std::vector<uint8_t> capture;
+  generateFrameCapture(3, 40, 9, capture);
+  size_t frameSize = TELEMETRY_FRAME_MAX_SIZE;
+
+  std::vector<uint8_t> damaged(capture.begin(), capture.begin() + 10 * frameSize);
+  damaged.insert(damaged.end(), {0x00, 0xFF, 0x13, 0x37, 0x01});  // line noise in place of frame 10
+  damaged.insert(damaged.end(), capture.begin() + 11 * frameSize, capture.end() - frameSize / 2);  // last one truncated
+
+  std::vector<TelemetryFrame> frames;
+  FrameDecodeStats stats = {};
+  decodeFrameStream(damaged, frames, stats);
+  CHECK_EQ(frames.size(), (size_t)(3 * 40 - 2));
+  CHECK_EQ(stats.lostFrames, 1ul);                // frame 10 is rover 1's
+  CHECK_EQ(stats.lastSeq.size(), (size_t)3);
+  CHECK_EQ(stats.skippedBytes, (unsigned long)(5 + frameSize / 2 + frameSize % 2));
+  CHECK_EQ(stats.bytes, (unsigned long)damaged.size());
+}
+
+TEST_CASE(hexCapturesDecodeLikeRawOnes) {
+  std::vector<uint8_t> capture;
+  generateFrameCapture(2, 5, 3, capture);
+  std::string hex;
+  char byte[3];
+  for (size_t i = 0; i < capture.size(); i++) {
+    snprintf(byte, sizeof(byte), "%02X", capture[i]);
+    hex += byte;
+    if ((i + 1) % TELEMETRY_FRAME_MAX_SIZE == 0) hex += "\r\n";  // mosquitto_sub -F %x, one payload per line
+    else if (i % 2) hex += ' ';
+  }
+  std::vector<uint8_t> parsed;
+  CHECK(parseFrameHex(hex, parsed));
+  CHECK(parsed == capture);
+  CHECK(!parseFrameHex("54 0", parsed));
+  CHECK(!parseFrameHex("5 4", parsed));
+  CHECK(!parseFrameHex("TRACE", parsed));
+
+  const char* rawPath = "/tmp/toxirover_test_frames.bin";
+  const char* hexPath = "/tmp/toxirover_test_frames.txt";
+  FILE* file = fopen(rawPath, "wb");
+  fwrite(capture.data(), 1, capture.size(), file);
+  fclose(file);
+  file = fopen(hexPath, "w");
+  fputs(hex.c_str(), file);
+  fclose(file);
+  std::vector<uint8_t> fromRaw, fromHex;
+  CHECK(loadFrameCapture(rawPath, fromRaw));
+  CHECK(loadFrameCapture(hexPath, fromHex));
+  CHECK(fromRaw == capture);
+  CHECK(fromHex == capture);
+  remove(rawPath);
+  remove(hexPath);
+}
+
+TEST_CASE(csvOutputHasOneRowPerFrame) {
+  std::vector<uint8_t> capture;
+  generateFrameCapture(2, 10, 5, capture);
+  std::vector<TelemetryFrame> frames;
+  FrameDecodeStats stats = {};
+  decodeFrameStream(capture, frames, stats);
+
+  char* text = NULL;
+  size_t length = 0;
+  FILE* out = open_memstream(&text, &length);
+  CHECK(writeDecodedFrames(out, frames, FRAME_OUTPUT_CSV));
+  fclose(out);
+  std::string csv(text, length);
+  free(text);
+
+  CHECK_EQ(csv.compare(0, strlen(getTelemetryFrameCsvHeader()), getTelemetryFrameCsvHeader()), 0);
+  CHECK_EQ((size_t)std::count(csv.begin(), csv.end(), '\n'), frames.size() + 1);
+  CHECK(csv.find("\n2,a10001,9,") != std::string::npos);
+}
+
+// ---------------------------------------------------------------- against JSON
+
+TEST_CASE(framesAreSmallerAndFasterThanJsonTelemetry) {
+  static char payload[FIREBASE_PAYLOAD_SIZE];
+  size_t jsonBytes = formatTelemetryPayload(payload, sizeof(payload));
+  CHECK(jsonBytes > 0);
+
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < ENCODE_RUNS / 10; i++) formatTelemetryPayload(payload, sizeof(payload));
+  double jsonNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+                  (ENCODE_RUNS / 10);
+
+  TelemetryFrame frame = sample();
+  uint8_t bytes[TELEMETRY_FRAME_MAX_SIZE];
+  volatile size_t sink = 0;
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < ENCODE_RUNS; i++) {
+    frame.seq = (uint8_t)i;
+    sink = sink + encodeTelemetryFrame(frame, bytes, sizeof(bytes));
+  }
+  double frameNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+                   ENCODE_RUNS;
+
+  printf("TELEMETRY_FRAME,frame_bytes=%d,json_bytes=%zu,size_ratio=%.1f,json_ns=%.0f,frame_ns=%.1f,"
+         "encode_speedup=%.0f\n", TELEMETRY_FRAME_MAX_SIZE, jsonBytes, (double)jsonBytes / TELEMETRY_FRAME_MAX_SIZE,
+         jsonNs, frameNs, frameNs > 0 ? jsonNs / frameNs : 0.0);
+  CHECK(jsonBytes >= 5 * TELEMETRY_FRAME_MAX_SIZE);
+  CHECK(frameNs * 5 < jsonNs);
+}
@@ -0,0 +1,137 @@
+/*
+ * Time Sync Tests for ToxiRover
+ * SNTP stand-in, the monotonic fallback, and batched /logs uploads against the RTDB stand-in
+ */
+
+#include "test_harness.h"
+#include "fake_rtdb.h"
+#include "firebase.h"
+#include "time_sync.h"
+#include "sample_bus.h"
+#include "boot_sequencer.h"
+#include "config_store.h"
+#include "device_id.h"
+
+#define BATCHES 10
+#define SYNC_WAIT_MS 1234
+
+static FakeRtdb rtdb;
+
+// /logs writes since `from`, and the bytes they put on the wire
+static size_t logRequests(size_t from, unsigned long* bodyBytes) {
+  std::string logs = roverPath("/logs");
+  size_t count = 0;
+  for (size_t i = from; i < rtdb.requests.size(); i++) {
+    if (rtdb.requests[i].path.compare(0, logs.size(), logs) != 0) continue;
+    count++;
+    if (bodyBytes) *bodyBytes += rtdb.requests[i].body.size();
+  }
+  return count;
+}
+
+static void logSamples(int count) {
+  for (int i = 0; i < count; i++) {
+    publishSample(SAMPLE_GAS_PPM, 100.0f + i);
+    fakeAdvanceMillis(SAMPLE_LOG_INTERVAL);
+    logDataToFirebase();
+  }
+}
+
+TEST_CASE(unsyncedRecordsAreBootRelative) {
+  fakeSetNtpReachable(false);
+  initBootSequencer();
+  initConfigStore();
+  initFirebase();
+  beginNetwork("lab", "password1");
+  runSchedulerFor(FAKE_WIFI_CONNECT_MS + 1000);
+  serviceFirebaseConnection();
+  CHECK(isFirebaseConnected());
+
+  CHECK(!isTimeSynced());
+  CHECK_EQ(getEpochMillis(), 0ull);
+  CHECK_EQ(getRecordTimestamp(millis() - 5), (uint64_t)(millis() - 5));
+
+  size_t from = rtdb.requests.size();
+  logSamples(SAMPLE_BATCH_SIZE);
+  CHECK_EQ(logRequests(from, NULL), (size_t)1);
+
+  char key[24];
+  snprintf(key, sizeof(key), "b%08lx_", (unsigned long)getBootId());
+  std::string logs = rtdb.get(roverPath("/logs"));
+  CHECK(logs.find(std::string("\"") + key) != std::string::npos);
+  CHECK(logs.find("\"boot_id\"") != std::string::npos);
+
+  logSamples(SAMPLE_BATCH_SIZE / 2);  // left pending across the sync
+  CHECK_EQ(logRequests(from, NULL), (size_t)1);
+}
+
+TEST_CASE(syncConvertsEarlierStamps) {
+  unsigned long before = millis();
+  fakeAdvanceMillis(SYNC_WAIT_MS);
+  fakeSetNtpReachable(true);
+
+  CHECK(isTimeSynced());
+  uint64_t now = getEpochMillis();
+  CHECK(now >= (uint64_t)TIME_SYNC_MIN_EPOCH * 1000);
+  CHECK_EQ(millisToEpochMillis(before), now - SYNC_WAIT_MS);
+  CHECK_EQ(getRecordTimestamp(before), now - SYNC_WAIT_MS);
+
+  char out[21];
+  formatTimestamp(out, 42, 13);
+  CHECK_EQ(std::string(out), std::string("0000000000042"));
+}
+
+// The batch opened before the sync is keyed by epoch once it goes up, in order
+TEST_CASE(batchStartedBeforeSyncUploadsEpochKeys) {
+  size_t from = rtdb.requests.size();
+  logSamples(SAMPLE_BATCH_SIZE - SAMPLE_BATCH_SIZE / 2);
+  CHECK_EQ(logRequests(from, NULL), (size_t)1);
+
+  const std::string& body = rtdb.requests.back().body;
+  std::vector<uint64_t> keys;
+  for (size_t at = body.find("\"1"); at != std::string::npos; at = body.find("\"1", at + 1)) {
+    if (body.compare(at + 14, 2, "\":") == 0) keys.push_back(strtoull(body.c_str() + at + 1, NULL, 10));
+  }
+  CHECK_EQ(keys.size(), (size_t)SAMPLE_BATCH_SIZE);
+  for (size_t i = 1; i < keys.size(); i++) {
+    uint64_t spacing = SAMPLE_LOG_INTERVAL + (i == SAMPLE_BATCH_SIZE / 2 ? SYNC_WAIT_MS : 0);
+    CHECK_EQ(keys[i] - keys[i - 1], spacing);  // the stamps' own spacing, across the sync
+  }
+}
+
+TEST_CASE(clockStepsBackwardNeverReachRecords) {
+  uint64_t now = getEpochMillis();
+  fakeSetEpoch((time_t)(now / 1000) - 3600);  // SNTP correction an hour back
+  CHECK(getEpochMillis() >= now);
+  fakeAdvanceMillis(10);
+  CHECK(getEpochMillis() >= now);
+  fakeSetEpoch((time_t)(now / 1000) + 1);
+  CHECK(getEpochMillis() > now);
+}
+
+TEST_CASE(batchingCutsRequestsPerSample) {
+  size_t from = rtdb.requests.size();
+  unsigned long wireBefore = rtdb.bytesReceived;
+  unsigned long bodyBytes = 0;
+  logSamples(BATCHES * SAMPLE_BATCH_SIZE);
+
+  size_t requests = logRequests(from, &bodyBytes);
+  unsigned long wireBytes = rtdb.bytesReceived - wireBefore;
+  unsigned long headerBytes = wireBytes - bodyBytes;
+  printf("TIME_SYNC_BATCH,samples=%d,requests=%zu,requests_per_sample=%.2f,body_bytes=%lu,header_bytes=%lu,"
+         "header_bytes_unbatched=%lu\n", BATCHES * SAMPLE_BATCH_SIZE, requests,
+         (double)requests / (BATCHES * SAMPLE_BATCH_SIZE), bodyBytes, headerBytes,
+         requests > 0 ? headerBytes / requests * BATCHES * SAMPLE_BATCH_SIZE : 0);
+
+  CHECK_EQ(requests, (size_t)BATCHES);  // one push per SAMPLE_BATCH_SIZE samples
+  CHECK_EQ(rtdb.count(roverPath("/logs")), (size_t)((BATCHES + 2) * SAMPLE_BATCH_SIZE));
+}
+
+TEST_CASE(partialBatchFlushesByAge) {
+  size_t from = rtdb.requests.size();
+  logSamples(SAMPLE_BATCH_SIZE / 2);
+  CHECK_EQ(logRequests(from, NULL), (size_t)0);
+  fakeAdvanceMillis(SAMPLE_BATCH_MAX_AGE);
+  logDataToFirebase();
+  CHECK_EQ(logRequests(from, NULL), (size_t)1);
+}
@@ -0,0 +1,109 @@
+/*
+ * Trace Replay Tests for ToxiRover
+ * A scripted session recorded through TRACE_INPUT(), replayed on the virtual clock and compared
+ */
+
+#include "test_harness.h"
+#include "trace_replay.h"
+#include "config_store.h"
+
+#include <chrono>
+
+#define SESSION_SECONDS 300
+
+static std::vector<uint8_t> trace;
+static ReplayOutput live;
+
+static size_t countKind(const ReplayOutput& output, const char* kind) {
+  size_t count = 0;
+  for (const std::string& line : output.lines) {
+    if (line.find(std::string(",") + kind) != std::string::npos) count++;
+  }
+  return count;
+}
+
+TEST_CASE(recordingCapturesEveryInput) {
+  initConfigStore();
+  CHECK(recordScriptedTrace(SESSION_SECONDS, 7, trace, live));
+  CHECK_EQ(traceStats.dropped, 0ul);
+
+  // Per second: gas ADC + digital, five sonar pings, two servo pings; plus the scripted commands
+  size_t records = (trace.size() - sizeof(TraceHeader)) / sizeof(TraceRecord);
+  CHECK(records >= (size_t)SESSION_SECONDS * (2 + 1000 / REPLAY_DISTANCE_INTERVAL + 1000 / REPLAY_AVOID_INTERVAL));
+  CHECK(countKind(live, "alert,HIGH_GAS") >= 2);  // two plumes
+  CHECK(countKind(live, "obstacle_stop") >= 1);
+  CHECK(countKind(live, "avoid,") > 0);
+}
+
+TEST_CASE(replayMatchesLiveSession) {
+  ReplayOutput replayed = {};
+  auto start = std::chrono::steady_clock::now();
+  CHECK(replayTrace(trace, replayed));
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  printf("REPLAY,records=%lu,decisions=%zu,virtual_s=%.1f,wall_s=%.4f,speedup=%.0f\n", replayed.records,
+         replayed.lines.size(), replayed.virtualMs / 1000.0, seconds, replayed.virtualMs / 1000.0 / seconds);
+
+  long difference = compareReplayOutputs(live.lines, replayed.lines);
+  CHECK_EQ(difference, -1L);
+  if (difference >= 0 && (size_t)difference < live.lines.size() && (size_t)difference < replayed.lines.size()) {
+    printf("  live:     %s\n  replayed: %s\n", live.lines[difference].c_str(), replayed.lines[difference].c_str());
+  }
+  CHECK_EQ(replayed.misses, 0ul);
+  CHECK(replayed.virtualMs >= (SESSION_SECONDS - 1) * 1000UL);
+  CHECK(seconds * 10 < SESSION_SECONDS);  // far faster than real time
+}
+
+TEST_CASE(replayIsDeterministic) {
+  ReplayOutput first = {}, second = {};
+  CHECK(replayTrace(trace, first));
+  CHECK(replayTrace(trace, second));
+  CHECK_EQ(compareReplayOutputs(first.lines, second.lines), -1L);
+}
+
+// Another firmware version, here a danger threshold above the plume, shows up as the first changed decision
+TEST_CASE(changedLogicIsReported) {
+  float threshold = roverConfig.gasDangerThreshold;
+  roverConfig.gasDangerThreshold = threshold * 2;
+  ReplayOutput changed = {};
+  CHECK(replayTrace(trace, changed));
+  roverConfig.gasDangerThreshold = threshold;
+
+  long difference = compareReplayOutputs(live.lines, changed.lines);
+  CHECK(difference >= 0);
+  if (difference >= 0) {
+    CHECK(live.lines[difference].find(",gas,") != std::string::npos);  // the first plume sample
+    CHECK(live.lines[difference].find("DANGER") != std::string::npos);
+  }
+  CHECK_EQ(countKind(changed, "alert,"), (size_t)0);
+}
+
+TEST_CASE(serialDumpLoadsLikeTheFile) {
+  const char* binary = "/tmp/toxirover_test_trace.bin";
+  const char* dump = "/tmp/toxirover_test_trace.txt";
+  FILE* file = fopen(binary, "wb");
+  fwrite(trace.data(), 1, trace.size(), file);
+  fclose(file);
+
+  // What 'dump' prints, between other Serial output and with CRLF line ends
+  fakeSerialClear();
+  exportTraceSerial();
+  std::string capture = "boot noise\r\n";
+  for (char c : fakeSerialOutput()) {
+    if (c == '\n') capture += '\r';
+    capture += c;
+  }
+  file = fopen(dump, "w");
+  fputs(capture.c_str(), file);
+  fclose(file);
+
+  std::vector<uint8_t> fromBinary, fromDump;
+  CHECK(loadTraceFile(binary, fromBinary));
+  CHECK(loadTraceFile(dump, fromDump));
+  CHECK(fromBinary == trace);
+  CHECK(fromDump == trace);
+
+  std::string truncated = capture.substr(0, capture.find("TRACE,64,"));
+  CHECK(!parseTraceHexDump(truncated + "TRACE,96,00\r\nTRACE,END\r\n", fromDump));  // a lost line is caught
+  remove(binary);
+  remove(dump);
+}
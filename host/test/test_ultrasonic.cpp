@@ -0,0 +1,48 @@
+/*
+ * Ultrasonic Sensor Tests for ToxiRover
+ */
+
+#include "test_harness.h"
+#include "ultrasonic.h"
+#include "config_store.h"
+
+NewPing sonar(ULTRASONIC_TRIG_PIN, ULTRASONIC_ECHO_PIN, MAX_DISTANCE);  // defined by the sketch on the device
+
+TEST_CASE(echoConvertsToCentimeters) {
+  initConfigStore();
+  fakeSetEcho(ULTRASONIC_ECHO_PIN, 30 * US_ROUNDTRIP_CM);
+  CHECK_EQ(readDistance(), 30);
+  CHECK_EQ(getDistanceStatus(), DISTANCE_WARNING);
+  CHECK(!isObstacleDetected());
+  CHECK(!isDistanceSafe());
+}
+
+TEST_CASE(noEchoReadsAsMaxDistance) {
+  fakeSetEcho(ULTRASONIC_ECHO_PIN, 0);
+  unsigned long start = micros();
+  CHECK_EQ(readDistance(), MAX_DISTANCE);
+  CHECK(micros() - start >= (unsigned long)MAX_DISTANCE * US_ROUNDTRIP_CM);  // waited out the range
+  CHECK(isDistanceSafe());
+}
+
+TEST_CASE(closeObstacleIsDanger) {
+  fakeSetEcho(ULTRASONIC_ECHO_PIN, 10 * US_ROUNDTRIP_CM);
+  CHECK(isObstacleDetected());
+  CHECK_EQ(getDistanceStatus(), DISTANCE_DANGER);
+}
+
+TEST_CASE(obstacleThresholdComesFromConfig) {
+  roverConfig.obstacleThreshold = 40;
+  fakeSetEcho(ULTRASONIC_ECHO_PIN, 30 * US_ROUNDTRIP_CM);
+  CHECK(isObstacleDetected());
+  CHECK_EQ(getDistanceStatus(), DISTANCE_DANGER);
+  roverConfig.obstacleThreshold = OBSTACLE_THRESHOLD;
+  CHECK(!isObstacleDetected());
+}
+
+TEST_CASE(averageTakesFiveReadings) {
+  fakeSetEcho(ULTRASONIC_ECHO_PIN, 40 * US_ROUNDTRIP_CM);
+  unsigned long start = millis();
+  CHECK_EQ(getAverageDistance(), 40);
+  CHECK(millis() - start >= 50);
+}
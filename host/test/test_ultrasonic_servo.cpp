@@ -0,0 +1,79 @@
+/*
+ * UltrasonicServo Tests for ToxiRover
+ */
+
+#include "test_harness.h"
+#include "UltrasonicServo.h"
+#include "config_store.h"
+
+static UltrasonicServo sensor(ULTRASONIC_SERVO_TRIG, ULTRASONIC_SERVO_ECHO, ULTRASONIC_SERVO_SERVO,
+                              ULTRASONIC_SERVO_MOTOR1, ULTRASONIC_SERVO_MOTOR2);
+
+// 0.034 cm/us, halved for the round trip
+static unsigned long echoFor(float cm) {
+  return (unsigned long)(cm * 2 / 0.034 + 0.5);
+}
+
+TEST_CASE(distanceFromEcho) {
+  initConfigStore();
+  sensor.begin();
+  fakeSetEcho(ULTRASONIC_SERVO_ECHO, echoFor(35));
+  CHECK_NEAR(sensor.getDistance(), 35.0, 0.1);
+  CHECK_EQ(sensor.getDistanceStatus(), DISTANCE_WARNING);
+  CHECK(sensor.isWarningDistance());
+}
+
+TEST_CASE(noEchoIsAnError) {
+  fakeSetEcho(ULTRASONIC_SERVO_ECHO, 0);
+  unsigned long start = micros();
+  CHECK_NEAR(sensor.getDistance(), -1.0, 0.001);
+  CHECK(micros() - start >= 30000);  // pulseIn waited out its timeout
+  CHECK_NEAR(sensor.getLastDistance(), 35.0, 0.1);  // a miss keeps the last good reading
+}
+
+TEST_CASE(obstacleTriggersAvoidanceOnce) {
+  fakeAdvanceMillis(3000);  // past the action cooldown
+  fakeSetEcho(ULTRASONIC_SERVO_ECHO, echoFor(10));
+  unsigned long start = millis();
+  sensor.checkAndAct();
+  CHECK(sensor.isObstacleDetected());
+  CHECK(millis() - start >= 500);  // rotation duration
+  CHECK_EQ(fakePinLevel(ULTRASONIC_SERVO_MOTOR1), LOW);
+
+  unsigned long writes = fakeServoWrites();
+  fakeAdvanceMillis(3000);
+  sensor.checkAndAct();  // still blocked: no second manoeuvre
+  CHECK_EQ(fakeServoWrites(), writes);
+}
+
+TEST_CASE(clearPathResets) {
+  fakeSetEcho(ULTRASONIC_SERVO_ECHO, echoFor(150));
+  sensor.checkAndAct();
+  CHECK(!sensor.isObstacleDetected());
+  CHECK(sensor.isSafeDistance());
+}
+
+TEST_CASE(obstacleThresholdComesFromConfig) {
+  roverConfig.obstacleThreshold = 40;
+  fakeAdvanceMillis(3000);
+  fakeSetEcho(ULTRASONIC_SERVO_ECHO, echoFor(35));
+  sensor.checkAndAct();
+  CHECK(sensor.isObstacleDetected());
+  CHECK_EQ(sensor.getDistanceStatus(), DISTANCE_DANGER);
+  roverConfig.obstacleThreshold = 20;
+  CHECK_EQ(sensor.getDistanceStatus(), DISTANCE_WARNING);
+}
+
+TEST_CASE(parkingDetachesServo) {
+  sensor.setServoAttached(false);
+  unsigned long writes = fakeServoWrites();
+  sensor.aimServo(30);
+  CHECK_EQ(fakeServoWrites(), writes);
+  sensor.setServoAttached(true);
+  sensor.aimServo(30);
+  CHECK(fakeServoWrites() > writes);
+}
+
+TEST_CASE(echoConversion) {
+  CHECK_NEAR(UltrasonicServo::echoToCentimeters(1160), 19.72, 0.01);
+}
@@ -0,0 +1,153 @@
+/*
+ * VFH Planner Tests for ToxiRover
+ * Sector choice, hysteresis and drive output, the live control task, and the 2-D simulation
+ */
+
+#include "test_harness.h"
+#include "vfh_planner.h"
+#include "UltrasonicServo.h"
+#include "task_scheduler.h"
+#include "boot_sequencer.h"
+
+#define SIM_TRIALS 100
+#define SPEED 400
+#define ECHO_US_PER_CM 59  // UltrasonicServo::echoToCentimeters() inverted
+
+static VfhPlanner planner;
+
+// Every sector read at the same distance, as one full sweep would
+static void sweep(float distanceCm, unsigned long now) {
+  for (int i = 0; i < VFH_SECTORS; i++) vfhAddReading(planner, vfhSectorAngle(i), distanceCm, now);
+}
+
+TEST_CASE(clearFieldDrivesStraightAtFullSpeed) {
+  vfhReset(planner);
+  sweep(-1, 1000);  // no echo anywhere
+  VfhDecision decision = vfhPlan(planner, VFH_HEADING_AHEAD, SPEED, 1000);
+  CHECK_EQ(decision.heading, VFH_HEADING_AHEAD);
+  CHECK_EQ(decision.left, SPEED);
+  CHECK_EQ(decision.right, SPEED);
+  CHECK(!decision.boxedIn);
+}
+
+TEST_CASE(obstacleAheadSteersInsteadOfStopping) {
+  vfhReset(planner);
+  sweep(-1, 1000);
+  vfhAddReading(planner, VFH_HEADING_AHEAD, 25, 1000);
+  VfhDecision decision = vfhPlan(planner, VFH_HEADING_AHEAD, SPEED, 1000);
+  CHECK(decision.heading != VFH_HEADING_AHEAD);
+  CHECK(!decision.boxedIn);
+  CHECK(decision.left != decision.right);            // turning...
+  CHECK(decision.left > 0 || decision.right > 0);    // ...while still making progress
+  CHECK(max(decision.left, decision.right) < SPEED);  // slowed by the close obstacle
+
+  // A goal off to the left is honoured when that side is free
+  decision = vfhPlan(planner, VFH_HEADING_AHEAD + 45, SPEED, 1000);
+  CHECK(decision.heading > VFH_HEADING_AHEAD);
+  CHECK(decision.right > decision.left);
+}
+
+TEST_CASE(blockedSectorsHaveHysteresis) {
+  vfhReset(planner);
+  sweep(-1, 1000);
+  vfhAddReading(planner, VFH_HEADING_AHEAD, 25, 1000);  // density 0.75: blocked
+  vfhPlan(planner, VFH_HEADING_AHEAD, SPEED, 1000);
+  CHECK(planner.blocked[VFH_SECTORS / 2]);
+
+  vfhAddReading(planner, VFH_HEADING_AHEAD, 38, 1100);  // 0.62: between the thresholds, stays blocked
+  vfhPlan(planner, VFH_HEADING_AHEAD, SPEED, 1100);
+  CHECK(planner.blocked[VFH_SECTORS / 2]);
+
+  vfhAddReading(planner, VFH_HEADING_AHEAD, 60, 1200);  // 0.40: free again
+  vfhPlan(planner, VFH_HEADING_AHEAD, SPEED, 1200);
+  CHECK(!planner.blocked[VFH_SECTORS / 2]);
+}
+
+TEST_CASE(staleReadingsExpire) {
+  vfhReset(planner);
+  sweep(-1, 1000);
+  vfhAddReading(planner, VFH_HEADING_AHEAD, 25, 1000);
+  CHECK(vfhPlan(planner, VFH_HEADING_AHEAD, SPEED, 1000).heading != VFH_HEADING_AHEAD);
+  unsigned long later = 1000 + VFH_READING_TTL + 1;
+  CHECK_EQ(vfhPlan(planner, VFH_HEADING_AHEAD, SPEED, later).heading, VFH_HEADING_AHEAD);
+}
+
+TEST_CASE(boxedInRotatesTowardEmptierSide) {
+  vfhReset(planner);
+  sweep(10, 1000);
+  vfhAddReading(planner, vfhSectorAngle(VFH_SECTORS - 1), 20, 1000);  // slightly more room on the left
+  VfhDecision decision = vfhPlan(planner, VFH_HEADING_AHEAD, SPEED, 1000);
+  CHECK(decision.boxedIn);
+  CHECK_EQ(decision.left, -decision.right);
+  CHECK(decision.right > 0);  // rotating left
+}
+
+TEST_CASE(sweepVisitsEverySectorBothWays) {
+  vfhReset(planner);
+  bool seen[VFH_SECTORS] = {};
+  int previous = vfhSectorAngle(planner.scanSector);
+  for (int i = 0; i < 2 * VFH_SECTORS; i++) {
+    int angle = vfhNextScanAngle(planner);
+    CHECK_EQ(abs(angle - previous), VFH_SECTOR_WIDTH);  // one sector per tick, the servo never jumps
+    seen[angle / VFH_SECTOR_WIDTH] = true;
+    previous = angle;
+  }
+  for (int i = 0; i < VFH_SECTORS; i++) CHECK(seen[i]);
+}
+
+// ---------------------------------------------------------------- live control
+
+static UltrasonicServo sensor(ULTRASONIC_SERVO_TRIG, ULTRASONIC_SERVO_ECHO, ULTRASONIC_SERVO_SERVO,
+                              ULTRASONIC_SERVO_MOTOR1, ULTRASONIC_SERVO_MOTOR2);
+static int driveCalls = 0;
+static int lastLeft = 0, lastRight = 0;
+
+static void recordDrive(int left, int right) {
+  driveCalls++;
+  lastLeft = left;
+  lastRight = right;
+}
+
+TEST_CASE(remoteForwardBecomesSteeredDriving) {
+  initBootSequencer();
+  sensor.begin();
+  initAvoidance(&sensor, recordDrive);
+  addPeriodicTask("obstacle", serviceAvoidance, VFH_CONTROL_INTERVAL, PRIORITY_HIGH, 30000);
+  fakeSetEcho(ULTRASONIC_SERVO_ECHO, 150 * ECHO_US_PER_CM);
+
+  CHECK(steerDriveCommand('F', SPEED));
+  CHECK(isAvoidanceActive());
+  runSchedulerFor(5000);
+  CHECK(driveCalls >= 5000 / VFH_CONTROL_INTERVAL - 2);  // one drive update per control tick
+  CHECK(driveCalls <= 5000 / VFH_CONTROL_INTERVAL + 1);
+  CHECK_EQ(lastLeft, SPEED);
+  CHECK_EQ(lastRight, SPEED);
+
+  // Something close in every direction: the planner turns in place rather than stalling
+  fakeSetEcho(ULTRASONIC_SERVO_ECHO, 12 * ECHO_US_PER_CM);
+  runSchedulerFor(2 * VFH_SECTORS * VFH_CONTROL_INTERVAL);
+  CHECK_EQ(lastLeft, -lastRight);
+  CHECK(lastLeft != 0);
+
+  // Reverse and stop drive the motors themselves
+  CHECK(!steerDriveCommand('S', SPEED));
+  CHECK(!isAvoidanceActive());
+  int calls = driveCalls;
+  runSchedulerFor(1000);
+  CHECK_EQ(driveCalls, calls);
+}
+
+// ---------------------------------------------------------------- simulation
+
+TEST_CASE(simulatedFieldsFavourThePlanner) {
+  VfhSimResult bump = simulateVfh(SIM_TRIALS, false);
+  VfhSimResult vfh = simulateVfh(SIM_TRIALS, true);
+  printf("VFH_SIM,trials=%d,bump_success_pct=%.1f,vfh_success_pct=%.1f,vfh_collided=%d,vfh_timeout=%d,"
+         "vfh_mean_time_s=%.2f\n", SIM_TRIALS, 100.0 * bump.reached / SIM_TRIALS, 100.0 * vfh.reached / SIM_TRIALS,
+         vfh.collided, vfh.timedOut, vfh.reached > 0 ? vfh.totalMs / 1000.0 / vfh.reached : 0);
+
+  CHECK(vfh.reached * 100 >= SIM_TRIALS * 65);
+  CHECK(vfh.reached >= 3 * bump.reached);
+  CHECK(vfh.reached > 0 && vfh.totalMs / vfh.reached < 40000);  // time to goal across a 4 m field
+  CHECK_EQ(vfh.reached + vfh.collided + vfh.timedOut, SIM_TRIALS);
+}
@@ -0,0 +1,248 @@
+/*
+ * WAN (Adafruit IO MQTT) Tests for ToxiRover
+ */
+
+#include "test_harness.h"
+#include "WANconnection.h"
+#include "Wifi_control.h"
+#include "dead_reckoning.h"
+#include "boot_sequencer.h"
+#include "config_store.h"
+#include "device_id.h"
+#include "pin_config.h"
+#include "task_scheduler.h"
+#include <string.h>
+#include <ESP8266WiFi.h>
+
+#define AIO_USER "YOUR_ADAFRUIT_USERNAME"
+#define TURN_MS 100
+
+static std::string feed(const char* name) {
+  char topic[96];
+  return formatDeviceFeed(topic, sizeof(topic), AIO_USER, name);
+}
+
+TEST_CASE(storedCredentialsAssociate) {
+  initBootSequencer();
+  initConfigStore();
+  CHECK(setWiFiCredentials("lab", "password1"));
+  setupWAN();
+  runSchedulerFor(FAKE_WIFI_CONNECT_MS + 1000);
+  CHECK_EQ(WiFi.status(), WL_CONNECTED);
+}
+
+TEST_CASE(connectsAndPublishes) {
+  loopWAN();
+  CHECK_EQ(fakeMqttConnects(), 1ul);
+  CHECK(publishWanStatus("hello"));
+  std::vector<FakeMqttMessage>& published = fakeMqttPublished();
+  CHECK(!published.empty());
+  CHECK_EQ(published.back().topic, feed("status"));
+  CHECK_EQ(published.back().payload, std::string("hello"));
+}
+
+// Forward and left drive M1F (GPIO15), which used to be read as the portal trigger
+TEST_CASE(feedsDriveMotors) {
+  fakeMqttInject(feed("forward").c_str(), "1");
+  loopWAN();
+  CHECK_EQ(fakePinLevel(M1F), HIGH);
+  CHECK_EQ(fakePinLevel(M2F), HIGH);
+  CHECK_EQ(fakePinLevel(M1B), LOW);
+
+  fakeMqttInject(feed("forward").c_str(), "0");
+  loopWAN();
+  CHECK_EQ(fakePinLevel(M1F), LOW);
+  CHECK_EQ(fakePinLevel(M2F), LOW);
+
+  fakeMqttInject(feed("backward").c_str(), "1");
+  loopWAN();
+  CHECK_EQ(fakePinLevel(M1B), HIGH);
+  CHECK_EQ(fakePinLevel(M2B), HIGH);
+  CHECK_EQ(fakePinLevel(M1F), LOW);
+
+  fakeMqttInject(feed("backward").c_str(), "0");
+  loopWAN();
+  CHECK_EQ(fakePinLevel(M1B), LOW);
+  CHECK_EQ(fakePinLevel(M2B), LOW);
+
+  fakeMqttInject(feed("left").c_str(), "1");
+  loopWAN();
+  CHECK_EQ(fakePinLevel(M1F), HIGH);
+  CHECK_EQ(fakePinLevel(M2B), HIGH);
+
+  fakeMqttInject(feed("left").c_str(), "0");
+  loopWAN();
+  CHECK_EQ(fakePinLevel(M1F), LOW);
+
+  fakeMqttInject(feed("right").c_str(), "1");
+  loopWAN();
+  CHECK_EQ(fakePinLevel(M1B), HIGH);
+  CHECK_EQ(fakePinLevel(M2F), HIGH);
+
+  fakeMqttInject(feed("right").c_str(), "0");
+  loopWAN();
+  CHECK_EQ(fakePinLevel(M2F), LOW);
+}
+
+// Heading change over TURN_MS while the command holds; loopWAN's own time is left out
+static float turnOver() {
+  float start = getPose().heading;
+  fakeAdvanceMillis(TURN_MS);
+  return getPose().heading - start;
+}
+
+static float mqttTurn(const char* direction) {
+  fakeMqttInject(feed(direction).c_str(), "1");
+  loopWAN();
+  float turn = turnOver();
+  fakeMqttInject(feed(direction).c_str(), "0");
+  loopWAN();
+  return turn;
+}
+
+static float remoteTurn(char command) {
+  dispatchCommand(command);
+  float turn = turnOver();
+  dispatchCommand('S');
+  return turn;
+}
+
+// Both control planes drive IN1/IN2 as the left wheel, so a turn integrates the same either way
+TEST_CASE(bothControlPlanesTurnTheSameWay) {
+  int savedSpeed = SPEED;
+  SPEED = 1023;  // the feeds drive the pins fully on
+
+  float mqttLeft = mqttTurn("left");
+  float remoteLeft = remoteTurn('L');
+  CHECK(mqttLeft > 0);  // counterclockwise
+  CHECK_NEAR(remoteLeft, mqttLeft, 0.001);
+
+  float mqttRight = mqttTurn("right");
+  float remoteRight = remoteTurn('R');
+  CHECK(mqttRight < 0);
+  CHECK_NEAR(remoteRight, mqttRight, 0.001);
+
+  // The same pins, too: left reverses IN1/IN2 and runs IN3/IN4 forward
+  dispatchCommand('L');
+  CHECK_EQ(fakePwm(IN2), 1023);
+  CHECK_EQ(fakePwm(IN3), 1023);
+  CHECK_EQ(fakePinLevel(IN1), LOW);
+  CHECK_EQ(fakePinLevel(IN4), LOW);
+  CHECK_EQ(getWheelMotion(), MOTION_LEFT);
+  dispatchCommand('S');
+
+  // An arc to the left slows the left wheel
+  dispatchCommand('G');
+  CHECK_EQ(fakePwm(IN1), 1023 / speed_Coeff);
+  CHECK_EQ(fakePwm(IN3), 1023);
+  CHECK(remoteTurn('G') > 0);
+  SPEED = savedSpeed;
+}
+
+TEST_CASE(brokerOutageBacksOff) {
+  fakeMqttSetReachable(false);
+  fakeAdvanceMillis(31000);  // next keep-alive ping fails
+  unsigned long connects = fakeMqttConnects();
+  loopWAN();
+  CHECK(!publishWanStatus("lost"));
+
+  // 5 s, then 10 s between attempts; never a blocking retry loop
+  for (int i = 0; i < 40; i++) {
+    unsigned long start = millis();
+    loopWAN();
+    CHECK(millis() - start < 100);
+    fakeAdvanceMillis(500);
+  }
+  unsigned long attempts = fakeMqttConnects() - connects;
+  CHECK(attempts >= 2 && attempts <= 4);
+
+  fakeMqttSetReachable(true);
+  fakeAdvanceMillis(60000);
+  loopWAN();
+  CHECK(publishWanStatus("back"));
+}
+
+// ---------------------------------------------------------------- scheduler, virtual clock
+
+static TaskId mqttTask = TASK_INVALID;
+
+static const SchedulerTask* findTask(const char* name) {
+  for (TaskId id = 0; id < SCHEDULER_MAX_TASKS; id++) {
+    const SchedulerTask* task = getTask(id);
+    if (task && task->name && strcmp(task->name, name) == 0) return task;
+  }
+  return NULL;
+}
+
+TEST_CASE(drivingForwardKeepsStationLink) {
+  mqttTask = addPeriodicTask("mqtt", loopWAN, 50, PRIORITY_NORMAL, 50000);  // as main.cpp registers it
+  fakeMqttInject(feed("forward").c_str(), "1");
+  runSchedulerFor(30000);
+  CHECK_EQ(fakePinLevel(M1F), HIGH);
+  CHECK(!isWanPortalOpen());
+  CHECK_EQ(WiFi.status(), WL_CONNECTED);
+
+  fakeMqttInject(feed("forward").c_str(), "0");
+  runSchedulerFor(100);
+  CHECK_EQ(fakePinLevel(M1F), LOW);
+}
+
+TEST_CASE(lostNetworkOpensPortalWithoutBlocking) {
+  fakeWiFiSetReachable(false);
+  fakeWiFiDrop();
+  unsigned long dropped = millis();
+
+  // Every scheduler pass stays short while the portal comes up, so the other tasks keep running
+  unsigned long longestStep = 0;
+  while (!isWanPortalOpen() && millis() - dropped < NETWORK_CONNECT_TIMEOUT + 30000) {
+    unsigned long before = millis();
+    runSchedulerFor(10);
+    longestStep = max(longestStep, millis() - before);
+  }
+  CHECK(isWanPortalOpen());
+  CHECK(millis() - dropped >= 10000);  // offline grace before the hotspot
+  CHECK(longestStep <= 20);
+  CHECK(WiFi.softAPIP() == IPAddress(192, 168, 4, 1));
+
+  const SchedulerTask* portal = findTask("portal");
+  CHECK(portal != NULL);
+  if (portal) CHECK(portal->maxRunMicros < 20000);
+  unsigned long mqttRuns = getTask(mqttTask)->runs;
+
+  // The page is served from the task, the LED blinks, and loopWAN keeps its rate
+  unsigned long ledWrites = fakePinWrites(2);
+  FakeHttpResponse response;
+  fakeHttpRequest(80, "/");
+  runSchedulerFor(1000);
+  CHECK(fakeHttpResponse(80, response));
+  CHECK_EQ(response.code, 200);
+  CHECK(response.body.find("action='setting'") != std::string::npos);  // credential form
+  CHECK(fakePinWrites(2) - ledWrites >= 8);
+  CHECK(getTask(mqttTask)->runs - mqttRuns >= 15);
+}
+
+TEST_CASE(portalSavesCredentialsAndRestarts) {
+  unsigned long restarts = fakeRestarts();
+  FakeHttpResponse response;
+  fakeHttpRequest(80, "/setting?ssid=workshop&pass=newsecret");
+  runSchedulerFor(200);
+  CHECK(fakeHttpResponse(80, response));
+  CHECK_EQ(response.code, 200);
+  CHECK_EQ(fakeRestarts(), restarts + 1);
+  CHECK_EQ(std::string(roverConfig.ssid), std::string("workshop"));
+}
+
+TEST_CASE(reconnectClosesPortal) {
+  fakeWiFiSetReachable(true);
+  beginNetwork(roverConfig.ssid, roverConfig.password);
+  runSchedulerFor(FAKE_WIFI_CONNECT_MS + 1000);
+  CHECK_EQ(WiFi.status(), WL_CONNECTED);
+  CHECK(!isWanPortalOpen());
+
+  // Staying connected never reopens it; a request does, without a hardware pin
+  runSchedulerFor(30000);
+  CHECK(!isWanPortalOpen());
+  requestWanPortal();
+  runSchedulerFor(FAKE_WIFI_SCAN_MS + 200);
+  CHECK(isWanPortalOpen());
+}
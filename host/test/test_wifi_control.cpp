@@ -0,0 +1,131 @@
+/*
+ * WiFi Remote Control Tests for ToxiRover
+ */
+
+#include "test_harness.h"
+#include "Wifi_control.h"
+#include "boot_sequencer.h"
+#include "config_store.h"
+#include "pin_config.h"
+#include "power_manager.h"
+#include "task_scheduler.h"
+#include "sample_bus.h"
+#include "rover_status.h"
+#include <ESP8266WiFi.h>
+
+static void sendState(const char* state) {
+  std::string uri = std::string("/?State=") + state;
+  fakeHttpRequest(80, uri.c_str());
+  handleClient();
+}
+
+TEST_CASE(setupAssociatesInBackground) {
+  initBootSequencer();
+  unsigned long start = millis();
+  setupWiFi();
+  CHECK(millis() - start < 100);  // association is not waited for
+  CHECK_EQ(SPEED, (int)roverConfig.motorSpeed);
+  runSchedulerFor(FAKE_WIFI_CONNECT_MS + 1000);
+  CHECK(isNetworkUp());
+  CHECK_EQ(WiFi.status(), WL_CONNECTED);
+}
+
+TEST_CASE(driveCommandsSetMotorPins) {
+  sendState("F");
+  CHECK_EQ(fakePwm(IN1), SPEED);
+  CHECK_EQ(fakePwm(IN3), SPEED);
+  CHECK_EQ(fakePinLevel(IN2), LOW);
+
+  sendState("B");
+  CHECK_EQ(fakePwm(IN2), SPEED);
+  CHECK_EQ(fakePwm(IN4), SPEED);
+  CHECK_EQ(fakePwm(IN1), 0);
+
+  sendState("S");
+  CHECK_EQ(fakePinLevel(IN1), LOW);
+  CHECK_EQ(fakePinLevel(IN2), LOW);
+  CHECK_EQ(fakePinLevel(IN3), LOW);
+  CHECK_EQ(fakePinLevel(IN4), LOW);
+}
+
+TEST_CASE(speedCommandsScaleDrive) {
+  sendState("7");
+  CHECK_EQ(SPEED, 196);
+  sendState("G");  // forward left: left wheel (IN1/IN2) slowed by speed_Coeff
+  CHECK_EQ(fakePwm(IN1), 196 / speed_Coeff);
+  CHECK_EQ(fakePwm(IN3), 196);
+  dispatchCommand('S');
+}
+
+TEST_CASE(rootPageAnswers) {
+  FakeHttpResponse response;
+  fakeHttpRequest(80, "/");
+  handleClient();
+  CHECK(fakeHttpResponse(80, response));
+  CHECK_EQ(response.code, 200);
+}
+
+TEST_CASE(unreachableNetworkFallsBackToAccessPoint) {
+  fakeWiFiSetReachable(false);
+  fakeWiFiDrop();
+  beginNetwork("nowhere", "secret");
+  runSchedulerFor(NETWORK_CONNECT_TIMEOUT + 2000);
+  CHECK(!isNetworkUp());
+}
+
+// ---------------------------------------------------------------- duty cycle
+
+// main.cpp polls the web server every 10 ms; a request's command must run once, not once per poll
+TEST_CASE(commandRunsOncePerRequest) {
+  initPowerManager();
+  TaskId wifiId = addPeriodicTask("wifi", handleClient, 10, PRIORITY_HIGH, 20000);
+  addPowerManagedTask(wifiId, 10, 200);
+
+  const int buzPin = 16;
+  unsigned long hornWrites = fakePinWrites(buzPin);
+  fakeHttpRequest(80, "/?State=V");
+  runSchedulerFor(1000);
+  CHECK_EQ(fakePinWrites(buzPin) - hornWrites, 2ul);  // one beep: HIGH then LOW
+
+  unsigned long driveWrites = fakePinWrites(IN1);
+  fakeHttpRequest(80, "/?State=F");
+  runSchedulerFor(1000);
+  CHECK_EQ(fakePinWrites(IN1) - driveWrites, 1ul);
+  CHECK_EQ(getPowerState(), POWER_DRIVING);
+}
+
+TEST_CASE(idleRoverParksAfterLastCommand) {
+  fakeHttpRequest(80, "/?State=S");
+  runSchedulerFor(1000);
+  CHECK_EQ(getPowerState(), POWER_MONITORING);
+  CHECK_EQ(fakePinLevel(IN1), LOW);
+
+  // A lingering State argument used to count as fresh activity every 10 ms
+  runSchedulerFor(POWER_PARK_TIMEOUT);
+  CHECK_EQ(getPowerState(), POWER_PARKED);
+
+  // The next request wakes it; the parked 200 ms poll bounds the latency
+  unsigned long start = millis();
+  fakeHttpRequest(80, "/?State=F");
+  while (getPowerState() != POWER_DRIVING && millis() - start < 1000) runSchedulerFor(10);
+  CHECK_EQ(getPowerState(), POWER_DRIVING);
+  CHECK(millis() - start <= 200 + POWER_SERVICE_INTERVAL);
+  dispatchCommand('S');
+}
+
+TEST_CASE(samplesRouteShowsLatestBusValues) {
+  publishSample(SAMPLE_GAS_PPM, 321.5f);
+  publishSample(SAMPLE_MOTION, MOTION_FORWARD);
+  handleClient();  // the client task drains the HTTP channel on every run
+
+  FakeHttpResponse response;
+  while (fakeHttpResponse(80, response)) {}  // replies to the remote commands above
+  fakeHttpRequest(80, "/samples");
+  handleClient();
+  CHECK(fakeHttpResponse(80, response));
+  CHECK_EQ(response.code, 200);
+  CHECK_EQ(response.contentType, std::string("application/json"));
+  CHECK(response.body.find("\"gas_ppm\":321.50") != std::string::npos);
+  CHECK(response.body.find("\"motion\":\"FORWARD\"") != std::string::npos);
+  CHECK(response.body.find("\"drops\":0") != std::string::npos);
+}
@@ -0,0 +1,40 @@
+# Feature Size Report for ToxiRover
+# Prints code and static RAM of each feature preset's host image against the full one
+#
+# Usage: cmake -DSIZE_TOOL=size "-DIMAGES=full=PATH;local=PATH;..." -P feature_sizes.cmake
+# Host sizes are not device sizes, but what a preset strips shows up in both.
+# Prints one FEATURE_SIZE CSV line per image; fails if a preset is not smaller than full.
+
+function(image_size path out_text out_ram)
+  execute_process(COMMAND ${SIZE_TOOL} ${path} OUTPUT_VARIABLE output RESULT_VARIABLE result)
+  if(NOT result EQUAL 0)
+    message(FATAL_ERROR "❌ ${SIZE_TOOL} failed on ${path}")
+  endif()
+  # Berkeley format: a header row, then text data bss dec hex filename
+  string(REGEX MATCH "\n[ \t]*([0-9]+)[ \t]+([0-9]+)[ \t]+([0-9]+)" row "${output}")
+  math(EXPR ram "${CMAKE_MATCH_2} + ${CMAKE_MATCH_3}")
+  set(${out_text} ${CMAKE_MATCH_1} PARENT_SCOPE)
+  set(${out_ram} ${ram} PARENT_SCOPE)
+endfunction()
+
+set(failed FALSE)
+foreach(image IN LISTS IMAGES)
+  string(REGEX MATCH "^([^=]+)=(.*)$" pair "${image}")
+  set(role ${CMAKE_MATCH_1})
+  image_size(${CMAKE_MATCH_2} text ram)
+  if(role STREQUAL "full")
+    set(full_text ${text})
+    set(full_ram ${ram})
+  endif()
+  math(EXPR saved_text "${full_text} - ${text}")
+  math(EXPR saved_ram "${full_ram} - ${ram}")
+  message("FEATURE_SIZE,preset=${role},text=${text},ram=${ram},text_saved=${saved_text},ram_saved=${saved_ram}")
+  if(NOT role STREQUAL "full" AND NOT saved_text GREATER 0)
+    message("❌ ${role} is no smaller than the full image")
+    set(failed TRUE)
+  endif()
+endforeach()
+
+if(failed)
+  message(FATAL_ERROR "❌ A feature preset did not strip any code")
+endif()
@@ -0,0 +1,127 @@
+/*
+ * Telemetry Frame Decoder Implementation for ToxiRover
+ */
+
+#include "frame_decoder.h"
+#include "gas_sensor.h"
+
+// ---------------------------------------------------------------- input
+
+static int hexValue(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+// Hex digits with any whitespace between bytes; false on anything else
+bool parseFrameHex(const std::string& text, std::vector<uint8_t>& bytes) {
+  bytes.clear();
+  int high = -1;
+  for (char c : text) {
+    if (isspace((unsigned char)c)) {
+      if (high >= 0) return false;  // a byte split by whitespace
+      continue;
+    }
+    int value = hexValue(c);
+    if (value < 0) return false;
+    if (high < 0) {
+      high = value;
+    } else {
+      bytes.push_back((uint8_t)(high << 4 | value));
+      high = -1;
+    }
+  }
+  return high < 0;
+}
+
+// The magic 'T' is not a hex digit, so a raw capture never parses as hex text
+bool loadFrameCapture(const char* path, std::vector<uint8_t>& bytes) {
+  FILE* file = fopen(path, "rb");
+  if (file == NULL) {
+    fprintf(stderr, "❌ Cannot open %s\n", path);
+    return false;
+  }
+  std::string data;
+  char chunk[4096];
+  size_t n;
+  while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0) data.append(chunk, n);
+  fclose(file);
+
+  if (!data.empty() && data[0] == TELEMETRY_FRAME_MAGIC) {
+    bytes.assign(data.begin(), data.end());
+    return true;
+  }
+  if (!parseFrameHex(data, bytes)) {
+    fprintf(stderr, "❌ %s is neither a raw frame capture nor hex frames\n", path);
+    return false;
+  }
+  return true;
+}
+
+// ---------------------------------------------------------------- decoding
+
+// Frames are self-delimiting through the body length; anything that doesn't
+// decode is skipped a byte at a time until the next magic that does. There is
+// no checksum, so a stray 'T' with a plausible length still reads as a frame.
+void decodeFrameStream(const std::vector<uint8_t>& bytes, std::vector<TelemetryFrame>& frames, FrameDecodeStats& stats) {
+  size_t at = 0;
+  while (at < bytes.size()) {
+    TelemetryFrame frame;
+    if (!decodeTelemetryFrame(bytes.data() + at, bytes.size() - at, frame)) {
+      at++;
+      stats.skippedBytes++;
+      continue;
+    }
+    at += TELEMETRY_FRAME_HEADER_SIZE + bytes[at + 2];
+
+    auto last = stats.lastSeq.find(frame.device);
+    if (last != stats.lastSeq.end()) stats.lostFrames += (uint8_t)(frame.seq - last->second - 1);
+    stats.lastSeq[frame.device] = frame.seq;
+    frames.push_back(frame);
+    stats.frames++;
+  }
+  stats.bytes += bytes.size();
+}
+
+bool writeDecodedFrames(FILE* out, const std::vector<TelemetryFrame>& frames, FrameOutputFormat format) {
+  char line[TELEMETRY_JSON_SIZE];
+  if (format == FRAME_OUTPUT_CSV) fprintf(out, "%s\n", getTelemetryFrameCsvHeader());
+  for (const TelemetryFrame& frame : frames) {
+    const char* text = format == FRAME_OUTPUT_CSV ? formatTelemetryFrameCsv(frame, line, sizeof(line))
+                                                  : formatTelemetryFrameJson(frame, line, sizeof(line));
+    if (text == NULL || fprintf(out, "%s\n", text) < 0) return false;
+  }
+  return true;
+}
+
+// ---------------------------------------------------------------- synthetic capture
+
+// Rovers circling at different radii, their frames interleaved as a gateway would receive them
+void generateFrameCapture(int rovers, int framesPerRover, uint32_t seed, std::vector<uint8_t>& bytes) {
+  uint32_t rng = seed | 1;
+  bytes.clear();
+  for (int i = 0; i < framesPerRover; i++) {
+    for (int rover = 0; rover < rovers; rover++) {
+      rng = rng * 1664525UL + 1013904223UL;
+      float angle = i * 0.05f + rover;
+      float radius = 100 + 50 * rover;
+
+      TelemetryFrame frame;
+      memset(&frame, 0, sizeof(frame));
+      frame.seq = (uint8_t)i;
+      frame.stamp = i * TELEMETRY_FRAME_INTERVAL + rover * 37;
+      frame.device = 0xA10000UL + rover;
+      setTelemetryFrameGas(frame, 20 + (rng >> 8) % 4000 / 10.0f);
+      setTelemetryFramePose(frame, radius * cosf(angle), radius * sinf(angle), atan2f(cosf(angle), -sinf(angle)));  // tangent
+      frame.motion = MOTION_LEFT;
+      frame.distanceCm = (rng >> 20) % 8 == 0 ? TELEMETRY_NO_DISTANCE : 20 + (rng >> 12) % 300;
+      frame.servoAngle = TELEMETRY_NO_SERVO;
+      if (frame.gasDeciPpm >= GAS_WARNING_THRESHOLD * 10) frame.flags |= FRAME_FLAG_GAS_ALARM;
+
+      uint8_t encoded[TELEMETRY_FRAME_MAX_SIZE];
+      size_t length = encodeTelemetryFrame(frame, encoded, sizeof(encoded));
+      bytes.insert(bytes.end(), encoded, encoded + length);
+    }
+  }
+}
@@ -0,0 +1,42 @@
+/*
+ * Telemetry Frame Decoder for ToxiRover
+ * Turns captured binary telemetry frames back into JSON lines or CSV on the PC
+ *
+ * Features:
+ * - Raw captures (frames back to back, as saved from MQTT, UDP or the stream) or hex text, one frame per line
+ * - Resynchronizes on the magic byte after corrupt or truncated input
+ * - Every frame version the firmware's decoder accepts, per the schema evolution rules
+ * - Lost frames counted per device from sequence gaps
+ * - Synthetic capture generator for tests and the smoke run
+ */
+
+#ifndef FRAME_DECODER_H
+#define FRAME_DECODER_H
+
+#include "telemetry_frame.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+enum FrameOutputFormat {
+  FRAME_OUTPUT_JSON,    // one object per line
+  FRAME_OUTPUT_CSV      // header row, then one row per frame
+};
+
+struct FrameDecodeStats {
+  unsigned long frames;
+  unsigned long bytes;            // input consumed, frames and skipped bytes
+  unsigned long skippedBytes;     // not part of any valid frame
+  unsigned long lostFrames;       // sequence gaps, summed over devices
+  std::map<uint32_t, uint8_t> lastSeq;  // per device, to continue across captures
+};
+
+// Function declarations
+bool loadFrameCapture(const char* path, std::vector<uint8_t>& bytes);
+bool parseFrameHex(const std::string& text, std::vector<uint8_t>& bytes);
+void decodeFrameStream(const std::vector<uint8_t>& bytes, std::vector<TelemetryFrame>& frames, FrameDecodeStats& stats);
+bool writeDecodedFrames(FILE* out, const std::vector<TelemetryFrame>& frames, FrameOutputFormat format);
+void generateFrameCapture(int rovers, int framesPerRover, uint32_t seed, std::vector<uint8_t>& bytes);
+
+#endif
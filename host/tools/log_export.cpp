@@ -0,0 +1,678 @@
+/*
+ * Log Export Analyzer Implementation for ToxiRover
+ */
+
+#include "log_export.h"
+
+#include <atomic>
+#include <charconv>
+#include <functional>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+LogExportOptions defaultLogExportOptions() {
+  LogExportOptions options;
+  options.threads = std::max(1u, std::thread::hardware_concurrency());
+  options.chunkBytes = 0;
+  options.gapMs = LOG_EXPORT_GAP_MS;
+  options.windowMs = LOG_EXPORT_WINDOW_MS;
+  options.alertPpm = LOG_EXPORT_ALERT_PPM;
+  options.device = "rover";
+  return options;
+}
+
+// ---------------------------------------------------------------- series
+
+static void seriesAdd(LogSeries& series, uint32_t boot, uint64_t stamp, float ppm, const LogExportOptions& options) {
+  if (series.samples == 0) {
+    series.firstBoot = boot;
+    series.first = stamp;
+  } else if (boot != series.lastBoot) {
+    series.reboots++;  // boot-relative times restart; not a gap
+  } else if (stamp > series.last && stamp - series.last > options.gapMs) {
+    series.gaps.push_back({boot, series.last, stamp - series.last});
+  }
+  series.lastBoot = boot;
+  series.last = stamp;
+
+  series.samples++;
+  double delta = ppm - series.mean;
+  series.mean += delta / series.samples;
+  series.m2 += delta * (ppm - series.mean);
+  if (series.samples == 1 || ppm < series.min) series.min = ppm;
+  if (series.samples == 1 || ppm > series.max) series.max = ppm;
+
+  uint64_t start = stamp - stamp % options.windowMs;
+  if (series.points.empty() || series.points.back().boot != boot || series.points.back().start != start) {
+    series.points.push_back({boot, start, ppm, ppm, 0, 0});
+  }
+  LogSeriesPoint& point = series.points.back();
+  point.min = std::min(point.min, ppm);
+  point.max = std::max(point.max, ppm);
+  point.sum += ppm;
+  point.count++;
+
+  if (ppm < options.alertPpm) {
+    series.inAlert = false;
+  } else if (series.inAlert && series.alerts.back().boot == boot) {
+    LogAlertEpisode& episode = series.alerts.back();
+    episode.end = stamp;
+    episode.peak = std::max(episode.peak, ppm);
+    episode.samples++;
+  } else {
+    series.alerts.push_back({boot, stamp, stamp, ppm, 1});
+    series.inAlert = true;
+  }
+}
+
+// Appends the samples that followed `into` in the export, as if seriesAdd() had seen them all
+static void seriesAppend(LogSeries& into, LogSeries& next, const LogExportOptions& options) {
+  if (next.samples == 0) return;
+  if (into.samples == 0) {
+    into = std::move(next);
+    return;
+  }
+
+  if (next.firstBoot != into.lastBoot) {
+    into.reboots++;
+  } else if (next.first > into.last && next.first - into.last > options.gapMs) {
+    into.gaps.push_back({next.firstBoot, into.last, next.first - into.last});
+  }
+
+  // Chan et al.'s pairwise update for the combined mean and variance
+  uint64_t samples = into.samples + next.samples;
+  double delta = next.mean - into.mean;
+  into.mean += delta * next.samples / samples;
+  into.m2 += next.m2 + delta * delta * ((double)into.samples * next.samples / samples);
+  into.samples = samples;
+  into.min = std::min(into.min, next.min);
+  into.max = std::max(into.max, next.max);
+
+  size_t from = 0;
+  LogSeriesPoint& tail = into.points.back();
+  const LogSeriesPoint& head = next.points.front();
+  if (tail.boot == head.boot && tail.start == head.start) {
+    tail.min = std::min(tail.min, head.min);
+    tail.max = std::max(tail.max, head.max);
+    tail.sum += head.sum;
+    tail.count += head.count;
+    from = 1;
+  }
+  into.points.insert(into.points.end(), next.points.begin() + from, next.points.end());
+
+  // An episode open at the end of `into` continues if `next` starts above the threshold
+  from = 0;
+  if (into.inAlert && !next.alerts.empty() && next.firstBoot == into.lastBoot &&
+      next.alerts.front().start == next.first) {
+    LogAlertEpisode& open = into.alerts.back();
+    const LogAlertEpisode& continued = next.alerts.front();
+    open.end = continued.end;
+    open.peak = std::max(open.peak, continued.peak);
+    open.samples += continued.samples;
+    from = 1;
+  }
+  into.alerts.insert(into.alerts.end(), next.alerts.begin() + from, next.alerts.end());
+  into.gaps.insert(into.gaps.end(), next.gaps.begin(), next.gaps.end());
+
+  into.inAlert = next.inAlert;
+  into.last = next.last;
+  into.lastBoot = next.lastBoot;
+  into.reboots += next.reboots;
+}
+
+double logSeriesStdDev(const LogSeries& series) {
+  return series.samples > 1 ? sqrt(series.m2 / (series.samples - 1)) : 0;
+}
+
+// ---------------------------------------------------------------- JSON scanning
+
+static inline bool isSpace(char c) {
+  return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+static inline size_t skipSpace(const char* data, size_t size, size_t pos) {
+  while (pos < size && isSpace(data[pos])) pos++;
+  return pos;
+}
+
+// An odd run of backslashes before a quote escapes it
+static inline bool isEscaped(const char* data, size_t pos) {
+  size_t run = 0;
+  while (run < pos && data[pos - 1 - run] == '\\') run++;
+  return run & 1;
+}
+
+// Index of the quote closing a string whose contents start at `pos`, or size
+static size_t stringClose(const char* data, size_t size, size_t pos) {
+  while (pos < size) {
+    const char* quote = (const char*)memchr(data + pos, '"', size - pos);
+    if (quote == NULL) return size;
+    pos = quote - data;
+    if (!isEscaped(data, pos)) return pos;
+    pos++;
+  }
+  return size;
+}
+
+static int countQuotes(const char* data, size_t begin, size_t end) {
+  int quotes = 0;
+  for (size_t pos = begin; pos < end; pos++) {
+    const char* quote = (const char*)memchr(data + pos, '"', end - pos);
+    if (quote == NULL) break;
+    pos = quote - data;
+    if (!isEscaped(data, pos)) quotes++;
+  }
+  return quotes;
+}
+
+// True if the object opening at `open` holds only scalars (a /logs or /event_logs record)
+static bool isLeafObject(const char* data, size_t size, size_t open) {
+  for (size_t pos = open + 1; pos < size; pos++) {
+    char c = data[pos];
+    if (c == '"') pos = stringClose(data, size, pos + 1);
+    else if (c == '}') return true;
+    else if (c == '{' || c == '[') return false;
+  }
+  return false;
+}
+
+// Opening quote of the first key at or after `pos` whose value is a leaf object.
+// Chunks start there, so a chunk never begins inside a record or between a key and its object.
+static size_t findRecordBoundary(const char* data, size_t size, size_t pos, bool inString) {
+  if (inString) pos = stringClose(data, size, pos) + 1;  // the rest of a string is never a key we can use
+  size_t lastString = SIZE_MAX;
+  size_t key = SIZE_MAX;
+  while (pos < size) {
+    char c = data[pos];
+    if (c == '"') {
+      lastString = pos;
+      key = SIZE_MAX;
+      pos = stringClose(data, size, pos + 1) + 1;
+      continue;
+    }
+    if (c == ':') {
+      key = lastString;
+    } else if (c == '{') {
+      if (key != SIZE_MAX && isLeafObject(data, size, pos)) return key;
+      key = SIZE_MAX;
+    } else if (!isSpace(c)) {
+      key = SIZE_MAX;
+    }
+    if (c != ':' && !isSpace(c)) lastString = SIZE_MAX;
+    pos++;
+  }
+  return size;
+}
+
+struct LeafRecord {
+  bool hasGas;
+  bool hasStamp;
+  bool hasEvent;
+  float ppm;
+  uint64_t stamp;
+  uint32_t boot;
+  const char* event;
+  size_t eventLength;
+  const char* data;
+  size_t dataLength;
+};
+
+static inline bool keyIs(const char* key, size_t length, const char* name) {
+  return length == strlen(name) && memcmp(key, name, length) == 0;
+}
+
+// Reads the leaf object opening at `open`; false if it holds a nested object or array
+static bool parseLeafObject(const char* data, size_t size, size_t open, LeafRecord& record, size_t& end) {
+  memset(&record, 0, sizeof(record));
+  size_t pos = open + 1;
+  for (;;) {
+    pos = skipSpace(data, size, pos);
+    if (pos < size && data[pos] == ',') pos = skipSpace(data, size, pos + 1);
+    if (pos >= size) return false;
+    if (data[pos] == '}') {
+      end = pos + 1;
+      return true;
+    }
+    if (data[pos] != '"') return false;
+
+    const char* key = data + pos + 1;
+    size_t keyClose = stringClose(data, size, pos + 1);
+    size_t keyLength = data + keyClose - key;
+    pos = skipSpace(data, size, keyClose + 1);
+    if (pos >= size || data[pos] != ':') return false;
+    pos = skipSpace(data, size, pos + 1);
+    if (pos >= size || data[pos] == '{' || data[pos] == '[') return false;
+
+    const char* value;
+    size_t valueLength;
+    if (data[pos] == '"') {
+      value = data + pos + 1;
+      size_t valueClose = stringClose(data, size, pos + 1);
+      valueLength = data + valueClose - value;
+      pos = valueClose + 1;
+    } else {
+      value = data + pos;
+      while (pos < size && data[pos] != ',' && data[pos] != '}' && !isSpace(data[pos])) pos++;
+      valueLength = data + pos - value;
+    }
+
+    if (keyIs(key, keyLength, "gas_ppm")) {
+      double ppm;
+      record.hasGas = std::from_chars(value, value + valueLength, ppm).ec == std::errc();
+      record.ppm = (float)ppm;
+    } else if (keyIs(key, keyLength, "timestamp")) {
+      record.hasStamp = std::from_chars(value, value + valueLength, record.stamp).ec == std::errc();
+    } else if (keyIs(key, keyLength, "boot_id")) {
+      std::from_chars(value, value + valueLength, record.boot, 16);
+    } else if (keyIs(key, keyLength, "event")) {
+      record.hasEvent = true;
+      record.event = value;
+      record.eventLength = valueLength;
+    } else if (keyIs(key, keyLength, "data")) {
+      record.data = value;
+      record.dataLength = valueLength;
+    }
+  }
+}
+
+static void appendUtf8(std::string& out, unsigned code) {
+  if (code < 0x80) {
+    out += (char)code;
+  } else if (code < 0x800) {
+    out += (char)(0xC0 | (code >> 6));
+    out += (char)(0x80 | (code & 0x3F));
+  } else {
+    out += (char)(0xE0 | (code >> 12));
+    out += (char)(0x80 | ((code >> 6) & 0x3F));
+    out += (char)(0x80 | (code & 0x3F));
+  }
+}
+
+static std::string unescapeJson(const char* text, size_t length) {
+  std::string out;
+  out.reserve(length);
+  for (size_t i = 0; i < length; i++) {
+    if (text[i] != '\\' || i + 1 == length) {
+      out += text[i];
+      continue;
+    }
+    char c = text[++i];
+    switch (c) {
+      case 'n': out += '\n'; break;
+      case 't': out += '\t'; break;
+      case 'r': out += '\r'; break;
+      case 'b': out += '\b'; break;
+      case 'f': out += '\f'; break;
+      case 'u': {
+        unsigned code = 0;
+        if (i + 4 < length && std::from_chars(text + i + 1, text + i + 5, code, 16).ec == std::errc()) {
+          appendUtf8(out, code);
+          i += 4;
+        }
+        break;
+      }
+      default: out += c; break;  // \" \\ \/
+    }
+  }
+  return out;
+}
+
+// ---------------------------------------------------------------- chunks
+
+// Records under one parent object, as far as the chunk can tell
+struct ChunkContext {
+  size_t pops;                     // enclosing objects of the chunk's start closed before these records
+  std::vector<std::string> path;   // objects opened inside the chunk, outermost first
+  LogSeries series;
+  std::vector<LogEvent> events;
+};
+
+struct ChunkResult {
+  size_t pops;                     // objects closed that opened before the chunk
+  std::vector<std::string> stack;  // objects opened in the chunk and still open at its end
+  std::vector<ChunkContext> contexts;
+};
+
+static void parseChunk(const char* data, size_t size, size_t begin, size_t end,
+                       const LogExportOptions& options, ChunkResult& result) {
+  result.pops = 0;
+  unsigned long depthChanges = 0;
+  unsigned long contextChanges = ~0UL;
+  const char* key = "";
+  size_t keyLength = 0;
+
+  size_t pos = begin;
+  while (pos < end) {
+    char c = data[pos];
+    if (c == '"') {
+      size_t close = stringClose(data, size, pos + 1);
+      size_t next = skipSpace(data, size, close + 1);
+      if (next < size && data[next] == ':') {
+        key = data + pos + 1;
+        keyLength = close - pos - 1;
+        pos = next + 1;
+      } else {
+        pos = close + 1;  // a string value outside any record
+      }
+      continue;
+    }
+    if (c == '{' || c == '[') {
+      LeafRecord record;
+      size_t recordEnd;
+      if (c == '{' && parseLeafObject(data, size, pos, record, recordEnd)) {
+        bool sample = record.hasGas && record.hasStamp;
+        bool event = record.hasEvent && record.hasStamp;
+        if (sample || event) {
+          if (contextChanges != depthChanges) {
+            result.contexts.push_back(ChunkContext());
+            result.contexts.back().pops = result.pops;
+            result.contexts.back().path = result.stack;
+            contextChanges = depthChanges;
+          }
+          ChunkContext& context = result.contexts.back();
+          if (sample) seriesAdd(context.series, record.boot, record.stamp, record.ppm, options);
+          else context.events.push_back({record.stamp, unescapeJson(record.event, record.eventLength),
+                                         unescapeJson(record.data, record.dataLength)});
+        }
+        pos = recordEnd;
+      } else {
+        result.stack.push_back(std::string(key, keyLength));
+        depthChanges++;
+        pos++;
+      }
+      keyLength = 0;
+      continue;
+    }
+    if (c == '}' || c == ']') {
+      if (!result.stack.empty()) result.stack.pop_back();
+      else result.pops++;
+      depthChanges++;
+    }
+    if (c != ':' && !isSpace(c)) keyLength = 0;
+    pos++;
+  }
+}
+
+static void runParallel(int tasks, int threads, const std::function<void(int)>& task) {
+  std::atomic<int> next(0);
+  auto worker = [&]() {
+    for (int i = next++; i < tasks; i = next++) task(i);
+  };
+  std::vector<std::thread> pool;
+  for (int t = 1; t < std::min(threads, tasks); t++) pool.emplace_back(worker);
+  worker();
+  for (std::thread& thread : pool) thread.join();
+}
+
+static int chunkCount(size_t size, const LogExportOptions& options) {
+  if (options.chunkBytes > 0) return (int)std::min<size_t>((size + options.chunkBytes - 1) / options.chunkBytes, INT32_MAX);
+  size_t chunks = std::min<size_t>((size_t)options.threads * 4, size / LOG_EXPORT_MIN_CHUNK);
+  return (int)std::max<size_t>(chunks, 1);
+}
+
+// Device from /rovers/<id>/...; records must sit under logs / event_logs, or
+// directly under the root when the export is of that node itself
+static void mergeContext(ChunkContext& context, const std::vector<std::string>& path,
+                         const LogExportOptions& options, LogExportResult& result) {
+  size_t rovers = 0;
+  while (rovers + 1 < path.size() && path[rovers] != "rovers") rovers++;
+  const std::string& name = rovers + 2 < path.size() ? path[rovers + 1] : options.device;
+  bool root = path.size() <= 1;
+  std::string parent = root ? "" : path.back();
+
+  DeviceLogs& logs = result.devices[name];
+  if (root || parent == "logs") {
+    result.samples += context.series.samples;
+    seriesAppend(logs.series, context.series, options);
+  }
+  if (root || parent == "event_logs") {
+    result.events += context.events.size();
+    logs.events.insert(logs.events.end(), std::make_move_iterator(context.events.begin()),
+                       std::make_move_iterator(context.events.end()));
+  }
+}
+
+// Quote parity per chunk gives each chunk's string state; chunks then move to
+// record boundaries, parse in parallel, and are stitched in file order
+void analyzeLogExport(const char* data, size_t size, const LogExportOptions& options, LogExportResult& result) {
+  result.bytes += size;
+  if (size == 0) return;
+
+  int chunks = chunkCount(size, options);
+  std::vector<size_t> starts(chunks + 1);
+  for (int k = 0; k < chunks; k++) starts[k] = (size_t)((unsigned __int128)size * k / chunks);
+  starts[chunks] = size;
+
+  std::vector<int> quotes(chunks);
+  runParallel(chunks, options.threads, [&](int k) { quotes[k] = countQuotes(data, starts[k], starts[k + 1]); });
+
+  std::vector<size_t> bounds(chunks + 1);
+  bounds[0] = 0;
+  bounds[chunks] = size;
+  int parity = 0;
+  for (int k = 1; k < chunks; k++) {
+    parity ^= quotes[k - 1] & 1;
+    bounds[k] = std::max(bounds[k - 1], findRecordBoundary(data, size, starts[k], parity));
+  }
+
+  std::vector<ChunkResult> parsed(chunks);
+  runParallel(chunks, options.threads, [&](int k) {
+    parseChunk(data, size, bounds[k], bounds[k + 1], options, parsed[k]);
+  });
+
+  std::vector<std::string> base;  // objects open at the start of the chunk
+  for (ChunkResult& chunk : parsed) {
+    for (ChunkContext& context : chunk.contexts) {
+      std::vector<std::string> path(base.begin(), base.end() - std::min(context.pops, base.size()));
+      path.insert(path.end(), context.path.begin(), context.path.end());
+      mergeContext(context, path, options, result);
+    }
+    base.resize(base.size() - std::min(chunk.pops, base.size()));
+    base.insert(base.end(), chunk.stack.begin(), chunk.stack.end());
+  }
+  result.chunks += chunks;
+}
+
+bool analyzeLogFile(const char* path, const LogExportOptions& options, LogExportResult& result) {
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    fprintf(stderr, "❌ Cannot open %s: %s\n", path, strerror(errno));
+    return false;
+  }
+  struct stat info;
+  if (fstat(fd, &info) != 0) {
+    fprintf(stderr, "❌ Cannot stat %s: %s\n", path, strerror(errno));
+    close(fd);
+    return false;
+  }
+  if (info.st_size == 0) {
+    close(fd);
+    return true;
+  }
+
+  void* mapped = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapped == MAP_FAILED) {
+    fprintf(stderr, "❌ Cannot map %s: %s\n", path, strerror(errno));
+    return false;
+  }
+  madvise(mapped, info.st_size, MADV_SEQUENTIAL);
+  analyzeLogExport((const char*)mapped, info.st_size, options, result);
+  munmap(mapped, info.st_size);
+  return true;
+}
+
+// ---------------------------------------------------------------- output
+
+static FILE* openTable(const char* directory, const char* name, const char* header) {
+  std::string path = std::string(directory) + "/" + name;
+  FILE* out = fopen(path.c_str(), "w");
+  if (out == NULL) {
+    fprintf(stderr, "❌ Cannot write %s: %s\n", path.c_str(), strerror(errno));
+    return NULL;
+  }
+  fputs(header, out);
+  fputc('\n', out);
+  return out;
+}
+
+static void writeCsvText(FILE* out, const std::string& text) {
+  if (text.find_first_of(",\"\n\r") == std::string::npos) {
+    fputs(text.c_str(), out);
+    return;
+  }
+  fputc('"', out);
+  for (char c : text) {
+    if (c == '"') fputc('"', out);
+    fputc(c, out);
+  }
+  fputc('"', out);
+}
+
+static const char* bootText(uint32_t boot, char* text) {
+  if (boot == 0) text[0] = '\0';
+  else snprintf(text, 9, "%08x", boot);
+  return text;
+}
+
+// devices.csv, series.csv, gaps.csv, alerts.csv and events.csv, one row per item
+bool writeLogTables(const LogExportResult& result, const char* directory) {
+  if (mkdir(directory, 0755) != 0 && errno != EEXIST) {
+    fprintf(stderr, "❌ Cannot create %s: %s\n", directory, strerror(errno));
+    return false;
+  }
+  FILE* devices = openTable(directory, "devices.csv",
+      "device,samples,first_ms,last_ms,gas_min,gas_mean,gas_max,gas_std,gaps,gap_total_ms,longest_gap_ms,"
+      "alert_episodes,reboots,events");
+  FILE* series = openTable(directory, "series.csv", "device,boot_id,start_ms,min,mean,max,n");
+  FILE* gaps = openTable(directory, "gaps.csv", "device,boot_id,start_ms,length_ms");
+  FILE* alerts = openTable(directory, "alerts.csv", "device,boot_id,start_ms,end_ms,peak_ppm,samples");
+  FILE* events = openTable(directory, "events.csv", "device,timestamp,event,data");
+  bool ok = devices && series && gaps && alerts && events;
+
+  char boot[9];
+  for (auto& entry : result.devices) {
+    if (!ok) break;
+    const char* device = entry.first.c_str();
+    const LogSeries& log = entry.second.series;
+
+    uint64_t gapTotal = 0, longestGap = 0;
+    for (const LogGap& gap : log.gaps) {
+      gapTotal += gap.lengthMs;
+      longestGap = std::max(longestGap, gap.lengthMs);
+      fprintf(gaps, "%s,%s,%llu,%llu\n", device, bootText(gap.boot, boot),
+              (unsigned long long)gap.start, (unsigned long long)gap.lengthMs);
+    }
+    fprintf(devices, "%s,%llu,%llu,%llu,%.2f,%.2f,%.2f,%.2f,%zu,%llu,%llu,%zu,%u,%zu\n", device,
+            (unsigned long long)log.samples, (unsigned long long)log.first, (unsigned long long)log.last,
+            log.min, log.mean, log.max, logSeriesStdDev(log), log.gaps.size(), (unsigned long long)gapTotal,
+            (unsigned long long)longestGap, log.alerts.size(), log.reboots, entry.second.events.size());
+
+    for (const LogSeriesPoint& point : log.points) {
+      fprintf(series, "%s,%s,%llu,%.2f,%.2f,%.2f,%u\n", device, bootText(point.boot, boot),
+              (unsigned long long)point.start, point.min, point.sum / point.count, point.max, point.count);
+    }
+    for (const LogAlertEpisode& episode : log.alerts) {
+      fprintf(alerts, "%s,%s,%llu,%llu,%.2f,%u\n", device, bootText(episode.boot, boot),
+              (unsigned long long)episode.start, (unsigned long long)episode.end, episode.peak, episode.samples);
+    }
+    for (const LogEvent& event : entry.second.events) {
+      fprintf(events, "%s,%llu,", device, (unsigned long long)event.timestamp);
+      writeCsvText(events, event.event);
+      fputc(',', events);
+      writeCsvText(events, event.data);
+      fputc('\n', events);
+    }
+  }
+
+  for (FILE* table : {devices, series, gaps, alerts, events}) {
+    if (table != NULL && fclose(table) != 0) ok = false;
+  }
+  return ok;
+}
+
+void printLogExportSummary(const LogExportResult& result) {
+  printf("📒 %llu samples and %llu events from %zu devices\n", (unsigned long long)result.samples,
+         (unsigned long long)result.events, result.devices.size());
+  for (auto& entry : result.devices) {
+    const LogSeries& log = entry.second.series;
+    uint64_t longestGap = 0;
+    for (const LogGap& gap : log.gaps) longestGap = std::max(longestGap, gap.lengthMs);
+    printf("  %s: %llu samples, gas %.1f/%.1f/%.1f ± %.1f ppm, %zu gaps (longest %llu ms), "
+           "%zu alert episodes, %u reboots, %zu events\n", entry.first.c_str(), (unsigned long long)log.samples,
+           log.min, log.mean, log.max, logSeriesStdDev(log), log.gaps.size(), (unsigned long long)longestGap,
+           log.alerts.size(), log.reboots, entry.second.events.size());
+  }
+}
+
+// ---------------------------------------------------------------- synthetic export
+
+#define SYNTHETIC_START_MS 1767225600000ULL
+#define SYNTHETIC_EVENT_EVERY 100000  // bytes of /logs per /event_logs entry
+#define SYNTHETIC_PLUME_EVERY 2000    // samples between gas plumes
+#define SYNTHETIC_PLUME_LENGTH 20
+#define SYNTHETIC_STALL_EVERY 5000    // samples between logger stalls
+
+// A whole-database export shaped like the console's: /rovers/<id>/{event_logs,logs},
+// keys sorted, 3 s logging with jitter, periodic plumes over the alert threshold
+// and stalls longer than LOG_EXPORT_GAP_MS
+bool writeSyntheticExport(const char* path, int devices, uint64_t bytes, SyntheticExport& written) {
+  FILE* out = fopen(path, "w");
+  if (out == NULL) {
+    fprintf(stderr, "❌ Cannot write %s: %s\n", path, strerror(errno));
+    return false;
+  }
+  static char buffer[1 << 20];
+  setvbuf(out, buffer, _IOFBF, sizeof(buffer));
+  memset(&written, 0, sizeof(written));
+
+  uint64_t perDevice = bytes / devices;
+  uint32_t rng = 1;
+  fputs("{\"rovers\":{", out);
+  uint64_t total = 11;  // the braces around the rovers
+  for (int d = 0; d < devices; d++) {
+    uint64_t deviceBytes = fprintf(out, "%s\"%06x\":{\"event_logs\":{", d > 0 ? "," : "", 0x1a2b00 + d);
+    uint64_t events = std::max<uint64_t>(1, perDevice / SYNTHETIC_EVENT_EVERY);
+    for (uint64_t e = 0; e < events; e++) {
+      deviceBytes += fprintf(out, "%s\"-Nx%012llu\":{\"data\":\"peak \\\"%llu\\\" ppm, zone A\",\"event\":\"gas_alert\","
+              "\"timestamp\":%llu}", e > 0 ? "," : "", (unsigned long long)e, (unsigned long long)(300 + e % 200),
+              (unsigned long long)(SYNTHETIC_START_MS + e * 60000));
+    }
+    written.events += events;
+
+    fputs("},\"logs\":{", out);
+    deviceBytes += 10;
+    uint64_t stamp = SYNTHETIC_START_MS;
+    for (uint64_t i = 0; deviceBytes < perDevice; i++) {
+      rng = rng * 1103515245UL + 12345UL;
+      bool plume = i % SYNTHETIC_PLUME_EVERY >= SYNTHETIC_PLUME_EVERY - SYNTHETIC_PLUME_LENGTH;
+      if (i > 0) {
+        stamp += 3000 + (rng >> 16) % 40;
+        if (i % SYNTHETIC_STALL_EVERY == 0 && !plume) {
+          stamp += LOG_EXPORT_GAP_MS + (rng >> 8) % 60000;
+          written.gaps++;
+        }
+      }
+      if (plume && i % SYNTHETIC_PLUME_EVERY == SYNTHETIC_PLUME_EVERY - SYNTHETIC_PLUME_LENGTH) written.alerts++;
+      float ppm = plume ? LOG_EXPORT_ALERT_PPM + 20 + (rng >> 20) % 200 : 40 + (rng >> 20) % 60;
+      deviceBytes += fprintf(out, "%s\"%llu\":{\"distance_cm\":%u,\"gas_ppm\":%.2f,\"motion\":\"%s\",\"servo_angle\":%u,"
+              "\"timestamp\":%llu,\"x_cm\":%d,\"y_cm\":%d}", i > 0 ? "," : "", (unsigned long long)stamp,
+              (rng >> 12) % 200, ppm, (rng >> 10) % 4 == 0 ? "STOP" : "FORWARD", 90 + (rng >> 14) % 60,
+              (unsigned long long)stamp, (int)(i % 500), -(int)(i % 300));
+      written.samples++;
+    }
+    fputs("}}", out);
+    total += deviceBytes + 2;
+  }
+  fputs("}}", out);
+
+  written.bytes = total + 2;
+  if (fclose(out) != 0) {
+    fprintf(stderr, "❌ Cannot write %s: %s\n", path, strerror(errno));
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,118 @@
+/*
+ * Log Export Analyzer for ToxiRover
+ * Reads RTDB JSON exports of /logs and /event_logs on the PC, in parallel chunks
+ *
+ * Features:
+ * - Memory-mapped input; any subtree export (one rover's /logs, a rover root, the whole database)
+ * - Chunks parsed on worker threads, then stitched back together in file order
+ * - Per-device gas statistics, gas alert episodes, sampling gaps and a downsampled series
+ * - /event_logs entries as an event timeline
+ * - Columnar output: one CSV table per kind of row
+ * - Synthetic export generator for the throughput benchmark
+ */
+
+#ifndef LOG_EXPORT_H
+#define LOG_EXPORT_H
+
+#include "gas_sensor.h"
+#include "log_summary.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+#define LOG_EXPORT_GAP_MS 45000                     // above the parked logger interval (30 s)
+#define LOG_EXPORT_WINDOW_MS LOG_SUMMARY_WINDOW     // same points as /log_summary
+#define LOG_EXPORT_ALERT_PPM GAS_WARNING_THRESHOLD
+#define LOG_EXPORT_MIN_CHUNK (4UL << 20)            // smaller chunks cost more than they balance
+
+struct LogExportOptions {
+  int threads;
+  size_t chunkBytes;    // 0: a few chunks per thread
+  unsigned long gapMs;
+  unsigned long windowMs;
+  float alertPpm;
+  std::string device;   // for records outside /rovers/<id>
+};
+
+// boot is the record's boot_id, 0 once the rover had wall-clock time; times are
+// the record timestamps (epoch ms, or ms since that boot)
+struct LogSeriesPoint {
+  uint32_t boot;
+  uint64_t start;
+  float min;
+  float max;
+  double sum;
+  uint32_t count;
+};
+
+struct LogGap {
+  uint32_t boot;
+  uint64_t start;       // last sample before the gap
+  uint64_t lengthMs;
+};
+
+struct LogAlertEpisode {
+  uint32_t boot;
+  uint64_t start;
+  uint64_t end;         // last sample at or above the threshold
+  float peak;
+  uint32_t samples;
+};
+
+struct LogEvent {
+  uint64_t timestamp;
+  std::string event;
+  std::string data;
+};
+
+// One device's /logs samples in export (key) order
+struct LogSeries {
+  uint64_t samples;
+  double mean;
+  double m2;            // Welford sum of squared deviations
+  float min;
+  float max;
+  uint32_t firstBoot;
+  uint32_t lastBoot;
+  uint64_t first;
+  uint64_t last;
+  uint32_t reboots;     // boot_id changes between consecutive samples
+  bool inAlert;         // the last episode is still open
+  std::vector<LogSeriesPoint> points;
+  std::vector<LogGap> gaps;
+  std::vector<LogAlertEpisode> alerts;
+};
+
+struct DeviceLogs {
+  LogSeries series;
+  std::vector<LogEvent> events;
+};
+
+struct LogExportResult {
+  std::map<std::string, DeviceLogs> devices;
+  uint64_t bytes;
+  uint64_t samples;
+  uint64_t events;
+  int chunks;
+};
+
+// What writeSyntheticExport() put in the file, to check the analysis against
+struct SyntheticExport {
+  uint64_t bytes;
+  uint64_t samples;
+  uint64_t events;
+  uint64_t gaps;
+  uint64_t alerts;
+};
+
+// Function declarations
+LogExportOptions defaultLogExportOptions();
+void analyzeLogExport(const char* data, size_t size, const LogExportOptions& options, LogExportResult& result);
+bool analyzeLogFile(const char* path, const LogExportOptions& options, LogExportResult& result);
+double logSeriesStdDev(const LogSeries& series);
+bool writeLogTables(const LogExportResult& result, const char* directory);
+void printLogExportSummary(const LogExportResult& result);
+bool writeSyntheticExport(const char* path, int devices, uint64_t bytes, SyntheticExport& written);
+
+#endif
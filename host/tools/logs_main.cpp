@@ -0,0 +1,123 @@
+/*
+ * Log Export Tool for ToxiRover
+ * Analyzes RTDB JSON exports of /logs and /event_logs on the PC
+ *
+ * Usage: toxirover_logs [options] EXPORT.json...
+ *   --out DIR        write devices/series/gaps/alerts/events.csv into DIR
+ *   --threads N      worker threads (default: all cores)
+ *   --device ID      device for records outside /rovers/<id> (default: rover)
+ *   --gap-ms MS      sample spacing that counts as a gap (default 45000)
+ *   --window-ms MS   downsampled point width (default 60000)
+ *   --alert-ppm PPM  gas alert threshold (default 300)
+ *   --bench MB       analyze a synthetic MB-sized export instead, at 1 and N threads
+ *   --keep FILE      where --bench writes its export, kept afterwards
+ * Exports must be given in time order; a device's records continue across files.
+ * Prints LOGEXPORT CSV lines with the throughput of each run.
+ */
+
+#include "log_export.h"
+
+#include <chrono>
+#include <unistd.h>
+
+#define BENCH_DEVICES 4
+#define BENCH_PATH "/tmp/toxirover_logs_bench.json"
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void printThroughput(const char* name, const LogExportResult& result, int threads, double seconds) {
+  printf("LOGEXPORT,%s,bytes=%llu,samples=%llu,events=%llu,threads=%d,chunks=%d,seconds=%.3f,mb_per_s=%.1f\n",
+         name, (unsigned long long)result.bytes, (unsigned long long)result.samples,
+         (unsigned long long)result.events, threads, result.chunks, seconds,
+         seconds > 0 ? result.bytes / seconds / 1e6 : 0.0);
+}
+
+// Generated export against what the analysis found, at one thread and at all of them
+static int runBench(uint64_t megabytes, const char* keep, const LogExportOptions& options) {
+  const char* path = keep != NULL ? keep : BENCH_PATH;
+  SyntheticExport written;
+  auto start = std::chrono::steady_clock::now();
+  if (!writeSyntheticExport(path, BENCH_DEVICES, megabytes << 20, written)) return 1;
+  printf("📝 Synthetic export: %llu bytes, %llu samples, %llu events in %.1f s\n",
+         (unsigned long long)written.bytes, (unsigned long long)written.samples,
+         (unsigned long long)written.events, secondsSince(start));
+
+  int failures = 0;
+  std::vector<int> threadCounts = {1};
+  if (options.threads > 1) threadCounts.push_back(options.threads);
+  for (int threads : threadCounts) {
+    LogExportOptions run = options;
+    run.threads = threads;
+    LogExportResult result = {};
+    start = std::chrono::steady_clock::now();
+    if (!analyzeLogFile(path, run, result)) return 1;
+    printThroughput("bench", result, threads, secondsSince(start));
+
+    uint64_t gaps = 0, alerts = 0;
+    for (auto& entry : result.devices) {
+      gaps += entry.second.series.gaps.size();
+      alerts += entry.second.series.alerts.size();
+    }
+    if (result.bytes != written.bytes || result.samples != written.samples || result.events != written.events ||
+        gaps != written.gaps || alerts != written.alerts || result.devices.size() != BENCH_DEVICES) {
+      fprintf(stderr, "❌ %d threads: found %llu samples, %llu events, %llu gaps, %llu alerts; expected "
+              "%llu, %llu, %llu, %llu\n", threads, (unsigned long long)result.samples,
+              (unsigned long long)result.events, (unsigned long long)gaps, (unsigned long long)alerts,
+              (unsigned long long)written.samples, (unsigned long long)written.events,
+              (unsigned long long)written.gaps, (unsigned long long)written.alerts);
+      failures++;
+    }
+  }
+
+  if (keep == NULL) unlink(path);
+  return failures == 0 ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+  LogExportOptions options = defaultLogExportOptions();
+  const char* out = NULL;
+  const char* keep = NULL;
+  uint64_t benchMegabytes = 0;
+  std::vector<const char*> files;
+
+  for (int i = 1; i < argc; i++) {
+    const char* arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (strcmp(arg, "--out") == 0 && hasValue) out = argv[++i];
+    else if (strcmp(arg, "--threads") == 0 && hasValue) options.threads = std::max(1, atoi(argv[++i]));
+    else if (strcmp(arg, "--device") == 0 && hasValue) options.device = argv[++i];
+    else if (strcmp(arg, "--gap-ms") == 0 && hasValue) options.gapMs = strtoul(argv[++i], NULL, 10);
+    else if (strcmp(arg, "--window-ms") == 0 && hasValue) options.windowMs = std::max(1UL, strtoul(argv[++i], NULL, 10));
+    else if (strcmp(arg, "--alert-ppm") == 0 && hasValue) options.alertPpm = strtof(argv[++i], NULL);
+    else if (strcmp(arg, "--bench") == 0 && hasValue) benchMegabytes = strtoull(argv[++i], NULL, 10);
+    else if (strcmp(arg, "--keep") == 0 && hasValue) keep = argv[++i];
+    else if (arg[0] == '-') {
+      fprintf(stderr, "❌ Unknown option %s\n", arg);
+      return 2;
+    } else {
+      files.push_back(arg);
+    }
+  }
+
+  if (benchMegabytes > 0) return runBench(benchMegabytes, keep, options);
+  if (files.empty()) {
+    fprintf(stderr, "Usage: toxirover_logs [--out DIR] [--threads N] [--device ID] EXPORT.json...\n");
+    return 2;
+  }
+
+  LogExportResult result = {};
+  auto start = std::chrono::steady_clock::now();
+  for (const char* file : files) {
+    if (!analyzeLogFile(file, options, result)) return 1;
+  }
+  printThroughput("analyze", result, options.threads, secondsSince(start));
+  printLogExportSummary(result);
+
+  if (out != NULL) {
+    if (!writeLogTables(result, out)) return 1;
+    printf("💾 Tables written to %s\n", out);
+  }
+  return 0;
+}
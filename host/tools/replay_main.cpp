@@ -0,0 +1,100 @@
+/*
+ * Trace Replay Tool for ToxiRover
+ * Replays a recorded sensor trace through this build's firmware logic on the PC
+ *
+ * Usage: toxirover_replay [options] TRACE
+ *   TRACE            /trace.bin from the rover's /trace page, or a Serial capture of 'dump'
+ *   --out FILE       write the decision log (one CSV line per decision)
+ *   --compare FILE   compare with a decision log from another firmware version; exit 1 on a difference
+ *   --record SECONDS record a scripted session into TRACE first, then replay it against the live log
+ *   --seed N         noise seed for --record (default 1)
+ * Prints a REPLAY CSV line with the record count and the speed-up over real time.
+ */
+
+#include "trace_replay.h"
+#include "fake_hal.h"
+#include "config_store.h"
+
+#include <chrono>
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static bool saveTrace(const char* path, const std::vector<uint8_t>& trace) {
+  FILE* file = fopen(path, "wb");
+  if (file == NULL) {
+    fprintf(stderr, "❌ Cannot write %s\n", path);
+    return false;
+  }
+  bool ok = fwrite(trace.data(), 1, trace.size(), file) == trace.size();
+  fclose(file);
+  return ok;
+}
+
+static int reportDifference(const char* what, const std::vector<std::string>& expected,
+                            const std::vector<std::string>& actual) {
+  long line = compareReplayOutputs(expected, actual);
+  if (line < 0) {
+    printf("✅ Decisions match %s (%zu lines)\n", what, actual.size());
+    return 0;
+  }
+  fprintf(stderr, "❌ Decisions differ from %s at line %ld\n", what, line + 1);
+  fprintf(stderr, "  expected: %s\n", (size_t)line < expected.size() ? expected[line].c_str() : "(end)");
+  fprintf(stderr, "  actual:   %s\n", (size_t)line < actual.size() ? actual[line].c_str() : "(end)");
+  return 1;
+}
+
+int main(int argc, char** argv) {
+  const char* out = NULL;
+  const char* compare = NULL;
+  const char* tracePath = NULL;
+  unsigned long recordSeconds = 0;
+  uint32_t seed = 1;
+
+  for (int i = 1; i < argc; i++) {
+    const char* arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (strcmp(arg, "--out") == 0 && hasValue) out = argv[++i];
+    else if (strcmp(arg, "--compare") == 0 && hasValue) compare = argv[++i];
+    else if (strcmp(arg, "--record") == 0 && hasValue) recordSeconds = strtoul(argv[++i], NULL, 10);
+    else if (strcmp(arg, "--seed") == 0 && hasValue) seed = strtoul(argv[++i], NULL, 10);
+    else if (arg[0] == '-') {
+      fprintf(stderr, "❌ Unknown option %s\n", arg);
+      return 2;
+    } else {
+      tracePath = arg;
+    }
+  }
+  if (tracePath == NULL) {
+    fprintf(stderr, "Usage: toxirover_replay [--out FILE] [--compare FILE] [--record SECONDS] TRACE\n");
+    return 2;
+  }
+
+  initConfigStore();
+  std::vector<uint8_t> trace;
+  ReplayOutput live = {};
+  if (recordSeconds > 0) {
+    if (!recordScriptedTrace(recordSeconds, seed, trace, live) || !saveTrace(tracePath, trace)) return 1;
+    printf("⏺️ Recorded %lu s into %s (%zu bytes)\n", recordSeconds, tracePath, trace.size());
+  }
+  if (!loadTraceFile(tracePath, trace)) return 1;
+
+  ReplayOutput output = {};
+  auto start = std::chrono::steady_clock::now();
+  if (!replayTrace(trace, output)) return 1;
+  double seconds = secondsSince(start);
+  printf("REPLAY,records=%lu,decisions=%zu,misses=%lu,virtual_s=%.1f,wall_s=%.3f,speedup=%.0f\n",
+         output.records, output.lines.size(), output.misses, output.virtualMs / 1000.0, seconds,
+         seconds > 0 ? output.virtualMs / 1000.0 / seconds : 0.0);
+
+  int failures = 0;
+  if (out != NULL && !writeReplayOutput(out, output)) return 1;
+  if (recordSeconds > 0) failures += reportDifference("the live session", live.lines, output.lines);
+  if (compare != NULL) {
+    std::vector<std::string> expected;
+    if (!readReplayOutput(compare, expected)) return 1;
+    failures += reportDifference(compare, expected, output.lines);
+  }
+  return failures == 0 ? 0 : 1;
+}
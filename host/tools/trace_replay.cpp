@@ -0,0 +1,374 @@
+/*
+ * Trace Replay Driver Implementation for ToxiRover
+ */
+
+#include "trace_replay.h"
+#include "fake_hal.h"
+#include "alert_manager.h"
+#include "config_store.h"
+#include "gas_sensor.h"
+#include "rover_status.h"
+#include "UltrasonicServo.h"
+#include "ultrasonic.h"
+#include "Wifi_control.h"
+
+#include <LittleFS.h>
+#include <algorithm>
+#include <cstdarg>
+
+#define REPLAY_LINE_SIZE 96
+
+NewPing sonar(ULTRASONIC_TRIG_PIN, ULTRASONIC_ECHO_PIN, MAX_DISTANCE);  // defined by the sketch on the device
+static UltrasonicServo ultraServo(ULTRASONIC_SERVO_TRIG, ULTRASONIC_SERVO_ECHO, ULTRASONIC_SERVO_SERVO,
+                                  ULTRASONIC_SERVO_MOTOR1, ULTRASONIC_SERVO_MOTOR2);
+
+static ReplayOutput* session = NULL;
+static unsigned long sessionStart = 0;
+static MotionCommand currentMotion = MOTION_STOP;
+
+static void emit(const char* format, ...) {
+  char line[REPLAY_LINE_SIZE];
+  int n = snprintf(line, sizeof(line), "%lu,", millis() - sessionStart);
+  va_list args;
+  va_start(args, format);
+  vsnprintf(line + n, sizeof(line) - n, format, args);
+  va_end(args);
+  session->lines.push_back(line);
+}
+
+static void logAlert(const AlertRecord& alert) {
+  emit("alert,%s,%s,%lu,%.2f", getAlertTypeName(alert.type), getAlertSeverityName(alert.severity),
+       alert.count, alert.peak);
+}
+
+// ---------------------------------------------------------------- task steps
+// What toxirover_integrated.ino's tasks do with each input
+
+static void gasStep() {
+  float ppm = readGasSensor();
+  emit("gas,%.2f,%s", ppm, getGasLevel());
+  if (ppm > roverConfig.gasDangerThreshold) {
+    raiseAlert(ALERT_HIGH_GAS, SEVERITY_DANGER, ppm, "High gas concentration detected");
+  }
+  serviceAlerts();
+}
+
+static void distanceStep() {
+  int distance = readDistance();
+  emit("distance,%d", distance);
+  if (distance < roverConfig.obstacleThreshold && currentMotion != MOTION_STOP) {
+    currentMotion = MOTION_STOP;
+    emit("obstacle_stop");
+  }
+}
+
+static void avoidStep() {
+  ultraServo.checkAndAct();
+  emit("avoid,%.1f,%d", ultraServo.getLastDistance(), ultraServo.isObstacleDetected() ? 1 : 0);
+}
+
+static void applyMotion(MotionCommand command) {
+  currentMotion = command;
+  emit("motion,%s", getMotionName(command));
+}
+
+static void applyServo(int angle) {
+  ultraServo.aimServo(angle);
+  emit("servo,%d", angle);
+}
+
+static void applyDrive(char command) {
+  dispatchCommand(command);
+  if (command == 'F' || command == 'G' || command == 'I') currentMotion = MOTION_FORWARD;
+  else if (command == 'S') currentMotion = MOTION_STOP;
+  emit("drive,%c", command);
+}
+
+// Both sessions start from the same state: alerts resolved, avoidance idle, on a whole millisecond
+static void beginSession(ReplayOutput& output) {
+  setAlertSink(NULL);
+  fakeAdvanceMillis(ALERT_RESOLVE_TIMEOUT + 2000);  // resolve timeout, and checkAndAct's cooldown
+  fakeAdvanceMicros(1000 - micros() % 1000);
+  serviceAlerts();
+  ultraServo.begin();
+  ultraServo.reset();
+  currentMotion = MOTION_STOP;
+
+  output.lines.clear();
+  output.records = 0;
+  output.virtualMs = 0;
+  output.misses = 0;
+  session = &output;
+  sessionStart = millis();
+  setAlertSink(logAlert);
+}
+
+static void endSession() {
+  session->virtualMs = millis() - sessionStart;
+  setAlertSink(NULL);
+  session = NULL;
+}
+
+// ---------------------------------------------------------------- trace files
+
+// "TRACE,<offset>,<hex>" lines from exportTraceSerial(), anything else in the capture skipped
+bool parseTraceHexDump(const std::string& text, std::vector<uint8_t>& trace) {
+  trace.clear();
+  size_t start = 0;
+  bool ended = false;
+  while (start < text.size() && !ended) {
+    size_t end = text.find('\n', start);
+    if (end == std::string::npos) end = text.size();
+    std::string line = text.substr(start, end - start);
+    start = end + 1;
+    while (!line.empty() && (line.back() == '\r' || line.back() == ' ')) line.pop_back();
+
+    size_t at = line.find("TRACE,");
+    if (at == std::string::npos) continue;
+    line.erase(0, at + 6);
+    if (line == "END") {
+      ended = true;
+      break;
+    }
+    size_t comma = line.find(',');
+    if (comma == std::string::npos) return false;
+    if (strtoul(line.c_str(), NULL, 10) != trace.size()) return false;  // a line went missing
+    const std::string hex = line.substr(comma + 1);
+    if (hex.size() % 2 != 0) return false;
+    for (size_t i = 0; i < hex.size(); i += 2) {
+      char byte[3] = {hex[i], hex[i + 1], 0};
+      char* parsed;
+      trace.push_back((uint8_t)strtoul(byte, &parsed, 16));
+      if (*parsed != 0) return false;
+    }
+  }
+  return ended;
+}
+
+bool loadTraceFile(const char* path, std::vector<uint8_t>& trace) {
+  FILE* file = fopen(path, "rb");
+  if (file == NULL) {
+    fprintf(stderr, "❌ Cannot open %s\n", path);
+    return false;
+  }
+  std::string bytes;
+  char chunk[4096];
+  size_t n;
+  while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0) bytes.append(chunk, n);
+  fclose(file);
+
+  uint32_t magic = 0;
+  if (bytes.size() >= sizeof(magic)) memcpy(&magic, bytes.data(), sizeof(magic));
+  if (magic == TRACE_MAGIC) {
+    trace.assign(bytes.begin(), bytes.end());
+    return true;
+  }
+  if (!parseTraceHexDump(bytes, trace)) {
+    fprintf(stderr, "❌ %s is neither a trace file nor a TRACE dump\n", path);
+    return false;
+  }
+  return true;
+}
+
+// ---------------------------------------------------------------- replay
+
+static bool installTrace(const std::vector<uint8_t>& trace) {
+  if (!LittleFS.begin()) return false;
+  File file = LittleFS.open(TRACE_FILE, "w");
+  if (!file) return false;
+  bool ok = file.write(trace.data(), trace.size()) == trace.size();
+  file.close();
+  return ok;
+}
+
+// Records are taken in file order; the clock jumps to each offset, so a trace
+// replays as fast as the logic runs. The firmware's reads pull the values back
+// through TRACE_INPUT() from their own channel positions.
+bool replayTrace(const std::vector<uint8_t>& trace, ReplayOutput& output) {
+  if (trace.size() < sizeof(TraceHeader) || (trace.size() - sizeof(TraceHeader)) % sizeof(TraceRecord) != 0) {
+    fprintf(stderr, "❌ Trace is %zu bytes, not a header and whole records\n", trace.size());
+    return false;
+  }
+  if (!installTrace(trace)) return false;
+
+  beginSession(output);
+  if (!startTraceReplay()) {
+    endSession();
+    return false;
+  }
+
+  size_t count = (trace.size() - sizeof(TraceHeader)) / sizeof(TraceRecord);
+  for (size_t i = 0; i < count; i++) {
+    TraceRecord record;
+    memcpy(&record, trace.data() + sizeof(TraceHeader) + i * sizeof(TraceRecord), sizeof(record));
+    unsigned long due = sessionStart + record.offsetMs;
+    if ((long)(due - millis()) > 0) fakeAdvanceMicros((unsigned long)due * 1000 - micros());
+
+    switch (record.channel) {
+      case TRACE_GAS_ADC: gasStep(); break;
+      case TRACE_ECHO_US: distanceStep(); break;
+      case TRACE_SERVO_ECHO_US: avoidStep(); break;
+      case TRACE_MOTION_CMD: applyMotion((MotionCommand)record.value); break;
+      case TRACE_SERVO_CMD: applyServo(record.value); break;
+      case TRACE_DRIVE_CMD: applyDrive((char)record.value); break;
+      default: break;  // read by a step along with its channel (GAS_DIGITAL)
+    }
+    output.records++;
+  }
+
+  output.misses = traceStats.replayMisses;
+  stopTraceReplay();
+  endSession();
+  return true;
+}
+
+// ---------------------------------------------------------------- scripted session
+
+struct ScriptedCommand {
+  unsigned long atMs;
+  TraceChannel channel;
+  int value;
+};
+
+// Operator steering around a parked minute, a gas plume while driving, and a dashboard stop
+static const ScriptedCommand SCRIPT[] = {
+  {20000, TRACE_DRIVE_CMD, '5'},
+  {30000, TRACE_DRIVE_CMD, 'F'},
+  {75000, TRACE_SERVO_CMD, 45},
+  {90000, TRACE_DRIVE_CMD, 'S'},
+  {150000, TRACE_MOTION_CMD, MOTION_FORWARD},
+  {175000, TRACE_SERVO_CMD, 90},
+  {200000, TRACE_MOTION_CMD, MOTION_STOP},
+  {240000, TRACE_DRIVE_CMD, 'I'},
+  {270000, TRACE_DRIVE_CMD, 'S'},
+};
+
+static uint32_t scriptSeed = 1;
+static unsigned long scriptStart = 0;
+static int plumeCounts = 0;
+
+static uint32_t noise(unsigned long ms) {
+  uint32_t x = (uint32_t)ms * 2654435761u ^ scriptSeed;
+  x ^= x >> 15;
+  x *= 2246822519u;
+  return x ^ (x >> 13);
+}
+
+static bool inPlume(unsigned long ms) {
+  unsigned long second = (ms - scriptStart) / 1000;
+  return (second >= 100 && second < 130) || (second >= 205 && second < 212);
+}
+
+static int scriptedGas(unsigned long ms) {
+  int base = inPlume(ms) ? plumeCounts : roverConfig.gasBaseline + 20;
+  return base + (int)(noise(ms) % 9) - 4;
+}
+
+// A wall closes in while driving and falls back when parked; now and then no echo
+static int scriptedEcho(unsigned long ms) {
+  unsigned long second = (ms - scriptStart) / 1000;
+  int cm = 150;
+  if (second >= 30 && second < 90) cm = 150 - (int)(second - 30) * 2;
+  else if (second >= 240 && second < 270) cm = 60 - (int)(second - 240) * 2;
+  if (noise(ms + 7) % 97 == 0) return 0;
+  return cm * 58 + (int)(noise(ms) % 40);
+}
+
+// Runs the task steps at their rates against scripted inputs while the recorder captures them
+bool recordScriptedTrace(unsigned long seconds, uint32_t seed, std::vector<uint8_t>& trace, ReplayOutput& live) {
+  scriptSeed = seed;
+  plumeCounts = roverConfig.gasBaseline + (int)(roverConfig.gasDangerThreshold * 1.3f / roverConfig.gasPpmPerCount);
+  fakeSetAnalogSource(GAS_ANALOG_PIN, scriptedGas);
+  fakeSetEchoSource(ULTRASONIC_ECHO_PIN, scriptedEcho);
+  if (!LittleFS.begin()) return false;
+
+  beginSession(live);
+  scriptStart = sessionStart;
+  if (!startTraceRecording()) {
+    endSession();
+    return false;
+  }
+
+  unsigned long nextGas = 0, nextDistance = 0, nextAvoid = 0;
+  size_t nextCommand = 0;
+  unsigned long endMs = seconds * 1000;
+  while (true) {
+    unsigned long commandAt = nextCommand < sizeof(SCRIPT) / sizeof(SCRIPT[0]) ? SCRIPT[nextCommand].atMs : endMs;
+    unsigned long due = std::min(std::min(nextGas, nextDistance), std::min(nextAvoid, commandAt));
+    if (due >= endMs) break;
+    if ((long)(sessionStart + due - millis()) > 0) {
+      fakeAdvanceMicros((unsigned long)(sessionStart + due) * 1000 - micros());
+    }
+    fakeSetDigital(GAS_DIGITAL_PIN, inPlume(millis()) ? HIGH : LOW);
+
+    if (due == commandAt) {
+      const ScriptedCommand& command = SCRIPT[nextCommand++];
+      TRACE_EVENT(command.channel, command.value);
+      if (command.channel == TRACE_DRIVE_CMD) applyDrive((char)command.value);
+      else if (command.channel == TRACE_MOTION_CMD) applyMotion((MotionCommand)command.value);
+      else applyServo(command.value);
+    } else if (due == nextGas) {
+      gasStep();
+      nextGas += REPLAY_GAS_INTERVAL;
+    } else if (due == nextDistance) {
+      distanceStep();
+      nextDistance += REPLAY_DISTANCE_INTERVAL;
+    } else {
+      avoidStep();
+      nextAvoid += REPLAY_AVOID_INTERVAL;
+    }
+  }
+
+  stopTraceRecording();
+  endSession();
+  fakeSetAnalogSource(GAS_ANALOG_PIN, NULL);
+  fakeSetEchoSource(ULTRASONIC_ECHO_PIN, NULL);
+
+  std::vector<uint8_t> bytes = fakeFsRead(TRACE_FILE);
+  trace.assign(bytes.begin(), bytes.end());
+  if (traceStats.dropped > 0) {
+    fprintf(stderr, "❌ %lu records did not fit in %d bytes; record fewer seconds\n", traceStats.dropped,
+            TRACE_MAX_BYTES);
+    return false;
+  }
+  return true;
+}
+
+// ---------------------------------------------------------------- outputs
+
+// Index of the first line that differs, -1 when both logs match
+long compareReplayOutputs(const std::vector<std::string>& expected, const std::vector<std::string>& actual) {
+  size_t common = std::min(expected.size(), actual.size());
+  for (size_t i = 0; i < common; i++) {
+    if (expected[i] != actual[i]) return (long)i;
+  }
+  return expected.size() == actual.size() ? -1 : (long)common;
+}
+
+bool writeReplayOutput(const char* path, const ReplayOutput& output) {
+  FILE* file = fopen(path, "w");
+  if (file == NULL) {
+    fprintf(stderr, "❌ Cannot write %s\n", path);
+    return false;
+  }
+  for (const std::string& line : output.lines) fprintf(file, "%s\n", line.c_str());
+  fclose(file);
+  return true;
+}
+
+bool readReplayOutput(const char* path, std::vector<std::string>& lines) {
+  FILE* file = fopen(path, "r");
+  if (file == NULL) {
+    fprintf(stderr, "❌ Cannot read %s\n", path);
+    return false;
+  }
+  lines.clear();
+  char buffer[REPLAY_LINE_SIZE + 2];
+  while (fgets(buffer, sizeof(buffer), file) != NULL) {
+    std::string line(buffer);
+    while (!line.empty() && (line.back() == '\n' || line.back() == '\r')) line.pop_back();
+    lines.push_back(line);
+  }
+  fclose(file);
+  return true;
+}
@@ -0,0 +1,42 @@
+/*
+ * Trace Replay Driver for ToxiRover
+ * Feeds a recorded sensor trace through the firmware's gas, distance, avoidance and alert logic on the PC
+ *
+ * Features:
+ * - Reads /trace.bin as downloaded from /trace, or a Serial capture of its TRACE hex lines
+ * - Replays on the virtual clock: record offsets are jumped to, never waited for
+ * - The same task steps the sketch runs, so replayed decisions match the live ones
+ * - Decision log as CSV lines, compared line by line between firmware versions
+ * - Scripted recording session for tests and the smoke run
+ */
+
+#ifndef TRACE_REPLAY_H
+#define TRACE_REPLAY_H
+
+#include "trace_recorder.h"
+
+#include <string>
+#include <vector>
+
+// Task rates of the recorded session (toxirover_integrated.ino runs gas at 1 s)
+#define REPLAY_GAS_INTERVAL 1000
+#define REPLAY_DISTANCE_INTERVAL 200
+#define REPLAY_AVOID_INTERVAL 500
+
+struct ReplayOutput {
+  std::vector<std::string> lines;  // "<ms>,<kind>,<fields>" decisions, in order
+  unsigned long records;           // trace records consumed
+  unsigned long virtualMs;         // span of the session on the rover's clock
+  unsigned long misses;            // reads that found no record left on their channel
+};
+
+// Function declarations
+bool loadTraceFile(const char* path, std::vector<uint8_t>& trace);
+bool parseTraceHexDump(const std::string& text, std::vector<uint8_t>& trace);
+bool replayTrace(const std::vector<uint8_t>& trace, ReplayOutput& output);
+bool recordScriptedTrace(unsigned long seconds, uint32_t seed, std::vector<uint8_t>& trace, ReplayOutput& live);
+long compareReplayOutputs(const std::vector<std::string>& expected, const std::vector<std::string>& actual);
+bool writeReplayOutput(const char* path, const ReplayOutput& output);
+bool readReplayOutput(const char* path, std::vector<std::string>& lines);
+
+#endif